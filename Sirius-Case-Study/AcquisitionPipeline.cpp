@@ -0,0 +1,92 @@
+#include "AcquisitionPipeline.h"
+#include <chrono>
+#include <thread>
+
+template <typename T>
+BasicAcquisitionPipeline<T>::BasicAcquisitionPipeline(BasicSensor<T>& sensor, BasicDataProcessor<T>& processor, size_t bufferCapacity, OverflowPolicy overflowPolicy)
+	:m_collect([&sensor](const std::function<void(const BasicSample<T>&)>& onDataPoint) { sensor.collectDataPoints(onDataPoint); }), // Data source
+	 m_processor(processor),                 // Data sink
+	 m_buffer(bufferCapacity, overflowPolicy), // Hand-off buffer between the threads
+	 m_expectedCount((size_t)sensor.getNumOfDataPoints()) // The sensor generates a known number of data points
+{
+	// Constructor body
+}
+
+template <typename T>
+BasicAcquisitionPipeline<T>::BasicAcquisitionPipeline(BasicReplaySource<T>& source, BasicDataProcessor<T>& processor, size_t bufferCapacity, OverflowPolicy overflowPolicy)
+	:m_collect([&source](const std::function<void(const BasicSample<T>&)>& onDataPoint) { source.collectDataPoints(onDataPoint); }), // Data source
+	 m_processor(processor),                 // Data sink
+	 m_buffer(bufferCapacity, overflowPolicy), // Hand-off buffer between the threads
+	 m_expectedCount(source.getSamples().size()) // The whole capture is replayed
+{
+	// Constructor body
+}
+
+template <typename T>
+BasicAcquisitionPipeline<T>::~BasicAcquisitionPipeline()
+{
+	// Destructor body
+}
+
+template <typename T>
+void BasicAcquisitionPipeline<T>::run()
+{
+	std::thread consumer(&BasicAcquisitionPipeline::consume, this); // Start processing first so that it is ready for the first data point
+	std::thread producer(&BasicAcquisitionPipeline::produce, this);
+
+	producer.join();
+	consumer.join();
+}
+
+template <typename T>
+size_t BasicAcquisitionPipeline<T>::getDroppedCount() const
+{
+	return m_buffer.getDroppedCount();
+}
+
+template <typename T>
+void BasicAcquisitionPipeline<T>::produce()
+{
+	m_collect([this](const BasicSample<T>& sample) { m_buffer.push(sample); });
+	m_buffer.close(); // Signal the consumer that no more data points will arrive
+}
+
+template <typename T>
+void BasicAcquisitionPipeline<T>::consume()
+{
+	int idleRounds = 0; // Number of consecutive polls that found the buffer empty
+	BasicSample<T> sample;
+
+	m_processor.beginStream(m_expectedCount); // Size the processor's buffers once, before the first data point
+	while (true)
+	{
+		if (m_buffer.tryPop(sample))
+		{
+			m_processor.onSample(sample);
+			idleRounds = 0;
+		}
+		else if (m_buffer.isDrained())
+		{
+			break;
+		}
+		else if (++idleRounds < 64)
+		{
+			// Spin briefly, the next data point is usually close
+		}
+		else if (idleRounds < 128)
+		{
+			std::this_thread::yield();
+		}
+		else
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(50)); // Stop burning a core during slow captures
+		}
+	}
+	m_processor.endStream();
+}
+
+// The sample types of SampleTraits; other types do not link
+template class BasicAcquisitionPipeline<double>;
+template class BasicAcquisitionPipeline<float>;
+template class BasicAcquisitionPipeline<std::int16_t>;
+template class BasicAcquisitionPipeline<std::int32_t>;
@@ -0,0 +1,86 @@
+#pragma once
+#include "Sensor.h"
+#include "DataProcessor.h"
+#include "ReplaySource.h"
+#include "SpscRingBuffer.h"
+#include <functional>
+
+/**
+ * @brief Connects a source of data points of a sample type to a data processor of the same type.
+ *
+ * `AcquisitionPipeline` is the double instantiation. The class is instantiated for double, float,
+ * std::int16_t and std::int32_t only, in AcquisitionPipeline.cpp.
+ *
+ * @tparam T The sample type.
+ */
+template <typename T>
+class BasicAcquisitionPipeline
+{
+public:
+	/**
+ * @brief Constructs a BasicAcquisitionPipeline object connecting a sensor to a data processor.
+ *
+ * The sensor runs on a dedicated producer thread and the data processor on a dedicated consumer
+ * thread. The two are connected by a bounded single-producer/single-consumer ring buffer, so the
+ * acquisition timing never depends on how long processing a sample takes.
+ *
+ * @param sensor The sensor producing the data points.
+ * @param processor The data processor consuming the data points.
+ * @param bufferCapacity The number of data points the ring buffer can hold (default: 4096).
+ * @param overflowPolicy What the producer does when the ring buffer is full (default: eBlock).
+ *        - eBlock: Wait for the consumer, no data point is lost.
+ *        - eDropOldest: Discard the oldest buffered data point.
+ *        - eDropNewest: Discard the new data point.
+ */
+	BasicAcquisitionPipeline(BasicSensor<T>& sensor, BasicDataProcessor<T>& processor, size_t bufferCapacity = 4096, OverflowPolicy overflowPolicy = eBlock);
+	/**
+ * @brief Constructs a BasicAcquisitionPipeline object connecting a recorded capture to a data processor.
+ *
+ * The replay source takes the place of the sensor on the producer thread and keeps its pacing,
+ * so recorded data goes through exactly the same path as live data.
+ *
+ * @param source The replay source producing the data points.
+ * @param processor The data processor consuming the data points.
+ * @param bufferCapacity The number of data points the ring buffer can hold (default: 4096).
+ * @param overflowPolicy What the producer does when the ring buffer is full (default: eBlock).
+ */
+	BasicAcquisitionPipeline(BasicReplaySource<T>& source, BasicDataProcessor<T>& processor, size_t bufferCapacity = 4096, OverflowPolicy overflowPolicy = eBlock);
+	~BasicAcquisitionPipeline();
+
+	/**
+ * @brief Runs a complete capture.
+ *
+ * Starts the producer thread, which collects the source's data points and pushes them into the
+ * ring buffer, and the consumer thread, which streams them into the data processor with
+ * `beginStream`/`onSample`/`endStream`. Returns once both threads have finished.
+ */
+	void run();
+
+	/**
+ * @brief Retrieves the number of data points discarded because the ring buffer was full.
+ *
+ * @return The number of dropped data points (always 0 with eBlock).
+ */
+	size_t getDroppedCount() const;
+
+private:
+
+	std::function<void(const std::function<void(const BasicSample<T>&)>&)> m_collect; // Runs the data source, driven by the producer thread
+	BasicDataProcessor<T>& m_processor; // The data sink, driven by the consumer thread
+	SpscRingBuffer<BasicSample<T>> m_buffer; // The hand-off buffer between the producer and the consumer, timestamps travel with the values
+	size_t m_expectedCount;           // The number of data points the source delivers, passed to `DataProcessor::beginStream`
+
+	/**
+ * @brief Body of the producer thread: collects the source's data points into the ring buffer.
+ */
+	void produce();
+	/**
+ * @brief Body of the consumer thread: streams the buffered data points into the data processor.
+ *
+ * When the buffer is empty the consumer backs off from spinning to yielding to short sleeps,
+ * so slow periodic captures do not keep a core busy.
+ */
+	void consume();
+};
+
+using AcquisitionPipeline = BasicAcquisitionPipeline<double>;
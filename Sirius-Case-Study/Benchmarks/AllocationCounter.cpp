@@ -0,0 +1,126 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<size_t> g_allocationCount(0); // Calls to operator new
+	std::atomic<size_t> g_allocatedBytes(0);  // Bytes requested from operator new
+
+	void* countedAllocate(size_t size)
+	{
+		g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+		g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		return std::malloc(size == 0 ? 1 : size);
+	}
+
+	void* countedAllocateAligned(size_t size, std::align_val_t alignment)
+	{
+		g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+		g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		size_t align = (size_t)alignment;
+#if defined(_MSC_VER)
+		return _aligned_malloc(size == 0 ? align : size, align);
+#else
+		// aligned_alloc needs the size to be a multiple of the alignment
+		size_t rounded = size == 0 ? align : (size + align - 1) / align * align;
+		return std::aligned_alloc(align, rounded);
+#endif
+	}
+
+	void freeAligned(void* pointer)
+	{
+#if defined(_MSC_VER)
+		_aligned_free(pointer);
+#else
+		std::free(pointer);
+#endif
+	}
+}
+
+size_t AllocationCounter::getAllocationCount()
+{
+	return g_allocationCount.load(std::memory_order_relaxed);
+}
+
+size_t AllocationCounter::getAllocatedBytes()
+{
+	return g_allocatedBytes.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size)
+{
+	void* pointer = countedAllocate(size);
+	if (pointer == nullptr)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	void* pointer = countedAllocateAligned(size, alignment);
+	if (pointer == nullptr)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+	freeAligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+	freeAligned(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept
+{
+	freeAligned(pointer);
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept
+{
+	freeAligned(pointer);
+}
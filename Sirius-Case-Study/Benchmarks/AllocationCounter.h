@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @brief Counts the heap allocations made through the global operator new.
+ *
+ * Linking AllocationCounter.cpp replaces every form of the global operator new and delete, so the
+ * counters cover all allocations of the process, including those made inside the standard library.
+ * The counters are atomic and never reset; take a snapshot before and after the code of interest.
+ */
+namespace AllocationCounter
+{
+	/**
+ * @brief Retrieves the number of allocations made so far.
+ *
+ * @return The number of calls to operator new.
+ */
+	size_t getAllocationCount();
+	/**
+ * @brief Retrieves the number of bytes allocated so far.
+ *
+ * @return The total size requested from operator new (frees are not subtracted).
+ */
+	size_t getAllocatedBytes();
+}
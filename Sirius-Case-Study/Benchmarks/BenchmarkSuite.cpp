@@ -0,0 +1,132 @@
+#include "BenchmarkSuite.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+BenchmarkSuite::BenchmarkSuite(double minSeconds)
+	: m_minSeconds(minSeconds) // Minimum measuring time per benchmark
+{
+	// Constructor body
+}
+
+BenchmarkSuite::~BenchmarkSuite()
+{
+	// Destructor body
+}
+
+void BenchmarkSuite::add(const std::string& name, size_t samplesPerIteration, const std::function<void()>& body)
+{
+	m_benchmarks.push_back(Benchmark{ name, samplesPerIteration, body });
+}
+
+void BenchmarkSuite::run(const std::string& filter)
+{
+	m_results.clear();
+
+	std::cout << std::left << std::setw(56) << "Benchmark"
+		<< std::right << std::setw(12) << "ns/sample"
+		<< std::setw(15) << "samples/s"
+		<< std::setw(14) << "bytes/sample"
+		<< std::setw(13) << "allocs/iter"
+		<< std::setw(12) << "iterations" << "\n";
+	std::cout << std::string(122, '-') << "\n";
+
+	for (const Benchmark& benchmark : m_benchmarks)
+	{
+		if (!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+			continue;
+
+		BenchmarkResult result = measure(benchmark);
+		m_results.push_back(result);
+
+		std::cout << std::left << std::setw(56) << result.name << std::right
+			<< std::fixed << std::setprecision(3) << std::setw(12) << result.nsPerSample
+			<< std::scientific << std::setprecision(3) << std::setw(15) << result.samplesPerSecond
+			<< std::fixed << std::setprecision(3) << std::setw(14) << result.bytesPerSample
+			<< std::setprecision(1) << std::setw(13) << result.allocationsPerIteration
+			<< std::setw(12) << result.iterations << "\n";
+		std::cout.unsetf(std::ios::floatfield);
+	}
+}
+
+const std::vector<BenchmarkResult>& BenchmarkSuite::getResults() const
+{
+	return m_results;
+}
+
+bool BenchmarkSuite::writeJson(const std::string& path, const std::vector<std::pair<std::string, std::string>>& context) const
+{
+	std::ofstream file(path);
+	if (!file.is_open())
+		return false;
+
+	file << std::setprecision(17);
+	file << "{\n  \"context\": {\n";
+	file << "    \"min_time_s\": " << m_minSeconds;
+	for (const auto& entry : context)
+		file << ",\n    \"" << entry.first << "\": \"" << entry.second << "\"";
+	file << "\n  },\n  \"benchmarks\": [";
+
+	for (size_t i = 0; i < m_results.size(); i++)
+	{
+		const BenchmarkResult& result = m_results[i];
+		file << (i == 0 ? "\n" : ",\n")
+			<< "    {\n"
+			<< "      \"name\": \"" << result.name << "\",\n"
+			<< "      \"iterations\": " << result.iterations << ",\n"
+			<< "      \"samples_per_iteration\": " << result.samplesPerIteration << ",\n"
+			<< "      \"real_time_ns\": " << result.secondsPerIteration * 1e9 << ",\n"
+			<< "      \"ns_per_sample\": " << result.nsPerSample << ",\n"
+			<< "      \"samples_per_second\": " << result.samplesPerSecond << ",\n"
+			<< "      \"bytes_per_sample\": " << result.bytesPerSample << ",\n"
+			<< "      \"allocations_per_iteration\": " << result.allocationsPerIteration << "\n"
+			<< "    }";
+	}
+	file << "\n  ]\n}\n";
+
+	file.close();
+	return !file.fail();
+}
+
+BenchmarkResult BenchmarkSuite::measure(const Benchmark& benchmark) const
+{
+	size_t iterations = 1;
+	double seconds = 0.0;
+	size_t allocations = 0;
+	size_t bytes = 0;
+
+	while (true)
+	{
+		size_t allocationsBefore = AllocationCounter::getAllocationCount();
+		size_t bytesBefore = AllocationCounter::getAllocatedBytes();
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; i++)
+			benchmark.body();
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		allocations = AllocationCounter::getAllocationCount() - allocationsBefore;
+		bytes = AllocationCounter::getAllocatedBytes() - bytesBefore;
+
+		// A long first run is measurement enough; otherwise size the next batch from it, like Google Benchmark
+		if (seconds >= m_minSeconds || iterations >= 1000000000)
+			break;
+		double perIteration = std::max(seconds / (double)iterations, 1e-9);
+		size_t next = (size_t)std::ceil(m_minSeconds * 1.2 / perIteration);
+		iterations = std::min<size_t>(std::max(next, iterations * 2), 1000000000);
+	}
+
+	double samples = (double)iterations * (double)benchmark.samplesPerIteration;
+	BenchmarkResult result = BenchmarkResult();
+	result.name = benchmark.name;
+	result.iterations = iterations;
+	result.samplesPerIteration = benchmark.samplesPerIteration;
+	result.secondsPerIteration = seconds / (double)iterations;
+	result.nsPerSample = samples > 0.0 ? seconds * 1e9 / samples : 0.0;
+	result.samplesPerSecond = seconds > 0.0 ? samples / seconds : 0.0;
+	result.bytesPerSample = samples > 0.0 ? (double)bytes / samples : 0.0;
+	result.allocationsPerIteration = (double)allocations / (double)iterations;
+	return result;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Measurements of one benchmark.
+ */
+struct BenchmarkResult
+{
+	std::string name;                ///< The benchmark name, e.g. "DataProcessor/movingAverageFilter/window:11".
+	size_t iterations;               ///< The number of timed iterations.
+	size_t samplesPerIteration;      ///< The number of samples one iteration processes.
+	double secondsPerIteration;      ///< The mean wall-clock time of one iteration.
+	double nsPerSample;              ///< The mean time per sample in nanoseconds.
+	double samplesPerSecond;         ///< The throughput in samples per second.
+	double bytesPerSample;           ///< The heap bytes allocated per sample.
+	double allocationsPerIteration;  ///< The heap allocations per iteration.
+};
+
+/**
+ * @brief A minimal benchmark harness in the style of Google Benchmark.
+ *
+ * Each registered benchmark is a function that processes a known number of samples. The harness
+ * runs it once to estimate its cost, then repeats it enough times to fill the minimum measuring
+ * time and reports the time per sample together with the heap allocations counted by
+ * AllocationCounter.
+ */
+class BenchmarkSuite
+{
+public:
+	/**
+ * @brief Constructs a BenchmarkSuite object.
+ *
+ * @param minSeconds The minimum measuring time per benchmark (default: 0.5).
+ */
+	BenchmarkSuite(double minSeconds = 0.5);
+	~BenchmarkSuite();
+
+	/**
+ * @brief Registers a benchmark.
+ *
+ * @param name The benchmark name; `run` filters on it.
+ * @param samplesPerIteration The number of samples one call of `body` processes.
+ * @param body The code to measure. Work that should not be measured belongs outside of it.
+ */
+	void add(const std::string& name, size_t samplesPerIteration, const std::function<void()>& body);
+	/**
+ * @brief Runs every registered benchmark whose name contains the filter and prints one line per benchmark.
+ *
+ * @param filter A substring of the names to run, empty to run everything.
+ */
+	void run(const std::string& filter);
+
+	/**
+ * @brief Retrieves the results of the last `run`.
+ *
+ * @return The results in registration order.
+ */
+	const std::vector<BenchmarkResult>& getResults() const;
+	/**
+ * @brief Writes the results and a description of the machine as JSON.
+ *
+ * The layout follows Google Benchmark's JSON output: a "context" object and a "benchmarks" array.
+ *
+ * @param path The path of the file to create or overwrite.
+ * @param context Additional "key": "value" pairs for the context object.
+ * @return True if the file was written successfully.
+ */
+	bool writeJson(const std::string& path, const std::vector<std::pair<std::string, std::string>>& context) const;
+
+private:
+
+	struct Benchmark
+	{
+		std::string name;              // The benchmark name
+		size_t samplesPerIteration;    // Samples processed per call of body
+		std::function<void()> body;    // The measured code
+	};
+
+	double m_minSeconds;                   // The minimum measuring time per benchmark
+	std::vector<Benchmark> m_benchmarks;   // The registered benchmarks
+	std::vector<BenchmarkResult> m_results; // The results of the last run
+
+	/**
+ * @brief Measures one benchmark.
+ *
+ * @param benchmark The benchmark to measure.
+ * @return The measurements.
+ */
+	BenchmarkResult measure(const Benchmark& benchmark) const;
+};
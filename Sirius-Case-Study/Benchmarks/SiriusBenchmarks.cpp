@@ -0,0 +1,584 @@
+#include "BenchmarkSuite.h"
+#include "../AcquisitionPipeline.h"
+#include "../CompressedSampleStore.h"
+#include "../DataProcessor.h"
+#include "../FilterChain.h"
+#include "../Logger.h"
+#include "../QuantileSketch.h"
+#include "../RandomEngine.h"
+#include "../Sensor.h"
+#include "../SensorFleet.h"
+#include "../SpectrumAnalyzer.h"
+#include "../SummaryPyramid.h"
+#include "../ThreadPool.h"
+#include "../Workspace.h"
+#include "../SimdKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <thread>
+
+namespace
+{
+	volatile double g_sink; // Keeps the compiler from discarding benchmark results
+
+	// Silences the progress messages of Sensor while it is in scope; the progress counting itself is still measured
+	class LogSilencer
+	{
+	public:
+		LogSilencer() : m_level(getLogger().getLevel()) { getLogger().setLevel(eLogOff); }
+		~LogSilencer() { getLogger().setLevel(m_level); }
+
+	private:
+		LogLevel m_level; // The log level to restore
+	};
+
+	std::vector<double> makeRandomData(size_t size, unsigned seed)
+	{
+		std::mt19937_64 generator(seed);
+		std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+		std::vector<double> data(size);
+		for (double& value : data)
+			value = distribution(generator);
+		return data;
+	}
+
+	void registerSensorBenchmarks(BenchmarkSuite& suite)
+	{
+		const int numDataPoints = 1000000;
+		const DataType types[] = { LINEAR, SINE, RANDOM };
+		const char* names[] = { "LINEAR", "SINE", "RANDOM" };
+
+		for (int i = 0; i < 3; i++)
+		{
+			DataType type = types[i];
+			suite.add(std::string("Sensor/generateDataPoint/") + names[i], numDataPoints, [type, numDataPoints]()
+			{
+				// generateDataPoint is private; collectDataPoints with immediate timing is its thinnest caller
+				LogSilencer silencer;
+				Sensor sensor(numDataPoints, eImmediate, 100, type, -100.0, 100.0);
+				double sum = 0.0;
+				sensor.collectDataPoints([&sum](const Sample& sample) { sum += sample.value; });
+				g_sink = sum;
+			});
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			DataType type = types[i];
+			std::shared_ptr<Sensor> sensor(new Sensor(numDataPoints, eImmediate, 100, type, -100.0, 100.0));
+			std::shared_ptr<std::vector<double>> block(new std::vector<double>(4096));
+			suite.add(std::string("Sensor/generateBlock/") + names[i], numDataPoints, [sensor, block, numDataPoints]()
+			{
+				// Bulk generation into a reused buffer, the same data points as above
+				for (int generated = 0; generated < numDataPoints; generated += (int)block->size())
+					sensor->generateBlock(std::span<double>(block->data(), std::min(block->size(), (size_t)(numDataPoints - generated))));
+				g_sink = block->back();
+			});
+		}
+	}
+
+	void registerRandomEngineBenchmarks(BenchmarkSuite& suite)
+	{
+		const RandomEngineType types[] = { eXoshiro256PlusPlus, ePcg32 };
+		for (RandomEngineType type : types)
+		{
+			std::shared_ptr<RandomEngine> engine(createRandomEngine(type, 42));
+			std::shared_ptr<std::vector<double>> block(new std::vector<double>(4096));
+			suite.add(std::string("RandomEngine/fillUniform/") + engine->getName(), block->size(), [engine, block]()
+			{
+				engine->fillUniform(*block, -100.0, 100.0);
+				g_sink = block->back();
+			});
+		}
+	}
+
+	void registerProcessorBenchmarks(BenchmarkSuite& suite, const std::shared_ptr<const std::vector<double>>& data)
+	{
+		const int windows[] = { 3, 5, 11, 21, 51, 101 };
+		for (int window : windows)
+		{
+			std::shared_ptr<DataProcessor> processor(new DataProcessor(window, 100));
+			processor->setRawData(*data);
+			processor->movingAverageFilter(); // Size the output once, the measured runs reuse it
+			suite.add("DataProcessor/movingAverageFilter/window:" + std::to_string(window), data->size(), [processor]()
+			{
+				processor->movingAverageFilter();
+				g_sink = processor->getProcessedData()[0];
+			});
+		}
+
+		const int subsets[] = { 1, 4, 16, 64, 1000, 100000 };
+		for (int subset : subsets)
+		{
+			std::shared_ptr<DataProcessor> processor(new DataProcessor(3, subset));
+			suite.add("DataProcessor/calculateSubsetAverage/subset:" + std::to_string(subset), data->size(), [processor, data]()
+			{
+				std::vector<double> averages = processor->calculateSubsetAverage(*data);
+				g_sink = averages.back();
+			});
+		}
+
+		std::shared_ptr<DataProcessor> processor(new DataProcessor(11, 100));
+		processor->setRawData(*data);
+		processor->movingAverageFilter();
+		processor->calculateStatistics();
+		suite.add("DataProcessor/calculateStatistics", data->size() * 2, [processor]()
+		{
+			processor->calculateStatistics();
+			g_sink = processor->getProcessedAverage();
+		});
+	}
+
+	void registerFilterChainBenchmarks(BenchmarkSuite& suite, const std::shared_ptr<const std::vector<double>>& data)
+	{
+		const char* const kChain = "ema:0.1,median:9,fir:0.25:0.5:0.25,lowpass:0.05";
+		std::shared_ptr<FilterChain> chain(new FilterChain());
+		chain->parse(kChain);
+		std::shared_ptr<std::vector<double>> work(new std::vector<double>(*data));
+
+		// All stages per block of FilterChain::kBlockSize data points, while the block is in cache
+		suite.add(std::string("FilterChain/blocked/") + kChain, data->size(), [chain, work, data]()
+		{
+			std::copy(data->begin(), data->end(), work->begin());
+			chain->reset();
+			chain->process(*work);
+			g_sink = work->back();
+		});
+
+		// One stage at a time over the whole array, as separate filter passes would do
+		suite.add(std::string("FilterChain/stageByStage/") + kChain, data->size(), [chain, work, data]()
+		{
+			std::copy(data->begin(), data->end(), work->begin());
+			chain->reset();
+			for (size_t i = 0; i < chain->getStageCount(); i++)
+				chain->getStage(i).process(*work);
+			g_sink = work->back();
+		});
+	}
+
+	void registerSpectrumBenchmarks(BenchmarkSuite& suite, const std::shared_ptr<const std::vector<double>>& data)
+	{
+		const size_t segments[] = { 256, 1024, 4096, 65536 };
+		for (size_t segment : segments)
+		{
+			// Welch averaging with half-segment overlap, so every data point is transformed twice
+			std::shared_ptr<SpectrumAnalyzer> analyzer(new SpectrumAnalyzer(segment));
+			suite.add("SpectrumAnalyzer/process/segment:" + std::to_string(segment), data->size(), [analyzer, data]()
+			{
+				analyzer->reset();
+				analyzer->process(*data);
+				g_sink = analyzer->getDominantFrequency();
+			});
+		}
+	}
+
+	void registerQuantileSketchBenchmarks(BenchmarkSuite& suite, const std::shared_ptr<const std::vector<double>>& data)
+	{
+		std::shared_ptr<QuantileSketch> sketch(new QuantileSketch());
+		suite.add("QuantileSketch/add", data->size(), [sketch, data]()
+		{
+			sketch->reset();
+			sketch->add(*data);
+			g_sink = sketch->getQuantile(0.99);
+		});
+
+		// Sketches of 16 chunks merged into one, as the parallel statistics and the fleet summary do
+		std::shared_ptr<std::vector<QuantileSketch>> partials(new std::vector<QuantileSketch>(16));
+		size_t chunk = data->size() / partials->size();
+		for (size_t i = 0; i < partials->size(); i++)
+			(*partials)[i].add(std::span<const double>(data->data() + i * chunk, chunk));
+		suite.add("QuantileSketch/merge/16", partials->size(), [sketch, partials]()
+		{
+			sketch->reset();
+			for (const QuantileSketch& partial : *partials)
+				sketch->merge(partial);
+			g_sink = sketch->getQuantile(0.99);
+		});
+
+		suite.add("QuantileSketch/getQuantile", 1, [sketch]()
+		{
+			g_sink = sketch->getQuantile(0.95);
+		});
+	}
+
+	void registerSummaryIndexBenchmarks(BenchmarkSuite& suite, const std::shared_ptr<const std::vector<double>>& data)
+	{
+		std::shared_ptr<SummaryPyramid> pyramid(new SummaryPyramid());
+		pyramid->assign(*data);
+		suite.add("SummaryPyramid/assign", data->size(), [pyramid, data]()
+		{
+			pyramid->assign(*data);
+			g_sink = pyramid->query(0, data->size()).sum;
+		});
+
+		// The same append per streamed data point as DataProcessor::onSample
+		suite.add("SummaryPyramid/append", data->size(), [pyramid, data]()
+		{
+			pyramid->clear();
+			for (double value : *data)
+				pyramid->append(value);
+			g_sink = pyramid->query(0, data->size()).sum;
+		});
+
+		// 1000 queries of random ranges per iteration, against a scan of the same ranges
+		std::shared_ptr<std::vector<size_t>> edges(new std::vector<size_t>(2000));
+		std::mt19937_64 generator(7);
+		for (size_t& edge : *edges)
+			edge = (size_t)(generator() % (data->size() + 1));
+		for (size_t i = 0; i < edges->size(); i += 2)
+		{
+			if ((*edges)[i] > (*edges)[i + 1])
+				std::swap((*edges)[i], (*edges)[i + 1]);
+		}
+		suite.add("SummaryPyramid/query", 1000, [pyramid, edges]()
+		{
+			double sum = 0.0;
+			for (size_t i = 0; i < edges->size(); i += 2)
+				sum += pyramid->query((*edges)[i], (*edges)[i + 1]).sum;
+			g_sink = sum;
+		});
+		suite.add("SummaryPyramid/scan", 1000, [data, edges]()
+		{
+			double sum = 0.0;
+			for (size_t i = 0; i < edges->size(); i += 2)
+				sum += computeDataStatistics(data->data() + (*edges)[i], (*edges)[i + 1] - (*edges)[i], 1 << 30, nullptr).sum;
+			g_sink = sum;
+		});
+	}
+
+	void registerParallelBenchmarks(BenchmarkSuite& suite, const std::shared_ptr<const std::vector<double>>& data)
+	{
+		// 1 thread is the serial path; the calling thread takes part, so the pool holds one thread less
+		size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+		std::vector<size_t> threadCounts = { 1, 2, 4 };
+		if (hardwareThreads > 4)
+			threadCounts.push_back(hardwareThreads);
+		for (size_t threads : threadCounts)
+		{
+			std::shared_ptr<DataProcessor> processor(new DataProcessor(11, 100));
+			if (threads > 1)
+				processor->setThreadPool(std::shared_ptr<ThreadPool>(new ThreadPool(threads - 1)));
+			processor->setRawData(*data);
+			processor->movingAverageFilter();
+			processor->calculateStatistics();
+			suite.add("DataProcessor/parallel/movingAverageFilter/threads:" + std::to_string(threads), data->size(), [processor]()
+			{
+				processor->movingAverageFilter();
+				g_sink = processor->getProcessedData()[0];
+			});
+			suite.add("DataProcessor/parallel/calculateStatistics/threads:" + std::to_string(threads), data->size() * 2, [processor]()
+			{
+				processor->calculateStatistics();
+				g_sink = processor->getProcessedAverage();
+			});
+		}
+	}
+
+	void registerFleetBenchmarks(BenchmarkSuite& suite)
+	{
+		size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+		std::vector<size_t> threadCounts = { 1, 2, 4 };
+		if (hardwareThreads > 4)
+			threadCounts.push_back(hardwareThreads);
+		for (size_t threads : threadCounts)
+		{
+			// Tasks that do nothing, so the time is the pool's own bookkeeping for submit, wake-up and completion
+			const size_t numTasks = 100000;
+			std::shared_ptr<ThreadPool> pool(new ThreadPool(threads));
+			suite.add("ThreadPool/submit/threads:" + std::to_string(threads), numTasks, [pool, numTasks]()
+			{
+				for (size_t i = 0; i < numTasks; i++)
+					pool->submit([] {});
+				pool->wait();
+			});
+
+			// 16 streaming channels, as a fleet run with `--channels 16` processes them
+			const int numChannels = 16;
+			const int numDataPoints = 100000;
+			std::shared_ptr<SensorFleet> fleet(new SensorFleet(threads));
+			for (int channel = 0; channel < numChannels; channel++)
+			{
+				fleet->addChannel(std::unique_ptr<Sensor>(new Sensor(numDataPoints, eImmediate, 100, RANDOM, -100.0, 100.0, (std::uint64_t)channel + 1)),
+					std::unique_ptr<DataProcessor>(new DataProcessor(11, 100)));
+			}
+			suite.add("SensorFleet/run/threads:" + std::to_string(threads), (size_t)numChannels * numDataPoints, [fleet]()
+			{
+				LogSilencer silencer;
+				fleet->run();
+				g_sink = fleet->getChannelStatistics(0).processedAverage;
+			});
+		}
+	}
+
+	template <typename T>
+	void registerSampleTypeBenchmarks(BenchmarkSuite& suite, const std::shared_ptr<const std::vector<double>>& data, double scale)
+	{
+		// The same data in every sample type, integers spanning the [-100, 100) range of the generated values
+		std::vector<T> samples(data->size());
+		for (size_t i = 0; i < samples.size(); i++)
+			samples[i] = SampleTraits<T>::quantize((*data)[i], scale);
+		std::shared_ptr<BasicDataProcessor<T>> processor(new BasicDataProcessor<T>(11, 100, scale));
+		processor->setRawData(std::move(samples));
+		processor->movingAverageFilter();
+		processor->calculateStatistics();
+
+		std::string prefix = std::string("DataProcessor/") + SampleTraits<T>::kName;
+		suite.add(prefix + "/movingAverageFilter", data->size(), [processor]()
+		{
+			processor->movingAverageFilter();
+			g_sink = (double)processor->getProcessedData()[0];
+		});
+		suite.add(prefix + "/calculateStatistics", data->size() * 2, [processor]()
+		{
+			processor->calculateStatistics();
+			g_sink = processor->getProcessedAverage();
+		});
+	}
+
+	void registerCompressionBenchmarks(BenchmarkSuite& suite)
+	{
+		const int numDataPoints = 1000000;
+		const DataType types[] = { LINEAR, SINE, RANDOM };
+		const char* names[] = { "LINEAR", "SINE", "RANDOM" };
+
+		for (int i = 0; i < 3; i++)
+		{
+			// Immediate captures with their timing, as `--output compressed` stores them
+			LogSilencer silencer;
+			Sensor sensor(numDataPoints, eImmediate, 100, types[i], -100.0, 100.0);
+			sensor.collectAndStoreDataPoints();
+			std::shared_ptr<SampleBuffer> samples(new SampleBuffer(sensor.releaseSamples()));
+			std::shared_ptr<CompressedSampleStore> store(new CompressedSampleStore());
+			store->assign(*samples);
+			std::cout << "CompressedSampleStore/" << names[i] << ": " << (double)(samples->size() * (sizeof(double) + sizeof(std::uint64_t) + sizeof(std::uint32_t))) / (double)store->getCompressedBytes()
+				<< " times smaller than the uncompressed data points\n";
+
+			suite.add(std::string("CompressedSampleStore/encode/") + names[i], samples->size(), [samples, store]()
+			{
+				store->assign(*samples);
+				g_sink = (double)store->getCompressedBytes();
+			});
+			std::shared_ptr<std::vector<double>> block(new std::vector<double>(CompressedSampleStore::kBlockSize));
+			suite.add(std::string("CompressedSampleStore/decodeBlock/") + names[i], samples->size(), [store, block]()
+			{
+				// Values only, into a buffer that stays in cache
+				for (size_t b = 0; b < store->getBlockCount(); b++)
+					store->decodeBlock(b, *block);
+				g_sink = block->front();
+			});
+			std::shared_ptr<DataProcessor> processor(new DataProcessor(11, 100));
+			suite.add(std::string("CompressedSampleStore/decodeIntoProcessor/") + names[i], samples->size(), [store, processor]()
+			{
+				processor->setRawData(*store);
+				g_sink = processor->getRawSamples().getValues().back();
+			});
+		}
+	}
+
+	void registerPipelineBenchmarks(BenchmarkSuite& suite, long long maxPoints)
+	{
+		for (long long numDataPoints = 1000; numDataPoints <= maxPoints; numDataPoints *= 10)
+		{
+			int points = (int)numDataPoints;
+			suite.add("Pipeline/streaming/points:" + std::to_string(points), (size_t)points, [points]()
+			{
+				// Sensor -> ring buffer -> streaming DataProcessor, as in an interactive run
+				LogSilencer silencer;
+				Sensor sensor(points, eImmediate, 100, RANDOM, -100.0, 100.0);
+				DataProcessor processor(11, 100);
+				AcquisitionPipeline pipeline(sensor, processor);
+				pipeline.run();
+				g_sink = processor.getProcessedAverage();
+			});
+		}
+
+		for (long long numDataPoints = 1000; numDataPoints <= maxPoints; numDataPoints *= 10)
+		{
+			int points = (int)numDataPoints;
+			suite.add("Pipeline/batch/points:" + std::to_string(points), (size_t)points, [points]()
+			{
+				// Collect everything first, then filter and summarize with the vector kernels
+				LogSilencer silencer;
+				Sensor sensor(points, eImmediate, 100, RANDOM, -100.0, 100.0);
+				sensor.collectAndStoreDataPoints();
+				DataProcessor processor(11, 100);
+				processor.setRawData(sensor.releaseSamples());
+				processor.movingAverageFilter();
+				processor.calculateStatistics();
+				g_sink = processor.getProcessedAverage();
+			});
+		}
+
+		// The same batch run with a sensor and processor that draw their buffers from a shared workspace: after the
+		// first iteration, the buffers circulate between them and allocs/iter drops to zero. Every workspace keeps
+		// its buffers until the program ends, so the sizes stop at 1e7 data points.
+		for (long long numDataPoints = 1000; numDataPoints <= std::min(maxPoints, 10000000LL); numDataPoints *= 10)
+		{
+			int points = (int)numDataPoints;
+			std::shared_ptr<Workspace> workspace(new Workspace());
+			std::shared_ptr<Sensor> sensor(new Sensor(points, eImmediate, 100, RANDOM, -100.0, 100.0));
+			std::shared_ptr<DataProcessor> processor(new DataProcessor(11, 100));
+			sensor->setWorkspace(workspace);
+			processor->setWorkspace(workspace);
+			suite.add("Pipeline/batchWorkspace/points:" + std::to_string(points), (size_t)points, [sensor, processor]()
+			{
+				LogSilencer silencer;
+				sensor->collectAndStoreDataPoints();
+				processor->setRawData(sensor->releaseSamples());
+				processor->movingAverageFilter();
+				processor->calculateStatistics();
+				g_sink = processor->getProcessedAverage();
+			});
+		}
+	}
+
+	// Prints the speed-up of every benchmark measured at several thread counts over its single-threaded run
+	void printScalingTable(const std::vector<BenchmarkResult>& results)
+	{
+		const std::string kThreads = "/threads:";
+		std::map<std::string, std::vector<std::pair<size_t, double>>> groups; // Benchmark name without the thread count -> (threads, samples/s)
+		for (const BenchmarkResult& result : results)
+		{
+			size_t position = result.name.rfind(kThreads);
+			if (position != std::string::npos)
+				groups[result.name.substr(0, position)].push_back({ (size_t)std::atoll(result.name.c_str() + position + kThreads.size()), result.samplesPerSecond });
+		}
+
+		size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+		bool printed = false;
+		for (auto& [name, runs] : groups)
+		{
+			std::sort(runs.begin(), runs.end());
+			if (runs.size() < 2 || runs[0].first != 1 || runs[0].second <= 0.0)
+				continue;
+			if (!printed)
+			{
+				std::cout << "\nScaling on " << hardwareThreads << " hardware threads (speed-up over 1 thread, efficiency = speed-up / threads):\n";
+				printed = true;
+			}
+			std::cout << name << "\n";
+			for (const auto& [threads, samplesPerSecond] : runs)
+			{
+				double speedUp = samplesPerSecond / runs[0].second;
+				std::cout << "  " << std::left << std::setw(12) << ("threads:" + std::to_string(threads)) << std::right
+					<< std::scientific << std::setprecision(3) << std::setw(15) << samplesPerSecond << " samples/s"
+					<< std::fixed << std::setprecision(2) << std::setw(9) << speedUp << "x"
+					<< std::setw(9) << 100.0 * speedUp / (double)threads << "%";
+				if (threads > hardwareThreads)
+					std::cout << "  (more threads than hardware threads)";
+				std::cout << "\n";
+			}
+		}
+		std::cout << std::defaultfloat;
+	}
+
+	void printUsage()
+	{
+		std::cout << "Usage: Sirius-Benchmarks [options]\n\n"
+			<< "  --filter TEXT      Only run benchmarks whose name contains TEXT\n"
+			<< "  --json PATH        Write the results as JSON\n"
+			<< "  --min-time S       Minimum measuring time per benchmark in seconds (default: 0.5)\n"
+			<< "  --max-points N     Largest pipeline size (default: 100000000)\n"
+			<< "  --simd LEVEL       Kernels to use: scalar, avx2 or avx512 (default: the best supported)\n"
+			<< "  --help             Show this text\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string filter;
+	std::string jsonPath;
+	double minSeconds = 0.5;
+	long long maxPoints = 100000000;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--help")
+		{
+			printUsage();
+			return 0;
+		}
+		else if (argument == "--filter" && i + 1 < argc)
+			filter = argv[++i];
+		else if (argument == "--json" && i + 1 < argc)
+			jsonPath = argv[++i];
+		else if (argument == "--min-time" && i + 1 < argc)
+			minSeconds = std::atof(argv[++i]);
+		else if (argument == "--max-points" && i + 1 < argc)
+			maxPoints = std::atoll(argv[++i]);
+		else if (argument == "--simd" && i + 1 < argc)
+		{
+			std::string level = argv[++i];
+			if (level == "scalar")
+				setSimdLevel(eScalar);
+			else if (level == "avx2")
+				setSimdLevel(eAvx2);
+			else if (level == "avx512")
+				setSimdLevel(eAvx512);
+			else
+			{
+				printUsage();
+				return 1;
+			}
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	std::cout << "Kernels: " << getSimdLevelName(getSimdLevel()) << "\n\n";
+
+	BenchmarkSuite suite(minSeconds);
+	std::shared_ptr<const std::vector<double>> data(new std::vector<double>(makeRandomData(1000000, 42)));
+	registerSensorBenchmarks(suite);
+	registerRandomEngineBenchmarks(suite);
+	registerProcessorBenchmarks(suite, data);
+	registerFilterChainBenchmarks(suite, data);
+	registerSpectrumBenchmarks(suite, data);
+	registerQuantileSketchBenchmarks(suite, data);
+	registerSummaryIndexBenchmarks(suite, data);
+	registerParallelBenchmarks(suite, data);
+	registerFleetBenchmarks(suite);
+	registerSampleTypeBenchmarks<double>(suite, data, 1.0);
+	registerSampleTypeBenchmarks<float>(suite, data, 1.0);
+	registerSampleTypeBenchmarks<std::int16_t>(suite, data, 100.0 / 32767.0);
+	registerSampleTypeBenchmarks<std::int32_t>(suite, data, 100.0 / 2147483647.0);
+	registerCompressionBenchmarks(suite);
+	registerPipelineBenchmarks(suite, std::min<long long>(maxPoints, 2147483647));
+	suite.run(filter);
+	printScalingTable(suite.getResults());
+
+	if (!jsonPath.empty())
+	{
+		char date[32];
+		std::time_t now = std::time(nullptr);
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+		std::vector<std::pair<std::string, std::string>> context;
+		context.push_back({ "date", date });
+		context.push_back({ "simd_level", getSimdLevelName(getSimdLevel()) });
+		context.push_back({ "num_cpus", std::to_string(std::thread::hardware_concurrency()) });
+#if defined(NDEBUG)
+		context.push_back({ "build_type", "release" });
+#else
+		context.push_back({ "build_type", "debug" });
+#endif
+		if (!suite.writeJson(jsonPath, context))
+		{
+			std::cout << "Failed to write " << jsonPath << "\n";
+			return 1;
+		}
+		std::cout << "\nResults have been saved to '" << jsonPath << "'.\n";
+	}
+	return 0;
+}
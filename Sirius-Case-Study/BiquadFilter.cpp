@@ -0,0 +1,100 @@
+#include "BiquadFilter.h"
+#include <cmath>
+#include <sstream>
+
+namespace
+{
+	const double kPi = 3.14159265358979323846;
+}
+
+BiquadFilter::BiquadFilter(double b0, double b1, double b2, double a1, double a2)
+	: m_b0(b0), m_b1(b1), m_b2(b2), // Feed-forward coefficients
+	  m_a1(a1), m_a2(a2),           // Feedback coefficients
+	  m_state1(0.0),                // Primed by the first data point
+	  m_state2(0.0),
+	  m_started(false)
+{
+	// Constructor body
+}
+
+BiquadFilter::~BiquadFilter()
+{
+	// Destructor body
+}
+
+BiquadFilter BiquadFilter::lowPass(double cutoff, double q)
+{
+	double omega = 2.0 * kPi * cutoff;
+	double cosine = std::cos(omega);
+	double alpha = std::sin(omega) / (2.0 * q);
+	double a0 = 1.0 + alpha;
+	BiquadFilter filter((1.0 - cosine) / 2.0 / a0, (1.0 - cosine) / a0, (1.0 - cosine) / 2.0 / a0,
+		-2.0 * cosine / a0, (1.0 - alpha) / a0);
+
+	std::ostringstream design;
+	design << "lowpass:" << cutoff << ":" << q;
+	filter.m_design = design.str();
+	return filter;
+}
+
+BiquadFilter BiquadFilter::highPass(double cutoff, double q)
+{
+	double omega = 2.0 * kPi * cutoff;
+	double cosine = std::cos(omega);
+	double alpha = std::sin(omega) / (2.0 * q);
+	double a0 = 1.0 + alpha;
+	BiquadFilter filter((1.0 + cosine) / 2.0 / a0, -(1.0 + cosine) / a0, (1.0 + cosine) / 2.0 / a0,
+		-2.0 * cosine / a0, (1.0 - alpha) / a0);
+
+	std::ostringstream design;
+	design << "highpass:" << cutoff << ":" << q;
+	filter.m_design = design.str();
+	return filter;
+}
+
+void BiquadFilter::process(std::span<double> block)
+{
+	if (block.empty())
+		return;
+	if (!m_started)
+	{
+		// Start in the steady state of a constant input at the first value, so there is no transient
+		double input = block[0];
+		double denominator = 1.0 + m_a1 + m_a2;
+		double output = std::fabs(denominator) > 1e-300 ? (m_b0 + m_b1 + m_b2) / denominator * input : 0.0;
+		m_state2 = m_b2 * input - m_a2 * output;
+		m_state1 = m_b1 * input - m_a1 * output + m_state2;
+		m_started = true;
+	}
+
+	// The recurrence is serial, keep the state in registers for the whole block
+	double state1 = m_state1;
+	double state2 = m_state2;
+	for (double& value : block)
+	{
+		double input = value;
+		double output = m_b0 * input + state1;
+		state1 = m_b1 * input - m_a1 * output + state2;
+		state2 = m_b2 * input - m_a2 * output;
+		value = output;
+	}
+	m_state1 = state1;
+	m_state2 = state2;
+}
+
+void BiquadFilter::reset()
+{
+	m_state1 = 0.0;
+	m_state2 = 0.0;
+	m_started = false;
+}
+
+std::string BiquadFilter::describe() const
+{
+	if (!m_design.empty())
+		return m_design;
+
+	std::ostringstream description;
+	description << "biquad:" << m_b0 << ":" << m_b1 << ":" << m_b2 << ":" << m_a1 << ":" << m_a2;
+	return description.str();
+}
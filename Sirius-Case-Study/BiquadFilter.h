@@ -0,0 +1,56 @@
+#pragma once
+#include "FilterStage.h"
+
+/**
+ * @brief Second-order IIR section in transposed direct form II.
+ *
+ * y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2], with a0 normalized to 1. The
+ * transposed form keeps two state variables and has good numerical behavior in double precision.
+ * Higher orders are built by chaining several sections in a FilterChain. `lowPass` and `highPass`
+ * design Butterworth-like sections with the formulas of the Audio EQ Cookbook (R. Bristow-Johnson).
+ */
+class BiquadFilter final : public FilterStage
+{
+public:
+	/**
+ * @brief Constructs a BiquadFilter object from its coefficients.
+ *
+ * @param b0 Feed-forward coefficient of x[n].
+ * @param b1 Feed-forward coefficient of x[n-1].
+ * @param b2 Feed-forward coefficient of x[n-2].
+ * @param a1 Feedback coefficient of y[n-1].
+ * @param a2 Feedback coefficient of y[n-2].
+ */
+	BiquadFilter(double b0, double b1, double b2, double a1, double a2);
+	~BiquadFilter();
+
+	/**
+ * @brief Designs a low-pass section.
+ *
+ * @param cutoff The cutoff frequency as a fraction of the sample rate, in (0, 0.5).
+ * @param q The quality factor (default: 1/sqrt(2), maximally flat).
+ * @return The filter.
+ */
+	static BiquadFilter lowPass(double cutoff, double q = 0.70710678118654752);
+	/**
+ * @brief Designs a high-pass section.
+ *
+ * @param cutoff The cutoff frequency as a fraction of the sample rate, in (0, 0.5).
+ * @param q The quality factor (default: 1/sqrt(2), maximally flat).
+ * @return The filter.
+ */
+	static BiquadFilter highPass(double cutoff, double q = 0.70710678118654752);
+
+	void process(std::span<double> block) override;
+	void reset() override;
+	std::string describe() const override;
+
+private:
+
+	double m_b0, m_b1, m_b2; // Feed-forward coefficients
+	double m_a1, m_a2;       // Feedback coefficients
+	double m_state1;         // First state variable of the transposed direct form
+	double m_state2;         // Second state variable of the transposed direct form
+	bool m_started;          // Set once the state has been primed with the first data point
+	std::string m_design;    // How `lowPass` or `highPass` designed the filter, empty for given coefficients
+};
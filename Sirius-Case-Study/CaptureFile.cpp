@@ -0,0 +1,541 @@
+#include "CaptureFile.h"
+#include "CompressedSampleStore.h"
+#include "StatisticsKernel.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const char kCaptureMagic[8] = { 'S', 'I', 'R', 'C', 'A', 'P', 'T', '\0' };
+	const std::uint32_t kCaptureVersion = 1;
+	const std::uint64_t kCaptureAlignment = 64; // Column data starts on a cache line
+
+	std::uint64_t alignUp(std::uint64_t value)
+	{
+		return (value + kCaptureAlignment - 1) & ~(kCaptureAlignment - 1);
+	}
+}
+
+std::uint64_t computeCaptureChecksum(const void* data, size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	const std::uint64_t modulus = 0xFFFFFFFFull;
+	std::uint64_t sum1 = 0;
+	std::uint64_t sum2 = 0;
+
+	size_t wordCount = size / 4;
+	size_t i = 0;
+	while (i < wordCount)
+	{
+		// sum2 grows by at most 2^32 * sum1 per word, so reducing every 92680 words cannot overflow
+		size_t blockEnd = std::min(wordCount, i + 92680);
+		for (; i < blockEnd; i++)
+		{
+			std::uint32_t word;
+			std::memcpy(&word, bytes + i * 4, 4);
+			sum1 += word;
+			sum2 += sum1;
+		}
+		sum1 %= modulus;
+		sum2 %= modulus;
+	}
+
+	// Zero pad the trailing bytes to a full word
+	if (size % 4 != 0)
+	{
+		std::uint32_t word = 0;
+		std::memcpy(&word, bytes + wordCount * 4, size % 4);
+		sum1 = (sum1 + word) % modulus;
+		sum2 = (sum2 + sum1) % modulus;
+	}
+
+	return (sum2 << 32) | sum1;
+}
+
+size_t getCaptureValueSize(std::uint32_t type)
+{
+	switch (type)
+	{
+	case eColumnFloat64:
+		return sizeof(double);
+	case eColumnUInt64:
+		return sizeof(std::uint64_t);
+	case eColumnUInt32:
+		return sizeof(std::uint32_t);
+	case eColumnCompressed:
+		return 1;
+	case eColumnFloat32:
+		return sizeof(float);
+	case eColumnInt16:
+		return sizeof(std::int16_t);
+	case eColumnInt32:
+		return sizeof(std::int32_t);
+	default:
+		return 0;
+	}
+}
+
+template <>
+std::uint32_t getCaptureColumnType<double>()
+{
+	return eColumnFloat64;
+}
+
+template <>
+std::uint32_t getCaptureColumnType<float>()
+{
+	return eColumnFloat32;
+}
+
+template <>
+std::uint32_t getCaptureColumnType<std::int16_t>()
+{
+	return eColumnInt16;
+}
+
+template <>
+std::uint32_t getCaptureColumnType<std::int32_t>()
+{
+	return eColumnInt32;
+}
+
+CaptureWriter::CaptureWriter(std::uint64_t chunkSize)
+	: m_chunkSize(chunkSize),   // Values per chunk index entry
+	  m_samplePeriodNs(0),      // The sample period is unknown until it is set
+	  m_valueScale(0.0)         // Counts have no known scale until it is set
+{
+	// Constructor body
+}
+
+CaptureWriter::~CaptureWriter()
+{
+	// Destructor body
+}
+
+void CaptureWriter::setSamplePeriod(std::uint64_t samplePeriodNs)
+{
+	m_samplePeriodNs = samplePeriodNs;
+}
+
+void CaptureWriter::addColumn(const std::string& name, std::span<const double> values, std::uint32_t channel)
+{
+	m_columns.push_back(PendingColumn{ name, eColumnFloat64, values.data(), values.size(), channel });
+}
+
+void CaptureWriter::setValueScale(double scale)
+{
+	m_valueScale = scale;
+}
+
+void CaptureWriter::addColumn(const std::string& name, std::span<const float> values, std::uint32_t channel)
+{
+	m_columns.push_back(PendingColumn{ name, eColumnFloat32, values.data(), values.size(), channel });
+}
+
+void CaptureWriter::addColumn(const std::string& name, std::span<const std::int16_t> values, std::uint32_t channel)
+{
+	m_columns.push_back(PendingColumn{ name, eColumnInt16, values.data(), values.size(), channel });
+}
+
+void CaptureWriter::addColumn(const std::string& name, std::span<const std::int32_t> values, std::uint32_t channel)
+{
+	m_columns.push_back(PendingColumn{ name, eColumnInt32, values.data(), values.size(), channel });
+}
+
+void CaptureWriter::addColumn(const std::string& name, std::span<const std::uint64_t> values, std::uint32_t channel)
+{
+	m_columns.push_back(PendingColumn{ name, eColumnUInt64, values.data(), values.size(), channel });
+}
+
+void CaptureWriter::addColumn(const std::string& name, std::span<const std::uint32_t> values, std::uint32_t channel)
+{
+	m_columns.push_back(PendingColumn{ name, eColumnUInt32, values.data(), values.size(), channel });
+}
+
+void CaptureWriter::addColumn(const std::string& name, const CompressedSampleStore& samples, std::uint32_t channel)
+{
+	PendingColumn column{ name, eColumnCompressed, nullptr, 0, channel };
+	samples.serialize(column.ownedData);
+	column.valueCount = column.ownedData.size();
+	m_columns.push_back(std::move(column));
+}
+
+bool CaptureWriter::write(const std::string& path) const
+{
+	CaptureFileHeader header = CaptureFileHeader();
+	std::memcpy(header.magic, kCaptureMagic, sizeof(header.magic));
+	header.version = kCaptureVersion;
+	header.headerSize = sizeof(CaptureFileHeader);
+	header.columnCount = (std::uint32_t)m_columns.size();
+	header.samplePeriodNs = m_samplePeriodNs;
+	header.chunkSize = m_chunkSize;
+	header.valueScale = m_valueScale;
+
+	// Lay out the file: header, descriptors, then each column's data followed by its chunk index
+	std::vector<CaptureColumnDescriptor> descriptors(m_columns.size());
+	std::vector<std::vector<CaptureChunkIndexEntry>> chunkIndices(m_columns.size());
+	std::uint64_t offset = sizeof(CaptureFileHeader) + m_columns.size() * sizeof(CaptureColumnDescriptor);
+	for (size_t c = 0; c < m_columns.size(); c++)
+	{
+		const PendingColumn& column = m_columns[c];
+		CaptureColumnDescriptor& descriptor = descriptors[c];
+		size_t nameLength = std::min(column.name.size(), sizeof(descriptor.name) - 1);
+		std::memcpy(descriptor.name, column.name.data(), nameLength);
+		size_t byteCount = column.valueCount * getCaptureValueSize(column.type);
+		descriptor.type = column.type;
+		descriptor.channel = column.channel;
+		descriptor.valueCount = column.valueCount;
+		descriptor.dataOffset = alignUp(offset);
+		descriptor.dataChecksum = computeCaptureChecksum(getColumnData(column), byteCount);
+		offset = descriptor.dataOffset + byteCount;
+
+		// Summarize each chunk of the sample columns so that readers can skip or verify parts of the column
+		bool indexed = m_chunkSize > 0;
+		if (indexed)
+		{
+			switch (column.type)
+			{
+			case eColumnFloat64:
+				indexChunks(static_cast<const double*>(column.data), column.valueCount, chunkIndices[c]);
+				break;
+			case eColumnFloat32:
+				indexChunks(static_cast<const float*>(column.data), column.valueCount, chunkIndices[c]);
+				break;
+			case eColumnInt16:
+				indexChunks(static_cast<const std::int16_t*>(column.data), column.valueCount, chunkIndices[c]);
+				break;
+			case eColumnInt32:
+				indexChunks(static_cast<const std::int32_t*>(column.data), column.valueCount, chunkIndices[c]);
+				break;
+			default:
+				indexed = false; // Timing and compressed columns have no chunk index
+				break;
+			}
+		}
+		if (indexed)
+		{
+			descriptor.chunkIndexOffset = alignUp(offset);
+			offset = descriptor.chunkIndexOffset + chunkIndices[c].size() * sizeof(CaptureChunkIndexEntry);
+		}
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	std::uint64_t position = 0;
+	auto writeAt = [&](std::uint64_t target, const void* data, size_t size)
+	{
+		// Zero fill the alignment gap before the block
+		static const char padding[kCaptureAlignment] = {};
+		file.write(padding, (std::streamsize)(target - position));
+		file.write(static_cast<const char*>(data), (std::streamsize)size);
+		position = target + size;
+	};
+
+	writeAt(0, &header, sizeof(header));
+	writeAt(position, descriptors.data(), descriptors.size() * sizeof(CaptureColumnDescriptor));
+	for (size_t c = 0; c < m_columns.size(); c++)
+	{
+		writeAt(descriptors[c].dataOffset, getColumnData(m_columns[c]), (size_t)descriptors[c].valueCount * getCaptureValueSize(m_columns[c].type));
+		if (descriptors[c].chunkIndexOffset != 0)
+			writeAt(descriptors[c].chunkIndexOffset, chunkIndices[c].data(), chunkIndices[c].size() * sizeof(CaptureChunkIndexEntry));
+	}
+
+	file.close();
+	return !file.fail();
+}
+
+template <typename T>
+void CaptureWriter::indexChunks(const T* values, size_t count, std::vector<CaptureChunkIndexEntry>& entries) const
+{
+	double scale = m_valueScale != 0.0 ? m_valueScale : 1.0;
+	for (size_t begin = 0; begin < count; begin += m_chunkSize)
+	{
+		size_t chunkCount = std::min<size_t>(m_chunkSize, count - begin);
+		DataStatistics chunkStatistics = computeDataStatistics(values + begin, chunkCount, 1, nullptr, scale);
+		CaptureChunkIndexEntry entry = CaptureChunkIndexEntry();
+		entry.min = chunkStatistics.min;
+		entry.max = chunkStatistics.max;
+		entry.sum = chunkStatistics.sum;
+		entry.checksum = computeCaptureChecksum(values + begin, chunkCount * sizeof(T));
+		entries.push_back(entry);
+	}
+}
+
+const void* CaptureWriter::getColumnData(const PendingColumn& column)
+{
+	return column.type == eColumnCompressed ? static_cast<const void*>(column.ownedData.data()) : column.data;
+}
+
+CaptureReader::CaptureReader()
+	: m_data(nullptr),     // No file is mapped yet
+	  m_size(0),
+	  m_header(nullptr),
+	  m_columns(nullptr)
+#if defined(_WIN32)
+	  , m_fileHandle(INVALID_HANDLE_VALUE),
+	  m_mappingHandle(nullptr)
+#endif
+{
+	// Constructor body
+}
+
+CaptureReader::~CaptureReader()
+{
+	close();
+}
+
+bool CaptureReader::open(const std::string& path, bool verifyChecksums)
+{
+	close();
+	m_lastError.clear();
+
+#if defined(_WIN32)
+	m_fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_fileHandle == INVALID_HANDLE_VALUE)
+		return fail("cannot open " + path);
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(m_fileHandle, &fileSize))
+		return fail("cannot read the size of " + path);
+	m_size = (size_t)fileSize.QuadPart;
+	if (m_size < sizeof(CaptureFileHeader))
+		return fail(path + " is too small to be a capture file");
+
+	m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mappingHandle == nullptr)
+		return fail("cannot map " + path);
+	m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (m_data == nullptr)
+		return fail("cannot map " + path);
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return fail("cannot open " + path);
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0)
+	{
+		::close(fd);
+		return fail("cannot read the size of " + path);
+	}
+	m_size = (size_t)fileStat.st_size;
+	if (m_size < sizeof(CaptureFileHeader))
+	{
+		::close(fd);
+		return fail(path + " is too small to be a capture file");
+	}
+
+	void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // The mapping keeps the file alive
+	if (mapping == MAP_FAILED)
+		return fail("cannot map " + path);
+	m_data = static_cast<const unsigned char*>(mapping);
+	madvise(mapping, m_size, MADV_SEQUENTIAL); // Captures are mostly replayed front to back
+#endif
+
+	return validate(verifyChecksums);
+}
+
+void CaptureReader::close()
+{
+#if defined(_WIN32)
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+	if (m_mappingHandle != nullptr)
+		CloseHandle(m_mappingHandle);
+	if (m_fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(m_fileHandle);
+	m_mappingHandle = nullptr;
+	m_fileHandle = INVALID_HANDLE_VALUE;
+#else
+	if (m_data != nullptr)
+		munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+	m_data = nullptr;
+	m_size = 0;
+	m_header = nullptr;
+	m_columns = nullptr;
+}
+
+bool CaptureReader::isOpen() const
+{
+	return m_header != nullptr;
+}
+
+const std::string& CaptureReader::getLastError() const
+{
+	return m_lastError;
+}
+
+std::uint64_t CaptureReader::getSamplePeriod() const
+{
+	return m_header != nullptr ? m_header->samplePeriodNs : 0;
+}
+
+double CaptureReader::getValueScale() const
+{
+	return m_header != nullptr && m_header->valueScale != 0.0 ? m_header->valueScale : 1.0;
+}
+
+size_t CaptureReader::getColumnCount() const
+{
+	return m_header != nullptr ? m_header->columnCount : 0;
+}
+
+const CaptureColumnDescriptor& CaptureReader::getColumnDescriptor(size_t index) const
+{
+	return m_columns[index];
+}
+
+int CaptureReader::findColumn(const std::string& name, std::uint32_t channel) const
+{
+	for (size_t i = 0; i < getColumnCount(); i++)
+	{
+		const CaptureColumnDescriptor& descriptor = m_columns[i];
+		if (descriptor.channel == channel && name == descriptor.name)
+			return (int)i;
+	}
+	return -1;
+}
+
+std::span<const double> CaptureReader::getColumn(size_t index) const
+{
+	const CaptureColumnDescriptor& descriptor = m_columns[index];
+	if (descriptor.type != eColumnFloat64)
+		return std::span<const double>();
+
+	// The data offset is 64-byte aligned and the mapping is page aligned, so the values can be used in place
+	return std::span<const double>(reinterpret_cast<const double*>(m_data + descriptor.dataOffset), (size_t)descriptor.valueCount);
+}
+
+std::span<const std::uint64_t> CaptureReader::getUInt64Column(size_t index) const
+{
+	const CaptureColumnDescriptor& descriptor = m_columns[index];
+	if (descriptor.type != eColumnUInt64)
+		return std::span<const std::uint64_t>();
+
+	return std::span<const std::uint64_t>(reinterpret_cast<const std::uint64_t*>(m_data + descriptor.dataOffset), (size_t)descriptor.valueCount);
+}
+
+std::span<const std::uint32_t> CaptureReader::getUInt32Column(size_t index) const
+{
+	const CaptureColumnDescriptor& descriptor = m_columns[index];
+	if (descriptor.type != eColumnUInt32)
+		return std::span<const std::uint32_t>();
+
+	return std::span<const std::uint32_t>(reinterpret_cast<const std::uint32_t*>(m_data + descriptor.dataOffset), (size_t)descriptor.valueCount);
+}
+
+template <typename T>
+std::span<const T> CaptureReader::getSampleColumn(size_t index) const
+{
+	const CaptureColumnDescriptor& descriptor = m_columns[index];
+	if (descriptor.type != getCaptureColumnType<T>())
+		return std::span<const T>();
+
+	return std::span<const T>(reinterpret_cast<const T*>(m_data + descriptor.dataOffset), (size_t)descriptor.valueCount);
+}
+
+bool CaptureReader::getCompressedColumn(size_t index, CompressedSampleStore& samples) const
+{
+	const CaptureColumnDescriptor& descriptor = m_columns[index];
+	if (descriptor.type != eColumnCompressed)
+	{
+		samples.clear();
+		return false;
+	}
+
+	return samples.deserialize(std::span<const unsigned char>(m_data + descriptor.dataOffset, (size_t)descriptor.valueCount));
+}
+
+std::span<const CaptureChunkIndexEntry> CaptureReader::getChunkIndex(size_t index) const
+{
+	const CaptureColumnDescriptor& descriptor = m_columns[index];
+	if (descriptor.chunkIndexOffset == 0 || m_header->chunkSize == 0)
+		return std::span<const CaptureChunkIndexEntry>();
+
+	size_t chunkCount = (size_t)((descriptor.valueCount + m_header->chunkSize - 1) / m_header->chunkSize);
+	return std::span<const CaptureChunkIndexEntry>(reinterpret_cast<const CaptureChunkIndexEntry*>(m_data + descriptor.chunkIndexOffset), chunkCount);
+}
+
+std::uint64_t CaptureReader::getChunkSize() const
+{
+	return m_header != nullptr ? m_header->chunkSize : 0;
+}
+
+bool CaptureReader::fail(const std::string& message)
+{
+	close();
+	m_lastError = message;
+	return false;
+}
+
+bool CaptureReader::validate(bool verifyChecksums)
+{
+	const CaptureFileHeader* header = reinterpret_cast<const CaptureFileHeader*>(m_data);
+	if (std::memcmp(header->magic, kCaptureMagic, sizeof(kCaptureMagic)) != 0)
+		return fail("not a capture file");
+	if (header->version != kCaptureVersion)
+		return fail("unsupported capture file version " + std::to_string(header->version));
+	if (header->headerSize < sizeof(CaptureFileHeader) || header->headerSize > m_size)
+		return fail("corrupt capture file header");
+
+	// Every range is checked against the file size before anything points into it
+	std::uint64_t descriptorBytes = (std::uint64_t)header->columnCount * sizeof(CaptureColumnDescriptor);
+	if (descriptorBytes > m_size - header->headerSize)
+		return fail("truncated column table");
+	const CaptureColumnDescriptor* columns = reinterpret_cast<const CaptureColumnDescriptor*>(m_data + header->headerSize);
+
+	for (std::uint32_t c = 0; c < header->columnCount; c++)
+	{
+		const CaptureColumnDescriptor& descriptor = columns[c];
+		std::string columnName = "column " + std::to_string(c);
+		size_t valueSize = getCaptureValueSize(descriptor.type);
+		if (valueSize == 0)
+			return fail(columnName + " has an unknown type");
+		if (descriptor.dataOffset % kCaptureAlignment != 0 || descriptor.dataOffset > m_size
+			|| descriptor.valueCount > (m_size - descriptor.dataOffset) / valueSize)
+			return fail(columnName + " is truncated");
+
+		if (descriptor.chunkIndexOffset != 0 && header->chunkSize != 0)
+		{
+			std::uint64_t chunkCount = (descriptor.valueCount + header->chunkSize - 1) / header->chunkSize;
+			if (descriptor.chunkIndexOffset % kCaptureAlignment != 0 || descriptor.chunkIndexOffset > m_size
+				|| chunkCount > (m_size - descriptor.chunkIndexOffset) / sizeof(CaptureChunkIndexEntry))
+				return fail(columnName + " has a truncated chunk index");
+		}
+
+		if (verifyChecksums)
+		{
+			size_t byteCount = (size_t)descriptor.valueCount * valueSize;
+			if (computeCaptureChecksum(m_data + descriptor.dataOffset, byteCount) != descriptor.dataChecksum)
+				return fail(columnName + " fails its checksum");
+		}
+	}
+
+	m_header = header;
+	m_columns = columns;
+	return true;
+}
+
+// The sample types of SampleTraits
+template std::span<const double> CaptureReader::getSampleColumn<double>(size_t) const;
+template std::span<const float> CaptureReader::getSampleColumn<float>(size_t) const;
+template std::span<const std::int16_t> CaptureReader::getSampleColumn<std::int16_t>(size_t) const;
+template std::span<const std::int32_t> CaptureReader::getSampleColumn<std::int32_t>(size_t) const;
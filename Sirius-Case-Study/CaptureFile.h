@@ -0,0 +1,389 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Represents the element type of a column in a binary capture file.
+ */
+enum CaptureColumnType
+{
+	eColumnFloat64 = 0, ///< IEEE 754 double precision values.
+	eColumnUInt64,      ///< Unsigned 64-bit integers, e.g. timestamps in nanoseconds.
+	eColumnUInt32,      ///< Unsigned 32-bit integers, e.g. sequence numbers.
+	eColumnCompressed,  ///< A CompressedSampleStore serialization; the value count is its size in bytes.
+	eColumnFloat32,     ///< IEEE 754 single precision values.
+	eColumnInt16,       ///< Signed 16-bit integers, e.g. ADC counts.
+	eColumnInt32        ///< Signed 32-bit integers, e.g. ADC counts.
+};
+
+class CompressedSampleStore;
+
+/**
+ * @brief Retrieves the size of one value of a column type.
+ *
+ * @param type The CaptureColumnType.
+ * @return The size in bytes, 0 for an unknown type.
+ */
+size_t getCaptureValueSize(std::uint32_t type);
+
+/**
+ * @brief Retrieves the column type that stores a sample type.
+ *
+ * @tparam T The sample type: double, float, std::int16_t or std::int32_t.
+ * @return The CaptureColumnType of the samples.
+ */
+template <typename T>
+std::uint32_t getCaptureColumnType();
+
+/**
+ * @brief Fixed-size header at the start of a binary capture file.
+ *
+ * All integers are little-endian. The layout has no implicit padding so it can be written and
+ * mapped directly.
+ */
+struct CaptureFileHeader
+{
+	char magic[8];               ///< "SIRCAPT" followed by a zero byte.
+	std::uint32_t version;       ///< Format version, currently 1.
+	std::uint32_t headerSize;    ///< sizeof(CaptureFileHeader), lets newer readers skip unknown fields.
+	std::uint32_t columnCount;   ///< The number of column descriptors following the header.
+	std::uint32_t flags;         ///< Reserved, 0.
+	std::uint64_t samplePeriodNs;///< Nominal sample period in nanoseconds, 0 if unknown.
+	std::uint64_t chunkSize;     ///< Values per chunk index entry, 0 if the file has no chunk index.
+	double valueScale;           ///< Physical value of one count of the integer sample columns, 0 if unknown (read as 1).
+	std::uint64_t reserved[2];   ///< Reserved, 0.
+};
+
+/**
+ * @brief Describes one typed column of a binary capture file.
+ */
+struct CaptureColumnDescriptor
+{
+	char name[32];                 ///< Zero-terminated column name, e.g. "raw" or "processed".
+	std::uint32_t type;            ///< The CaptureColumnType of the values.
+	std::uint32_t channel;         ///< The sensor channel the column belongs to.
+	std::uint64_t valueCount;      ///< The number of values in the column.
+	std::uint64_t dataOffset;      ///< File offset of the first value, aligned to 64 bytes.
+	std::uint64_t dataChecksum;    ///< Fletcher-64 checksum of the column's bytes.
+	std::uint64_t chunkIndexOffset;///< File offset of the column's chunk index, 0 if there is none.
+};
+
+/**
+ * @brief Summary of one chunk of a column, stored in the optional chunk index.
+ */
+struct CaptureChunkIndexEntry
+{
+	double min;             ///< The smallest value in the chunk, in physical units.
+	double max;             ///< The largest value in the chunk, in physical units.
+	double sum;             ///< The sum of the values in the chunk, in physical units.
+	std::uint64_t checksum; ///< Fletcher-64 checksum of the chunk's bytes.
+};
+
+static_assert(sizeof(CaptureFileHeader) == 64, "CaptureFileHeader must not contain padding");
+static_assert(sizeof(CaptureColumnDescriptor) == 72, "CaptureColumnDescriptor must not contain padding");
+static_assert(sizeof(CaptureChunkIndexEntry) == 32, "CaptureChunkIndexEntry must not contain padding");
+
+/**
+ * @brief Computes the Fletcher-64 checksum of a byte range.
+ *
+ * The bytes are summed as little-endian 32-bit words (the last word zero padded).
+ *
+ * @param data Pointer to the first byte.
+ * @param size The number of bytes.
+ * @return The checksum.
+ */
+std::uint64_t computeCaptureChecksum(const void* data, size_t size);
+
+class CaptureWriter
+{
+public:
+	/**
+ * @brief Constructs a CaptureWriter object.
+ *
+ * @param chunkSize The number of values summarized by each chunk index entry (default: 65536),
+ *        or 0 to write the file without a chunk index.
+ */
+	CaptureWriter(std::uint64_t chunkSize = 65536);
+	~CaptureWriter();
+
+	/**
+ * @brief Sets the nominal sample period stored in the header.
+ *
+ * @param samplePeriodNs The sample period in nanoseconds, 0 if unknown.
+ */
+	void setSamplePeriod(std::uint64_t samplePeriodNs);
+	/**
+ * @brief Sets the physical value of one count stored in the header, for the integer sample columns.
+ *
+ * @param scale The physical value of one count, e.g. volts per count.
+ */
+	void setValueScale(double scale);
+	/**
+ * @brief Adds a double precision column to the file.
+ *
+ * The values are not copied, they must stay valid until `write` returns.
+ *
+ * @param name The column name (at most 31 characters are kept).
+ * @param values The column's values.
+ * @param channel The sensor channel the column belongs to (default: 0).
+ */
+	void addColumn(const std::string& name, std::span<const double> values, std::uint32_t channel = 0);
+	/**
+ * @brief Adds a single precision column to the file.
+ *
+ * The values are not copied, they must stay valid until `write` returns.
+ *
+ * @param name The column name (at most 31 characters are kept).
+ * @param values The column's values.
+ * @param channel The sensor channel the column belongs to (default: 0).
+ */
+	void addColumn(const std::string& name, std::span<const float> values, std::uint32_t channel = 0);
+	/**
+ * @brief Adds a column of signed 16-bit counts to the file; its chunk index is in physical units (see `setValueScale`).
+ *
+ * The values are not copied, they must stay valid until `write` returns.
+ *
+ * @param name The column name (at most 31 characters are kept).
+ * @param values The column's values.
+ * @param channel The sensor channel the column belongs to (default: 0).
+ */
+	void addColumn(const std::string& name, std::span<const std::int16_t> values, std::uint32_t channel = 0);
+	/**
+ * @brief Adds a column of signed 32-bit counts to the file; its chunk index is in physical units (see `setValueScale`).
+ *
+ * The values are not copied, they must stay valid until `write` returns.
+ *
+ * @param name The column name (at most 31 characters are kept).
+ * @param values The column's values.
+ * @param channel The sensor channel the column belongs to (default: 0).
+ */
+	void addColumn(const std::string& name, std::span<const std::int32_t> values, std::uint32_t channel = 0);
+	/**
+ * @brief Adds an unsigned 64-bit integer column to the file. Timing columns have no chunk index.
+ *
+ * The values are not copied, they must stay valid until `write` returns.
+ *
+ * @param name The column name (at most 31 characters are kept).
+ * @param values The column's values.
+ * @param channel The sensor channel the column belongs to (default: 0).
+ */
+	void addColumn(const std::string& name, std::span<const std::uint64_t> values, std::uint32_t channel = 0);
+	/**
+ * @brief Adds an unsigned 32-bit integer column to the file. Timing columns have no chunk index.
+ *
+ * The values are not copied, they must stay valid until `write` returns.
+ *
+ * @param name The column name (at most 31 characters are kept).
+ * @param values The column's values.
+ * @param channel The sensor channel the column belongs to (default: 0).
+ */
+	void addColumn(const std::string& name, std::span<const std::uint32_t> values, std::uint32_t channel = 0);
+	/**
+ * @brief Adds a compressed column to the file, with the timing of the data points if the store has any.
+ * Compressed columns have no chunk index; the store keeps the statistics of its blocks itself.
+ *
+ * The store is serialized right away, so it may change before `write` is called.
+ *
+ * @param name The column name (at most 31 characters are kept).
+ * @param samples The data points.
+ * @param channel The sensor channel the column belongs to (default: 0).
+ */
+	void addColumn(const std::string& name, const CompressedSampleStore& samples, std::uint32_t channel = 0);
+	/**
+ * @brief Writes the header, the column descriptors, the column data and the chunk index to a file.
+ *
+ * @param path The path of the file to create or overwrite.
+ * @return True if the file was written successfully.
+ */
+	bool write(const std::string& path) const;
+
+private:
+
+	struct PendingColumn
+	{
+		std::string name;              // The column name
+		std::uint32_t type;            // The CaptureColumnType of the values
+		const void* data;              // The column's values, owned by the caller unless `ownedData` holds them
+		size_t valueCount;             // The number of values
+		std::uint32_t channel;         // The sensor channel
+		std::vector<unsigned char> ownedData; // The serialization of a compressed column
+	};
+
+	std::vector<PendingColumn> m_columns; // The columns to write, in order
+	std::uint64_t m_chunkSize;            // Values per chunk index entry, 0 for no index
+	std::uint64_t m_samplePeriodNs;       // Nominal sample period stored in the header
+	double m_valueScale;                  // Physical value of one count stored in the header
+
+	/**
+ * @brief Summarizes the chunks of a sample column.
+ *
+ * @param values The column's values.
+ * @param count The number of values.
+ * @param entries Receives one entry per chunk.
+ */
+	template <typename T>
+	void indexChunks(const T* values, size_t count, std::vector<CaptureChunkIndexEntry>& entries) const;
+	/**
+ * @brief Retrieves the bytes of a column to write.
+ *
+ * @param column The column.
+ * @return The serialization the writer owns, or else the caller's values.
+ */
+	static const void* getColumnData(const PendingColumn& column);
+};
+
+class CaptureReader
+{
+public:
+	CaptureReader();
+	/**
+ * @brief Unmaps the file if one is open.
+ */
+	~CaptureReader();
+
+	CaptureReader(const CaptureReader&) = delete;
+	CaptureReader& operator=(const CaptureReader&) = delete;
+
+	/**
+ * @brief Memory-maps a binary capture file and validates its structure.
+ *
+ * The column data is not parsed or copied: `getColumn` returns views straight into the mapping,
+ * so a saved capture can be fed back into a DataProcessor at memory bandwidth.
+ *
+ * @param path The path of the file to open.
+ * @param verifyChecksums If true, every column's checksum is verified (reads the whole file).
+ * @return True if the file was mapped and is valid; otherwise `getLastError` describes the problem.
+ */
+	bool open(const std::string& path, bool verifyChecksums = true);
+	/**
+ * @brief Unmaps the file. Views returned earlier become invalid.
+ */
+	void close();
+	/**
+ * @brief Checks whether a file is currently mapped.
+ *
+ * @return True if `open` succeeded and `close` has not been called since.
+ */
+	bool isOpen() const;
+	/**
+ * @brief Retrieves the description of the last error.
+ *
+ * @return The error message of the last failed `open`.
+ */
+	const std::string& getLastError() const;
+
+	/**
+ * @brief Retrieves the nominal sample period stored in the header.
+ *
+ * @return The sample period in nanoseconds, 0 if unknown.
+ */
+	std::uint64_t getSamplePeriod() const;
+	/**
+ * @brief Retrieves the physical value of one count of the integer sample columns.
+ *
+ * @return The scale stored in the header, 1.0 if the file does not record one.
+ */
+	double getValueScale() const;
+	/**
+ * @brief Retrieves the number of columns.
+ *
+ * @return The number of columns in the file.
+ */
+	size_t getColumnCount() const;
+	/**
+ * @brief Retrieves the descriptor of a column.
+ *
+ * @param index The index of the column.
+ * @return A constant reference to the column descriptor inside the mapping.
+ */
+	const CaptureColumnDescriptor& getColumnDescriptor(size_t index) const;
+	/**
+ * @brief Looks up a column by name and channel.
+ *
+ * @param name The column name.
+ * @param channel The sensor channel (default: 0).
+ * @return The index of the column, or -1 if there is no such column.
+ */
+	int findColumn(const std::string& name, std::uint32_t channel = 0) const;
+	/**
+ * @brief Retrieves a zero-copy view of a double precision column.
+ *
+ * @param index The index of the column.
+ * @return A view into the mapped file, empty if the column is not of type eColumnFloat64.
+ */
+	std::span<const double> getColumn(size_t index) const;
+	/**
+ * @brief Retrieves a zero-copy view of an unsigned 64-bit integer column.
+ *
+ * @param index The index of the column.
+ * @return A view into the mapped file, empty if the column is not of type eColumnUInt64.
+ */
+	std::span<const std::uint64_t> getUInt64Column(size_t index) const;
+	/**
+ * @brief Retrieves a zero-copy view of a sample column stored in its native type.
+ *
+ * @tparam T The sample type: double, float, std::int16_t or std::int32_t.
+ * @param index The index of the column.
+ * @return A view into the mapped file, empty if the column is not of type `getCaptureColumnType<T>()`.
+ */
+	template <typename T>
+	std::span<const T> getSampleColumn(size_t index) const;
+	/**
+ * @brief Retrieves a zero-copy view of an unsigned 32-bit integer column.
+ *
+ * @param index The index of the column.
+ * @return A view into the mapped file, empty if the column is not of type eColumnUInt32.
+ */
+	std::span<const std::uint32_t> getUInt32Column(size_t index) const;
+	/**
+ * @brief Decodes the structure of a compressed column; the values are decoded later, block by block.
+ *
+ * @param index The index of the column.
+ * @param samples Receives the data points.
+ * @return True if the column is of type eColumnCompressed and its serialization is well formed.
+ */
+	bool getCompressedColumn(size_t index, CompressedSampleStore& samples) const;
+	/**
+ * @brief Retrieves the chunk index of a column.
+ *
+ * @param index The index of the column.
+ * @return A view of the column's chunk summaries, empty if the file or column has no chunk index.
+ */
+	std::span<const CaptureChunkIndexEntry> getChunkIndex(size_t index) const;
+	/**
+ * @brief Retrieves the number of values summarized by each chunk index entry.
+ *
+ * @return The chunk size, 0 if the file has no chunk index.
+ */
+	std::uint64_t getChunkSize() const;
+
+private:
+
+	const unsigned char* m_data;                       // Start of the mapped file
+	size_t m_size;                                     // Size of the mapped file in bytes
+	const CaptureFileHeader* m_header;                 // The header inside the mapping
+	const CaptureColumnDescriptor* m_columns;          // The column descriptors inside the mapping
+	std::string m_lastError;                           // Description of the last error
+#if defined(_WIN32)
+	void* m_fileHandle;                                // Handle of the opened file
+	void* m_mappingHandle;                             // Handle of the file mapping
+#endif
+
+	/**
+ * @brief Records an error, unmaps the file and returns false.
+ *
+ * @param message The error description.
+ * @return Always false.
+ */
+	bool fail(const std::string& message);
+	/**
+ * @brief Checks that the header, descriptors and data ranges fit inside the mapping.
+ *
+ * @param verifyChecksums If true, the column checksums are verified too.
+ * @return True if the file is valid.
+ */
+	bool validate(bool verifyChecksums);
+};
@@ -0,0 +1,87 @@
+#pragma once
+#include <cmath>
+
+/**
+ * @brief Accumulates a running sum using Neumaier (improved Kahan) compensation.
+ *
+ * The low-order bits lost by each floating point addition are collected in a separate
+ * compensation term, so the accumulated error stays bounded by a few ulps regardless of
+ * how many values are added or removed.
+ */
+class CompensatedSum
+{
+public:
+	CompensatedSum() : m_sum(0.0), m_compensation(0.0) {}
+
+	/**
+ * @brief Adds a value to the running sum. Removing a value is done by adding its negation.
+ *
+ * @param value The value to add.
+ */
+	void add(double value)
+	{
+		double t = m_sum + value;
+		if (std::fabs(m_sum) >= std::fabs(value))
+			m_compensation += (m_sum - t) + value; // Low-order bits of value were lost
+		else
+			m_compensation += (value - t) + m_sum; // Low-order bits of m_sum were lost
+		m_sum = t;
+	}
+
+	/**
+ * @brief Retrieves the compensated value of the running sum.
+ *
+ * @return The running sum including the compensation term.
+ */
+	double getValue() const { return m_sum + m_compensation; }
+
+	/**
+ * @brief Resets the running sum to zero.
+ */
+	void reset()
+	{
+		m_sum = 0.0;
+		m_compensation = 0.0;
+	}
+
+private:
+
+	double m_sum;          // The uncompensated running sum
+	double m_compensation; // The accumulated rounding error of m_sum
+};
+
+/**
+ * @brief Accumulates a plain running sum in an accumulator type, for sums that need no compensation.
+ *
+ * Integer samples are summed exactly in 64 bits. Float samples summed in double keep far more bits
+ * than the samples have. Has the interface of CompensatedSum, so kernels can take either.
+ */
+template <typename A>
+class RunningSum
+{
+public:
+	RunningSum() : m_sum(0) {}
+
+	/**
+ * @brief Adds a value to the running sum. Removing a value is done by adding its negation.
+ *
+ * @param value The value to add.
+ */
+	void add(A value) { m_sum += value; }
+
+	/**
+ * @brief Retrieves the running sum.
+ *
+ * @return The sum in the accumulator type.
+ */
+	A getValue() const { return m_sum; }
+
+	/**
+ * @brief Resets the running sum to zero.
+ */
+	void reset() { m_sum = 0; }
+
+private:
+
+	A m_sum; // The running sum
+};
@@ -0,0 +1,660 @@
+#include "CompressedSampleStore.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace
+{
+	const size_t kEstimateLength = 1024;  // Values per block used to choose the predictor
+	const size_t kLags[] = { 1, 2, 4, 8 }; // Distances of the predictor taps; interleaved signals repeat at a lag
+	const size_t kHeaderWords = 8;        // Words of the serialization header
+	const std::uint64_t kTimingFlag = 1;  // Header flag: the data points carry timing
+
+	// Copies raw bytes; an empty vector may hand out a null pointer, which memcpy must not be given
+	inline void copyBytes(void* destination, const void* source, size_t count)
+	{
+		if (count > 0)
+			std::memcpy(destination, source, count);
+	}
+
+	// Appends bits to a word stream, most significant bit first
+	class BitWriter
+	{
+	public:
+		BitWriter(std::vector<std::uint64_t>& words) : m_words(words), m_used(64) {}
+
+		// Writes the low `bits` bits of value, 1 to 64
+		void write(std::uint64_t value, unsigned bits)
+		{
+			if (bits < 64)
+				value &= ((std::uint64_t)1 << bits) - 1;
+			if (m_used == 64)
+			{
+				m_words.push_back(0);
+				m_used = 0;
+			}
+			unsigned free = 64 - m_used;
+			if (bits <= free)
+			{
+				m_words.back() |= value << (free - bits);
+				m_used += bits;
+			}
+			else
+			{
+				// Split across two words
+				m_words.back() |= value >> (bits - free);
+				m_words.push_back(value << (64 - (bits - free)));
+				m_used = bits - free;
+			}
+		}
+
+	private:
+		std::vector<std::uint64_t>& m_words; // The stream; every block starts on a new word
+		unsigned m_used;                     // Bits used in the last word
+	};
+
+	// Reads bits from a word stream; reads past its end return zero bits, so corrupt streams cannot overrun
+	class BitReader
+	{
+	public:
+		BitReader(std::span<const std::uint64_t> words, std::uint64_t wordOffset) : m_words(words), m_position(wordOffset * 64) {}
+
+		// Reads `bits` bits, 1 to 64
+		std::uint64_t read(unsigned bits)
+		{
+			size_t index = (size_t)(m_position >> 6);
+			unsigned shift = (unsigned)(m_position & 63);
+			std::uint64_t high = getWord(index) << shift;
+			if (shift + bits > 64)
+				high |= getWord(index + 1) >> (64 - shift);
+			m_position += bits;
+			return high >> (64 - bits);
+		}
+
+		bool readBit()
+		{
+			return read(1) != 0;
+		}
+
+	private:
+		std::span<const std::uint64_t> m_words; // The stream
+		std::uint64_t m_position;               // Position of the next bit
+
+		std::uint64_t getWord(size_t index) const
+		{
+			return index < m_words.size() ? m_words[index] : 0;
+		}
+	};
+
+	// The prediction of a value from two earlier ones; encoder and decoder must compute it identically
+	inline double predict(double c1, double c2, double previous, double beforePrevious)
+	{
+		double predicted = c1 * previous + c2 * beforePrevious;
+		return std::isfinite(predicted) ? predicted : previous;
+	}
+
+	// Approximate bits the XOR encoding needs with a predictor, ignoring the window headers
+	std::uint64_t estimateBits(std::span<const double> values, size_t lag, double c1, double c2)
+	{
+		std::uint64_t bits = 0;
+		size_t count = std::min(values.size(), kEstimateLength);
+		for (size_t i = 2 * lag; i < count; i++)
+		{
+			std::uint64_t difference = std::bit_cast<std::uint64_t>(values[i]) ^ std::bit_cast<std::uint64_t>(predict(c1, c2, values[i - lag], values[i - 2 * lag]));
+			bits += difference == 0 ? 1 : 2 + 64 - std::countl_zero(difference) - std::countr_zero(difference);
+		}
+		return bits;
+	}
+
+	// Zigzag maps small negative and positive differences to small unsigned numbers
+	inline std::uint64_t toZigzag(std::uint64_t difference)
+	{
+		return (difference << 1) ^ (std::uint64_t)((std::int64_t)difference >> 63);
+	}
+
+	inline std::uint64_t fromZigzag(std::uint64_t zigzag)
+	{
+		return (zigzag >> 1) ^ (0 - (zigzag & 1));
+	}
+
+	// Gorilla buckets of a delta of deltas: 1 bit for 0, otherwise a prefix and 7 to 64 bits
+	void writeDeltaOfDelta(BitWriter& writer, std::uint64_t deltaOfDelta)
+	{
+		std::uint64_t zigzag = toZigzag(deltaOfDelta);
+		if (zigzag == 0)
+			writer.write(0, 1);
+		else if (zigzag < ((std::uint64_t)1 << 7))
+		{
+			writer.write(0x2, 2);
+			writer.write(zigzag, 7);
+		}
+		else if (zigzag < ((std::uint64_t)1 << 9))
+		{
+			writer.write(0x6, 3);
+			writer.write(zigzag, 9);
+		}
+		else if (zigzag < ((std::uint64_t)1 << 12))
+		{
+			writer.write(0xE, 4);
+			writer.write(zigzag, 12);
+		}
+		else if (zigzag < ((std::uint64_t)1 << 32))
+		{
+			writer.write(0x1E, 5);
+			writer.write(zigzag, 32);
+		}
+		else
+		{
+			writer.write(0x1F, 5);
+			writer.write(zigzag, 64);
+		}
+	}
+
+	std::uint64_t readDeltaOfDelta(BitReader& reader)
+	{
+		static const unsigned kBucketBits[] = { 7, 9, 12, 32, 64 };
+		unsigned bucket = 0;
+		if (!reader.readBit())
+			return 0;
+		while (bucket < 4 && reader.readBit())
+			bucket++;
+		return fromZigzag(reader.read(kBucketBits[bucket]));
+	}
+}
+
+CompressedSampleStore::CompressedSampleStore()
+	: m_hasTiming(false) // Set by the first push
+{
+	// Constructor body
+}
+
+CompressedSampleStore::~CompressedSampleStore()
+{
+	// Destructor body
+}
+
+void CompressedSampleStore::push(const Sample& sample)
+{
+	if (empty())
+		m_hasTiming = true;
+	m_pendingValues.push_back(sample.value);
+	m_pendingTimestamps.push_back(sample.timestampNs);
+	m_pendingSequences.push_back(sample.sequence);
+	if (m_pendingValues.size() == kBlockSize)
+		sealBlock();
+}
+
+void CompressedSampleStore::append(std::span<const double> values)
+{
+	while (!values.empty())
+	{
+		size_t count = std::min(values.size(), kBlockSize - m_pendingValues.size());
+		m_pendingValues.insert(m_pendingValues.end(), values.begin(), values.begin() + count);
+		values = values.subspan(count);
+		if (m_pendingValues.size() == kBlockSize)
+			sealBlock();
+	}
+}
+
+void CompressedSampleStore::assign(const SampleBuffer& samples)
+{
+	clear();
+	std::span<const double> values = samples.getValues();
+	if (!samples.hasTiming())
+	{
+		append(values);
+		return;
+	}
+
+	// Encode whole blocks straight from the buffer's columns
+	m_hasTiming = true;
+	std::span<const std::uint64_t> timestamps = samples.getTimestamps();
+	std::span<const std::uint32_t> sequences = samples.getSequences();
+	size_t begin = 0;
+	for (; begin + kBlockSize <= values.size(); begin += kBlockSize)
+		m_blocks.push_back(encodeBlock(values.subspan(begin, kBlockSize), timestamps.subspan(begin, kBlockSize),
+			sequences.subspan(begin, kBlockSize), m_valueWords, m_timingWords));
+	m_pendingValues.assign(values.begin() + begin, values.end());
+	m_pendingTimestamps.assign(timestamps.begin() + begin, timestamps.end());
+	m_pendingSequences.assign(sequences.begin() + begin, sequences.end());
+}
+
+template <typename T>
+void CompressedSampleStore::assign(const BasicSampleBuffer<T>& samples, double scale)
+{
+	clear();
+	std::span<const T> counts = samples.getValues();
+	std::span<const std::uint64_t> timestamps = samples.getTimestamps();
+	std::span<const std::uint32_t> sequences = samples.getSequences();
+	m_hasTiming = samples.hasTiming();
+
+	// Convert one block at a time into a buffer that stays in cache
+	std::vector<double> values(kBlockSize);
+	size_t begin = 0;
+	for (; begin + kBlockSize <= counts.size(); begin += kBlockSize)
+	{
+		for (size_t i = 0; i < kBlockSize; i++)
+			values[i] = SampleTraits<T>::toValue((double)counts[begin + i], scale);
+		m_blocks.push_back(encodeBlock(values, m_hasTiming ? timestamps.subspan(begin, kBlockSize) : std::span<const std::uint64_t>(),
+			m_hasTiming ? sequences.subspan(begin, kBlockSize) : std::span<const std::uint32_t>(), m_valueWords, m_timingWords));
+	}
+	for (size_t i = begin; i < counts.size(); i++)
+		m_pendingValues.push_back(SampleTraits<T>::toValue((double)counts[i], scale));
+	if (m_hasTiming)
+	{
+		m_pendingTimestamps.assign(timestamps.begin() + begin, timestamps.end());
+		m_pendingSequences.assign(sequences.begin() + begin, sequences.end());
+	}
+}
+
+void CompressedSampleStore::clear()
+{
+	m_blocks.clear();
+	m_valueWords.clear();
+	m_timingWords.clear();
+	m_pendingValues.clear();
+	m_pendingTimestamps.clear();
+	m_pendingSequences.clear();
+	m_hasTiming = false;
+}
+
+size_t CompressedSampleStore::size() const
+{
+	return m_blocks.size() * kBlockSize + m_pendingValues.size();
+}
+
+bool CompressedSampleStore::empty() const
+{
+	return m_blocks.empty() && m_pendingValues.empty();
+}
+
+bool CompressedSampleStore::hasTiming() const
+{
+	return m_hasTiming && !empty();
+}
+
+size_t CompressedSampleStore::getCompressedBytes() const
+{
+	return m_blocks.size() * sizeof(Block) + (m_valueWords.size() + m_timingWords.size()) * sizeof(std::uint64_t)
+		+ m_pendingValues.size() * sizeof(double) + m_pendingTimestamps.size() * sizeof(std::uint64_t)
+		+ m_pendingSequences.size() * sizeof(std::uint32_t);
+}
+
+size_t CompressedSampleStore::getBlockCount() const
+{
+	return m_blocks.size() + (m_pendingValues.empty() ? 0 : 1);
+}
+
+size_t CompressedSampleStore::getBlockLength(size_t block) const
+{
+	return block < m_blocks.size() ? kBlockSize : m_pendingValues.size();
+}
+
+DataStatistics CompressedSampleStore::getBlockStatistics(size_t block) const
+{
+	Block summary = block < m_blocks.size() ? m_blocks[block] : summarize(m_pendingValues);
+	return DataStatistics{ (size_t)summary.count, summary.sum, summary.min, summary.max };
+}
+
+DataStatistics CompressedSampleStore::getStatistics() const
+{
+	DataStatistics statistics = DataStatistics();
+	for (size_t block = 0; block < getBlockCount(); block++)
+	{
+		DataStatistics blockStatistics = getBlockStatistics(block);
+		statistics.min = block == 0 ? blockStatistics.min : std::min(statistics.min, blockStatistics.min);
+		statistics.max = block == 0 ? blockStatistics.max : std::max(statistics.max, blockStatistics.max);
+		statistics.sum += blockStatistics.sum;
+		statistics.count += blockStatistics.count;
+	}
+	return statistics;
+}
+
+void CompressedSampleStore::decodeBlock(size_t block, std::span<double> values) const
+{
+	if (block >= m_blocks.size())
+	{
+		std::copy(m_pendingValues.begin(), m_pendingValues.end(), values.begin());
+		return;
+	}
+
+	const Block& summary = m_blocks[block];
+	size_t count = (size_t)summary.count;
+	size_t lag = (size_t)summary.lag;
+	BitReader reader(m_valueWords, summary.valueOffset);
+	double* output = values.data();
+	output[0] = std::bit_cast<double>(reader.read(64));
+
+	// The position of the differing bits stays until a value announces a new one
+	unsigned leading = 0;
+	unsigned trailing = 0;
+	for (size_t i = 1; i < count; i++)
+	{
+		double predicted = i >= 2 * lag ? predict(summary.c1, summary.c2, output[i - lag], output[i - 2 * lag]) : output[i - 1];
+		std::uint64_t difference = 0;
+		if (reader.readBit())
+		{
+			if (reader.readBit())
+			{
+				leading = (unsigned)reader.read(6);
+				unsigned length = (unsigned)reader.read(6) + 1;
+				length = std::min(length, 64 - leading); // Only a corrupt stream exceeds 64 bits
+				trailing = 64 - leading - length;
+			}
+			difference = reader.read(64 - leading - trailing) << trailing;
+		}
+		output[i] = std::bit_cast<double>(std::bit_cast<std::uint64_t>(predicted) ^ difference);
+	}
+}
+
+void CompressedSampleStore::decodeBlockTiming(size_t block, std::span<std::uint64_t> timestamps, std::span<std::uint32_t> sequences) const
+{
+	if (block >= m_blocks.size())
+	{
+		std::copy(m_pendingTimestamps.begin(), m_pendingTimestamps.end(), timestamps.begin());
+		std::copy(m_pendingSequences.begin(), m_pendingSequences.end(), sequences.begin());
+		return;
+	}
+
+	const Block& summary = m_blocks[block];
+	BitReader reader(m_timingWords, summary.timingOffset);
+	timestamps[0] = reader.read(64);
+	sequences[0] = (std::uint32_t)reader.read(32);
+	std::uint64_t timestampDelta = 0;
+	std::uint64_t sequenceDelta = 0;
+	for (size_t i = 1; i < (size_t)summary.count; i++)
+	{
+		// Unsigned arithmetic wraps like the encoder's
+		timestampDelta += readDeltaOfDelta(reader);
+		sequenceDelta += readDeltaOfDelta(reader);
+		timestamps[i] = timestamps[i - 1] + timestampDelta;
+		sequences[i] = sequences[i - 1] + (std::uint32_t)sequenceDelta;
+	}
+}
+
+void CompressedSampleStore::decode(SampleBuffer& samples) const
+{
+	samples.clear();
+	samples.reserve(size());
+
+	// Decode into buffers that stay in cache, then append the block
+	bool timing = hasTiming();
+	std::vector<double> values(kBlockSize);
+	std::vector<std::uint64_t> timestamps(timing ? kBlockSize : 0);
+	std::vector<std::uint32_t> sequences(timing ? kBlockSize : 0);
+	for (size_t block = 0; block < getBlockCount(); block++)
+	{
+		size_t count = getBlockLength(block);
+		decodeBlock(block, values);
+		if (timing)
+		{
+			decodeBlockTiming(block, timestamps, sequences);
+			samples.append(std::span<const double>(values.data(), count), std::span<const std::uint64_t>(timestamps.data(), count),
+				std::span<const std::uint32_t>(sequences.data(), count));
+		}
+		else
+		{
+			samples.append(std::span<const double>(values.data(), count), std::span<const std::uint64_t>(), std::span<const std::uint32_t>());
+		}
+	}
+}
+
+template <typename T>
+void CompressedSampleStore::decode(BasicSampleBuffer<T>& samples, double scale) const
+{
+	samples.clear();
+	samples.reserve(size());
+
+	// Decode and quantize into buffers that stay in cache, then append the block
+	bool timing = hasTiming();
+	std::vector<double> values(kBlockSize);
+	std::vector<T> counts(kBlockSize);
+	std::vector<std::uint64_t> timestamps(timing ? kBlockSize : 0);
+	std::vector<std::uint32_t> sequences(timing ? kBlockSize : 0);
+	for (size_t block = 0; block < getBlockCount(); block++)
+	{
+		size_t count = getBlockLength(block);
+		decodeBlock(block, values);
+		for (size_t i = 0; i < count; i++)
+			counts[i] = SampleTraits<T>::quantize(values[i], scale);
+		if (timing)
+			decodeBlockTiming(block, timestamps, sequences);
+		samples.append(std::span<const T>(counts.data(), count), std::span<const std::uint64_t>(timestamps.data(), timing ? count : 0),
+			std::span<const std::uint32_t>(sequences.data(), timing ? count : 0));
+	}
+}
+
+void CompressedSampleStore::serialize(std::vector<unsigned char>& bytes) const
+{
+	// The block being filled is encoded too, into copies of the streams
+	std::vector<Block> blocks = m_blocks;
+	std::vector<std::uint64_t> valueWords = m_valueWords;
+	std::vector<std::uint64_t> timingWords = m_timingWords;
+	if (!m_pendingValues.empty())
+		blocks.push_back(encodeBlock(m_pendingValues, m_pendingTimestamps, m_pendingSequences, valueWords, timingWords));
+
+	std::uint64_t header[kHeaderWords] = {};
+	size_t byteCount = sizeof(header) + blocks.size() * sizeof(Block) + (valueWords.size() + timingWords.size()) * sizeof(std::uint64_t);
+	header[0] = byteCount;
+	header[1] = size();
+	header[2] = hasTiming() ? kTimingFlag : 0;
+	header[3] = kBlockSize;
+	header[4] = blocks.size();
+	header[5] = valueWords.size();
+	header[6] = timingWords.size();
+
+	bytes.resize(byteCount);
+	unsigned char* output = bytes.data();
+	copyBytes(output, header, sizeof(header));
+	output += sizeof(header);
+	copyBytes(output, blocks.data(), blocks.size() * sizeof(Block));
+	output += blocks.size() * sizeof(Block);
+	copyBytes(output, valueWords.data(), valueWords.size() * sizeof(std::uint64_t));
+	output += valueWords.size() * sizeof(std::uint64_t);
+	copyBytes(output, timingWords.data(), timingWords.size() * sizeof(std::uint64_t));
+}
+
+bool CompressedSampleStore::deserialize(std::span<const unsigned char> bytes)
+{
+	clear();
+	std::uint64_t header[kHeaderWords];
+	if (bytes.size() < sizeof(header))
+		return false;
+	copyBytes(header, bytes.data(), sizeof(header));
+
+	// Every count is checked against the size before anything is copied
+	std::uint64_t sampleCount = header[1];
+	std::uint64_t blockCount = header[4];
+	std::uint64_t valueWordCount = header[5];
+	std::uint64_t timingWordCount = header[6];
+	std::uint64_t available = (bytes.size() - sizeof(header)) / sizeof(std::uint64_t);
+	if (header[0] != bytes.size() || header[3] != kBlockSize || blockCount > available / (sizeof(Block) / sizeof(std::uint64_t))
+		|| valueWordCount > available || timingWordCount > available
+		|| blockCount * (sizeof(Block) / sizeof(std::uint64_t)) + valueWordCount + timingWordCount != available
+		|| sampleCount != (blockCount == 0 ? 0 : (blockCount - 1) * kBlockSize + ((sampleCount - 1) % kBlockSize + 1)))
+		return false;
+
+	const unsigned char* input = bytes.data() + sizeof(header);
+	m_blocks.resize((size_t)blockCount);
+	copyBytes(m_blocks.data(), input, m_blocks.size() * sizeof(Block));
+	input += m_blocks.size() * sizeof(Block);
+	m_valueWords.resize((size_t)valueWordCount);
+	copyBytes(m_valueWords.data(), input, m_valueWords.size() * sizeof(std::uint64_t));
+	input += m_valueWords.size() * sizeof(std::uint64_t);
+	m_timingWords.resize((size_t)timingWordCount);
+	copyBytes(m_timingWords.data(), input, m_timingWords.size() * sizeof(std::uint64_t));
+	m_hasTiming = (header[2] & kTimingFlag) != 0;
+
+	// Every block but the last is full, and the streams are read from increasing offsets
+	for (size_t block = 0; block < m_blocks.size(); block++)
+	{
+		const Block& summary = m_blocks[block];
+		bool last = block + 1 == m_blocks.size();
+		if ((last ? summary.count != sampleCount - block * kBlockSize : summary.count != kBlockSize) || summary.count == 0 || summary.lag < 1 || summary.lag > kLags[std::size(kLags) - 1]
+			|| summary.valueOffset >= valueWordCount || (m_hasTiming && summary.timingOffset >= timingWordCount)
+			|| (block > 0 && (summary.valueOffset <= m_blocks[block - 1].valueOffset
+				|| (m_hasTiming && summary.timingOffset <= m_blocks[block - 1].timingOffset))))
+		{
+			clear();
+			return false;
+		}
+	}
+
+	// A partial last block becomes the block being filled again, so data points can be appended
+	if (!m_blocks.empty() && m_blocks.back().count < kBlockSize)
+	{
+		size_t last = m_blocks.size() - 1;
+		size_t count = (size_t)m_blocks.back().count;
+		m_pendingValues.resize(count);
+		decodeBlock(last, m_pendingValues);
+		if (m_hasTiming)
+		{
+			m_pendingTimestamps.resize(count);
+			m_pendingSequences.resize(count);
+			decodeBlockTiming(last, m_pendingTimestamps, m_pendingSequences);
+		}
+		m_valueWords.resize((size_t)m_blocks.back().valueOffset);
+		if (m_hasTiming)
+			m_timingWords.resize((size_t)m_blocks.back().timingOffset);
+		m_blocks.pop_back();
+	}
+	return true;
+}
+
+void CompressedSampleStore::sealBlock()
+{
+	m_blocks.push_back(encodeBlock(m_pendingValues, m_pendingTimestamps, m_pendingSequences, m_valueWords, m_timingWords));
+	m_pendingValues.clear();
+	m_pendingTimestamps.clear();
+	m_pendingSequences.clear();
+}
+
+CompressedSampleStore::Block CompressedSampleStore::encodeBlock(std::span<const double> values, std::span<const std::uint64_t> timestamps,
+	std::span<const std::uint32_t> sequences, std::vector<std::uint64_t>& valueWords, std::vector<std::uint64_t>& timingWords)
+{
+	Block block = summarize(values);
+	block.valueOffset = valueWords.size();
+	block.timingOffset = timingWords.size();
+	size_t count = values.size();
+
+	// Candidate predictors: the previous value (plain Gorilla), and per lag a straight line, a sinusoid
+	// and a least-squares fit; the one the first values of the block encode in the fewest bits wins
+	block.lag = 1;
+	block.c1 = 1.0;
+	block.c2 = 0.0;
+	std::uint64_t bestBits = estimateBits(values, 1, 1.0, 0.0);
+	size_t estimateCount = std::min(count, kEstimateLength);
+	for (size_t lag : kLags)
+	{
+		double s11 = 0.0, s12 = 0.0, s22 = 0.0, t1 = 0.0, t2 = 0.0, sinusoid = 0.0;
+		for (size_t i = 2 * lag; i < estimateCount; i++)
+		{
+			double a = values[i - lag], b = values[i - 2 * lag], x = values[i];
+			s11 += a * a;
+			s12 += a * b;
+			s22 += b * b;
+			t1 += x * a;
+			t2 += x * b;
+			sinusoid += (x + b) * a;
+		}
+
+		// A sinusoid of any frequency follows x[n] = 2 cos(w lag) x[n-lag] - x[n-2 lag]; fitting only the first weight keeps the second exact
+		double candidates[3][2] = { { 2.0, -1.0 }, { sinusoid / s11, -1.0 },
+			{ (t1 * s22 - t2 * s12) / (s11 * s22 - s12 * s12), (t2 * s11 - t1 * s12) / (s11 * s22 - s12 * s12) } };
+		for (const double* candidate : candidates)
+		{
+			if (!std::isfinite(candidate[0]) || !std::isfinite(candidate[1]))
+				continue;
+			std::uint64_t bits = estimateBits(values, lag, candidate[0], candidate[1]);
+			if (bits < bestBits)
+			{
+				bestBits = bits;
+				block.lag = (std::uint32_t)lag;
+				block.c1 = candidate[0];
+				block.c2 = candidate[1];
+			}
+		}
+	}
+
+	// Values: the first one as it is, then '0' for an exact prediction, '10' + the bits within the
+	// previous window, or '11' + 6 bits of leading zeros + 6 bits of length - 1 + the bits
+	BitWriter valueWriter(valueWords);
+	valueWriter.write(std::bit_cast<std::uint64_t>(values[0]), 64);
+	unsigned windowLeading = 0;
+	unsigned windowTrailing = 0;
+	bool windowValid = false;
+	for (size_t i = 1; i < count; i++)
+	{
+		double predicted = i >= 2 * block.lag ? predict(block.c1, block.c2, values[i - block.lag], values[i - 2 * block.lag]) : values[i - 1];
+		std::uint64_t difference = std::bit_cast<std::uint64_t>(values[i]) ^ std::bit_cast<std::uint64_t>(predicted);
+		if (difference == 0)
+		{
+			valueWriter.write(0, 1);
+			continue;
+		}
+
+		unsigned leading = (unsigned)std::countl_zero(difference);
+		unsigned trailing = (unsigned)std::countr_zero(difference);
+		unsigned length = 64 - leading - trailing;
+		unsigned windowLength = 64 - windowLeading - windowTrailing;
+		// Reuse the window unless a new one saves more than its 12-bit header
+		if (windowValid && leading >= windowLeading && trailing >= windowTrailing && windowLength <= length + 12)
+		{
+			valueWriter.write(0x2, 2);
+			valueWriter.write(difference >> windowTrailing, windowLength);
+		}
+		else
+		{
+			valueWriter.write(0x3, 2);
+			valueWriter.write(leading, 6);
+			valueWriter.write(length - 1, 6);
+			valueWriter.write(difference >> trailing, length);
+			windowLeading = leading;
+			windowTrailing = trailing;
+			windowValid = true;
+		}
+	}
+
+	// Timing: the first timestamp and sequence number as they are, then the change of each delta
+	if (!timestamps.empty())
+	{
+		BitWriter timingWriter(timingWords);
+		timingWriter.write(timestamps[0], 64);
+		timingWriter.write(sequences[0], 32);
+		std::uint64_t timestampDelta = 0;
+		std::uint64_t sequenceDelta = 0;
+		for (size_t i = 1; i < count; i++)
+		{
+			// Unsigned differences wrap, so any timestamps round-trip; sequence steps are signed 32-bit
+			std::uint64_t nextTimestampDelta = timestamps[i] - timestamps[i - 1];
+			std::uint64_t nextSequenceDelta = (std::uint64_t)(std::int64_t)(std::int32_t)(sequences[i] - sequences[i - 1]);
+			writeDeltaOfDelta(timingWriter, nextTimestampDelta - timestampDelta);
+			writeDeltaOfDelta(timingWriter, nextSequenceDelta - sequenceDelta);
+			timestampDelta = nextTimestampDelta;
+			sequenceDelta = nextSequenceDelta;
+		}
+	}
+	return block;
+}
+
+CompressedSampleStore::Block CompressedSampleStore::summarize(std::span<const double> values)
+{
+	Block block = Block();
+	DataStatistics statistics = computeDataStatistics(values.data(), values.size(), 1, nullptr);
+	block.count = (std::uint32_t)values.size();
+	block.lag = 1;
+	block.min = statistics.min;
+	block.max = statistics.max;
+	block.sum = statistics.sum;
+	return block;
+}
+
+// The compact sample types of SampleTraits; double samples use the overloads without a scale
+template void CompressedSampleStore::assign<float>(const BasicSampleBuffer<float>&, double);
+template void CompressedSampleStore::assign<std::int16_t>(const BasicSampleBuffer<std::int16_t>&, double);
+template void CompressedSampleStore::assign<std::int32_t>(const BasicSampleBuffer<std::int32_t>&, double);
+template void CompressedSampleStore::decode<float>(BasicSampleBuffer<float>&, double) const;
+template void CompressedSampleStore::decode<std::int16_t>(BasicSampleBuffer<std::int16_t>&, double) const;
+template void CompressedSampleStore::decode<std::int32_t>(BasicSampleBuffer<std::int32_t>&, double) const;
@@ -0,0 +1,225 @@
+#pragma once
+#include "SampleBuffer.h"
+#include "SampleTraits.h"
+#include "StatisticsKernel.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Stores timestamped data points compressed in independently decodable blocks.
+ *
+ * Data points are collected into blocks of `kBlockSize`. A full block is encoded into two bit streams:
+ * - **Values**: Gorilla-style XOR encoding. Each value is XORed with a prediction, and only the bits
+ *   that differ are stored: one bit if the prediction is exact, otherwise the position and length of
+ *   the differing bits (or a reuse of the previous position) followed by the bits themselves. Plain
+ *   Gorilla predicts the previous value; here each block picks the cheapest two-tap predictor
+ *   `c1 * x[n-lag] + c2 * x[n-2 lag]` among the previous value and, for lags 1, 2, 4 and 8, a straight
+ *   line, a sinusoid fitted to the block and a least-squares fit. A straight line predicts LINEAR data
+ *   and the recurrence `2 cos(w lag) x[n-lag] - x[n-2 lag]` predicts SINE data, whose interleaved
+ *   generator lanes round differently, to within a few ulps, so both take a few bits per value.
+ * - **Timing**: delta-of-delta encoding of the timestamps and sequence numbers. A regular clock or
+ *   an incrementing sequence costs one bit per data point; jitter costs 9 to 69 bits.
+ *
+ * Every block also keeps the minimum, maximum and sum of its values, so statistics of whole blocks
+ * are available without decoding them. The block being filled stays uncompressed until it is full.
+ * Decoding is block at a time into caller-provided buffers that stay in cache, e.g. straight into
+ * a `DataProcessor` (see `DataProcessor::setRawData(const CompressedSampleStore&)`).
+ *
+ * Values are reproduced bit-exactly, including NaNs and signed zeros. Encoder and decoder compute
+ * the predictions with the same IEEE operations, so the encoding does not depend on the build.
+ * Samples of the other types of SampleTraits are stored as their physical values and quantized
+ * again when decoded, which gives back the same counts.
+ */
+class CompressedSampleStore
+{
+public:
+	static const size_t kBlockSize = 4096; ///< Data points per block.
+
+	CompressedSampleStore();
+	~CompressedSampleStore();
+
+	/**
+ * @brief Appends a data point with its timing.
+ *
+ * Appending to a store that holds values without timing is not allowed.
+ *
+ * @param sample The data point.
+ */
+	void push(const Sample& sample);
+	/**
+ * @brief Appends values without timing.
+ *
+ * Appending to a store that holds data points with timing is not allowed.
+ *
+ * @param values The values.
+ */
+	void append(std::span<const double> values);
+	/**
+ * @brief Replaces the contents with the data points of a buffer, with their timing if it has any.
+ *
+ * @param samples The data points.
+ */
+	void assign(const SampleBuffer& samples);
+	/**
+ * @brief Replaces the contents with the physical values of a buffer of another sample type, with their timing if it has any.
+ *
+ * @param samples The data points.
+ * @param scale The physical value of one count of integer samples.
+ */
+	template <typename T>
+	void assign(const BasicSampleBuffer<T>& samples, double scale);
+	/**
+ * @brief Removes all data points, keeping the storage.
+ */
+	void clear();
+
+	/**
+ * @brief Retrieves the number of data points.
+ *
+ * @return The number of stored data points.
+ */
+	size_t size() const;
+	/**
+ * @brief Checks whether the store holds no data points.
+ *
+ * @return True if there are no data points.
+ */
+	bool empty() const;
+	/**
+ * @brief Checks whether the data points carry timestamps and sequence numbers.
+ *
+ * @return True if the store is non-empty and was filled with `push`.
+ */
+	bool hasTiming() const;
+	/**
+ * @brief Retrieves the memory the encoded data points take.
+ *
+ * @return The bytes of the encoded blocks and their summaries plus the uncompressed block being filled.
+ */
+	size_t getCompressedBytes() const;
+
+	/**
+ * @brief Retrieves the number of blocks, including the partially filled last block.
+ *
+ * @return The number of blocks.
+ */
+	size_t getBlockCount() const;
+	/**
+ * @brief Retrieves the number of data points in a block.
+ *
+ * @param block The index of the block.
+ * @return `kBlockSize` for every block but the last.
+ */
+	size_t getBlockLength(size_t block) const;
+	/**
+ * @brief Retrieves the statistics of a block without decoding it.
+ *
+ * @param block The index of the block.
+ * @return The count, sum, minimum and maximum of the block's values.
+ */
+	DataStatistics getBlockStatistics(size_t block) const;
+	/**
+ * @brief Retrieves the statistics of all values from the block summaries, without decoding anything.
+ *
+ * @return The count, sum, minimum and maximum of the values.
+ */
+	DataStatistics getStatistics() const;
+	/**
+ * @brief Decodes the values of one block.
+ *
+ * @param block The index of the block.
+ * @param values Receives the values, at least `getBlockLength(block)` long.
+ */
+	void decodeBlock(size_t block, std::span<double> values) const;
+	/**
+ * @brief Decodes the timing of one block of a store with timing.
+ *
+ * @param block The index of the block.
+ * @param timestamps Receives the timestamps, at least `getBlockLength(block)` long.
+ * @param sequences Receives the sequence numbers, at least `getBlockLength(block)` long.
+ */
+	void decodeBlockTiming(size_t block, std::span<std::uint64_t> timestamps, std::span<std::uint32_t> sequences) const;
+	/**
+ * @brief Decodes every data point into a buffer, block by block.
+ *
+ * @param samples Receives the data points with their timing if the store has any; its previous
+ *        contents are discarded and its storage is reused.
+ */
+	void decode(SampleBuffer& samples) const;
+	/**
+ * @brief Decodes every data point into a buffer of another sample type, block by block.
+ *
+ * @param samples Receives the quantized data points with their timing if the store has any; its
+ *        previous contents are discarded and its storage is reused.
+ * @param scale The physical value of one count of integer samples.
+ */
+	template <typename T>
+	void decode(BasicSampleBuffer<T>& samples, double scale) const;
+
+	/**
+ * @brief Writes the store in its compressed form, e.g. into a capture file column.
+ *
+ * The layout is a header of eight little-endian 64-bit words (the byte size of the whole
+ * serialization first), the block summaries, the value words and the timing words.
+ *
+ * @param bytes Receives the serialization; its previous contents are discarded.
+ */
+	void serialize(std::vector<unsigned char>& bytes) const;
+	/**
+ * @brief Replaces the contents with a serialization written by `serialize`.
+ *
+ * @param bytes The serialization.
+ * @return True if the serialization is well formed; otherwise the store is left empty.
+ */
+	bool deserialize(std::span<const unsigned char> bytes);
+
+private:
+
+	// Summary and location of one encoded block; eight words without padding, so blocks serialize as they are
+	struct Block
+	{
+		std::uint64_t valueOffset;  // Index of the block's first word in m_valueWords
+		std::uint64_t timingOffset; // Index of the block's first word in m_timingWords
+		std::uint32_t count;        // The number of data points in the block
+		std::uint32_t lag;          // Distance of the predictor taps: x[n] is predicted from x[n-lag] and x[n-2 lag]
+		double c1;                  // Weight of x[n-lag] in the prediction
+		double c2;                  // Weight of x[n-2 lag] in the prediction
+		double min;                 // The smallest value of the block
+		double max;                 // The largest value of the block
+		double sum;                 // The sum of the values of the block
+	};
+
+	std::vector<Block> m_blocks;                    // The encoded blocks, all full
+	std::vector<std::uint64_t> m_valueWords;        // The value bit streams of the encoded blocks
+	std::vector<std::uint64_t> m_timingWords;       // The timing bit streams of the encoded blocks
+	std::vector<double> m_pendingValues;            // The values of the block being filled
+	std::vector<std::uint64_t> m_pendingTimestamps; // The timestamps of the block being filled
+	std::vector<std::uint32_t> m_pendingSequences;  // The sequence numbers of the block being filled
+	bool m_hasTiming;                               // Set by the first push
+
+	/**
+ * @brief Encodes the block being filled into the bit streams and starts a new one.
+ */
+	void sealBlock();
+	/**
+ * @brief Encodes one block of data points.
+ *
+ * @param values The values of the block.
+ * @param timestamps The timestamps of the block, empty without timing.
+ * @param sequences The sequence numbers of the block, empty without timing.
+ * @param valueWords Receives the value bit stream.
+ * @param timingWords Receives the timing bit stream.
+ * @return The summary and location of the block.
+ */
+	static Block encodeBlock(std::span<const double> values, std::span<const std::uint64_t> timestamps,
+		std::span<const std::uint32_t> sequences, std::vector<std::uint64_t>& valueWords, std::vector<std::uint64_t>& timingWords);
+	/**
+ * @brief Computes the summary of a block, also used for the block being filled.
+ *
+ * @param values The values of the block.
+ * @return The summary with the location fields zeroed.
+ */
+	static Block summarize(std::span<const double> values);
+};
@@ -1,184 +1,752 @@
 #include "DataProcessor.h"
+#include "SlidingWindowSum.h"
+#include "SimdKernels.h"
 #include <algorithm>
+#include <array>
 #include <numeric>
 #include <iostream>
+#include <type_traits>
 
-DataProcessor::DataProcessor(int movingAverageWindowSize, int subsetSize)
+template <typename T>
+BasicDataProcessor<T>::BasicDataProcessor(int movingAverageWindowSize, int subsetSize, double scale)
 	:m_windowSize(movingAverageWindowSize),  // Set the moving average window size
 	 m_subsetSize(subsetSize),               // Set the subset size for averaging
+	 m_scale(std::is_floating_point_v<T> ? 1.0 : scale), // Floating point samples are physical values already
 	 m_rawAverage(0.0),                      // Initialize raw average to 0
-	 m_processedAverage(0.0)                 // Initialize processed average to 0
+	 m_processedAverage(0.0),                // Initialize processed average to 0
+	 m_rawSummary(),                         // No statistics have been calculated yet
+	 m_processedSummary(),
+	 m_streamWindow(movingAverageWindowSize), // Moving average window for streamed samples
+	 m_rawSubsetSum(0),                      // No subset is being filled yet
+	 m_processedSubsetSum(0),
+	 m_rawSubsetCount(0),
+	 m_processedSubsetCount(0)
 {
 	// Constructor body
 }
 
-DataProcessor::~DataProcessor()
+template <typename T>
+BasicDataProcessor<T>::~BasicDataProcessor()
 {
-	// Destructor body
+	// Hand the buffers back for the next processor
+	if (m_workspace != nullptr)
+	{
+		m_workspace->release(std::move(m_rawData));
+		m_workspace->release(std::move(m_processedData));
+		m_workspace->release(std::move(m_rawSubsetAverageData));
+		m_workspace->release(std::move(m_processedSubsetAverageData));
+	}
 }
 
-std::vector<double> DataProcessor::getRawData() const
+template <typename T>
+double BasicDataProcessor<T>::getScale() const
 {
-	// Return the raw data stored in m_rawData
+	return m_scale;
+}
+
+template <typename T>
+void BasicDataProcessor<T>::setScale(double scale)
+{
+	m_scale = std::is_floating_point_v<T> ? 1.0 : scale;
+}
+
+template <typename T>
+std::span<const T> BasicDataProcessor<T>::getRawData() const
+{
+	// Return the values of the raw data stored in m_rawData
+	return m_rawData.getValues();
+}
+
+template <typename T>
+const BasicSampleBuffer<T>& BasicDataProcessor<T>::getRawSamples() const
+{
+	// Return the raw data points together with their timestamps and sequence numbers
 	return m_rawData;
 }
 
-std::vector<double> DataProcessor::getProcessedData() const
+template <typename T>
+std::span<const T> BasicDataProcessor<T>::getProcessedData() const
 {
 	// Return the processed data stored in m_processedData
 	return m_processedData;
 }
 
-std::vector<double> DataProcessor::getRawSubsetAverageData() const
+template <typename T>
+std::span<const double> BasicDataProcessor<T>::getRawSubsetAverageData() const
 {
 	// Return the raw subset averages stored in m_rawSubsetAverageData
 	return m_rawSubsetAverageData;
 }
 
-std::vector<double> DataProcessor::getProcessedSubsetAverageData() const
+template <typename T>
+std::span<const double> BasicDataProcessor<T>::getProcessedSubsetAverageData() const
 {
 	// Return the processed subset averages stored in m_processedSubsetAverageData
 	return m_processedSubsetAverageData;
 }
 
-std::vector<double> DataProcessor::calculateSubsetAverage(const std::vector<double>& vec) const
+template <typename T>
+std::vector<double> BasicDataProcessor<T>::calculateSubsetAverage(std::span<const T> vec) const
+{
+	std::vector<double> subsetAverages; // One average per subset, empty for an empty vector
+	computeStatistics(vec, &subsetAverages);
+	return subsetAverages;
+}
+
+template <typename T>
+double BasicDataProcessor<T>::getRawDataMin() const
+{
+	// Return the cached minimum value of the raw data
+	return m_rawSummary.min;
+}
+
+template <typename T>
+double BasicDataProcessor<T>::getRawDataMax() const
+{
+	// Return the cached maximum value of the raw data
+	return m_rawSummary.max;
+}
+
+template <typename T>
+double BasicDataProcessor<T>::getProcessedDataMin() const
+{
+	// Return the cached minimum value of the processed data
+	return m_processedSummary.min;
+}
+
+template <typename T>
+double BasicDataProcessor<T>::getProcessedDataMax() const
+{
+	// Return the cached maximum value of the processed data
+	return m_processedSummary.max;
+}
+
+template <typename T>
+double BasicDataProcessor<T>::getRawAverage() const
 {
-	double dScale = 1.0 / (double)m_subsetSize; // Scaling factor to calculate the average of each subset
+	// Return the average of the raw data stored in m_rawAverage
+	return m_rawAverage;
+}
 
+template <typename T>
+double BasicDataProcessor<T>::getProcessedAverage() const
+{
+	// Return the average of the processed data stored in m_processedAverage
+	return m_processedAverage;
+}
+
+template <typename T>
+double BasicDataProcessor<T>::calculateAverage(std::span<const T> vec)
+{	// Check if raw data is not empty
 	if (!vec.empty())
 	{
 		int size = vec.size();
-		int padding = size % m_subsetSize > 0 ? m_subsetSize - (size % m_subsetSize) : 0; // Calculate padding if the size isn't a multiple of m_subsetSize
-		std::vector<double> tempSubsetVector(size + padding, 0.0);  // Create a temporary vector with padding (filled with 0s) to handle incomplete subsets
-		std::vector<double> tempSubsetAverageVector; // Create a temporart vector to store the average of each subset
+		double dScale = 1.0 / (double)size; // Calculate the scaling factor for averaging
+		double sum;
+		if constexpr (std::is_same_v<T, double>)
+			sum = isParallel(vec.size())
+				? computeStatistics(vec, nullptr).sum     // Chunk sums reduced in a fixed order on the thread pool
+				: SimdKernels::sum(vec.data(), vec.size()); // Sum all values with the widest kernel the CPU supports
+		else
+			sum = computeStatistics(vec, nullptr).sum; // Exact integer sums, in physical units
+		return (sum * dScale); // Multiply by the scale to get the average and return
+	}
+	return 0.0; // If the vector is empty, return 0.0
+}
+
+template <typename T>
+void BasicDataProcessor<T>::setRawData(std::span<const T> vec)
+{
+	// Replace the current raw data with a copy of the provided data
+	prepareRawData(vec.size());
+	m_rawData.assignValues(vec);
+	indexRawData();
+}
+
+template <typename T>
+void BasicDataProcessor<T>::setRawData(std::span<const T> values, std::span<const std::uint64_t> timestamps, std::span<const std::uint32_t> sequences)
+{
+	// Copy the columns side by side, the timing stays with the values
+	prepareRawData(values.size());
+	m_rawData.append(values, timestamps, sequences);
+	indexRawData();
+}
+
+template <typename T>
+void BasicDataProcessor<T>::setRawData(std::vector<T>&& vec)
+{
+	// Take over the provided buffer instead of copying it
+	recycleRawData();
+	m_rawData.adoptValues(std::move(vec));
+	indexRawData();
+}
+
+template <typename T>
+void BasicDataProcessor<T>::setRawData(BasicSampleBuffer<T>&& samples)
+{
+	// Take over the provided columns instead of copying them
+	recycleRawData();
+	m_rawData = std::move(samples);
+	samples.clear();
+	indexRawData();
+}
 
-		// Copy the input data into the temporary vector
-		for (int i = 0; i < size; i++)
+template <typename T>
+void BasicDataProcessor<T>::setRawData(const CompressedSampleStore& samples)
+{
+	// Decode the blocks into the raw data storage
+	prepareRawData(samples.size());
+	if constexpr (std::is_same_v<T, double>)
+		samples.decode(m_rawData);
+	else
+		samples.decode(m_rawData, m_scale);
+	indexRawData();
+}
+
+template <typename T>
+void BasicDataProcessor<T>::calculateStatistics()
+{
+	// One fused pass over each buffer computes the minimum, maximum, sum and subset averages
+	size_t step = (size_t)std::max(m_subsetSize, 1);
+	prepareBuffer(m_rawSubsetAverageData, (m_rawData.size() + step - 1) / step);
+	prepareBuffer(m_processedSubsetAverageData, (m_processedData.size() + step - 1) / step);
+	m_rawSummary = computeStatistics(m_rawData.getValues(), &m_rawSubsetAverageData);
+	m_processedSummary = computeStatistics(m_processedData, &m_processedSubsetAverageData);
+
+	m_rawAverage = m_rawSummary.count > 0 ? m_rawSummary.sum * (1.0 / (double)m_rawSummary.count) : 0.0;
+	m_processedAverage = m_processedSummary.count > 0 ? m_processedSummary.sum * (1.0 / (double)m_processedSummary.count) : 0.0;
+	sketchQuantiles();
+}
+
+template <typename T>
+void BasicDataProcessor<T>::calculateAverages()
+{
+	// One pass over each buffer without subset averages
+	m_rawSummary = computeStatistics(m_rawData.getValues(), nullptr);
+	m_processedSummary = computeStatistics(m_processedData, nullptr);
+
+	m_rawAverage = m_rawSummary.count > 0 ? m_rawSummary.sum * (1.0 / (double)m_rawSummary.count) : 0.0;
+	m_processedAverage = m_processedSummary.count > 0 ? m_processedSummary.sum * (1.0 / (double)m_processedSummary.count) : 0.0;
+	sketchQuantiles();
+}
+
+template <typename T>
+void BasicDataProcessor<T>::calculateSubsetAverages()
+{
+	calculateStatistics(); // The subset sums come out of the same pass as the other statistics
+}
+
+template <typename T>
+void BasicDataProcessor<T>::movingAverageFilter()
+{
+	m_processedData.clear();
+
+	// Nothing to filter if there is no raw data
+	if (m_rawData.empty())
+		return;
+
+	// The kernel pads the edges with the first and last values and slides a running sum over the data;
+	// the SIMD variants produce exactly the same output as the scalar one
+	prepareBuffer(m_processedData, m_rawData.size());
+	m_processedData.resize(m_rawData.size());
+	const T* raw = m_rawData.getValues().data();
+	size_t size = m_rawData.size();
+	if (isParallel(size))
+	{
+		// Chunks start on resync blocks and read their halo of (m_windowSize - 1) / 2 neighbors straight from the
+		// shared raw data, so every output is computed exactly as in the single-threaded call
+		size_t chunkCount = (size + kParallelChunkSize - 1) / kParallelChunkSize;
+		T* output = m_processedData.data();
+		int windowSize = m_windowSize;
+		m_threadPool->parallelFor(chunkCount, [raw, size, windowSize, output](size_t index)
 		{
-			tempSubsetVector[i] = vec[i];
-		}
-		// Loop through the temporary vector in steps of m_subsetSize
-		for (int i = 0; i < tempSubsetVector.size(); i += m_subsetSize)
+			size_t begin = index * kParallelChunkSize;
+			SimdKernels::movingAverageRange(raw, size, windowSize, begin, std::min(begin + kParallelChunkSize, size), output);
+		});
+	}
+	else
+	{
+		SimdKernels::movingAverage(raw, size, m_windowSize, m_processedData.data());
+	}
+
+	// One more pass runs every configured stage over each cache-resident block of the output
+	m_filterChain.reset();
+	if constexpr (std::is_same_v<T, double>)
+	{
+		m_filterChain.process(m_processedData);
+	}
+	else if (!m_filterChain.empty())
+	{
+		// The stages work on physical values, so each block is converted and quantized again
+		std::array<double, kConversionBlockSize> block;
+		for (size_t begin = 0; begin < size; begin += kConversionBlockSize)
 		{
-			double sum = std::accumulate(tempSubsetVector.begin() + i, tempSubsetVector.begin() + i + m_subsetSize, 0.0); // Calculate the sum of the current subset using std::accumulate with initial sum of 0.0
-			double average = sum * dScale;
-			tempSubsetAverageVector.push_back(average);
+			size_t count = std::min(kConversionBlockSize, size - begin);
+			for (size_t i = 0; i < count; i++)
+				block[i] = toValue(m_processedData[begin + i]);
+			m_filterChain.process(std::span<double>(block.data(), count));
+			for (size_t i = 0; i < count; i++)
+				m_processedData[begin + i] = Traits::quantize(block[i], m_scale);
 		}
-		return tempSubsetAverageVector;
 	}
-	// If the vector is empty, return an empty vector
-	return std::vector<double>();
+	if (m_processedIndex != nullptr)
+		indexData(m_processedData, *m_processedIndex);
 }
 
-double DataProcessor::getRawDataMin() const
+template <typename T>
+void BasicDataProcessor<T>::setFilterChain(FilterChain&& chain)
 {
-	// Find and return the minimum value in the raw data vector
-	return (*std::min_element(m_rawData.begin(), m_rawData.end())); 
+	m_filterChain = std::move(chain);
+	m_filterChain.reset();
 }
 
-double DataProcessor::getRawDataMax() const
+template <typename T>
+const FilterChain& BasicDataProcessor<T>::getFilterChain() const
 {
-	// Find and return the maximum value in the raw data vector
-	return (*std::max_element(m_rawData.begin(), m_rawData.end()));
+	return m_filterChain;
 }
 
-double DataProcessor::getProcessedDataMin() const
+template <typename T>
+void BasicDataProcessor<T>::setSpectrumAnalyzer(std::unique_ptr<SpectrumAnalyzer> analyzer)
 {
-	// Find and return the minimum value in the processed data vector
-	return (*std::min_element(m_processedData.begin(), m_processedData.end()));
+	m_spectrumAnalyzer = std::move(analyzer);
+	if (m_spectrumAnalyzer != nullptr)
+		m_spectrumAnalyzer->reset();
 }
 
-double DataProcessor::getProcessedDataMax() const
+template <typename T>
+const SpectrumAnalyzer* BasicDataProcessor<T>::getSpectrumAnalyzer() const
 {
-	// Find and return the maximum value in the processed data vector
-	return (*std::max_element(m_processedData.begin(), m_processedData.end()));
+	return m_spectrumAnalyzer.get();
 }
 
-double DataProcessor::getRawAverage() const
+template <typename T>
+void BasicDataProcessor<T>::calculateSpectrum()
 {
-	// Return the average of the raw data stored in m_rawAverage
-	return m_rawAverage;
+	if (m_spectrumAnalyzer == nullptr)
+		return;
+	m_spectrumAnalyzer->reset();
+	forEachValueBlock(m_rawData.getValues(), [this](std::span<const double> block)
+	{
+		m_spectrumAnalyzer->process(block);
+	});
 }
 
-double DataProcessor::getProcessedAverage() const
+template <typename T>
+void BasicDataProcessor<T>::beginStream(size_t expectedCount)
 {
-	// Return the average of the processed data stored in m_processedAverage
-	return m_processedAverage;
+	// Discard the data and results of any previous capture, keeping room for the new one
+	size_t subsetCount = expectedCount / (size_t)std::max(m_subsetSize, 1) + 1;
+	prepareRawData(expectedCount);
+	prepareBuffer(m_processedData, expectedCount);
+	prepareBuffer(m_rawSubsetAverageData, subsetCount);
+	prepareBuffer(m_processedSubsetAverageData, subsetCount);
+	m_rawAverage = 0.0;
+	m_processedAverage = 0.0;
+	m_rawSummary = DataStatistics();
+	m_processedSummary = DataStatistics();
+
+	// Reset the streaming state
+	m_streamWindow.reset();
+	m_filterChain.reset();
+	if (m_spectrumAnalyzer != nullptr)
+		m_spectrumAnalyzer->reset();
+	if (m_rawQuantiles != nullptr)
+	{
+		m_rawQuantiles->reset();
+		m_processedQuantiles->reset();
+	}
+	if (m_rawIndex != nullptr)
+	{
+		m_rawIndex->clear();
+		m_rawIndex->reserve(expectedCount);
+		m_processedIndex->clear();
+		m_processedIndex->reserve(expectedCount);
+	}
+	m_rawStatistics.reset();
+	m_processedStatistics.reset();
+	m_rawSubsetSum = 0;
+	m_processedSubsetSum = 0;
+	m_rawSubsetCount = 0;
+	m_processedSubsetCount = 0;
 }
 
-double DataProcessor::calculateAverage(const std::vector<double>& vec)
-{	// Check if raw data is not empty
-	if (!vec.empty())
+template <typename T>
+void BasicDataProcessor<T>::onSample(const BasicSample<T>& rawSample)
+{
+	T sample = rawSample.value;
+	double value = toValue(sample);
+
+	// Pad the beginning of the window with the first sample, like movingAverageFilter does
+	if (m_rawData.empty())
 	{
-		int size = vec.size();
-		double dScale = 1.0 / (double)size; // Calculate the scaling factor for averaging
-		double sum = 0.0;
-		// Loop through the vector to sum all values
-		for (int i = 0; i < size; i++)
+		for (int i = 0; i < (m_windowSize - 1) / 2; i++)
 		{
-			sum += vec[i];
+			m_streamWindow.push(sample);
 		}
-		return (sum * dScale); // Multiply by the scale to get the average and return
 	}
-	return 0.0; // If the vector is empty, return 0.0
+
+	m_rawData.push(rawSample);
+	m_rawStatistics.add(value);
+	if (m_spectrumAnalyzer != nullptr)
+		m_spectrumAnalyzer->process(std::span<const double>(&value, 1));
+	if (m_rawQuantiles != nullptr)
+		m_rawQuantiles->add(value);
+	if (m_rawIndex != nullptr)
+		m_rawIndex->append(value);
+	m_rawAverage = m_rawStatistics.getMean();
+
+	// Update the raw subset and store its average once it is complete
+	m_rawSubsetSum += (Accumulator)sample;
+	if (++m_rawSubsetCount == m_subsetSize)
+	{
+		m_rawSubsetAverageData.push_back((double)m_rawSubsetSum * (Traits::toValue(1.0, m_scale) / (double)m_subsetSize));
+		m_rawSubsetSum = 0;
+		m_rawSubsetCount = 0;
+	}
+
+	m_streamWindow.push(sample);
+	if (m_streamWindow.isFull())
+		emitProcessedSample(m_streamWindow.getAverage());
 }
 
-void DataProcessor::setRawData(const std::vector<double>& vec)
+template <typename T>
+void BasicDataProcessor<T>::endStream()
 {
-	// Replace the current raw data with the provided vector vec
-	m_rawData = vec;
+	if (m_rawData.empty())
+		return;
+
+	// Pad the end of the window with the last sample until every raw sample has a filtered value
+	while (m_processedData.size() < m_rawData.size())
+	{
+		m_streamWindow.push(m_rawData.getValues().back());
+		if (m_streamWindow.isFull())
+			emitProcessedSample(m_streamWindow.getAverage());
+	}
+
+	// Close incomplete subsets; zero padding leaves the sum unchanged
+	double dScale = Traits::toValue(1.0, m_scale) / (double)m_subsetSize;
+	if (m_rawSubsetCount > 0)
+	{
+		m_rawSubsetAverageData.push_back((double)m_rawSubsetSum * dScale);
+		m_rawSubsetSum = 0;
+		m_rawSubsetCount = 0;
+	}
+	if (m_processedSubsetCount > 0)
+	{
+		m_processedSubsetAverageData.push_back((double)m_processedSubsetSum * dScale);
+		m_processedSubsetSum = 0;
+		m_processedSubsetCount = 0;
+	}
+
+	// Cache the minimum and maximum for the getters
+	m_rawSummary = toSummary(m_rawStatistics);
+	m_processedSummary = toSummary(m_processedStatistics);
+}
+
+template <typename T>
+const RunningStatistics& BasicDataProcessor<T>::getRawStatistics() const
+{
+	return m_rawStatistics;
+}
+
+template <typename T>
+const RunningStatistics& BasicDataProcessor<T>::getProcessedStatistics() const
+{
+	return m_processedStatistics;
 }
 
-void DataProcessor::calculateAverages()
+template <typename T>
+double BasicDataProcessor<T>::getCurrentRawSubsetAverage() const
 {
-	m_rawAverage = calculateAverage(m_rawData); // Calculate and store the average for raw data
-	m_processedAverage = calculateAverage(m_processedData); // Calculate and store the average for processed data
+	return m_rawSubsetCount > 0 ? Traits::toValue((double)m_rawSubsetSum, m_scale) / (double)m_rawSubsetCount : 0.0;
 }
 
-void DataProcessor::calculateSubsetAverages()
-{ 
-	m_rawSubsetAverageData = calculateSubsetAverage(m_rawData); // Calculate the subset averages for raw data and store them in m_rawSubsetAverageData
-	m_processedSubsetAverageData = calculateSubsetAverage(m_processedData); // Calculate the subset averages for processed data and store them in m_processedSubsetAverageData
+template <typename T>
+double BasicDataProcessor<T>::getCurrentProcessedSubsetAverage() const
+{
+	return m_processedSubsetCount > 0 ? Traits::toValue((double)m_processedSubsetSum, m_scale) / (double)m_processedSubsetCount : 0.0;
 }
 
-void DataProcessor::movingAverageFilter()
+template <typename T>
+void BasicDataProcessor<T>::setWorkspace(std::shared_ptr<Workspace> workspace)
 {
-	int offset = (m_windowSize - 1) / 2; // Calculate the offset for the window (half the window size, rounded down)
-	int index = 0;
-	double dScaler = 1.0 / (double)m_windowSize; // Scaling factor to normalize the sum to get the average
-	
-	std::vector<double> tempVec(m_rawData.size() + m_windowSize - 1); // Temporary vector to store padded data (to handle edge cases)
+	m_workspace = std::move(workspace);
+}
 
-	// Add padding at the beginning of tempVec using the first value of m_rawData
-	for (int i = 0; i < offset; i++)
+template <typename T>
+void BasicDataProcessor<T>::setQuantileSketchesEnabled(bool enabled, int k)
+{
+	if (!enabled)
 	{
-		tempVec[index++] = m_rawData.front();
+		m_rawQuantiles.reset();
+		m_processedQuantiles.reset();
+		return;
 	}
+	m_rawQuantiles.reset(new QuantileSketch(k));
+	m_processedQuantiles.reset(new QuantileSketch(k));
+	sketchQuantiles();
+}
+
+template <typename T>
+const QuantileSketch* BasicDataProcessor<T>::getRawQuantiles() const
+{
+	return m_rawQuantiles.get();
+}
+
+template <typename T>
+const QuantileSketch* BasicDataProcessor<T>::getProcessedQuantiles() const
+{
+	return m_processedQuantiles.get();
+}
+
+template <typename T>
+void BasicDataProcessor<T>::sketchQuantiles()
+{
+	if (m_rawQuantiles == nullptr)
+		return;
+	sketchQuantiles(m_rawData.getValues(), *m_rawQuantiles);
+	sketchQuantiles(m_processedData, *m_processedQuantiles);
+}
 
-	// Copy the raw data into the temporary vector
-	for (int i = 0; i < m_rawData.size(); i++)
+template <typename T>
+void BasicDataProcessor<T>::sketchQuantiles(std::span<const T> data, QuantileSketch& sketch) const
+{
+	sketch.reset();
+	if (!isParallel(data.size()))
 	{
-		tempVec[index++] = m_rawData[i];
+		forEachValueBlock(data, [&sketch](std::span<const double> block)
+		{
+			sketch.add(block);
+		});
+		return;
 	}
 
-	// Add padding at the end of tempVec using the last value of m_rawData
-	for (int i = 0; i < offset; i++)
+	// One sketch per chunk, merged in chunk order, so the result does not depend on the number of threads
+	size_t chunkCount = (data.size() + kParallelChunkSize - 1) / kParallelChunkSize;
+	std::vector<QuantileSketch> partials(chunkCount, QuantileSketch(sketch.getK()));
+	m_threadPool->parallelFor(chunkCount, [this, &data, &partials](size_t index)
+	{
+		size_t begin = index * kParallelChunkSize;
+		QuantileSketch& partial = partials[index];
+		forEachValueBlock(data.subspan(begin, std::min(kParallelChunkSize, data.size() - begin)), [&partial](std::span<const double> block)
+		{
+			partial.add(block);
+		});
+	});
+	for (const QuantileSketch& partial : partials)
+		sketch.merge(partial);
+}
+
+template <typename T>
+void BasicDataProcessor<T>::setSummaryIndexEnabled(bool enabled)
+{
+	if (!enabled)
 	{
-		tempVec[index++] = m_rawData.back();
+		m_rawIndex.reset();
+		m_processedIndex.reset();
+		return;
 	}
+	if (m_rawIndex != nullptr)
+		return;
 
-	// Perform the moving average calculation
-	for (int i = 0; i < m_rawData.size(); i++)
+	m_rawIndex.reset(new SummaryPyramid());
+	m_processedIndex.reset(new SummaryPyramid());
+	indexData(m_rawData.getValues(), *m_rawIndex);
+	indexData(m_processedData, *m_processedIndex);
+}
+
+template <typename T>
+const SummaryPyramid* BasicDataProcessor<T>::getRawSummaryIndex() const
+{
+	return m_rawIndex.get();
+}
+
+template <typename T>
+const SummaryPyramid* BasicDataProcessor<T>::getProcessedSummaryIndex() const
+{
+	return m_processedIndex.get();
+}
+
+template <typename T>
+DataStatistics BasicDataProcessor<T>::queryRawRange(size_t begin, size_t end) const
+{
+	return queryRange(m_rawData.getValues(), m_rawIndex.get(), begin, end);
+}
+
+template <typename T>
+DataStatistics BasicDataProcessor<T>::queryProcessedRange(size_t begin, size_t end) const
+{
+	return queryRange(m_processedData, m_processedIndex.get(), begin, end);
+}
+
+template <typename T>
+void BasicDataProcessor<T>::indexRawData()
+{
+	if (m_rawIndex != nullptr)
+		indexData(m_rawData.getValues(), *m_rawIndex);
+}
+
+template <typename T>
+void BasicDataProcessor<T>::indexData(std::span<const T> data, SummaryPyramid& index) const
+{
+	if constexpr (std::is_same_v<T, double>)
 	{
-		double sum = 0.0;
+		index.assign(data);
+	}
+	else
+	{
+		index.clear();
+		index.reserve(data.size());
+		forEachValueBlock(data, [&index](std::span<const double> block)
+		{
+			index.append(block);
+		});
+	}
+}
+
+template <typename T>
+DataStatistics BasicDataProcessor<T>::queryRange(std::span<const T> data, const SummaryPyramid* index, size_t begin, size_t end) const
+{
+	if (index != nullptr)
+		return index->query(begin, end);
+
+	end = std::min(end, data.size());
+	if (begin >= end)
+		return DataStatistics();
+	return computeDataStatistics(data.data() + begin, end - begin, (int)std::min<size_t>(end - begin, 2147483647), nullptr, m_scale);
+}
+
+template <typename T>
+void BasicDataProcessor<T>::setThreadPool(std::shared_ptr<ThreadPool> pool)
+{
+	m_threadPool = std::move(pool);
+}
+
+template <typename T>
+bool BasicDataProcessor<T>::isParallel(size_t size) const
+{
+	return m_threadPool != nullptr && size >= kMinParallelSize;
+}
 
-		// Sum the elements within the window (of size m_windowSize)
-		for (int j = 0, k= i; j < m_windowSize; j++, k++)
+template <typename T>
+DataStatistics BasicDataProcessor<T>::computeStatistics(std::span<const T> data, std::vector<double>* subsetAverages) const
+{
+	if (isParallel(data.size()))
+		return computeDataStatisticsParallel(data.data(), data.size(), m_subsetSize, subsetAverages, *m_threadPool, kParallelChunkSize, m_scale);
+	return computeDataStatistics(data.data(), data.size(), m_subsetSize, subsetAverages, m_scale);
+}
+
+template <typename T>
+template <typename Consumer>
+void BasicDataProcessor<T>::forEachValueBlock(std::span<const T> data, Consumer&& consumer) const
+{
+	if constexpr (std::is_same_v<T, double>)
+	{
+		consumer(data);
+	}
+	else
+	{
+		std::array<double, kConversionBlockSize> block;
+		for (size_t begin = 0; begin < data.size(); begin += kConversionBlockSize)
 		{
-			sum += tempVec[k];
+			size_t count = std::min(kConversionBlockSize, data.size() - begin);
+			for (size_t i = 0; i < count; i++)
+				block[i] = toValue(data[begin + i]);
+			consumer(std::span<const double>(block.data(), count));
 		}
+	}
+}
 
-		m_processedData.push_back(sum * dScaler); // Store the average of the window in the processed data
+template <typename T>
+double BasicDataProcessor<T>::toValue(T sample) const
+{
+	return Traits::toValue((double)sample, m_scale);
+}
+
+template <typename T>
+template <typename V>
+void BasicDataProcessor<T>::prepareBuffer(std::vector<V>& buffer, size_t capacity)
+{
+	buffer.clear();
+	if (buffer.capacity() >= capacity)
+		return;
+	if (m_workspace == nullptr)
+	{
+		buffer.reserve(capacity);
+		return;
 	}
-	
+	m_workspace->release(std::move(buffer));
+	buffer = m_workspace->acquireValues<V>(capacity);
 }
+
+template <typename T>
+void BasicDataProcessor<T>::prepareRawData(size_t capacity)
+{
+	m_rawData.clear();
+	if (m_rawData.capacity() >= capacity)
+		return;
+	if (m_workspace == nullptr)
+	{
+		m_rawData.reserve(capacity);
+		return;
+	}
+	m_workspace->release(std::move(m_rawData));
+	m_rawData = m_workspace->acquireSamples<T>(capacity);
+}
+
+template <typename T>
+void BasicDataProcessor<T>::recycleRawData()
+{
+	if (m_workspace != nullptr)
+		m_workspace->release(std::move(m_rawData));
+}
+
+template <typename T>
+void BasicDataProcessor<T>::emitProcessedSample(T sample)
+{
+	// The stages keep their state between calls, so filtering one sample at a time matches the batch result
+	double value = toValue(sample);
+	if (!m_filterChain.empty())
+	{
+		m_filterChain.process(std::span<double>(&value, 1));
+		sample = Traits::quantize(value, m_scale);
+		value = toValue(sample);
+	}
+	m_processedData.push_back(sample);
+	if (m_processedQuantiles != nullptr)
+		m_processedQuantiles->add(value);
+	if (m_processedIndex != nullptr)
+		m_processedIndex->append(value);
+	m_processedStatistics.add(value);
+	m_processedAverage = m_processedStatistics.getMean();
+
+	// Update the processed subset and store its average once it is complete
+	m_processedSubsetSum += (Accumulator)sample;
+	if (++m_processedSubsetCount == m_subsetSize)
+	{
+		m_processedSubsetAverageData.push_back((double)m_processedSubsetSum * (Traits::toValue(1.0, m_scale) / (double)m_subsetSize));
+		m_processedSubsetSum = 0;
+		m_processedSubsetCount = 0;
+	}
+}
+
+template <typename T>
+DataStatistics BasicDataProcessor<T>::toSummary(const RunningStatistics& statistics)
+{
+	DataStatistics summary = DataStatistics();
+	summary.count = (size_t)statistics.getCount();
+	if (summary.count > 0)
+	{
+		summary.sum = statistics.getSum();
+		summary.min = statistics.getMin();
+		summary.max = statistics.getMax();
+	}
+	return summary;
+}
+
+// The sample types of SampleTraits; other types do not link
+template class BasicDataProcessor<double>;
+template class BasicDataProcessor<float>;
+template class BasicDataProcessor<std::int16_t>;
+template class BasicDataProcessor<std::int32_t>;
@@ -1,6 +1,37 @@
+#pragma once
+#include <memory>
 #include <vector>
+#include <span>
+#include "CompressedSampleStore.h"
+#include "FilterChain.h"
+#include "RunningStatistics.h"
+#include "SampleBuffer.h"
+#include "SampleTraits.h"
+#include "SlidingWindowSum.h"
+#include "SpectrumAnalyzer.h"
+#include "Workspace.h"
+#include "QuantileSketch.h"
+#include "StatisticsKernel.h"
+#include "SummaryPyramid.h"
+#include "ThreadPool.h"
 
-class DataProcessor
+/**
+ * @brief Filters sensor data and computes its statistics, in batches or one sample at a time.
+ *
+ * The raw and processed data are stored in the sample type `T`, so 16-bit ADC counts take a quarter of
+ * the memory and bandwidth of doubles. The moving average and the statistics run on the samples with the
+ * accumulators of SampleTraits: integer moving averages are summed exactly and rounded to the nearest
+ * count. The statistics, subset averages, filter stages, spectrum, quantiles and summary indexes work on
+ * physical values, i.e. counts times the scale of the processor; filter stages quantize their output
+ * back to counts.
+ *
+ * `DataProcessor` is the double instantiation. The class is instantiated for double, float, std::int16_t
+ * and std::int32_t only, in DataProcessor.cpp.
+ *
+ * @tparam T The sample type.
+ */
+template <typename T>
+class BasicDataProcessor
 {
 public:
 	/**
@@ -10,80 +41,122 @@ public:
  *
  * @param movingAverageWindowSize The size of the moving average window (default: 3).
  * @param subsetSize The number of elements in each subset for averaging (default: 3).
+ * @param scale The physical value of one count of integer samples; ignored for floating point samples (default: 1.0).
  */
-	DataProcessor(int movingAverageWindowSize = 3, int subsetSize = 3);
-	~DataProcessor();
+	BasicDataProcessor(int movingAverageWindowSize = 3, int subsetSize = 3, double scale = 1.0);
+	~BasicDataProcessor();
+
+	/**
+ * @brief Retrieves the physical value of one count.
+ *
+ * @return The scale of integer samples, 1.0 for floating point samples.
+ */
+	double getScale() const;
+	/**
+ * @brief Sets the physical value of one count, e.g. the scale a capture was recorded with.
+ *
+ * The cached statistics are not recalculated.
+ *
+ * @param scale The physical value of one count of integer samples; ignored for floating point samples.
+ */
+	void setScale(double scale);
 
 	/**
  * @brief Retrieves the raw data processed by the DataProcessor.
  *
- * @return A copy to the vector of raw data.
+ * The returned view refers to the DataProcessor's own storage, no data is copied. It stays
+ * valid until the data is modified (e.g. by `setRawData`, `movingAverageFilter` or streaming).
+ *
+ * @return A read-only view of the raw data.
+ */
+	std::span<const T> getRawData() const;
+	/**
+ * @brief Retrieves the raw data points with their timestamps and sequence numbers.
+ *
+ * The values are the same storage that `getRawData` views. Raw data set from plain values
+ * has no timing.
+ *
+ * @return A constant reference to the raw data points.
  */
-	std::vector<double> getRawData() const;
+	const BasicSampleBuffer<T>& getRawSamples() const;
 	/**
  * @brief Retrieves the processed data after applying the moving average filter.
  *
- * @return A copy to the vector of processed data.
+ * The returned view refers to the DataProcessor's own storage, no data is copied. It stays
+ * valid until the data is modified (e.g. by `setRawData`, `movingAverageFilter` or streaming).
+ *
+ * @return A read-only view of the processed data.
  */
-	std::vector<double> getProcessedData() const;
+	std::span<const T> getProcessedData() const;
 	/**
  * @brief Retrieves the raw subset average data.
  *
- * @return A copy to the vector of raw subset averages.
+ * The returned view refers to the DataProcessor's own storage, no data is copied. It stays
+ * valid until the data is modified (e.g. by `setRawData`, `movingAverageFilter` or streaming).
+ *
+ * @return A read-only view of the raw subset averages.
  */
-	std::vector<double> getRawSubsetAverageData() const;
+	std::span<const double> getRawSubsetAverageData() const;
 	/**
  * @brief Retrieves the processed subset average data.
  *
- * @return A copy to the vector of processed subset averages.
+ * The returned view refers to the DataProcessor's own storage, no data is copied. It stays
+ * valid until the data is modified (e.g. by `setRawData`, `movingAverageFilter` or streaming).
+ *
+ * @return A read-only view of the processed subset averages.
  */
-	std::vector<double> getProcessedSubsetAverageData() const;
+	std::span<const double> getProcessedSubsetAverageData() const;
 	/**
  * @brief Calculates the subset averages of the given data vector.
  *
  * This function divides the input vector into subsets of a fixed size (`m_subsetSize`),
  * calculates the average for each subset, and returns a vector of the subset averages.
  * If the number of elements in the input vector is not a multiple of `m_subsetSize`,
- * the function adds padding to the end of the vector to complete the last subset.
+ * the last subset is averaged as if it were padded with zeros. The averages are computed
+ * by `computeDataStatistics` in a single pass, without copying the input.
  *
- * @param vec The vector of data for which the subset averages will be calculated.
+ * @param vec The data for which the subset averages will be calculated.
  * @return A vector containing the averages of each subset.
  */
-	std::vector<double> calculateSubsetAverage(const std::vector<double>& vec) const;
+	std::vector<double> calculateSubsetAverage(std::span<const T> vec) const;
 	/**
  * @brief Retrieves the minimum value from the raw data.
  *
- * This function calculates and returns the smallest value in the raw data vector,
- * `m_rawData`, using the `std::min_element` algorithm.
+ * This function returns the smallest value in the raw data vector, `m_rawData`, as cached
+ * by the last call to `calculateStatistics` (or `calculateAverages`/`calculateSubsetAverages`)
+ * or `endStream`. It does not rescan the data.
  *
- * @return The minimum value in the raw data vector.
+ * @return The minimum value in the raw data vector, or 0.0 if it is empty.
  */
 	double getRawDataMin() const;
 	/**
  * @brief Retrieves the maximum value from the raw data.
  *
- * This function calculates and returns the largest value in the raw data vector,
- * `m_rawData`, using the `std::max_element` algorithm.
+ * This function returns the largest value in the raw data vector, `m_rawData`, as cached
+ * by the last call to `calculateStatistics` (or `calculateAverages`/`calculateSubsetAverages`)
+ * or `endStream`. It does not rescan the data.
  *
- * @return The maximum value in the raw data vector.
+ * @return The maximum value in the raw data vector, or 0.0 if it is empty.
  */
 	double getRawDataMax() const;
 	/**
  * @brief Retrieves the minimum value from the processed data.
  *
- * This function calculates and returns the smallest value in the processed data vector,
- * `m_processedData`, using the `std::min_element` algorithm.
+ * This function returns the smallest value in the processed data vector, `m_processedData`, as cached
+ * by the last call to `calculateStatistics` (or `calculateAverages`/`calculateSubsetAverages`)
+ * or `endStream`. It does not rescan the data.
  *
- * @return The minimum value in the processed data vector.
+ * @return The minimum value in the processed data vector, or 0.0 if it is empty.
  */
 	double getProcessedDataMin() const;
 	/**
  * @brief Retrieves the maximum value from the processed data.
  *
- * This function calculates and returns the largest value in the processed data vector,
- * `m_processedData`, using the `std::max_element` algorithm.
+ * This function returns the largest value in the processed data vector, `m_processedData`, as cached
+ * by the last call to `calculateStatistics` (or `calculateAverages`/`calculateSubsetAverages`)
+ * or `endStream`. It does not rescan the data.
  *
- * @return The maximum value in the processed data vector.
+ * @return The maximum value in the processed data vector, or 0.0 if it is empty.
  */
 	double getProcessedDataMax() const;
 	/**
@@ -107,13 +180,13 @@ public:
  * @brief Calculates the average of a given data vector.
  *
  * This function computes the average by summing all elements of the input vector
- * and dividing by the number of elements. If the vector is empty, it does not perform
+ * (with `SimdKernels::sum`) and dividing by the number of elements. If the vector is empty, it does not perform
  * the calculation and returns nothing.
  *
- * @param vec The vector of data for which the average is to be calculated.
- * @return The average value of the elements in the vector, or 0.0 if the vector is empty.
+ * @param vec The data for which the average is to be calculated.
+ * @return The average value of the elements in the vector in physical units, or 0.0 if the vector is empty.
  */
-	double calculateAverage(const std::vector<double>& vec);
+	double calculateAverage(std::span<const T> vec);
 	/**
  * @brief Sets the raw data for the DataProcessor.
  *
@@ -123,22 +196,70 @@ public:
  *
  * @param vec A vector containing the new raw data to be processed.
  */
-	void setRawData(const std::vector<double>& vec);
+	void setRawData(std::span<const T> vec);
+	/**
+ * @brief Sets the raw data points together with their timing.
+ *
+ * This function copies the values, timestamps and sequence numbers into `m_rawData` in one pass,
+ * e.g. from the columns of a mapped capture, so the data keeps its recorded timing.
+ *
+ * @param values The new raw values.
+ * @param timestamps The timestamps in nanoseconds, as many as the values or empty.
+ * @param sequences The sequence numbers, as many as the values or empty.
+ */
+	void setRawData(std::span<const T> values, std::span<const std::uint64_t> timestamps, std::span<const std::uint32_t> sequences);
+	/**
+ * @brief Adopts a raw data buffer without copying it.
+ *
+ * This function moves the provided vector into `m_rawData`, so ownership of the buffer passes to
+ * the DataProcessor (e.g. straight from `Sensor::releaseData`) and a large capture is never
+ * duplicated in memory.
+ *
+ * @param vec A vector containing the new raw data to be processed, left empty on return.
+ */
+	void setRawData(std::vector<T>&& vec);
+	/**
+ * @brief Adopts timestamped raw data points without copying them.
+ *
+ * This function moves the provided columns into `m_rawData` (e.g. straight from `Sensor::releaseSamples`),
+ * so the timestamps and sequence numbers stay available next to the values.
+ *
+ * @param samples The new raw data points, left empty on return.
+ */
+	void setRawData(BasicSampleBuffer<T>&& samples);
+	/**
+ * @brief Decodes compressed raw data points.
+ *
+ * This function decodes the store block by block straight into `m_rawData`, with the timestamps and
+ * sequence numbers if the store has them, so the compressed capture is never expanded twice. Integer
+ * samples are quantized with the scale of the processor.
+ *
+ * @param samples The compressed data points.
+ */
+	void setRawData(const CompressedSampleStore& samples);
+	/**
+ * @brief Calculates all statistics of the raw and processed data in one pass over each buffer.
+ *
+ * This function calls `computeDataStatistics` once for `m_rawData` and once for `m_processedData`.
+ * Each call computes the minimum, maximum, sum and subset sums together, and the results are cached
+ * in `m_rawAverage`/`m_processedAverage`, `m_rawSubsetAverageData`/`m_processedSubsetAverageData`
+ * and the minimum and maximum returned by the getters.
+ */
+	void calculateStatistics();
 	/**
 	 * @brief Calculates the averages of the raw and processed data.
 	 *
-	 * This function calls the helper function `calculateAverage` twice:
-	 * once for `m_rawData` and once for `m_processedData`. It stores the results
-	 * in `m_rawAverage` and `m_processedAverage`, respectively.
-	 * If the data vectors are empty, their averages remain unchanged.
+	 * This function walks `m_rawData` and `m_processedData` once each and stores the averages
+	 * in `m_rawAverage` and `m_processedAverage`, respectively. The minimum and maximum are
+	 * cached in the same pass. If the data vectors are empty, their averages are 0.0.
 	 */
 	void calculateAverages();
 	/**
  * @brief Calculates the subset averages for both raw and processed data.
  *
- * This function calls `calculateSubsetAverage` for both the raw data (`m_rawData`)
- * and processed data (`m_processedData`) and stores the resulting subset averages
- * in `m_rawSubsetAverageData` and `m_processedSubsetAverageData`, respectively.
+ * This function is equivalent to `calculateStatistics`: the subset averages of `m_rawData` and
+ * `m_processedData` are stored in `m_rawSubsetAverageData` and `m_processedSubsetAverageData`,
+ * and the averages, minimum and maximum are refreshed in the same pass.
  */
 	void calculateSubsetAverages();
 	/**
@@ -150,21 +271,344 @@ public:
  *
  * The algorithm works as follows:
  * 1. The raw data is padded with the first and last values to handle edge cases.
- * 2. For each data point, the function calculates the sum of the current point and its neighbors
- *    within the window size, then scales the sum to calculate the average.
+ * 2. A running sum slides over the padded samples (the same recurrence as `BasicSlidingWindowSum`),
+ *    so each output costs O(1) regardless of the window size. The sum is compensated for double
+ *    samples and exact for integer samples, whose averages are rounded to the nearest count.
  * 3. The averages are stored in the `m_processedData` vector.
+ *
+ * The work is done by `SimdKernels::movingAverage`, which runs independent blocks of the data
+ * in AVX2/AVX-512 lanes when the CPU supports it; every variant produces the same output.
+ *
+ * The outputs match a direct per-window summation to within
+ * (m_windowSize + 2) * DBL_EPSILON * max|x| over the window.
+ *
+ * If a filter chain is set, its stages are then applied to `m_processedData` in place, all of them
+ * per cache-resident block (see `FilterChain::process`), starting from a reset state. The samples of
+ * other types than double are converted to physical values for the stages and quantized again.
  */
 	void movingAverageFilter();
+	/**
+ * @brief Sets the filter stages applied after the moving average filter.
+ *
+ * The chain is composed once and then used by `movingAverageFilter` and by streaming, where each
+ * filtered sample passes through the stages as it is produced; both give the same processed data.
+ *
+ * @param chain The stages, moved into the DataProcessor; an empty chain applies only the moving average.
+ */
+	void setFilterChain(FilterChain&& chain);
+	/**
+ * @brief Retrieves the filter stages applied after the moving average filter.
+ *
+ * @return A constant reference to the chain.
+ */
+	const FilterChain& getFilterChain() const;
+	/**
+ * @brief Sets the spectrum analyzer fed with the raw data.
+ *
+ * While streaming, every raw sample is passed to the analyzer as it arrives, so the spectrum is
+ * updated whenever a segment completes; `calculateSpectrum` analyzes stored raw data in one go.
+ *
+ * @param analyzer The analyzer, owned by the DataProcessor from now on; nullptr disables spectral analysis.
+ */
+	void setSpectrumAnalyzer(std::unique_ptr<SpectrumAnalyzer> analyzer);
+	/**
+ * @brief Retrieves the spectrum analyzer fed with the raw data.
+ *
+ * @return The analyzer holding the power spectrum of the raw data, or nullptr if none is set.
+ */
+	const SpectrumAnalyzer* getSpectrumAnalyzer() const;
+	/**
+ * @brief Calculates the power spectrum of the raw data.
+ *
+ * The analyzer is reset and fed with the whole of `m_rawData`. It gives the same spectrum as
+ * streaming the data. Nothing is done if no analyzer is set.
+ */
+	void calculateSpectrum();
+	/**
+ * @brief Enables or disables the quantile sketches of the raw and processed data.
+ *
+ * The sketches estimate percentiles in bounded memory (see QuantileSketch for the error bound).
+ * They are fed with every streamed sample, and rebuilt from the whole data by `calculateStatistics`
+ * and `calculateAverages`; with a thread pool, every parallel chunk gets its own sketch and the chunk
+ * sketches are merged in chunk order. Sketches of several processors can be merged the same way.
+ *
+ * @param enabled True to maintain the sketches, false to free them.
+ * @param k The accuracy parameter of the sketches (default: QuantileSketch::kDefaultK).
+ */
+	void setQuantileSketchesEnabled(bool enabled, int k = QuantileSketch::kDefaultK);
+	/**
+ * @brief Retrieves the quantile sketch of the raw data.
+ *
+ * @return The sketch, or nullptr if the sketches are disabled.
+ */
+	const QuantileSketch* getRawQuantiles() const;
+	/**
+ * @brief Retrieves the quantile sketch of the processed data.
+ *
+ * @return The sketch, or nullptr if the sketches are disabled.
+ */
+	const QuantileSketch* getProcessedQuantiles() const;
+	/**
+ * @brief Enables or disables the summary indexes of the raw and processed data.
+ *
+ * An index is a SummaryPyramid that is kept up to date whenever its data changes: it is rebuilt by
+ * `setRawData` and `movingAverageFilter`, and extended by every streamed sample. It answers range
+ * statistics and zoomed-out views in O(log N) without scanning the data, at the cost of four times
+ * the memory of the data it indexes. Enabling the indexes builds them from the current data.
+ *
+ * @param enabled True to maintain the indexes, false to free them.
+ */
+	void setSummaryIndexEnabled(bool enabled);
+	/**
+ * @brief Retrieves the summary index of the raw data.
+ *
+ * @return The index, or nullptr if the indexes are disabled.
+ */
+	const SummaryPyramid* getRawSummaryIndex() const;
+	/**
+ * @brief Retrieves the summary index of the processed data.
+ *
+ * @return The index, or nullptr if the indexes are disabled.
+ */
+	const SummaryPyramid* getProcessedSummaryIndex() const;
+	/**
+ * @brief Computes the statistics of a range of the raw data.
+ *
+ * @param begin The index of the first sample.
+ * @param end One past the index of the last sample; clamped to the number of samples.
+ * @return The count, sum, minimum and maximum of the range; in O(log N) if the indexes are enabled, otherwise by a scan of the range.
+ */
+	DataStatistics queryRawRange(size_t begin, size_t end) const;
+	/**
+ * @brief Computes the statistics of a range of the processed data.
+ *
+ * @param begin The index of the first sample.
+ * @param end One past the index of the last sample; clamped to the number of samples.
+ * @return The count, sum, minimum and maximum of the range; in O(log N) if the indexes are enabled, otherwise by a scan of the range.
+ */
+	DataStatistics queryProcessedRange(size_t begin, size_t end) const;
+	/**
+ * @brief Sets the workspace the data buffers are taken from.
+ *
+ * Whenever a buffer is too small for the next capture, it is swapped for a large enough buffer of the
+ * workspace instead of being reallocated, and every buffer goes back to the workspace when the data
+ * is replaced or the DataProcessor is destroyed. Processors created run after run with the same
+ * workspace therefore reuse the same storage.
+ *
+ * @param workspace The shared workspace, nullptr to allocate the buffers directly.
+ */
+	void setWorkspace(std::shared_ptr<Workspace> workspace);
+	/**
+ * @brief Sets the thread pool that processes large data in parallel chunks.
+ *
+ * With a pool, `movingAverageFilter`, `calculateStatistics`, `calculateAverages`, `calculateAverage` and
+ * `calculateSubsetAverage` split data of at least `kMinParallelSize` values into chunks and run them on the
+ * pool and the calling thread. The filter chunks start on `SlidingWindowSum::kResyncInterval` blocks and read
+ * their halo of `(m_windowSize - 1) / 2` neighbors from the shared raw data, so the processed data is
+ * bit-identical to the single-threaded result. The statistics chunks hold whole subsets, so the subset
+ * averages, minimum and maximum are identical too; the sums are reduced in chunk order and agree with the
+ * single-threaded sums to within size * DBL_EPSILON * sum|x|, whatever the number of threads.
+ * The filter chain and streaming stay sequential.
+ *
+ * @param pool The shared thread pool, nullptr to process on the calling thread only.
+ */
+	void setThreadPool(std::shared_ptr<ThreadPool> pool);
+
+	static constexpr size_t kParallelChunkSize = 16 * SlidingWindowSum::kResyncInterval; ///< Values per parallel chunk (512 KB).
+	static constexpr size_t kMinParallelSize = 2 * kParallelChunkSize;                ///< Smallest data processed in parallel.
+	/**
+ * @brief Starts a new streaming capture.
+ *
+ * Clears the raw and processed data, the subset averages, the averages and all streaming
+ * state, so that samples can be pushed one at a time with `onSample`. The buffers are sized for the
+ * expected number of samples up front, so `onSample` does not reallocate them while the capture runs.
+ *
+ * @param expectedCount The number of samples the capture will deliver, 0 if unknown (default: 0).
+ */
+	void beginStream(size_t expectedCount = 0);
+	/**
+ * @brief Processes a single sample as soon as it is produced.
+ *
+ * The sample is appended to `m_rawData` with its timing and the running raw statistics (mean, min, max)
+ * and the current raw subset are updated, and the sample is fed to the spectrum analyzer if one is set. The sample is also pushed into the moving average
+ * window; once the window is full, the next filtered sample passes through the filter chain, is
+ * appended to `m_processedData` and the processed statistics and subset are updated. Filtered output
+ * lags the input by `(m_windowSize - 1) / 2` samples because the window is centered. Each call costs
+ * O(1) plus the work of the filter stages.
+ *
+ * The filtered samples, the minimum and the maximum match `movingAverageFilter` and `calculateStatistics`
+ * exactly. The subset averages are summed in arrival order, while the vector kernels reassociate subsets of
+ * 16 or more values; those averages agree to within DBL_EPSILON times the sum of the subset's magnitudes
+ * (the `sum` contract of SimdKernels.h divided by the subset size).
+ *
+ * @param rawSample The new raw sample.
+ */
+	void onSample(const BasicSample<T>& rawSample);
+	/**
+ * @brief Finishes a streaming capture.
+ *
+ * Flushes the remaining filtered samples by padding the window with the last raw value,
+ * and closes incomplete subsets the same way `calculateSubsetAverage` pads them with zeros.
+ * The minimum and maximum returned by the getters are taken from the running statistics.
+ */
+	void endStream();
+	/**
+ * @brief Retrieves the running statistics of the raw data.
+ *
+ * @return A constant reference to the raw data statistics updated by `onSample`.
+ */
+	const RunningStatistics& getRawStatistics() const;
+	/**
+ * @brief Retrieves the running statistics of the processed data.
+ *
+ * @return A constant reference to the processed data statistics updated by `onSample`.
+ */
+	const RunningStatistics& getProcessedStatistics() const;
+	/**
+ * @brief Retrieves the average of the raw subset that is currently being filled.
+ *
+ * @return The average of the samples in the incomplete raw subset, or 0.0 if it is empty.
+ */
+	double getCurrentRawSubsetAverage() const;
+	/**
+ * @brief Retrieves the average of the processed subset that is currently being filled.
+ *
+ * @return The average of the samples in the incomplete processed subset, or 0.0 if it is empty.
+ */
+	double getCurrentProcessedSubsetAverage() const;
 
 private:
 
-	std::vector<double> m_rawData;					  // A vector containing the raw data that will be processed by the filter and averaging functions
-	std::vector<double> m_processedData;			  // A vector containing the processed data after applying filters or transformations on the raw data
+	using Traits = SampleTraits<T>;
+	using Accumulator = typename Traits::Accumulator;
+
+	static constexpr size_t kConversionBlockSize = 1024; // Samples converted to physical values at a time for the stages working on doubles
+
+	BasicSampleBuffer<T> m_rawData;					  // The raw data points that will be processed by the filter and averaging functions; the kernels only read its values column
+	std::vector<T> m_processedData;					  // A vector containing the processed data after applying filters or transformations on the raw data
 	std::vector<double> m_rawSubsetAverageData;		  // A vector to store the average of the raw data in subsets, where each element corresponds to the average of a subset
 	std::vector<double> m_processedSubsetAverageData; // A vector to store the average of the processed data in subsets, similar to m_rawSubsetAverageData
 	double m_rawAverage;							  // The average value of the raw data. This value is updated after processing the raw data
 	double m_processedAverage;						  // The average value of the processed data. This value is updated after processing the raw data
 	int m_windowSize;								  // The size of the moving average window used in the filter. Defines how many data points are considered for calculating each average
 	int m_subsetSize;								  // The size of the subsets used when calculating the subset averages. Defines how many elements are grouped together to calculate each subset average
+	double m_scale;									  // The physical value of one count, 1.0 for floating point samples
+
+	DataStatistics m_rawSummary;					  // Cached minimum, maximum, sum and count of the raw data
+	DataStatistics m_processedSummary;				  // Cached minimum, maximum, sum and count of the processed data
+
+	BasicSlidingWindowSum<T> m_streamWindow;		  // The moving average window used while streaming
+	FilterChain m_filterChain;						  // The stages applied after the moving average filter
+	std::unique_ptr<SpectrumAnalyzer> m_spectrumAnalyzer; // Estimates the power spectrum of the raw data, nullptr if disabled
+	std::unique_ptr<QuantileSketch> m_rawQuantiles;	  // Percentile estimates of the raw data, nullptr if disabled
+	std::unique_ptr<QuantileSketch> m_processedQuantiles; // Percentile estimates of the processed data, nullptr if disabled
+	std::unique_ptr<SummaryPyramid> m_rawIndex;		  // Range statistics of the raw data, nullptr if disabled
+	std::unique_ptr<SummaryPyramid> m_processedIndex; // Range statistics of the processed data, nullptr if disabled
+	std::shared_ptr<Workspace> m_workspace;			  // Supplies and takes back the data buffers, may be nullptr
+	std::shared_ptr<ThreadPool> m_threadPool;		  // Runs the chunks of large data in parallel, may be nullptr
+	RunningStatistics m_rawStatistics;				  // Running statistics of the raw data, updated per streamed sample
+	RunningStatistics m_processedStatistics;		  // Running statistics of the processed data, updated per streamed sample
+	Accumulator m_rawSubsetSum;						  // The sum of the raw subset that is currently being filled, in counts
+	Accumulator m_processedSubsetSum;				  // The sum of the processed subset that is currently being filled, in counts
+	int m_rawSubsetCount;							  // The number of samples in the raw subset that is currently being filled
+	int m_processedSubsetCount;						  // The number of samples in the processed subset that is currently being filled
+
+	/**
+ * @brief Rebuilds the quantile sketches from the raw and processed data, if the sketches are enabled.
+ */
+	void sketchQuantiles();
+	/**
+ * @brief Rebuilds a quantile sketch from a buffer, in parallel chunks if it is large enough.
+ *
+ * @param data The values.
+ * @param sketch The sketch, reset first.
+ */
+	void sketchQuantiles(std::span<const T> data, QuantileSketch& sketch) const;
+	/**
+ * @brief Rebuilds the raw summary index from the raw data, if the indexes are enabled.
+ */
+	void indexRawData();
+	/**
+ * @brief Rebuilds a summary index from a buffer.
+ *
+ * @param data The values.
+ * @param index The index, cleared first.
+ */
+	void indexData(std::span<const T> data, SummaryPyramid& index) const;
+	/**
+ * @brief Computes the statistics of a range of a buffer, from its summary index if there is one.
+ *
+ * @param data The buffer.
+ * @param index The summary index of the buffer, or nullptr to scan the range.
+ * @param begin The index of the first value.
+ * @param end One past the index of the last value; clamped to the size of the buffer.
+ * @return The count, sum, minimum and maximum of the range.
+ */
+	DataStatistics queryRange(std::span<const T> data, const SummaryPyramid* index, size_t begin, size_t end) const;
+	/**
+ * @brief Checks whether data of a given size is processed in parallel chunks.
+ *
+ * @param size The number of values.
+ * @return True if a thread pool is set and the data is at least `kMinParallelSize` values long.
+ */
+	bool isParallel(size_t size) const;
+	/**
+ * @brief Computes the statistics of a buffer, in parallel chunks if it is large enough.
+ *
+ * @param data The values.
+ * @param subsetAverages If not null, receives the subset averages.
+ * @return The minimum, maximum, sum and count of the values.
+ */
+	DataStatistics computeStatistics(std::span<const T> data, std::vector<double>* subsetAverages) const;
+	/**
+ * @brief Passes a buffer in physical values to a consumer of doubles, e.g. a quantile sketch.
+ *
+ * Double samples are passed as they are; other samples are converted `kConversionBlockSize` at a time.
+ *
+ * @param data The samples.
+ * @param consumer Called with each block of physical values in order.
+ */
+	template <typename Consumer>
+	void forEachValueBlock(std::span<const T> data, Consumer&& consumer) const;
+	/**
+ * @brief Converts a sample to its physical value.
+ *
+ * @param sample The sample.
+ * @return The sample times the scale for integer samples, the sample itself otherwise.
+ */
+	double toValue(T sample) const;
+	/**
+ * @brief Empties a buffer and makes room for a number of values without reallocating later.
+ *
+ * @param buffer The buffer to prepare; swapped for a workspace buffer if it is too small.
+ * @param capacity The number of values to make room for.
+ */
+	template <typename V>
+	void prepareBuffer(std::vector<V>& buffer, size_t capacity);
+	/**
+ * @brief Empties the raw data and makes room for a number of data points without reallocating later.
+ *
+ * @param capacity The number of data points to make room for.
+ */
+	void prepareRawData(size_t capacity);
+	/**
+ * @brief Returns the raw data storage to the workspace before new data is adopted.
+ */
+	void recycleRawData();
+	/**
+ * @brief Appends a filtered sample to the processed data and updates the processed statistics.
+ *
+ * @param sample The filtered sample.
+ */
+	void emitProcessedSample(T sample);
+	/**
+ * @brief Converts running statistics into a cached summary.
+ *
+ * @param statistics The running statistics to convert.
+ * @return The summary with the same count, sum, minimum and maximum (0.0 if empty).
+ */
+	static DataStatistics toSummary(const RunningStatistics& statistics);
 };
 
+using DataProcessor = BasicDataProcessor<double>;
+
@@ -0,0 +1,48 @@
+#include "ExponentialMovingAverage.h"
+#include <sstream>
+
+ExponentialMovingAverage::ExponentialMovingAverage(double alpha)
+	: m_alpha(alpha),   // Smoothing factor
+	  m_average(0.0),   // Set by the first data point
+	  m_started(false)  // No data point seen yet
+{
+	// Constructor body
+}
+
+ExponentialMovingAverage::~ExponentialMovingAverage()
+{
+	// Destructor body
+}
+
+void ExponentialMovingAverage::process(std::span<double> block)
+{
+	if (block.empty())
+		return;
+	if (!m_started)
+	{
+		m_average = block[0]; // Start from the first value instead of decaying up from zero
+		m_started = true;
+	}
+
+	// The recurrence is serial, keep the state in a register for the whole block
+	double average = m_average;
+	for (double& value : block)
+	{
+		average += m_alpha * (value - average);
+		value = average;
+	}
+	m_average = average;
+}
+
+void ExponentialMovingAverage::reset()
+{
+	m_average = 0.0;
+	m_started = false;
+}
+
+std::string ExponentialMovingAverage::describe() const
+{
+	std::ostringstream description;
+	description << "ema:" << m_alpha;
+	return description.str();
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "FilterStage.h"
+
+/**
+ * @brief Exponential moving average: y[n] = y[n-1] + alpha * (x[n] - y[n-1]).
+ *
+ * One multiply-add per data point and no history, so it smooths with almost no cost. Its
+ * impulse response decays by (1 - alpha) per data point.
+ */
+class ExponentialMovingAverage final : public FilterStage
+{
+public:
+	/**
+ * @brief Constructs an ExponentialMovingAverage object.
+ *
+ * @param alpha The smoothing factor in (0, 1]; 1 passes the signal through unchanged.
+ */
+	ExponentialMovingAverage(double alpha);
+	~ExponentialMovingAverage();
+
+	void process(std::span<double> block) override;
+	void reset() override;
+	std::string describe() const override;
+
+private:
+
+	double m_alpha;   // The smoothing factor
+	double m_average; // The output for the previous data point
+	bool m_started;   // Set once the first data point has been seen
+};
@@ -0,0 +1,159 @@
+#include "FilterChain.h"
+#include "BiquadFilter.h"
+#include "ExponentialMovingAverage.h"
+#include "FirFilter.h"
+#include "RunningMedian.h"
+#include <algorithm>
+#include <charconv>
+#include <sstream>
+
+namespace
+{
+	// Splits a text at a separator, keeping empty fields
+	std::vector<std::string> split(const std::string& text, char separator)
+	{
+		std::vector<std::string> fields;
+		std::stringstream stream(text);
+		std::string field;
+		while (std::getline(stream, field, separator))
+			fields.push_back(field);
+		if (fields.empty() || text.back() == separator)
+			fields.push_back(std::string());
+		return fields;
+	}
+
+	bool parseDouble(const std::string& text, double& value)
+	{
+		const char* first = text.data();
+		const char* last = text.data() + text.size();
+		std::from_chars_result result = std::from_chars(first, last, value);
+		return !text.empty() && result.ec == std::errc() && result.ptr == last;
+	}
+
+	const size_t kMaxFirTaps = 4096;    // Longer responses belong in the frequency domain
+	const int kMaxMedianWindow = 100000;
+}
+
+FilterChain::FilterChain()
+{
+	// Constructor body
+}
+
+FilterChain::~FilterChain()
+{
+	// Destructor body
+}
+
+void FilterChain::addStage(std::unique_ptr<FilterStage> stage)
+{
+	m_stages.push_back(std::move(stage));
+}
+
+void FilterChain::clear()
+{
+	m_stages.clear();
+}
+
+bool FilterChain::empty() const
+{
+	return m_stages.empty();
+}
+
+size_t FilterChain::getStageCount() const
+{
+	return m_stages.size();
+}
+
+FilterStage& FilterChain::getStage(size_t index)
+{
+	return *m_stages[index];
+}
+
+bool FilterChain::parse(const std::string& description)
+{
+	m_stages.clear();
+	m_lastError.clear();
+	if (description.empty())
+		return true;
+
+	for (const std::string& stageText : split(description, ','))
+	{
+		std::vector<std::string> fields = split(stageText, ':');
+		const std::string& name = fields[0];
+		std::vector<double> parameters;
+		for (size_t i = 1; i < fields.size(); i++)
+		{
+			double value;
+			if (!parseDouble(fields[i], value))
+			{
+				m_stages.clear();
+				m_lastError = "invalid parameter '" + fields[i] + "' of filter stage '" + stageText + "'";
+				return false;
+			}
+			parameters.push_back(value);
+		}
+
+		std::unique_ptr<FilterStage> stage;
+		if (name == "ema" && parameters.size() == 1 && parameters[0] > 0.0 && parameters[0] <= 1.0)
+			stage.reset(new ExponentialMovingAverage(parameters[0]));
+		else if (name == "median" && parameters.size() == 1 && parameters[0] >= 1.0 && parameters[0] <= kMaxMedianWindow
+			&& parameters[0] == (double)(int)parameters[0])
+			stage.reset(new RunningMedian((int)parameters[0]));
+		else if (name == "fir" && !parameters.empty() && parameters.size() <= kMaxFirTaps)
+			stage.reset(new FirFilter(parameters));
+		else if (name == "biquad" && parameters.size() == 5)
+			stage.reset(new BiquadFilter(parameters[0], parameters[1], parameters[2], parameters[3], parameters[4]));
+		else if ((name == "lowpass" || name == "highpass") && (parameters.size() == 1 || parameters.size() == 2)
+			&& parameters[0] > 0.0 && parameters[0] < 0.5 && (parameters.size() == 1 || parameters[1] > 0.0))
+		{
+			double q = parameters.size() == 2 ? parameters[1] : 0.70710678118654752;
+			stage.reset(new BiquadFilter(name == "lowpass" ? BiquadFilter::lowPass(parameters[0], q) : BiquadFilter::highPass(parameters[0], q)));
+		}
+
+		if (stage == nullptr)
+		{
+			m_stages.clear();
+			m_lastError = "invalid filter stage '" + stageText + "'";
+			return false;
+		}
+		m_stages.push_back(std::move(stage));
+	}
+	return true;
+}
+
+const std::string& FilterChain::getLastError() const
+{
+	return m_lastError;
+}
+
+std::string FilterChain::describe() const
+{
+	std::string description;
+	for (const auto& stage : m_stages)
+	{
+		if (!description.empty())
+			description += ",";
+		description += stage->describe();
+	}
+	return description;
+}
+
+void FilterChain::reset()
+{
+	for (auto& stage : m_stages)
+		stage->reset();
+}
+
+void FilterChain::process(std::span<double> data)
+{
+	if (m_stages.empty())
+		return;
+
+	// Run the whole chain over one cache-resident block before touching the next one
+	for (size_t begin = 0; begin < data.size(); begin += kBlockSize)
+	{
+		std::span<double> block = data.subspan(begin, std::min(kBlockSize, data.size() - begin));
+		for (auto& stage : m_stages)
+			stage->process(block);
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "FilterStage.h"
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief An ordered list of FilterStage objects applied to a signal one after the other.
+ *
+ * The chain is composed once, at configuration time, either stage by stage with `addStage` or from
+ * a text description with `parse`. `process` walks the signal in blocks of `kBlockSize` data points
+ * and runs every stage over a block before moving on to the next one, so the block stays in the
+ * L1 cache for the whole chain instead of the signal streaming through memory once per stage.
+ * Because every stage is causal and keeps its state between blocks, the result is the same as
+ * running the stages one after the other over the whole signal, and data points can also be
+ * streamed through the chain one at a time.
+ */
+class FilterChain
+{
+public:
+	static constexpr size_t kBlockSize = 1024; ///< Data points per block (8 KB), small enough to stay in L1.
+
+	FilterChain();
+	~FilterChain();
+
+	FilterChain(FilterChain&&) = default;
+	FilterChain& operator=(FilterChain&&) = default;
+
+	/**
+ * @brief Appends a stage to the end of the chain.
+ *
+ * @param stage The stage, applied to the output of the stages added before it.
+ */
+	void addStage(std::unique_ptr<FilterStage> stage);
+	/**
+ * @brief Removes every stage.
+ */
+	void clear();
+	/**
+ * @brief Checks whether the chain has no stages and leaves the signal unchanged.
+ *
+ * @return True if there are no stages.
+ */
+	bool empty() const;
+	/**
+ * @brief Retrieves the number of stages.
+ *
+ * @return The number of stages.
+ */
+	size_t getStageCount() const;
+	/**
+ * @brief Retrieves a stage.
+ *
+ * @param index The index of the stage.
+ * @return A reference to the stage.
+ */
+	FilterStage& getStage(size_t index);
+
+	/**
+ * @brief Replaces the stages with the ones described by a text.
+ *
+ * Stages are separated by commas and their parameters by colons:
+ * - `ema:ALPHA`: ExponentialMovingAverage with 0 < ALPHA <= 1.
+ * - `median:N`: RunningMedian over N data points, 1 <= N <= 100000.
+ * - `fir:H0:H1:...`: FirFilter with the given impulse response (at most 4096 taps).
+ * - `biquad:B0:B1:B2:A1:A2`: BiquadFilter with the given coefficients.
+ * - `lowpass:F[:Q]` and `highpass:F[:Q]`: designed BiquadFilter, 0 < F < 0.5 of the sample rate.
+ *
+ * An empty text gives an empty chain.
+ *
+ * @param description The stages, e.g. "median:5,lowpass:0.05".
+ * @return True if every stage is valid; otherwise the chain is left empty and `getLastError` describes the problem.
+ */
+	bool parse(const std::string& description);
+	/**
+ * @brief Retrieves the description of the last error.
+ *
+ * @return The error message of the last failed `parse`.
+ */
+	const std::string& getLastError() const;
+	/**
+ * @brief Describes the chain in the syntax accepted by `parse`.
+ *
+ * @return The description, empty for an empty chain.
+ */
+	std::string describe() const;
+
+	/**
+ * @brief Resets every stage, so that the next data point starts a new signal.
+ */
+	void reset();
+	/**
+ * @brief Filters the next part of the signal in place, block by block.
+ *
+ * @param data The input data points, overwritten with the output of the last stage.
+ */
+	void process(std::span<double> data);
+
+private:
+
+	std::vector<std::unique_ptr<FilterStage>> m_stages; // The stages in the order they are applied
+	std::string m_lastError;                            // Description of the last error
+};
@@ -0,0 +1,11 @@
+#include "FilterStage.h"
+
+FilterStage::FilterStage()
+{
+	// Constructor body
+}
+
+FilterStage::~FilterStage()
+{
+	// Destructor body
+}
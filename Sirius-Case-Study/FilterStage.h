@@ -0,0 +1,35 @@
+#pragma once
+#include <span>
+#include <string>
+
+/**
+ * @brief Interface of one stage of a FilterChain.
+ *
+ * A stage is a causal filter that keeps its state between calls, so a signal can be processed in
+ * blocks of any size, down to single data points while streaming, and the output does not depend
+ * on how it was split. Every stage starts as if the signal had been constant at its first value
+ * before, which avoids a transient from zero like the padding of the moving average filter.
+ */
+class FilterStage
+{
+public:
+	FilterStage();
+	virtual ~FilterStage();
+
+	/**
+ * @brief Filters the next block of the signal in place.
+ *
+ * @param block The input data points, overwritten with the output.
+ */
+	virtual void process(std::span<double> block) = 0;
+	/**
+ * @brief Forgets the signal processed so far; the next data point is treated as the first one.
+ */
+	virtual void reset() = 0;
+	/**
+ * @brief Describes the stage in the syntax accepted by `FilterChain::parse`.
+ *
+ * @return The description, e.g. "ema:0.1".
+ */
+	virtual std::string describe() const = 0;
+};
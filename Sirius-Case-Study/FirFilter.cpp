@@ -0,0 +1,69 @@
+#include "FirFilter.h"
+#include <algorithm>
+#include <sstream>
+
+FirFilter::FirFilter(std::vector<double> coefficients)
+	: m_coefficients(std::move(coefficients)), // The impulse response as given
+	  m_started(false)                         // The history is primed by the first data point
+{
+	if (m_coefficients.empty())
+		m_coefficients.push_back(1.0); // A single unit tap passes the signal through
+	m_reversed.assign(m_coefficients.rbegin(), m_coefficients.rend()); // Dot products run forward over the inputs
+}
+
+FirFilter::~FirFilter()
+{
+	// Destructor body
+}
+
+void FirFilter::process(std::span<double> block)
+{
+	if (block.empty())
+		return;
+
+	size_t history = m_reversed.size() - 1;
+	if (!m_started)
+	{
+		m_work.assign(history, block[0]); // Treat the signal as constant before its first value
+		m_started = true;
+	}
+
+	// Append the block after the history, then every output is a dot product over contiguous inputs
+	m_work.resize(history + block.size());
+	std::copy(block.begin(), block.end(), m_work.begin() + (std::ptrdiff_t)history);
+
+	const double* taps = m_reversed.data();
+	size_t tapCount = m_reversed.size();
+	for (size_t i = 0; i < block.size(); i++)
+	{
+		const double* input = m_work.data() + i;
+		double sum = 0.0;
+		for (size_t k = 0; k < tapCount; k++)
+			sum += taps[k] * input[k];
+		block[i] = sum;
+	}
+
+	// Keep the last inputs as the history of the next block
+	std::copy(m_work.end() - (std::ptrdiff_t)history, m_work.end(), m_work.begin());
+	m_work.resize(history);
+}
+
+void FirFilter::reset()
+{
+	m_work.clear();
+	m_started = false;
+}
+
+std::string FirFilter::describe() const
+{
+	std::ostringstream description;
+	description << "fir";
+	for (double coefficient : m_coefficients)
+		description << ":" << coefficient;
+	return description.str();
+}
+
+const std::vector<double>& FirFilter::getCoefficients() const
+{
+	return m_coefficients;
+}
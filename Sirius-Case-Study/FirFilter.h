@@ -0,0 +1,41 @@
+#pragma once
+#include "FilterStage.h"
+#include <vector>
+
+/**
+ * @brief Finite impulse response filter: y[n] = sum over k of h[k] * x[n - k].
+ *
+ * The last `taps - 1` inputs are carried over between blocks. Each block is processed from a
+ * work buffer holding that history followed by the block, so the inner loop runs over contiguous
+ * memory without wrap-around and vectorizes; the sum is always taken in the same order, so the
+ * output does not depend on the block size.
+ */
+class FirFilter final : public FilterStage
+{
+public:
+	/**
+ * @brief Constructs a FirFilter object.
+ *
+ * @param coefficients The impulse response h[0], h[1], ...; at least one coefficient.
+ */
+	FirFilter(std::vector<double> coefficients);
+	~FirFilter();
+
+	void process(std::span<double> block) override;
+	void reset() override;
+	std::string describe() const override;
+
+	/**
+ * @brief Retrieves the impulse response.
+ *
+ * @return The coefficients.
+ */
+	const std::vector<double>& getCoefficients() const;
+
+private:
+
+	std::vector<double> m_coefficients; // The coefficients as given
+	std::vector<double> m_reversed;     // The coefficients in reverse order, matching the input order in m_work
+	std::vector<double> m_work;         // The last taps - 1 inputs followed by the current block
+	bool m_started;                     // Set once the history has been primed with the first data point
+};
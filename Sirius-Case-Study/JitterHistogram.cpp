@@ -0,0 +1,95 @@
+#include "JitterHistogram.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+JitterHistogram::JitterHistogram()
+{
+	reset();
+}
+
+JitterHistogram::~JitterHistogram()
+{
+	// Destructor body
+}
+
+void JitterHistogram::add(std::int64_t latenessNs)
+{
+	std::int64_t lateness = std::max<std::int64_t>(latenessNs, 0);
+	int bucket = std::min((int)std::bit_width((std::uint64_t)lateness), kBucketCount - 1);
+	m_buckets[bucket]++;
+
+	m_min = m_count == 0 ? lateness : std::min(m_min, lateness);
+	m_max = m_count == 0 ? lateness : std::max(m_max, lateness);
+	m_count++;
+
+	// Welford's update keeps the variance accurate over millions of samples
+	double delta = (double)lateness - m_mean;
+	m_mean += delta / (double)m_count;
+	m_squaredDeviations += delta * ((double)lateness - m_mean);
+}
+
+void JitterHistogram::reset()
+{
+	std::fill(m_buckets, m_buckets + kBucketCount, 0);
+	m_count = 0;
+	m_min = 0;
+	m_max = 0;
+	m_mean = 0.0;
+	m_squaredDeviations = 0.0;
+}
+
+long long JitterHistogram::getCount() const
+{
+	return m_count;
+}
+
+std::int64_t JitterHistogram::getMin() const
+{
+	return m_min;
+}
+
+std::int64_t JitterHistogram::getMax() const
+{
+	return m_max;
+}
+
+double JitterHistogram::getMean() const
+{
+	return m_mean;
+}
+
+double JitterHistogram::getStandardDeviation() const
+{
+	return m_count > 0 ? std::sqrt(m_squaredDeviations / (double)m_count) : 0.0;
+}
+
+std::int64_t JitterHistogram::getPercentile(double fraction) const
+{
+	if (m_count == 0)
+		return 0;
+
+	// The first bucket whose cumulative count reaches the requested rank
+	long long rank = (long long)std::ceil(fraction * (double)m_count);
+	long long cumulative = 0;
+	for (int bucket = 0; bucket < kBucketCount; bucket++)
+	{
+		cumulative += m_buckets[bucket];
+		if (cumulative >= rank && cumulative > 0)
+			return std::min(getBucketUpperBound(bucket), m_max);
+	}
+	return m_max;
+}
+
+long long JitterHistogram::getBucketCount(int bucket) const
+{
+	return m_buckets[bucket];
+}
+
+std::int64_t JitterHistogram::getBucketUpperBound(int bucket)
+{
+	if (bucket >= kBucketCount - 1)
+		return std::numeric_limits<std::int64_t>::max();
+	return (std::int64_t)1 << bucket;
+}
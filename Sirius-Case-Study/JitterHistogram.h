@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Distribution of the lateness of scheduled events, e.g. how late each data point was generated.
+ *
+ * Latenesses are counted in power-of-two buckets of nanoseconds: bucket 0 holds exact hits, bucket b
+ * holds [2^(b-1), 2^b) ns and the last bucket everything above. Mean and standard deviation are
+ * tracked exactly (Welford), percentiles are resolved to the bucket bounds. Adding costs O(1) and
+ * never allocates, so it can run inside a kHz sampling loop.
+ */
+class JitterHistogram
+{
+public:
+	static const int kBucketCount = 40; ///< Buckets up to 2^38 ns (about 4.6 minutes) plus one overflow bucket.
+
+	JitterHistogram();
+	~JitterHistogram();
+
+	/**
+ * @brief Adds one lateness.
+ *
+ * @param latenessNs How late the event happened in nanoseconds; negative values (early) count as 0.
+ */
+	void add(std::int64_t latenessNs);
+	/**
+ * @brief Clears the histogram.
+ */
+	void reset();
+
+	/**
+ * @brief Retrieves the number of latenesses added.
+ *
+ * @return The count.
+ */
+	long long getCount() const;
+	/**
+ * @brief Retrieves the smallest lateness.
+ *
+ * @return The minimum in nanoseconds, 0 if nothing was added.
+ */
+	std::int64_t getMin() const;
+	/**
+ * @brief Retrieves the largest lateness.
+ *
+ * @return The maximum in nanoseconds, 0 if nothing was added.
+ */
+	std::int64_t getMax() const;
+	/**
+ * @brief Retrieves the mean lateness.
+ *
+ * @return The mean in nanoseconds.
+ */
+	double getMean() const;
+	/**
+ * @brief Retrieves the standard deviation of the lateness.
+ *
+ * @return The population standard deviation in nanoseconds.
+ */
+	double getStandardDeviation() const;
+	/**
+ * @brief Estimates a percentile from the buckets.
+ *
+ * @param fraction The percentile as a fraction, e.g. 0.99.
+ * @return The upper bound of the bucket holding the percentile in nanoseconds, capped at the maximum.
+ */
+	std::int64_t getPercentile(double fraction) const;
+
+	/**
+ * @brief Retrieves the number of latenesses in a bucket.
+ *
+ * @param bucket The bucket index, 0 to kBucketCount - 1.
+ * @return The count of the bucket.
+ */
+	long long getBucketCount(int bucket) const;
+	/**
+ * @brief Retrieves the exclusive upper bound of a bucket.
+ *
+ * @param bucket The bucket index, 0 to kBucketCount - 1.
+ * @return The bound in nanoseconds (1 for bucket 0, 2^b for bucket b, INT64_MAX for the last bucket).
+ */
+	static std::int64_t getBucketUpperBound(int bucket);
+
+private:
+
+	long long m_buckets[kBucketCount]; // Counts per power-of-two bucket
+	long long m_count;                 // The number of latenesses added
+	std::int64_t m_min;                // The smallest lateness
+	std::int64_t m_max;                // The largest lateness
+	double m_mean;                     // The running mean (Welford)
+	double m_squaredDeviations;        // The running sum of squared deviations from the mean (Welford)
+};
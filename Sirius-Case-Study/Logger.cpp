@@ -0,0 +1,168 @@
+#include "Logger.h"
+
+const char* getLogLevelName(LogLevel level)
+{
+	static const char* const kNames[] = { "debug", "info", "warning", "error", "off" };
+	return level >= eLogDebug && level <= eLogOff ? kNames[level] : "unknown";
+}
+
+LogSink::~LogSink()
+{
+	// Destructor body
+}
+
+void LogSink::flush()
+{
+	// Nothing is buffered by default
+}
+
+ConsoleLogSink::ConsoleLogSink(std::ostream& stream)
+	: m_stream(stream) // Receives the messages
+{
+	// Constructor body
+}
+
+ConsoleLogSink::~ConsoleLogSink()
+{
+	// Destructor body
+}
+
+void ConsoleLogSink::write(LogLevel level, const std::string& message)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stream << "[" << getLogLevelName(level) << "] " << message << "\n";
+}
+
+void ConsoleLogSink::flush()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stream.flush();
+}
+
+AsyncLogSink::AsyncLogSink(std::unique_ptr<LogSink> target, size_t capacity)
+	: m_target(std::move(target)),   // Written by the background thread
+	  m_capacity(capacity),          // Queue bound
+	  m_busy(false),                 // Nothing to write yet
+	  m_stopping(false),             // Running until destruction
+	  m_droppedCount(0)              // Nothing dropped yet
+{
+	m_queue.reserve(capacity);
+	m_thread = std::thread(&AsyncLogSink::run, this);
+}
+
+AsyncLogSink::~AsyncLogSink()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wakeUp.notify_one();
+	m_thread.join(); // The background thread writes what is left before it exits
+}
+
+void AsyncLogSink::write(LogLevel level, const std::string& message)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_queue.size() >= m_capacity)
+		{
+			// Never wait for the output, losing a message is cheaper than stalling the caller
+			m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		m_queue.push_back(Entry{ level, message });
+	}
+	m_wakeUp.notify_one();
+}
+
+void AsyncLogSink::flush()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_drained.wait(lock, [this] { return m_queue.empty() && !m_busy; });
+}
+
+std::uint64_t AsyncLogSink::getDroppedCount() const
+{
+	return m_droppedCount.load(std::memory_order_relaxed);
+}
+
+void AsyncLogSink::run()
+{
+	std::vector<Entry> batch;
+	batch.reserve(m_capacity);
+	std::uint64_t reportedDrops = 0;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_wakeUp.wait(lock, [this] { return !m_queue.empty() || m_stopping; });
+		if (m_queue.empty())
+			break; // Stopping and nothing left to write
+
+		// Take the whole queue at once and write it without holding the lock
+		batch.swap(m_queue);
+		m_busy = true;
+		lock.unlock();
+
+		for (const Entry& entry : batch)
+			m_target->write(entry.level, entry.message);
+		std::uint64_t drops = m_droppedCount.load(std::memory_order_relaxed);
+		if (drops != reportedDrops)
+		{
+			m_target->write(eLogWarning, std::to_string(drops - reportedDrops) + " log messages dropped, the log sink could not keep up");
+			reportedDrops = drops;
+		}
+		m_target->flush();
+		batch.clear();
+
+		lock.lock();
+		m_busy = false;
+		if (m_queue.empty())
+			m_drained.notify_all();
+	}
+	m_drained.notify_all();
+}
+
+Logger::Logger(LogLevel level, std::shared_ptr<LogSink> sink)
+	: m_level((int)level), // Lowest level passed on
+	  m_sink(sink != nullptr ? std::move(sink) : std::make_shared<ConsoleLogSink>()) // Receives the messages
+{
+	// Constructor body
+}
+
+Logger::~Logger()
+{
+	// Destructor body
+}
+
+void Logger::setLevel(LogLevel level)
+{
+	m_level.store((int)level, std::memory_order_relaxed);
+}
+
+LogLevel Logger::getLevel() const
+{
+	return (LogLevel)m_level.load(std::memory_order_relaxed);
+}
+
+void Logger::setSink(std::shared_ptr<LogSink> sink)
+{
+	m_sink = sink != nullptr ? std::move(sink) : std::make_shared<ConsoleLogSink>();
+}
+
+void Logger::log(LogLevel level, const std::string& message)
+{
+	if (isEnabled(level))
+		m_sink->write(level, message);
+}
+
+void Logger::flush()
+{
+	m_sink->flush();
+}
+
+Logger& getLogger()
+{
+	static Logger logger;
+	return logger;
+}
@@ -0,0 +1,212 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Represents the severity of a log message.
+ *
+ * A Logger passes on the messages at or above its level; eLogOff silences it completely.
+ */
+enum LogLevel
+{
+	eLogDebug = 0, ///< Detailed messages, e.g. one per generated data point.
+	eLogInfo,      ///< Progress and results.
+	eLogWarning,   ///< Unexpected conditions the program recovers from.
+	eLogError,     ///< Failures.
+	eLogOff        ///< No messages at all.
+};
+
+/**
+ * @brief Retrieves the lower-case name of a log level.
+ *
+ * @param level The log level.
+ * @return The name, e.g. "info".
+ */
+const char* getLogLevelName(LogLevel level);
+
+/**
+ * @brief Receives the messages passed on by a Logger.
+ *
+ * Sinks may be called from several threads at once and must serialize their output themselves.
+ */
+class LogSink
+{
+public:
+	virtual ~LogSink();
+
+	/**
+ * @brief Outputs one message.
+ *
+ * @param level The severity of the message.
+ * @param message The message text without a trailing newline.
+ */
+	virtual void write(LogLevel level, const std::string& message) = 0;
+	/**
+ * @brief Blocks until every message written so far has been output.
+ */
+	virtual void flush();
+};
+
+/**
+ * @brief Writes every message as one "[level] message" line to a stream.
+ *
+ * The caller blocks while the stream is written; wrap it in an AsyncLogSink to keep that
+ * out of time-critical threads.
+ */
+class ConsoleLogSink : public LogSink
+{
+public:
+	/**
+ * @brief Constructs a ConsoleLogSink object.
+ *
+ * @param stream The stream receiving the messages (default: std::clog, so that log lines stay apart from results on std::cout).
+ */
+	ConsoleLogSink(std::ostream& stream = std::clog);
+	~ConsoleLogSink();
+
+	void write(LogLevel level, const std::string& message) override;
+	void flush() override;
+
+private:
+
+	std::ostream& m_stream; // The stream receiving the messages
+	std::mutex m_mutex;     // Keeps lines of concurrent writers apart
+};
+
+/**
+ * @brief Hands messages over to a background thread that writes them to another sink.
+ *
+ * `write` only appends the message to a bounded queue under a short lock and never waits for I/O.
+ * When the queue is full the message is dropped and counted instead of blocking the caller;
+ * the background thread reports the number of dropped messages once it catches up.
+ */
+class AsyncLogSink : public LogSink
+{
+public:
+	/**
+ * @brief Constructs an AsyncLogSink object and starts its background thread.
+ *
+ * @param target The sink the background thread writes to.
+ * @param capacity The number of messages the queue holds before dropping new ones (default: 4096).
+ */
+	AsyncLogSink(std::unique_ptr<LogSink> target, size_t capacity = 4096);
+	/**
+ * @brief Writes the queued messages and stops the background thread.
+ */
+	~AsyncLogSink();
+
+	AsyncLogSink(const AsyncLogSink&) = delete;
+	AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+	void write(LogLevel level, const std::string& message) override;
+	void flush() override;
+
+	/**
+ * @brief Retrieves the number of messages dropped because the queue was full.
+ *
+ * @return The number of dropped messages since construction.
+ */
+	std::uint64_t getDroppedCount() const;
+
+private:
+
+	struct Entry
+	{
+		LogLevel level;      // The severity of the message
+		std::string message; // The message text
+	};
+
+	std::unique_ptr<LogSink> m_target;      // Written by the background thread only
+	size_t m_capacity;                      // Maximum number of queued messages
+	std::vector<Entry> m_queue;             // Messages waiting for the background thread
+	std::mutex m_mutex;                     // Protects m_queue, m_busy and m_stopping
+	std::condition_variable m_wakeUp;       // Signals new messages or stopping to the background thread
+	std::condition_variable m_drained;      // Signals an empty queue to flush
+	bool m_busy;                            // The background thread is writing a batch
+	bool m_stopping;                        // Set by the destructor
+	std::atomic<std::uint64_t> m_droppedCount; // Messages dropped because the queue was full
+	std::thread m_thread;                   // Writes the queued messages
+
+	/**
+ * @brief Body of the background thread: writes the queued messages in batches.
+ */
+	void run();
+};
+
+/**
+ * @brief Filters messages by level and passes them on to a sink.
+ *
+ * Checking `isEnabled` costs one relaxed atomic load, so callers can guard the formatting of
+ * detailed messages and pay almost nothing while the level filters them out.
+ */
+class Logger
+{
+public:
+	/**
+ * @brief Constructs a Logger object.
+ *
+ * @param level The lowest level passed on (default: eLogInfo).
+ * @param sink The sink receiving the messages (default: nullptr, a ConsoleLogSink on std::clog).
+ */
+	Logger(LogLevel level = eLogInfo, std::shared_ptr<LogSink> sink = nullptr);
+	~Logger();
+
+	/**
+ * @brief Sets the lowest level passed on. May be called while other threads are logging.
+ *
+ * @param level The new level.
+ */
+	void setLevel(LogLevel level);
+	/**
+ * @brief Retrieves the lowest level passed on.
+ *
+ * @return The level.
+ */
+	LogLevel getLevel() const;
+	/**
+ * @brief Checks whether messages of a level are passed on.
+ *
+ * @param level The level of a message.
+ * @return True if the message would reach the sink.
+ */
+	bool isEnabled(LogLevel level) const { return (int)level >= m_level.load(std::memory_order_relaxed) && level != eLogOff; }
+	/**
+ * @brief Replaces the sink. Must not be called while other threads are logging.
+ *
+ * @param sink The new sink; nullptr restores the default ConsoleLogSink.
+ */
+	void setSink(std::shared_ptr<LogSink> sink);
+
+	/**
+ * @brief Passes a message on to the sink if its level is enabled.
+ *
+ * @param level The severity of the message.
+ * @param message The message text without a trailing newline.
+ */
+	void log(LogLevel level, const std::string& message);
+	/**
+ * @brief Blocks until every message logged so far has been output.
+ */
+	void flush();
+
+private:
+
+	std::atomic<int> m_level;           // The lowest level passed on
+	std::shared_ptr<LogSink> m_sink;    // Receives the messages
+};
+
+/**
+ * @brief Retrieves the process-wide logger used by the library classes.
+ *
+ * It starts at eLogInfo with a synchronous ConsoleLogSink; programs install their own level and sink.
+ *
+ * @return The logger.
+ */
+Logger& getLogger();
@@ -0,0 +1,61 @@
+#include "Pcg32.h"
+
+namespace
+{
+	const std::uint64_t kMultiplier = 6364136223846793005ULL; // The LCG multiplier of the reference implementation
+
+	// One step of PCG-XSH-RR on a state held in a local variable
+	inline std::uint32_t step(std::uint64_t& state, std::uint64_t increment)
+	{
+		std::uint64_t old = state;
+		state = old * kMultiplier + increment;
+		std::uint32_t shifted = (std::uint32_t)(((old >> 18) ^ old) >> 27);
+		std::uint32_t rotation = (std::uint32_t)(old >> 59);
+		return (shifted >> rotation) | (shifted << ((0 - rotation) & 31));
+	}
+}
+
+Pcg32::Pcg32(std::uint64_t seed)
+{
+	this->seed(seed);
+}
+
+Pcg32::~Pcg32()
+{
+	// Destructor body
+}
+
+void Pcg32::seed(std::uint64_t seed)
+{
+	// The reference seeding procedure, with the initial state and the stream derived from one seed
+	std::uint64_t state = seed;
+	std::uint64_t initialState = splitMix64(state);
+	m_increment = (splitMix64(state) << 1) | 1;
+	m_state = 0;
+	step(m_state, m_increment);
+	m_state += initialState;
+	step(m_state, m_increment);
+}
+
+std::uint64_t Pcg32::next()
+{
+	std::uint64_t high = step(m_state, m_increment);
+	return (high << 32) | step(m_state, m_increment);
+}
+
+void Pcg32::fillUniform(std::span<double> block, double min, double max)
+{
+	std::uint64_t state = m_state;
+	double range = max - min;
+	for (double& value : block)
+	{
+		std::uint64_t high = step(state, m_increment);
+		value = min + toUnitInterval((high << 32) | step(state, m_increment)) * range;
+	}
+	m_state = state;
+}
+
+const char* Pcg32::getName() const
+{
+	return "pcg32";
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "RandomEngine.h"
+
+/**
+ * @brief The PCG-XSH-RR 64/32 generator (O'Neill, 2014).
+ *
+ * A 64-bit linear congruential state with a permuted 32-bit output; two outputs make one 64-bit
+ * value. Smaller state than xoshiro256++ and a different construction, for cross-checking results.
+ */
+class Pcg32 final : public RandomEngine
+{
+public:
+	/**
+ * @brief Constructs a seeded Pcg32 object.
+ *
+ * @param seed The seed (default: 1).
+ */
+	Pcg32(std::uint64_t seed = 1);
+	~Pcg32();
+
+	void seed(std::uint64_t seed) override;
+	std::uint64_t next() override;
+	void fillUniform(std::span<double> block, double min, double max) override;
+	const char* getName() const override;
+
+private:
+
+	std::uint64_t m_state;     // The LCG state
+	std::uint64_t m_increment; // The LCG increment (odd), selecting one of 2^63 streams
+};
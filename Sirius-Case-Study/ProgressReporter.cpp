@@ -0,0 +1,69 @@
+#include "ProgressReporter.h"
+#include <sstream>
+
+ProgressReporter::ProgressReporter(Logger& logger, const std::string& label, std::uint64_t total, std::uint64_t intervalNs)
+	: m_logger(logger),                                // Receives the messages
+	  m_label(label),                                  // Name of the work
+	  m_total(total),                                  // Expected number of items
+	  m_interval(std::chrono::nanoseconds(intervalNs)),// Minimum time between two messages
+	  m_done(0),                                       // Nothing processed yet
+	  m_nextCheck(1),                                  // Read the clock after the first item to learn the loop's speed
+	  m_checkStride(1),
+	  m_start(std::chrono::steady_clock::now()),
+	  m_lastCheck(m_start),
+	  m_lastReport(m_start)
+{
+	// Constructor body
+}
+
+ProgressReporter::~ProgressReporter()
+{
+	// Destructor body
+}
+
+void ProgressReporter::finish()
+{
+	if (m_logger.isEnabled(eLogInfo))
+		report(std::chrono::steady_clock::now(), true);
+}
+
+std::uint64_t ProgressReporter::getDone() const
+{
+	return m_done;
+}
+
+void ProgressReporter::check()
+{
+	auto now = std::chrono::steady_clock::now();
+
+	// Aim for a few clock readings per interval: fewer for fast loops, one per item for slow ones
+	auto sinceCheck = now - m_lastCheck;
+	if (sinceCheck < m_interval / 16)
+		m_checkStride *= 2;
+	else if (sinceCheck > m_interval / 4 && m_checkStride > 1)
+		m_checkStride /= 2;
+	m_lastCheck = now;
+	m_nextCheck = m_done + m_checkStride;
+
+	if (now - m_lastReport >= m_interval && m_logger.isEnabled(eLogInfo))
+	{
+		report(now, false);
+		m_lastReport = now;
+	}
+}
+
+void ProgressReporter::report(std::chrono::steady_clock::time_point now, bool final)
+{
+	double seconds = std::chrono::duration<double>(now - m_start).count();
+	std::ostringstream message;
+	message << m_label << ": " << m_done;
+	if (m_total > 0)
+		message << " / " << m_total << " data points (" << (int)(100.0 * (double)m_done / (double)m_total) << "%)";
+	else
+		message << " data points";
+	if (final)
+		message << " done in " << seconds << " s";
+	if (seconds > 0.0)
+		message << ", " << (double)m_done / seconds << " data points/s";
+	m_logger.log(eLogInfo, message.str());
+}
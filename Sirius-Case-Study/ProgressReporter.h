@@ -0,0 +1,76 @@
+#pragma once
+#include "Logger.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Reports the progress of a long loop through a Logger at a limited rate.
+ *
+ * `advance` is meant to be called from the loop itself: it only adds to a counter and compares it
+ * with a threshold. The clock is read once every few calls, and the number of calls between two
+ * readings adapts to the loop's speed, so both fast loops (millions of data points per second) and
+ * slow paced loops report about once per interval. Progress is logged at eLogInfo; nothing is
+ * formatted while that level is disabled.
+ */
+class ProgressReporter
+{
+public:
+	/**
+ * @brief Constructs a ProgressReporter object and starts its clock.
+ *
+ * @param logger The logger receiving the progress messages.
+ * @param label The name of the work, e.g. "Sensor".
+ * @param total The number of items the loop will process, 0 if unknown.
+ * @param intervalNs The minimum time between two progress messages in nanoseconds (default: 1 s).
+ */
+	ProgressReporter(Logger& logger, const std::string& label, std::uint64_t total, std::uint64_t intervalNs = 1000000000);
+	~ProgressReporter();
+
+	/**
+ * @brief Counts processed items and reports the progress if the interval has passed.
+ *
+ * @param count The number of items processed since the last call (default: 1).
+ */
+	void advance(std::uint64_t count = 1)
+	{
+		m_done += count;
+		if (m_done >= m_nextCheck)
+			check();
+	}
+	/**
+ * @brief Reports the final count, the elapsed time and the rate.
+ */
+	void finish();
+	/**
+ * @brief Retrieves the number of items processed so far.
+ *
+ * @return The count passed to `advance`.
+ */
+	std::uint64_t getDone() const;
+
+private:
+
+	Logger& m_logger;                                    // Receives the progress messages
+	std::string m_label;                                 // The name of the work
+	std::uint64_t m_total;                               // The expected number of items, 0 if unknown
+	std::chrono::nanoseconds m_interval;                 // The minimum time between two messages
+	std::uint64_t m_done;                                // The number of items processed so far
+	std::uint64_t m_nextCheck;                           // Item count at which the clock is read next
+	std::uint64_t m_checkStride;                         // Items between two clock readings
+	std::chrono::steady_clock::time_point m_start;       // The construction time
+	std::chrono::steady_clock::time_point m_lastCheck;   // The last clock reading
+	std::chrono::steady_clock::time_point m_lastReport;  // The time of the last message
+
+	/**
+ * @brief Reads the clock, adapts the stride and logs a progress message when it is due.
+ */
+	void check();
+	/**
+ * @brief Formats and logs one progress message.
+ *
+ * @param now The current time.
+ * @param final True for the message of `finish`.
+ */
+	void report(std::chrono::steady_clock::time_point now, bool final);
+};
@@ -0,0 +1,245 @@
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+
+QuantileSketch::QuantileSketch(int k)
+	: m_k(std::max(k, kMinK)),        // Accuracy, the capacity of the top level
+	  m_levelCount(0),                // Set by addLevel
+	  m_retained(0),                  // No value retained yet
+	  m_capacity(0),                  // Set by addLevel
+	  m_count(0),                     // No value added yet
+	  m_min(0.0),                     // Set by the first value
+	  m_max(0.0),                     // Set by the first value
+	  m_random(0x9E3779B97F4A7C15ull) // Fixed seed, so equal streams give equal sketches
+{
+	addLevel();
+	m_levels[0].reserve((size_t)m_k);
+}
+
+QuantileSketch::~QuantileSketch()
+{
+	// Destructor body
+}
+
+void QuantileSketch::add(double value)
+{
+	if (std::isnan(value))
+		return;
+	if (m_count == 0)
+	{
+		m_min = value;
+		m_max = value;
+	}
+	m_min = std::min(m_min, value);
+	m_max = std::max(m_max, value);
+	m_count++;
+
+	m_levels[0].push_back(value);
+	if (++m_retained >= m_capacity)
+		compress();
+}
+
+void QuantileSketch::add(std::span<const double> values)
+{
+	for (double value : values)
+		add(value);
+}
+
+bool QuantileSketch::merge(const QuantileSketch& other)
+{
+	if (other.m_k != m_k)
+		return false;
+	if (other.m_count == 0)
+		return true;
+
+	if (m_count == 0)
+	{
+		m_min = other.m_min;
+		m_max = other.m_max;
+	}
+	m_min = std::min(m_min, other.m_min);
+	m_max = std::max(m_max, other.m_max);
+	m_count += other.m_count;
+
+	// Values keep their weight, so each level of the other sketch goes into the same level of this one
+	while (m_levelCount < other.m_levelCount)
+		addLevel();
+	const std::vector<double>& unsorted = other.m_levels[0];
+	m_levels[0].insert(m_levels[0].end(), unsorted.begin(), unsorted.end());
+	for (size_t level = 1; level < other.m_levelCount; level++)
+		mergeIntoLevel(level, other.m_levels[level]);
+	m_retained += other.m_retained;
+
+	while (m_retained >= m_capacity)
+		compress();
+	return true;
+}
+
+void QuantileSketch::reset()
+{
+	// The level buffers stay allocated for the next stream
+	for (std::vector<double>& level : m_levels)
+		level.clear();
+	m_levelCount = 1;
+	m_capacity = getLevelCapacity(0, 1);
+	m_retained = 0;
+	m_count = 0;
+	m_min = 0.0;
+	m_max = 0.0;
+	m_random = 0x9E3779B97F4A7C15ull;
+}
+
+double QuantileSketch::getQuantile(double fraction) const
+{
+	double quantile = 0.0;
+	getQuantiles(std::span<const double>(&fraction, 1), std::span<double>(&quantile, 1));
+	return quantile;
+}
+
+void QuantileSketch::getQuantiles(std::span<const double> fractions, std::span<double> quantiles) const
+{
+	if (m_count == 0)
+	{
+		std::fill(quantiles.begin(), quantiles.end(), 0.0);
+		return;
+	}
+
+	// Turn the weights into cumulative weights, so every fraction is a binary search
+	std::vector<std::pair<double, std::uint64_t>> items;
+	getSortedItems(items);
+	std::uint64_t cumulative = 0;
+	for (std::pair<double, std::uint64_t>& item : items)
+	{
+		cumulative += item.second;
+		item.second = cumulative;
+	}
+
+	for (size_t i = 0; i < fractions.size(); i++)
+	{
+		double fraction = fractions[i];
+		if (fraction <= 0.0)
+			quantiles[i] = m_min;
+		else if (fraction >= 1.0)
+			quantiles[i] = m_max;
+		else
+		{
+			std::uint64_t rank = (std::uint64_t)std::ceil(fraction * (double)m_count);
+			auto found = std::lower_bound(items.begin(), items.end(), rank,
+				[](const std::pair<double, std::uint64_t>& item, std::uint64_t target) { return item.second < target; });
+			quantiles[i] = found != items.end() ? found->first : m_max;
+		}
+	}
+}
+
+double QuantileSketch::getRank(double value) const
+{
+	if (m_count == 0)
+		return 0.0;
+
+	std::uint64_t below = 0;
+	for (size_t level = 0; level < m_levelCount; level++)
+	{
+		for (double retained : m_levels[level])
+		{
+			if (retained < value)
+				below += (std::uint64_t)1 << level;
+		}
+	}
+	return (double)below / (double)m_count;
+}
+
+std::uint64_t QuantileSketch::getCount() const
+{
+	return m_count;
+}
+
+size_t QuantileSketch::getRetainedCount() const
+{
+	return m_retained;
+}
+
+int QuantileSketch::getK() const
+{
+	return m_k;
+}
+
+double QuantileSketch::getMin() const
+{
+	return m_min;
+}
+
+double QuantileSketch::getMax() const
+{
+	return m_max;
+}
+
+size_t QuantileSketch::getLevelCapacity(size_t level, size_t levelCount) const
+{
+	size_t depth = levelCount - 1 - level;
+	double capacity = std::ceil((double)m_k * std::pow(2.0 / 3.0, (double)depth));
+	return std::max((size_t)kMinK, (size_t)capacity);
+}
+
+void QuantileSketch::addLevel()
+{
+	if (m_levels.size() == m_levelCount)
+		m_levels.emplace_back();
+	m_levelCount++;
+
+	// Every level below the new top one now has a smaller capacity
+	size_t levelCount = m_levelCount;
+	m_capacity = 0;
+	for (size_t level = 0; level < levelCount; level++)
+		m_capacity += getLevelCapacity(level, levelCount);
+}
+
+void QuantileSketch::compress()
+{
+	// The lowest level at or over its capacity; one exists while the total is at or over the total capacity
+	size_t levelCount = m_levelCount;
+	size_t level = 0;
+	while (level + 1 < levelCount && m_levels[level].size() < getLevelCapacity(level, levelCount))
+		level++;
+	if (level + 1 == levelCount)
+		addLevel();
+
+	std::vector<double>& values = m_levels[level];
+	if (level == 0)
+		std::sort(values.begin(), values.end());
+
+	// An odd value out stays behind; of the others every second one moves up with twice the weight.
+	// The random offset makes the rank error of the compaction zero on average.
+	size_t kept = values.size() & 1;
+	m_random ^= m_random << 13;
+	m_random ^= m_random >> 7;
+	m_random ^= m_random << 17;
+	size_t offset = (size_t)(m_random >> 63);
+	m_promoted.clear();
+	for (size_t i = kept + offset; i < values.size(); i += 2)
+		m_promoted.push_back(values[i]);
+
+	size_t removed = values.size() - kept;
+	values.resize(kept);
+	mergeIntoLevel(level + 1, m_promoted);
+	m_retained -= removed - m_promoted.size();
+}
+
+void QuantileSketch::mergeIntoLevel(size_t level, std::span<const double> values)
+{
+	std::vector<double>& target = m_levels[level];
+	m_scratch.resize(target.size() + values.size());
+	std::merge(target.begin(), target.end(), values.begin(), values.end(), m_scratch.begin());
+	target.swap(m_scratch);
+}
+
+void QuantileSketch::getSortedItems(std::vector<std::pair<double, std::uint64_t>>& items) const
+{
+	items.clear();
+	items.reserve(m_retained);
+	for (size_t level = 0; level < m_levelCount; level++)
+	{
+		for (double value : m_levels[level])
+			items.emplace_back(value, (std::uint64_t)1 << level);
+	}
+	std::sort(items.begin(), items.end());
+}
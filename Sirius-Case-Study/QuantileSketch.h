@@ -0,0 +1,161 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Estimates quantiles of a data stream in bounded memory (a KLL sketch).
+ *
+ * Values are kept in compactors: level h holds values that each stand for 2^h values of the stream.
+ * New values go to level 0. When the sketch holds more values than its capacity, the lowest level
+ * that is over its own capacity is sorted and halved: every second value, starting at a random
+ * offset, moves up one level with twice the weight, the others are dropped. The capacity of a level
+ * shrinks by a factor of 2/3 per level below the top one, never below 8, so the sketch holds about
+ * 3k values however long the stream is, and adding a value costs amortized O(log k).
+ *
+ * The rank error of a quantile is the difference between the rank of the returned value and the
+ * requested rank, as a fraction of the count. It is random; for k = 200 it stays below about 1.3%
+ * with 99% probability, and it scales with 1/k. The minimum and maximum are exact.
+ *
+ * Sketches of the same k can be merged, e.g. the sketches of the chunks of a buffer or of several
+ * sensor channels; the merged sketch has the same error bound as a sketch fed with all values. The
+ * random offsets come from a generator with a fixed seed, so the same values in the same order (and
+ * the same merges) always give the same quantiles.
+ */
+class QuantileSketch
+{
+public:
+	static constexpr int kDefaultK = 200; ///< The accuracy parameter used unless another one is given.
+	static constexpr int kMinK = 8;       ///< The smallest accuracy parameter, also the smallest level capacity.
+
+	/**
+ * @brief Constructs a QuantileSketch object.
+ *
+ * @param k The accuracy parameter, the capacity of the top level; at least kMinK (default: kDefaultK).
+ */
+	QuantileSketch(int k = kDefaultK);
+	~QuantileSketch();
+
+	/**
+ * @brief Adds a value to the stream.
+ *
+ * @param value The value; NaN is ignored.
+ */
+	void add(double value);
+	/**
+ * @brief Adds values to the stream.
+ *
+ * @param values The values, in order.
+ */
+	void add(std::span<const double> values);
+	/**
+ * @brief Adds the stream of another sketch to this one.
+ *
+ * @param other A sketch with the same accuracy parameter.
+ * @return False if the accuracy parameters differ; nothing is merged then.
+ */
+	bool merge(const QuantileSketch& other);
+	/**
+ * @brief Forgets every value, so the sketch can be fed with a new stream.
+ */
+	void reset();
+
+	/**
+ * @brief Retrieves the quantile of a fraction of the stream.
+ *
+ * @param fraction The fraction, 0.0 for the minimum to 1.0 for the maximum, e.g. 0.99 for the 99th percentile.
+ * @return The smallest retained value whose weighted rank reaches fraction * count, or 0.0 if the stream is empty.
+ */
+	double getQuantile(double fraction) const;
+	/**
+ * @brief Retrieves the quantiles of several fractions of the stream, sorting the retained values once.
+ *
+ * @param fractions The fractions, each between 0.0 and 1.0.
+ * @param quantiles Receives the quantile of every fraction; as long as `fractions`.
+ */
+	void getQuantiles(std::span<const double> fractions, std::span<double> quantiles) const;
+	/**
+ * @brief Retrieves the estimated fraction of the stream below a value.
+ *
+ * @param value The value.
+ * @return The weight of the retained values lower than `value` divided by the count.
+ */
+	double getRank(double value) const;
+
+	/**
+ * @brief Retrieves the number of values added.
+ *
+ * @return The count, including the values of merged sketches.
+ */
+	std::uint64_t getCount() const;
+	/**
+ * @brief Retrieves the number of values the sketch holds.
+ *
+ * @return The number of retained values, bounded by about 3k.
+ */
+	size_t getRetainedCount() const;
+	/**
+ * @brief Retrieves the accuracy parameter.
+ *
+ * @return k.
+ */
+	int getK() const;
+	/**
+ * @brief Retrieves the smallest value added.
+ *
+ * @return The minimum, or 0.0 if the stream is empty.
+ */
+	double getMin() const;
+	/**
+ * @brief Retrieves the largest value added.
+ *
+ * @return The maximum, or 0.0 if the stream is empty.
+ */
+	double getMax() const;
+
+private:
+
+	int m_k;                                   // The capacity of the top level
+	std::vector<std::vector<double>> m_levels; // m_levels[h] holds values of weight 2^h; level 0 is unsorted, the others sorted
+	size_t m_levelCount;                       // The number of levels in use; m_levels may hold more, emptied by reset
+	size_t m_retained;                         // The number of values in all levels
+	size_t m_capacity;                         // The sum of the level capacities for the current number of levels
+	std::uint64_t m_count;                     // The number of values added
+	double m_min;                              // The smallest value added
+	double m_max;                              // The largest value added
+	std::uint64_t m_random;                    // The state of the generator choosing the compaction offsets
+	std::vector<double> m_promoted;            // The values a compaction moves up a level
+	std::vector<double> m_scratch;             // Holds the merged level during a compaction
+
+	/**
+ * @brief Computes the capacity of a level.
+ *
+ * @param level The level.
+ * @param levelCount The number of levels.
+ * @return max(kMinK, ceil(k * (2/3)^(levelCount - 1 - level))).
+ */
+	size_t getLevelCapacity(size_t level, size_t levelCount) const;
+	/**
+ * @brief Adds a level on top and updates the total capacity.
+ */
+	void addLevel();
+	/**
+ * @brief Halves the lowest level that is over its capacity into the level above.
+ */
+	void compress();
+	/**
+ * @brief Merges sorted values into a sorted level.
+ *
+ * @param level The level above 0.
+ * @param values The sorted values.
+ */
+	void mergeIntoLevel(size_t level, std::span<const double> values);
+	/**
+ * @brief Collects the retained values with their weights, sorted by value.
+ *
+ * @param items Receives the pairs of value and weight.
+ */
+	void getSortedItems(std::vector<std::pair<double, std::uint64_t>>& items) const;
+};
@@ -0,0 +1,52 @@
+#include "RandomEngine.h"
+#include "Pcg32.h"
+#include "Xoshiro256PlusPlus.h"
+
+RandomEngine::RandomEngine()
+{
+	// Constructor body
+}
+
+RandomEngine::~RandomEngine()
+{
+	// Destructor body
+}
+
+void RandomEngine::fillUniform(std::span<double> block, double min, double max)
+{
+	double range = max - min;
+	for (double& value : block)
+		value = min + toUnitInterval(next()) * range;
+}
+
+double RandomEngine::nextDouble()
+{
+	return toUnitInterval(next());
+}
+
+std::uint64_t RandomEngine::nextBelow(std::uint64_t bound)
+{
+	// Reject the lowest 2^64 mod bound values so that every remainder is equally likely
+	std::uint64_t threshold = (0 - bound) % bound;
+	std::uint64_t bits;
+	do
+	{
+		bits = next();
+	} while (bits < threshold);
+	return bits % bound;
+}
+
+std::uint64_t RandomEngine::splitMix64(std::uint64_t& state)
+{
+	std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+std::unique_ptr<RandomEngine> createRandomEngine(RandomEngineType type, std::uint64_t seed)
+{
+	if (type == ePcg32)
+		return std::unique_ptr<RandomEngine>(new Pcg32(seed));
+	return std::unique_ptr<RandomEngine>(new Xoshiro256PlusPlus(seed));
+}
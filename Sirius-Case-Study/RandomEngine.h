@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <span>
+
+/**
+ * @brief Represents the random number generators a Sensor can use.
+ *
+ * - **eXoshiro256PlusPlus**: xoshiro256++, 256 bits of state, the default.
+ * - **ePcg32**: PCG-XSH-RR with 64 bits of state and 32-bit outputs.
+ */
+enum RandomEngineType
+{
+	eXoshiro256PlusPlus = 0, ///< xoshiro256++ by Blackman and Vigna.
+	ePcg32                   ///< PCG32 by O'Neill.
+};
+
+/**
+ * @brief Interface of a seedable pseudo-random number generator.
+ *
+ * Every Sensor owns its own engine, so sensors running on different threads share no state and
+ * a run is reproduced exactly by reusing its seeds. Engines are not thread-safe themselves.
+ *
+ * The engines are called per block through `fillUniform`, which implementations override with a
+ * loop that keeps the state in registers; `next` is the per-value fallback.
+ */
+class RandomEngine
+{
+public:
+	RandomEngine();
+	virtual ~RandomEngine();
+
+	/**
+ * @brief Restarts the sequence from a seed.
+ *
+ * Any 64-bit value is a valid seed; it is expanded into the engine state with SplitMix64, so
+ * neighbouring seeds give unrelated sequences.
+ *
+ * @param seed The seed.
+ */
+	virtual void seed(std::uint64_t seed) = 0;
+	/**
+ * @brief Generates the next 64 random bits.
+ *
+ * @return A uniformly distributed 64-bit value.
+ */
+	virtual std::uint64_t next() = 0;
+	/**
+ * @brief Fills a block with values uniformly distributed in [min, max).
+ *
+ * The values are the same as `block.size()` calls of `nextDouble` scaled into the range.
+ *
+ * @param block The buffer to fill.
+ * @param min The lower bound (inclusive).
+ * @param max The upper bound (exclusive).
+ */
+	virtual void fillUniform(std::span<double> block, double min, double max);
+	/**
+ * @brief Retrieves the name of the algorithm.
+ *
+ * @return E.g. "xoshiro256++".
+ */
+	virtual const char* getName() const = 0;
+
+	/**
+ * @brief Generates a value uniformly distributed in [0, 1) with 53 random bits.
+ *
+ * @return The random value.
+ */
+	double nextDouble();
+	/**
+ * @brief Generates an unbiased integer in [0, bound).
+ *
+ * @param bound The exclusive upper bound (at least 1).
+ * @return The random integer.
+ */
+	std::uint64_t nextBelow(std::uint64_t bound);
+
+	/**
+ * @brief Maps 64 random bits to [0, 1) using the upper 53 bits.
+ *
+ * @param bits The random bits.
+ * @return The value in [0, 1).
+ */
+	static double toUnitInterval(std::uint64_t bits) { return (double)(bits >> 11) * 0x1.0p-53; }
+	/**
+ * @brief Advances a SplitMix64 state and returns its next output, used to expand seeds.
+ *
+ * @param state The SplitMix64 state.
+ * @return The next output.
+ */
+	static std::uint64_t splitMix64(std::uint64_t& state);
+};
+
+/**
+ * @brief Creates a seeded engine.
+ *
+ * @param type The algorithm.
+ * @param seed The seed.
+ * @return The engine.
+ */
+std::unique_ptr<RandomEngine> createRandomEngine(RandomEngineType type, std::uint64_t seed);
@@ -0,0 +1,100 @@
+#include "RealFft.h"
+#include <cmath>
+#include <numbers>
+
+namespace
+{
+	// Plain complex product; operator* of std::complex also handles infinities through a slow library call
+	inline std::complex<double> multiply(std::complex<double> a, std::complex<double> b)
+	{
+		return std::complex<double>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+	}
+}
+
+RealFft::RealFft(size_t size)
+	: m_size(2) // The smallest transform
+{
+	while (m_size < size)
+		m_size *= 2;
+	size_t half = m_size / 2;
+
+	// Each twiddle is computed directly rather than by repeated rotation, so no rounding error accumulates
+	m_twiddles.resize(half);
+	for (size_t k = 0; k < half; k++)
+	{
+		double angle = -2.0 * std::numbers::pi * (double)k / (double)m_size;
+		m_twiddles[k] = std::complex<double>(std::cos(angle), std::sin(angle));
+	}
+
+	int bits = 0;
+	while (((size_t)1 << bits) < half)
+		bits++;
+	m_reversed.resize(half);
+	for (size_t i = 0; i < half; i++)
+	{
+		std::uint32_t reversed = 0;
+		for (int bit = 0; bit < bits; bit++)
+			reversed |= (std::uint32_t)((i >> bit) & 1) << (bits - 1 - bit);
+		m_reversed[i] = reversed;
+	}
+
+	m_work.resize(half);
+}
+
+RealFft::~RealFft()
+{
+	// Destructor body
+}
+
+void RealFft::forward(std::span<const double> input, std::span<std::complex<double>> output)
+{
+	size_t half = m_size / 2;
+
+	// Pack the even and odd data points into one complex signal, already in bit-reversed order
+	for (size_t i = 0; i < half; i++)
+		m_work[m_reversed[i]] = std::complex<double>(input[2 * i], input[2 * i + 1]);
+
+	// Iterative radix-2 butterflies; the twiddles of a length-`length` stage are every (N / length)-th entry
+	for (size_t length = 2; length <= half; length *= 2)
+	{
+		size_t stride = m_size / length;
+		size_t span = length / 2;
+		for (size_t start = 0; start < half; start += length)
+		{
+			for (size_t j = 0; j < span; j++)
+			{
+				std::complex<double> even = m_work[start + j];
+				std::complex<double> odd = multiply(m_work[start + j + span], m_twiddles[j * stride]);
+				m_work[start + j] = even + odd;
+				m_work[start + j + span] = even - odd;
+			}
+		}
+	}
+
+	// Separate the spectra of the even and odd data points and combine them into the real spectrum
+	for (size_t k = 0; k <= half; k++)
+	{
+		std::complex<double> z = m_work[k % half];
+		std::complex<double> mirrored = std::conj(m_work[(half - k) % half]);
+		std::complex<double> even = 0.5 * (z + mirrored);
+		std::complex<double> difference = z - mirrored;
+		std::complex<double> odd(0.5 * difference.imag(), -0.5 * difference.real()); // (z - mirrored) / 2i
+		std::complex<double> twiddle = k < half ? m_twiddles[k] : std::complex<double>(-1.0, 0.0);
+		output[k] = even + multiply(twiddle, odd);
+	}
+}
+
+size_t RealFft::getSize() const
+{
+	return m_size;
+}
+
+size_t RealFft::getBinCount() const
+{
+	return m_size / 2 + 1;
+}
+
+bool RealFft::isValidSize(size_t size)
+{
+	return size >= 2 && (size & (size - 1)) == 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <complex>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Fast Fourier transform of real signals whose length is a power of two.
+ *
+ * A real signal of N data points is packed into N/2 complex values (even data points as real parts,
+ * odd ones as imaginary parts), transformed by an iterative radix-2 complex FFT of size N/2 and then
+ * split into the N/2 + 1 non-redundant bins of the real spectrum. This takes about half the work of
+ * a complex transform of the same length.
+ *
+ * The twiddle factors and the bit-reversal permutation are computed once by the constructor, and
+ * `forward` works in a buffer owned by the object, so repeated transforms of the same size allocate
+ * nothing and never call a trigonometric function.
+ */
+class RealFft
+{
+public:
+	/**
+ * @brief Constructs a RealFft object and precomputes its tables.
+ *
+ * @param size The transform length N; rounded up to a power of two, at least 2.
+ */
+	RealFft(size_t size);
+	~RealFft();
+
+	/**
+ * @brief Computes the spectrum of a real signal.
+ *
+ * Bin k holds sum over n of x[n] * exp(-2 pi i k n / N), without scaling. The bins above N/2 are the
+ * complex conjugates of those below it and are not returned.
+ *
+ * @param input The N data points of the signal.
+ * @param output Receives bins 0 to N/2 (N/2 + 1 values).
+ */
+	void forward(std::span<const double> input, std::span<std::complex<double>> output);
+
+	/**
+ * @brief Retrieves the transform length.
+ *
+ * @return N, a power of two.
+ */
+	size_t getSize() const;
+	/**
+ * @brief Retrieves the number of bins produced by `forward`.
+ *
+ * @return N/2 + 1.
+ */
+	size_t getBinCount() const;
+	/**
+ * @brief Checks whether a transform length is supported without rounding.
+ *
+ * @param size The transform length.
+ * @return True if `size` is a power of two and at least 2.
+ */
+	static bool isValidSize(size_t size);
+
+private:
+
+	size_t m_size;                                // The transform length N
+	std::vector<std::complex<double>> m_twiddles; // exp(-2 pi i k / N) for k < N/2
+	std::vector<std::uint32_t> m_reversed;        // Bit-reversed index of every position of the N/2-point transform
+	std::vector<std::complex<double>> m_work;     // The packed signal being transformed
+};
@@ -0,0 +1,321 @@
+#include "ReplaySource.h"
+#include "CompressedSampleStore.h"
+#include "ProgressReporter.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <type_traits>
+
+template <typename T>
+BasicReplaySource<T>::BasicReplaySource(ReplayPacing pacing, double speedFactor, double scale)
+	: m_pacing(pacing),           // Replay speed mode
+	  m_speedFactor(speedFactor), // Speed-up for eScaledTime
+	  m_samplePeriodNs(0),        // Use the capture's sample period unless one is set
+	  m_capturePeriodNs(0),       // Unknown until a capture is loaded
+	  m_scale(std::is_floating_point_v<T> ? 1.0 : scale), // Floating point samples are physical values already
+	  m_sampleScale(1.0),         // Set by load
+	  m_elapsedSeconds(0.0)       // Nothing has been replayed yet
+{
+	// Constructor body
+}
+
+template <typename T>
+BasicReplaySource<T>::~BasicReplaySource()
+{
+	// Destructor body
+}
+
+template <typename T>
+bool BasicReplaySource<T>::load(const std::string& path)
+{
+	m_captureReader.close();
+	m_convertedSamples.clear();
+	m_decodedSamples.clear();
+	m_samples = std::span<const T>();
+	m_sampleScale = 1.0;
+	m_timestamps = std::span<const std::uint64_t>();
+	m_sequences = std::span<const std::uint32_t>();
+	m_capturePeriodNs = 0;
+	m_lastError.clear();
+
+	// Binary captures start with a magic string, everything else is treated as text
+	char magic[8] = {};
+	std::ifstream probe(path, std::ios::binary);
+	if (!probe.is_open())
+	{
+		m_lastError = "cannot open " + path;
+		return false;
+	}
+	probe.read(magic, sizeof(magic));
+	probe.close();
+
+	if (std::memcmp(magic, "SIRCAPT", 8) != 0)
+		return loadText(path);
+
+	if (!m_captureReader.open(path))
+	{
+		m_lastError = m_captureReader.getLastError();
+		return false;
+	}
+
+	int column = m_captureReader.findColumn("raw");
+	if (column < 0)
+	{
+		m_captureReader.close();
+		m_lastError = path + " has no raw column";
+		return false;
+	}
+
+	m_capturePeriodNs = m_captureReader.getSamplePeriod();
+	std::uint32_t type = m_captureReader.getColumnDescriptor((size_t)column).type;
+	if (type == eColumnCompressed)
+	{
+		// A compressed capture carries its timing in the same column and is decoded once, block by block
+		CompressedSampleStore store;
+		if (!m_captureReader.getCompressedColumn((size_t)column, store))
+		{
+			m_captureReader.close();
+			m_lastError = path + " has a corrupt compressed raw column";
+			return false;
+		}
+		DataStatistics statistics = store.getStatistics();
+		m_sampleScale = getConversionScale(std::max(std::abs(statistics.min), std::abs(statistics.max)));
+		if constexpr (std::is_same_v<T, double>)
+			store.decode(m_decodedSamples);
+		else
+			store.decode(m_decodedSamples, m_sampleScale);
+		m_captureReader.close();
+		m_samples = m_decodedSamples.getValues();
+		if (m_decodedSamples.hasTiming())
+		{
+			m_timestamps = m_decodedSamples.getTimestamps();
+			m_sequences = m_decodedSamples.getSequences();
+		}
+		return true;
+	}
+
+	double captureScale = m_captureReader.getValueScale();
+	if (type == getCaptureColumnType<T>())
+	{
+		// Replay straight from the mapping, nothing is copied; the counts keep the scale they were recorded with
+		m_samples = m_captureReader.getSampleColumn<T>((size_t)column);
+		m_sampleScale = std::is_floating_point_v<T> ? 1.0 : captureScale;
+	}
+	else if (type == eColumnFloat64)
+		convertSamples(m_captureReader.getSampleColumn<double>((size_t)column), captureScale);
+	else if (type == eColumnFloat32)
+		convertSamples(m_captureReader.getSampleColumn<float>((size_t)column), captureScale);
+	else if (type == eColumnInt16)
+		convertSamples(m_captureReader.getSampleColumn<std::int16_t>((size_t)column), captureScale);
+	else if (type == eColumnInt32)
+		convertSamples(m_captureReader.getSampleColumn<std::int32_t>((size_t)column), captureScale);
+	else
+	{
+		m_captureReader.close();
+		m_lastError = path + " has a raw column of an unsupported type";
+		return false;
+	}
+
+	// Keep the recorded timing if the capture has it for every data point
+	int timestampColumn = m_captureReader.findColumn("timestamp");
+	int sequenceColumn = m_captureReader.findColumn("sequence");
+	if (timestampColumn >= 0 && sequenceColumn >= 0)
+	{
+		std::span<const std::uint64_t> timestamps = m_captureReader.getUInt64Column((size_t)timestampColumn);
+		std::span<const std::uint32_t> sequences = m_captureReader.getUInt32Column((size_t)sequenceColumn);
+		if (timestamps.size() == m_samples.size() && sequences.size() == m_samples.size())
+		{
+			m_timestamps = timestamps;
+			m_sequences = sequences;
+		}
+	}
+	return true;
+}
+
+template <typename T>
+const std::string& BasicReplaySource<T>::getLastError() const
+{
+	return m_lastError;
+}
+
+template <typename T>
+void BasicReplaySource<T>::setSamplePeriod(std::uint64_t samplePeriodNs)
+{
+	m_samplePeriodNs = samplePeriodNs;
+}
+
+template <typename T>
+std::uint64_t BasicReplaySource<T>::getSamplePeriod() const
+{
+	return m_samplePeriodNs != 0 ? m_samplePeriodNs : m_capturePeriodNs;
+}
+
+template <typename T>
+std::span<const T> BasicReplaySource<T>::getSamples() const
+{
+	return m_samples;
+}
+
+template <typename T>
+double BasicReplaySource<T>::getScale() const
+{
+	return m_sampleScale;
+}
+
+template <typename T>
+std::span<const std::uint64_t> BasicReplaySource<T>::getTimestamps() const
+{
+	return m_timestamps;
+}
+
+template <typename T>
+std::span<const std::uint32_t> BasicReplaySource<T>::getSequences() const
+{
+	return m_sequences;
+}
+
+template <typename T>
+bool BasicReplaySource<T>::hasRecordedTiming() const
+{
+	return !m_timestamps.empty();
+}
+
+template <typename T>
+void BasicReplaySource<T>::collectDataPoints(const std::function<void(const BasicSample<T>&)>& onDataPoint)
+{
+	auto start = std::chrono::steady_clock::now();
+	m_scheduler.start();
+
+	// A capture without a sample period cannot be paced
+	double periodNs = (double)getSamplePeriod();
+	if (m_pacing == eScaledTime && m_speedFactor > 0.0)
+		periodNs /= m_speedFactor;
+	bool paced = m_pacing != eAsFastAsPossible && periodNs > 0.0;
+	bool recorded = hasRecordedTiming();
+	std::uint64_t origin = m_scheduler.getOriginTimestamp();
+	ProgressReporter progress(getLogger(), "Replay", m_samples.size());
+
+	for (size_t i = 0; i < m_samples.size(); i++)
+	{
+		std::uint64_t handOverTime = 0;
+		if (paced)
+		{
+			// Wait for the data point's slot on the absolute schedule
+			handOverTime = origin + m_scheduler.waitUntil((std::uint64_t)(periodNs * (double)i));
+		}
+
+		// Recorded data points keep the timing of their acquisition, the others are stamped when they are handed over
+		if (recorded)
+			onDataPoint(BasicSample<T>{ m_timestamps[i], m_samples[i], m_sequences[i] });
+		else
+			onDataPoint(BasicSample<T>{ paced ? handOverTime : SampleScheduler::getTimestamp(), m_samples[i], (std::uint32_t)i });
+		progress.advance();
+	}
+	progress.finish();
+
+	m_elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename T>
+double BasicReplaySource<T>::getElapsedSeconds() const
+{
+	return m_elapsedSeconds;
+}
+
+template <typename T>
+double BasicReplaySource<T>::getAchievedRate() const
+{
+	return m_elapsedSeconds > 0.0 ? (double)m_samples.size() / m_elapsedSeconds : 0.0;
+}
+
+template <typename T>
+const JitterHistogram& BasicReplaySource<T>::getJitterHistogram() const
+{
+	return m_scheduler.getJitterHistogram();
+}
+
+template <typename T>
+bool BasicReplaySource<T>::loadText(const std::string& path)
+{
+	// Read the whole file at once and parse it in place
+	std::ifstream file(path, std::ios::binary);
+	std::stringstream contents;
+	contents << file.rdbuf();
+	std::string text = contents.str();
+	std::vector<double> values;
+
+	const char* cursor = text.data();
+	const char* end = text.data() + text.size();
+	int lineNumber = 0;
+	while (cursor < end)
+	{
+		const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', (size_t)(end - cursor)));
+		if (lineEnd == nullptr)
+			lineEnd = end;
+		const char* first = cursor;
+		const char* last = lineEnd;
+		cursor = lineEnd + 1;
+		lineNumber++;
+
+		// Trim whitespace, including the carriage return of Windows line endings
+		while (first < last && (*first == ' ' || *first == '\t'))
+			first++;
+		while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r'))
+			last--;
+
+		if (first == last || std::strncmp(first, "Raw Data:", 9) == 0)
+			continue;
+		if (std::strncmp(first, "Processed Data:", 15) == 0)
+			break; // The processed values are recomputed by the replay
+
+		double value;
+		std::from_chars_result result = std::from_chars(first, last, value);
+		if (result.ec != std::errc() || result.ptr != last)
+		{
+			m_lastError = path + " line " + std::to_string(lineNumber) + " is not a number";
+			return false;
+		}
+		values.push_back(value);
+	}
+
+	convertSamples(std::span<const double>(values), 1.0); // Text captures hold physical values
+	return true;
+}
+
+template <typename T>
+template <typename U>
+void BasicReplaySource<T>::convertSamples(std::span<const U> values, double scale)
+{
+	// Through physical units, so a capture replays the same values in any sample type
+	double magnitude = 0.0;
+	if (!std::is_floating_point_v<T> && m_scale == 0.0)
+	{
+		for (U value : values)
+			magnitude = std::max(magnitude, std::abs(SampleTraits<U>::toValue((double)value, scale)));
+	}
+	m_sampleScale = getConversionScale(magnitude);
+
+	m_convertedSamples.resize(values.size());
+	for (size_t i = 0; i < values.size(); i++)
+		m_convertedSamples[i] = SampleTraits<T>::quantize(SampleTraits<U>::toValue((double)values[i], scale), m_sampleScale);
+	m_samples = m_convertedSamples;
+}
+
+template <typename T>
+double BasicReplaySource<T>::getConversionScale(double magnitude) const
+{
+	if (std::is_floating_point_v<T> || m_scale != 0.0)
+		return m_scale;
+	return magnitude > 0.0 && std::isfinite(magnitude) ? magnitude / (double)std::numeric_limits<T>::max() : 1.0; // The largest value uses the full range
+}
+
+// The sample types of SampleTraits; other types do not link
+template class BasicReplaySource<double>;
+template class BasicReplaySource<float>;
+template class BasicReplaySource<std::int16_t>;
+template class BasicReplaySource<std::int32_t>;
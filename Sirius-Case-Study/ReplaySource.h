@@ -0,0 +1,197 @@
+#pragma once
+#include "CaptureFile.h"
+#include "SampleBuffer.h"
+#include "SampleScheduler.h"
+#include "SampleTraits.h"
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Represents how fast a recorded capture is replayed.
+ *
+ * - **eAsFastAsPossible**: Data points are handed over without any delay.
+ * - **eRealTime**: Data points are handed over at the capture's original sample period.
+ * - **eScaledTime**: Data points are handed over at the original sample period divided by a speed factor.
+ */
+enum ReplayPacing
+{
+	eAsFastAsPossible = 0, ///< No delay between data points.
+	eRealTime,             ///< The original timing.
+	eScaledTime            ///< The original timing sped up (or slowed down) by a factor.
+};
+
+/**
+ * @brief Replays a saved capture as samples of a sample type, as if a sensor produced them again.
+ *
+ * A binary capture whose raw column is stored in the type `T` is replayed from the mapping without a copy,
+ * with the scale recorded in the capture. Captures of other types are converted once: the values are turned
+ * into physical units and quantized with the scale given to the constructor, or one fitted to the capture. `ReplaySource` is the double
+ * instantiation. The class is instantiated for double, float, std::int16_t and std::int32_t only, in
+ * ReplaySource.cpp.
+ *
+ * @tparam T The sample type.
+ */
+template <typename T>
+class BasicReplaySource
+{
+public:
+	/**
+ * @brief Constructs a BasicReplaySource object.
+ *
+ * @param pacing How fast the capture is replayed (default: eAsFastAsPossible).
+ * @param speedFactor The speed-up relative to real time, used only with eScaledTime (default: 1.0).
+ * @param scale The physical value of one count that captures of another type are quantized with, 0 to let the
+ *        largest magnitude of the capture use the full range of `T`; ignored for floating point samples (default: 0.0).
+ */
+	BasicReplaySource(ReplayPacing pacing = eAsFastAsPossible, double speedFactor = 1.0, double scale = 0.0);
+	~BasicReplaySource();
+
+	/**
+ * @brief Loads a previously saved capture.
+ *
+ * Binary captures (`output.cap`) are memory-mapped and replayed in place from their "raw" column,
+ * together with their "timestamp" and "sequence" columns if they have them. A raw column of another
+ * sample type is converted once. A compressed "raw" column is decoded once, with the timing it holds.
+ * Anything else is read as a text capture (`output.txt`): the values under the "Raw Data:" heading,
+ * or every line if there is no heading. Text captures hold the values with six significant digits only.
+ *
+ * @param path The path of the capture file.
+ * @return True if the capture was loaded; otherwise `getLastError` describes the problem.
+ */
+	bool load(const std::string& path);
+	/**
+ * @brief Retrieves the description of the last error.
+ *
+ * @return The error message of the last failed `load`.
+ */
+	const std::string& getLastError() const;
+
+	/**
+ * @brief Sets the sample period used for pacing, overriding the one stored in the capture.
+ *
+ * Text captures do not store a sample period, so one must be set for eRealTime or eScaledTime.
+ *
+ * @param samplePeriodNs The sample period in nanoseconds.
+ */
+	void setSamplePeriod(std::uint64_t samplePeriodNs);
+	/**
+ * @brief Retrieves the sample period used for pacing.
+ *
+ * @return The sample period in nanoseconds, 0 if it is unknown (the capture is then replayed unpaced).
+ */
+	std::uint64_t getSamplePeriod() const;
+	/**
+ * @brief Retrieves the loaded data points.
+ *
+ * The view points into the mapped capture, the parsed text or the decoded compressed column. Processing
+ * it in a batch copies it once, e.g. into a DataProcessor with `getTimestamps` and `getSequences`.
+ *
+ * @return A view of the data points, valid until the next `load`.
+ */
+	std::span<const T> getSamples() const;
+	/**
+ * @brief Retrieves the physical value of one count of the loaded data points.
+ *
+ * @return The scale recorded in a capture of integer samples of type `T`, otherwise the scale the data points were
+ *         converted with; 1.0 for floating point samples.
+ */
+	double getScale() const;
+	/**
+ * @brief Retrieves the recorded timestamps of the loaded data points.
+ *
+ * @return A view of the timestamps in nanoseconds, empty if the capture has none; valid until the next `load`.
+ */
+	std::span<const std::uint64_t> getTimestamps() const;
+	/**
+ * @brief Retrieves the recorded sequence numbers of the loaded data points.
+ *
+ * @return A view of the sequence numbers, empty if the capture has none; valid until the next `load`.
+ */
+	std::span<const std::uint32_t> getSequences() const;
+	/**
+ * @brief Checks whether the loaded capture holds the timestamps and sequence numbers of its data points.
+ *
+ * @return True if the recorded timing is replayed with the values.
+ */
+	bool hasRecordedTiming() const;
+
+	/**
+ * @brief Hands every loaded data point to a callback with the configured pacing.
+ *
+ * Has the same shape as `Sensor::collectDataPoints`, so a replay can drive the same consumers as a
+ * live sensor. Paced replays follow an absolute schedule kept by a SampleScheduler, so a late data
+ * point does not delay the ones after it.
+ *
+ * Data points keep their recorded timestamps and sequence numbers if the capture has them, so gaps and
+ * rates of the original acquisition can be analyzed again. Otherwise they are stamped with the time
+ * they are handed over and numbered by their position in the capture.
+ *
+ * @param onDataPoint Callback invoked with each data point.
+ */
+	void collectDataPoints(const std::function<void(const BasicSample<T>&)>& onDataPoint);
+
+	/**
+ * @brief Retrieves the wall-clock duration of the last replay.
+ *
+ * @return The duration in seconds.
+ */
+	double getElapsedSeconds() const;
+	/**
+ * @brief Retrieves the rate achieved by the last replay.
+ *
+ * @return The number of data points handed over per second.
+ */
+	double getAchievedRate() const;
+	/**
+ * @brief Retrieves how late each data point of the last paced replay was handed over.
+ *
+ * @return The lateness against the schedule; empty after an eAsFastAsPossible replay.
+ */
+	const JitterHistogram& getJitterHistogram() const;
+
+private:
+
+	ReplayPacing m_pacing;             // How fast the capture is replayed
+	double m_speedFactor;              // Speed-up relative to real time for eScaledTime
+	CaptureReader m_captureReader;     // Keeps a binary capture mapped while it is replayed
+	std::vector<T> m_convertedSamples; // The values parsed from a text capture or converted from a raw column of another type
+	BasicSampleBuffer<T> m_decodedSamples; // The data points decoded from a compressed raw column
+	std::span<const T> m_samples;      // The data points to replay, in the mapping, m_convertedSamples or m_decodedSamples
+	std::span<const std::uint64_t> m_timestamps; // The recorded timestamps, empty if the capture has none
+	std::span<const std::uint32_t> m_sequences;  // The recorded sequence numbers, empty if the capture has none
+	std::uint64_t m_samplePeriodNs;    // The sample period set by the user, 0 to use the capture's
+	std::uint64_t m_capturePeriodNs;   // The sample period stored in the loaded capture
+	double m_scale;                    // The physical value of one count used to quantize converted data points, 0 to fit it
+	double m_sampleScale;              // The physical value of one count of m_samples
+	std::string m_lastError;           // Description of the last error
+	double m_elapsedSeconds;           // Duration of the last replay
+	SampleScheduler m_scheduler;       // Waits for the deadlines of paced replays
+
+	/**
+ * @brief Parses a text capture into m_textSamples.
+ *
+ * @param path The path of the text file.
+ * @return True if every value line could be parsed.
+ */
+	bool loadText(const std::string& path);
+	/**
+ * @brief Converts a raw column of another sample type into m_convertedSamples.
+ *
+ * @param values The values of the column.
+ * @param scale The physical value of one count of the column.
+ */
+	template <typename U>
+	void convertSamples(std::span<const U> values, double scale);
+	/**
+ * @brief Retrieves the scale that data points of another type are converted with.
+ *
+ * @param magnitude The largest magnitude of the physical values to convert.
+ * @return The configured scale, or the one that maps the magnitude to the largest count if none is configured.
+ */
+	double getConversionScale(double magnitude) const;
+};
+
+using ReplaySource = BasicReplaySource<double>;
@@ -0,0 +1,554 @@
+#include "RunConfiguration.h"
+#include "FilterChain.h"
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+	// Describes one per-run option
+	struct OptionDescription
+	{
+		const char* name;        // The option name without dashes
+		const char* argument;    // The argument placeholder shown in the usage text
+		const char* description; // The help text
+		bool numeric;            // Numeric options accept ranges
+		bool list;               // List options accept comma-separated values
+	};
+
+	// Runs are expanded in this order, the first option varying slowest
+	const OptionDescription kOptions[] = {
+		{ "source", "SOURCE", "Data source: sensor or replay (default: sensor)", false, false },
+		{ "points", "N", "Number of data points per channel, 1 to 2147483647 (default: 1000)", true, true },
+		{ "channels", "N", "Number of sensor channels (default: 1)", true, true },
+		{ "timing", "MODE", "Data timing: immediate, periodic or asynchronous (default: immediate)", false, true },
+		{ "period", "MS", "Period for periodic timing in milliseconds, 100 to 1000 (default: 100)", true, true },
+		{ "period-us", "US", "Period for periodic timing in microseconds, 1 to 1000000; overrides --period", true, true },
+		{ "spin-us", "US", "Busy-wait before each periodic or asynchronous deadline, 0 to 10000 (default: 100)", true, true },
+		{ "type", "TYPE", "Data type: linear, sine or random (default: linear)", false, true },
+		{ "min", "VALUE", "Minimum value for linear and random data, -1000 to 1000 (default: -100)", true, true },
+		{ "max", "VALUE", "Maximum value for linear and random data, -1000 to 1000 (default: 100)", true, true },
+		{ "seed", "N", "Seed for random data and asynchronous delays, 0 to 2147483647 (default: 1)", true, true },
+		{ "rng", "ENGINE", "Random number generator: xoshiro or pcg (default: xoshiro)", false, true },
+		{ "window", "N", "Moving average window size, odd, 3 to 101 (default: 3)", true, true },
+		{ "subset", "N", "Subset size for subset averages (default: 100)", true, true },
+		{ "filter", "STAGES", "Filters after the moving average, e.g. median:5,ema:0.2,fir:0.25:0.5:0.25,lowpass:0.05[:Q]", false, false },
+		{ "spectrum", "N", "Segment size of the raw data's power spectrum, a power of two from 16 to 1048576; 0 disables it (default: 0)", true, true },
+		{ "spectrum-window", "WINDOW", "Window of the spectrum segments: rectangular, hann, hamming or blackman (default: hann)", false, true },
+		{ "percentiles", "MODE", "Estimate the 50th, 95th and 99th percentiles: on or off (default: on)", false, true },
+		{ "zoom", "N", "Print a zoomed-out overview of N buckets, 0 to 1000; 0 disables it (default: 0)", true, true },
+		{ "threads", "N", "Threads processing the data of an immediate single-channel run or a fast replay, 0 for one per hardware thread, up to 256 (default: 1)", true, true },
+		{ "sample-type", "TYPE", "Type the samples are stored and processed in: double, float, int16 or int32 (default: double)", false, true },
+		{ "replay", "PATH", "Capture to replay (output.txt or output.cap), implies --source replay", false, false },
+		{ "pacing", "MODE", "Replay speed: fast, realtime or scaled (default: fast)", false, true },
+		{ "speed", "N", "Speed factor for scaled pacing, 1 to 1000 (default: 1)", true, true },
+		{ "replay-period", "MS", "Sample period for captures that do not store one, 0 to 1000 (default: 0)", true, true },
+		{ "overflow", "POLICY", "When processing falls behind the acquisition: block, drop-oldest or drop-newest (default: block)", false, true },
+		{ "output", "FORMAT", "Save the data after each run: none, text, binary or compressed (default: none)", false, false },
+		{ "output-path", "PATH", "File to save to; runs after the first get _<run> before the extension", false, false },
+		{ "log-level", "LEVEL", "Log messages shown: debug, info, warning, error or off (default: info)", false, false }
+	};
+
+	const size_t kMaxRunsPerOption = 100000; // Guards against ranges like 1:2147483647
+
+	const OptionDescription* findOption(const std::string& name)
+	{
+		for (const OptionDescription& option : kOptions)
+		{
+			if (name == option.name)
+				return &option;
+		}
+		return nullptr;
+	}
+
+	bool parseInt(const std::string& text, int& value)
+	{
+		const char* first = text.data();
+		const char* last = text.data() + text.size();
+		std::from_chars_result result = std::from_chars(first, last, value);
+		return result.ec == std::errc() && result.ptr == last;
+	}
+
+	// Parses a named choice, also accepting its index
+	bool parseChoice(const std::string& text, const std::vector<std::string>& choices, int& value)
+	{
+		for (size_t i = 0; i < choices.size(); i++)
+		{
+			if (text == choices[i])
+			{
+				value = (int)i;
+				return true;
+			}
+		}
+		return parseInt(text, value) && value >= 0 && value < (int)choices.size();
+	}
+
+	std::string trim(const std::string& text)
+	{
+		size_t first = text.find_first_not_of(" \t\r\n");
+		if (first == std::string::npos)
+			return std::string();
+		size_t last = text.find_last_not_of(" \t\r\n");
+		return text.substr(first, last - first + 1);
+	}
+}
+
+std::string RunConfiguration::describe() const
+{
+	static const char* kTimingNames[] = { "immediate", "periodic", "asynchronous" };
+	static const char* kTypeNames[] = { "linear", "sine", "random" };
+	static const char* kPacingNames[] = { "fast", "realtime", "scaled" };
+	static const char* kEngineNames[] = { "xoshiro", "pcg" };
+	static const char* kWindowNames[] = { "rectangular", "hann", "hamming", "blackman" };
+	static const char* kSampleTypeNames[] = { "double", "float", "int16", "int32" };
+	static const char* kOverflowNames[] = { "block", "drop-oldest", "drop-newest" };
+
+	std::ostringstream description;
+	if (dataSource == 1)
+	{
+		description << "replay " << replayPath << " (" << kPacingNames[replayPacing];
+		if (replayPacing == 2)
+			description << " x" << replaySpeedFactor;
+		description << ")";
+	}
+	else
+	{
+		description << numDataPoints << " points x " << numChannels << " channel(s), " << kTimingNames[dataTimingOption];
+		if (dataTimingOption == 1 && dataTimingPeriodUs != 0)
+			description << " " << dataTimingPeriodUs << " us";
+		else if (dataTimingOption == 1)
+			description << " " << dataTimingPeriod << " ms";
+		description << ", " << kTypeNames[dataType];
+		if (dataType != 1)
+			description << " [" << rangeMin << ", " << rangeMax << "]";
+		if (dataType == 2 || dataTimingOption == 2)
+			description << ", " << kEngineNames[randomEngine] << " seed " << seed;
+	}
+	description << ", window " << movingAverageWindowSize << ", subset " << subsetSize;
+	if (!filterChain.empty())
+		description << ", filter " << filterChain;
+	if (spectrumSize != 0)
+		description << ", spectrum " << spectrumSize << " " << kWindowNames[spectrumWindow];
+	if (percentiles == 0)
+		description << ", no percentiles";
+	if (zoomBuckets != 0)
+		description << ", zoom " << zoomBuckets;
+	if (threads != 1)
+		description << ", " << threads << " threads";
+	if (sampleType != eDoubleSamples)
+		description << ", " << kSampleTypeNames[sampleType] << " samples";
+	if (overflowPolicy != 0)
+		description << ", " << kOverflowNames[overflowPolicy];
+	return description.str();
+}
+
+std::uint64_t RunConfiguration::getSamplePeriodNs() const
+{
+	if (dataTimingPeriodUs != 0)
+		return (std::uint64_t)dataTimingPeriodUs * 1000; // Microseconds to nanoseconds
+	return (std::uint64_t)dataTimingPeriod * 1000000;    // Milliseconds to nanoseconds
+}
+
+RunConfigurationParser::RunConfigurationParser()
+	: m_helpRequested(false) // Only set by --help
+{
+	// Constructor body
+}
+
+RunConfigurationParser::~RunConfigurationParser()
+{
+	// Destructor body
+}
+
+bool RunConfigurationParser::parseArguments(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--help" || argument == "-h")
+		{
+			m_helpRequested = true;
+			return true;
+		}
+		if (argument.compare(0, 2, "--") != 0)
+		{
+			m_lastError = "unexpected argument '" + argument + "'";
+			return false;
+		}
+
+		// Accept both --name value and --name=value
+		std::string name = argument.substr(2);
+		std::string value;
+		size_t equals = name.find('=');
+		if (equals != std::string::npos)
+		{
+			value = name.substr(equals + 1);
+			name = name.substr(0, equals);
+		}
+		else if (i + 1 < argc)
+		{
+			value = argv[++i];
+		}
+		else
+		{
+			m_lastError = "option --" + name + " needs a value";
+			return false;
+		}
+
+		if (name == "config")
+		{
+			if (!parseFile(value))
+				return false;
+		}
+		else if (name == "csv")
+		{
+			m_csvPath = value;
+		}
+		else if (!addOption(m_overrides, name, value))
+		{
+			return false;
+		}
+	}
+
+	return expandRuns();
+}
+
+bool RunConfigurationParser::parseFile(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		m_lastError = "cannot open " + path;
+		return false;
+	}
+
+	OptionValues* current = &m_defaults; // Options before the first [run] apply to every group
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+		size_t comment = line.find('#');
+		if (comment != std::string::npos)
+			line.erase(comment);
+		line = trim(line);
+		if (line.empty())
+			continue;
+
+		if (line == "[run]")
+		{
+			m_groups.push_back(OptionValues());
+			current = &m_groups.back();
+			continue;
+		}
+
+		size_t equals = line.find('=');
+		if (equals == std::string::npos)
+		{
+			m_lastError = path + ":" + std::to_string(lineNumber) + ": expected name = value";
+			return false;
+		}
+		std::string name = trim(line.substr(0, equals));
+		std::string value = trim(line.substr(equals + 1));
+		if (name == "csv")
+		{
+			m_csvPath = value;
+			continue;
+		}
+		if (!addOption(*current, name, value))
+		{
+			m_lastError = path + ":" + std::to_string(lineNumber) + ": " + m_lastError;
+			return false;
+		}
+	}
+	return true;
+}
+
+const std::vector<RunConfiguration>& RunConfigurationParser::getRuns() const
+{
+	return m_runs;
+}
+
+const std::string& RunConfigurationParser::getCsvPath() const
+{
+	return m_csvPath;
+}
+
+bool RunConfigurationParser::isHelpRequested() const
+{
+	return m_helpRequested;
+}
+
+const std::string& RunConfigurationParser::getLastError() const
+{
+	return m_lastError;
+}
+
+std::string RunConfigurationParser::getUsage()
+{
+	std::ostringstream usage;
+	usage << "Usage: Sirius-Case-Study [options]\n"
+		<< "Without options the parameters are asked for interactively.\n\n"
+		<< "  --config PATH          Read options from a file (name = value lines, [run] starts a group of runs)\n"
+		<< "  --csv PATH             Write one summary row per run to a CSV file\n"
+		<< "  --help                 Show this text\n";
+	for (const OptionDescription& option : kOptions)
+	{
+		std::string flag = std::string("--") + option.name + " " + option.argument;
+		usage << "  " << flag << std::string(flag.size() < 23 ? 23 - flag.size() : 1, ' ') << option.description << "\n";
+	}
+	usage << "\nNumeric options accept lists and ranges (e.g. --points 1000,1000000 --window 3:101:2);\n"
+		<< "every combination of the given values is run.\n";
+	return usage.str();
+}
+
+bool RunConfigurationParser::addOption(OptionValues& values, const std::string& name, const std::string& value)
+{
+	const OptionDescription* option = findOption(name);
+	if (option == nullptr)
+	{
+		m_lastError = "unknown option --" + name;
+		return false;
+	}
+
+	std::vector<std::string> items;
+	if (!option->list)
+	{
+		items.push_back(value);
+	}
+	else
+	{
+		std::stringstream stream(value);
+		std::string item;
+		while (std::getline(stream, item, ','))
+		{
+			item = trim(item);
+			size_t colon = item.find(':');
+			if (!option->numeric || colon == std::string::npos)
+			{
+				items.push_back(item);
+				continue;
+			}
+
+			// Expand first:last or first:last:step
+			int first, last, step = 1;
+			size_t secondColon = item.find(':', colon + 1);
+			std::string lastText = item.substr(colon + 1, secondColon == std::string::npos ? std::string::npos : secondColon - colon - 1);
+			if (!parseInt(item.substr(0, colon), first) || !parseInt(lastText, last)
+				|| (secondColon != std::string::npos && !parseInt(item.substr(secondColon + 1), step))
+				|| step < 1 || first > last)
+			{
+				m_lastError = "invalid range '" + item + "' for --" + name;
+				return false;
+			}
+			for (long long v = first; v <= last; v += step)
+			{
+				if (items.size() >= kMaxRunsPerOption)
+				{
+					m_lastError = "range '" + item + "' for --" + name + " has too many values";
+					return false;
+				}
+				items.push_back(std::to_string(v));
+			}
+		}
+	}
+
+	if (items.empty())
+	{
+		m_lastError = "option --" + name + " needs a value";
+		return false;
+	}
+	values[name] = items; // A later occurrence replaces an earlier one
+	return true;
+}
+
+bool RunConfigurationParser::expandRuns()
+{
+	m_runs.clear();
+	std::vector<OptionValues> groups = m_groups;
+	if (groups.empty())
+		groups.push_back(OptionValues());
+
+	for (const OptionValues& group : groups)
+	{
+		// Later sources win: file defaults, then the group, then the command line
+		OptionValues merged = m_defaults;
+		for (const auto& entry : group)
+			merged[entry.first] = entry.second;
+		for (const auto& entry : m_overrides)
+			merged[entry.first] = entry.second;
+
+		// Walk every combination like an odometer, the last option turning fastest
+		std::vector<const std::vector<std::string>*> lists;
+		std::vector<std::string> names;
+		for (const OptionDescription& option : kOptions)
+		{
+			auto found = merged.find(option.name);
+			if (found != merged.end())
+			{
+				names.push_back(option.name);
+				lists.push_back(&found->second);
+			}
+		}
+
+		std::vector<size_t> positions(lists.size(), 0);
+		while (true)
+		{
+			RunConfiguration configuration;
+			for (size_t i = 0; i < lists.size(); i++)
+			{
+				if (!applyOption(configuration, names[i], (*lists[i])[positions[i]]))
+					return false;
+			}
+			if (!validate(configuration))
+			{
+				m_lastError = "run " + std::to_string(m_runs.size() + 1) + ": " + m_lastError;
+				return false;
+			}
+			m_runs.push_back(configuration);
+
+			size_t i = lists.size();
+			while (i > 0 && ++positions[i - 1] == lists[i - 1]->size())
+			{
+				positions[i - 1] = 0;
+				i--;
+			}
+			if (i == 0)
+				break;
+		}
+	}
+	return true;
+}
+
+bool RunConfigurationParser::applyOption(RunConfiguration& configuration, const std::string& name, const std::string& value)
+{
+	bool valid = true;
+	if (name == "source")
+		valid = parseChoice(value, { "sensor", "replay" }, configuration.dataSource);
+	else if (name == "points")
+		valid = parseInt(value, configuration.numDataPoints);
+	else if (name == "channels")
+		valid = parseInt(value, configuration.numChannels);
+	else if (name == "timing")
+		valid = parseChoice(value, { "immediate", "periodic", "asynchronous" }, configuration.dataTimingOption);
+	else if (name == "period")
+		valid = parseInt(value, configuration.dataTimingPeriod);
+	else if (name == "period-us")
+		valid = parseInt(value, configuration.dataTimingPeriodUs);
+	else if (name == "spin-us")
+		valid = parseInt(value, configuration.spinThresholdUs);
+	else if (name == "type")
+		valid = parseChoice(value, { "linear", "sine", "random" }, configuration.dataType);
+	else if (name == "min")
+		valid = parseInt(value, configuration.rangeMin);
+	else if (name == "max")
+		valid = parseInt(value, configuration.rangeMax);
+	else if (name == "seed")
+		valid = parseInt(value, configuration.seed);
+	else if (name == "rng")
+		valid = parseChoice(value, { "xoshiro", "pcg" }, configuration.randomEngine);
+	else if (name == "window")
+		valid = parseInt(value, configuration.movingAverageWindowSize);
+	else if (name == "subset")
+		valid = parseInt(value, configuration.subsetSize);
+	else if (name == "filter")
+		configuration.filterChain = value;
+	else if (name == "spectrum")
+		valid = parseInt(value, configuration.spectrumSize);
+	else if (name == "spectrum-window")
+		valid = parseChoice(value, { "rectangular", "hann", "hamming", "blackman" }, configuration.spectrumWindow);
+	else if (name == "percentiles")
+		valid = parseChoice(value, { "off", "on" }, configuration.percentiles);
+	else if (name == "zoom")
+		valid = parseInt(value, configuration.zoomBuckets);
+	else if (name == "threads")
+		valid = parseInt(value, configuration.threads);
+	else if (name == "sample-type")
+		valid = parseChoice(value, { "double", "float", "int16", "int32" }, configuration.sampleType);
+	else if (name == "replay")
+	{
+		configuration.replayPath = value;
+		configuration.dataSource = 1;
+	}
+	else if (name == "pacing")
+		valid = parseChoice(value, { "fast", "realtime", "scaled" }, configuration.replayPacing);
+	else if (name == "speed")
+		valid = parseInt(value, configuration.replaySpeedFactor);
+	else if (name == "replay-period")
+		valid = parseInt(value, configuration.replayPeriod);
+	else if (name == "overflow")
+		valid = parseChoice(value, { "block", "drop-oldest", "drop-newest" }, configuration.overflowPolicy);
+	else if (name == "output")
+		valid = parseChoice(value, { "none", "text", "binary", "compressed" }, configuration.outputFormat);
+	else if (name == "output-path")
+		configuration.outputPath = value;
+	else if (name == "log-level")
+		valid = parseChoice(value, { "debug", "info", "warning", "error", "off" }, configuration.logLevel);
+
+	if (!valid)
+		m_lastError = "invalid value '" + value + "' for --" + name;
+	return valid;
+}
+
+bool RunConfigurationParser::validate(const RunConfiguration& configuration)
+{
+	// The same limits as the interactive prompts, except for the number of data points
+	if (configuration.dataSource == 1)
+	{
+		if (configuration.replayPath.empty())
+			m_lastError = "--replay is required for the replay source";
+		else if (configuration.replaySpeedFactor < 1 || configuration.replaySpeedFactor > 1000)
+			m_lastError = "--speed must be between 1 and 1000";
+		else if (configuration.replayPeriod < 0 || configuration.replayPeriod > 1000)
+			m_lastError = "--replay-period must be between 0 and 1000";
+		else
+			m_lastError.clear();
+	}
+	else
+	{
+		if (configuration.numDataPoints < 1)
+			m_lastError = "--points must be at least 1";
+		else if (configuration.numChannels < 1)
+			m_lastError = "--channels must be at least 1";
+		else if (configuration.dataTimingOption == 1 && configuration.dataTimingPeriodUs == 0
+			&& (configuration.dataTimingPeriod < 100 || configuration.dataTimingPeriod > 1000))
+			m_lastError = "--period must be between 100 and 1000";
+		else if (configuration.dataTimingPeriodUs < 0 || configuration.dataTimingPeriodUs > 1000000)
+			m_lastError = "--period-us must be between 1 and 1000000";
+		else if (configuration.spinThresholdUs < 0 || configuration.spinThresholdUs > 10000)
+			m_lastError = "--spin-us must be between 0 and 10000";
+		else if (configuration.rangeMin < -1000 || configuration.rangeMax > 1000 || configuration.rangeMin >= configuration.rangeMax)
+			m_lastError = "--min must be lower than --max, both between -1000 and 1000";
+		else if (configuration.seed < 0)
+			m_lastError = "--seed must not be negative";
+		else
+			m_lastError.clear();
+	}
+
+	if (m_lastError.empty())
+	{
+		if (configuration.movingAverageWindowSize < 3 || configuration.movingAverageWindowSize > 101 || configuration.movingAverageWindowSize % 2 == 0)
+			m_lastError = "--window must be an odd number between 3 and 101";
+		else if (configuration.subsetSize < 1)
+			m_lastError = "--subset must be at least 1";
+		else if (configuration.spectrumSize != 0 && (configuration.spectrumSize < 16 || configuration.spectrumSize > 1048576
+			|| (configuration.spectrumSize & (configuration.spectrumSize - 1)) != 0))
+			m_lastError = "--spectrum must be 0 or a power of two between 16 and 1048576";
+		else if (configuration.zoomBuckets < 0 || configuration.zoomBuckets > 1000)
+			m_lastError = "--zoom must be between 0 and 1000";
+		else if (configuration.threads < 0 || configuration.threads > 256)
+			m_lastError = "--threads must be between 0 and 256";
+		else if (configuration.overflowPolicy < 0 || configuration.overflowPolicy > 2)
+			m_lastError = "--overflow must be block, drop-oldest or drop-newest";
+		else if (configuration.overflowPolicy != 0 && (configuration.dataSource == 1 ? configuration.replayPacing == 0
+			: configuration.numChannels != 1 || (configuration.dataTimingOption == 0 && configuration.threads != 1)))
+			m_lastError = "--overflow only applies to runs that hand the data points over through a buffer: paced replays and single-channel sensor runs, except immediate ones with --threads";
+	}
+	if (m_lastError.empty())
+	{
+		FilterChain chain;
+		if (!chain.parse(configuration.filterChain))
+			m_lastError = "--filter: " + chain.getLastError();
+	}
+	return m_lastError.empty();
+}
@@ -0,0 +1,189 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Represents how the data of a run is saved.
+ */
+enum OutputFormat
+{
+	eNoOutput = 0, ///< The data is not saved.
+	eTextOutput,   ///< The data is saved as a text file.
+	eBinaryOutput, ///< The data is saved as a binary capture.
+	eCompressedOutput ///< The data is saved as a binary capture with compressed columns.
+};
+
+/**
+ * @brief Represents the type the samples of a run are stored and processed in.
+ */
+enum SampleType
+{
+	eDoubleSamples = 0, ///< 64-bit floating point values.
+	eFloatSamples,      ///< 32-bit floating point values.
+	eInt16Samples,      ///< 16-bit ADC counts scaled to the range of the data.
+	eInt32Samples       ///< 32-bit ADC counts scaled to the range of the data.
+};
+
+/**
+ * @brief Every parameter of one run, as collected by UserInputHandler or parsed from the command line.
+ *
+ * The enumerations are stored as integers like in UserInputHandler: `dataTimingOption` is a
+ * DataGenerationTiming, `dataType` a DataType, `randomEngine` a RandomEngineType, `replayPacing`
+ * a ReplayPacing, `spectrumWindow` a SpectralWindow, `overflowPolicy` an OverflowPolicy, `outputFormat` an OutputFormat, `sampleType` a SampleType and `logLevel` a LogLevel. `dataSource` is 0 for the sensor and 1 for a replay.
+ */
+struct RunConfiguration
+{
+	int numDataPoints = 1000;           ///< The number of data points to generate per channel.
+	int numChannels = 1;                ///< The number of sensor channels.
+	int dataTimingOption = 0;           ///< The data generation timing.
+	int dataTimingPeriod = 100;         ///< The period in milliseconds for periodic timing.
+	int dataTimingPeriodUs = 0;         ///< The period in microseconds for periodic timing; overrides dataTimingPeriod if not 0.
+	int spinThresholdUs = 100;          ///< The busy-wait tail before each deadline of the paced modes in microseconds.
+	int dataType = 0;                   ///< The type of generated data.
+	int rangeMin = -100;                ///< The minimum value for linear and random data.
+	int rangeMax = 100;                 ///< The maximum value for linear and random data.
+	int seed = 1;                       ///< The random seed; channel i of a run uses seed + i.
+	int randomEngine = 0;               ///< The random number generator, a RandomEngineType.
+	int movingAverageWindowSize = 3;    ///< The moving average window size (odd).
+	int subsetSize = 100;               ///< The number of data points per subset average.
+	std::string filterChain;            ///< The filter stages after the moving average, in the syntax of `FilterChain::parse`.
+	int spectrumSize = 0;               ///< The segment size of the power spectrum of the raw data, 0 if disabled.
+	int spectrumWindow = 1;             ///< The window of the spectrum segments, a SpectralWindow (eHannWindow).
+	int percentiles = 1;                ///< 1 to estimate the percentiles of the raw and processed data, 0 to skip them.
+	int zoomBuckets = 0;                ///< The number of buckets of the zoomed-out overview printed after the run, 0 if disabled.
+	int threads = 1;                    ///< The threads processing large batches of single-channel data, 0 for one per hardware thread.
+	int sampleType = eDoubleSamples;    ///< The type the samples are stored and processed in.
+	int dataSource = 0;                 ///< 0 for the sensor, 1 for a replay.
+	std::string replayPath;             ///< The capture to replay.
+	int replayPacing = 0;               ///< How fast the capture is replayed.
+	int replaySpeedFactor = 1;          ///< The speed-up for scaled replay pacing.
+	int replayPeriod = 0;               ///< The sample period in milliseconds for captures that do not store one.
+	int overflowPolicy = 0;             ///< What the acquisition buffer does when processing falls behind (eBlock).
+	int outputFormat = eNoOutput;       ///< How the data is saved after the run.
+	std::string outputPath;             ///< Where the data is saved, empty for output.txt or output.cap.
+	int logLevel = 1;                   ///< The lowest level of the log messages shown during the run (eLogInfo).
+
+	/**
+ * @brief Describes the run in one line, e.g. for a progress message.
+ *
+ * @return The parameters that matter for the selected data source.
+ */
+	std::string describe() const;
+	/**
+ * @brief Retrieves the period of periodic timing.
+ *
+ * @return `dataTimingPeriodUs` if set, otherwise `dataTimingPeriod`, in nanoseconds.
+ */
+	std::uint64_t getSamplePeriodNs() const;
+};
+
+/**
+ * @brief Builds the list of runs from command-line options and configuration files.
+ *
+ * Every option is written `--name value` (or `--name=value`) on the command line and `name = value`
+ * in a configuration file, where `#` starts a comment. A `[run]` line in a file starts a new group of
+ * runs; options before the first group apply to every group and command-line options override both.
+ *
+ * Numeric options accept lists and ranges, e.g. `--points 1000,1000000` or `--window 3:101:2`, and
+ * every combination of the listed values becomes one run, so whole scaling sweeps execute in a
+ * single process.
+ */
+class RunConfigurationParser
+{
+public:
+	RunConfigurationParser();
+	~RunConfigurationParser();
+
+	/**
+ * @brief Parses the command line.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments, argv[0] being the program name.
+ * @return True if every option is known and every resulting run is valid; otherwise `getLastError` describes the problem.
+ */
+	bool parseArguments(int argc, char* argv[]);
+	/**
+ * @brief Parses a configuration file.
+ *
+ * @param path The path of the configuration file.
+ * @return True if the file could be read and every option is known.
+ */
+	bool parseFile(const std::string& path);
+
+	/**
+ * @brief Retrieves the runs described by the parsed options.
+ *
+ * @return One configuration per combination of option values, in order.
+ */
+	const std::vector<RunConfiguration>& getRuns() const;
+	/**
+ * @brief Retrieves the path of the CSV file receiving one summary row per run.
+ *
+ * @return The path, empty if no summary is requested.
+ */
+	const std::string& getCsvPath() const;
+	/**
+ * @brief Checks whether the usage text was requested.
+ *
+ * @return True if `--help` was given.
+ */
+	bool isHelpRequested() const;
+	/**
+ * @brief Retrieves the description of the last error.
+ *
+ * @return The error message of the last failed parse.
+ */
+	const std::string& getLastError() const;
+	/**
+ * @brief Retrieves the usage text listing every option.
+ *
+ * @return The usage text.
+ */
+	static std::string getUsage();
+
+private:
+
+	typedef std::map<std::string, std::vector<std::string>> OptionValues;
+
+	OptionValues m_defaults;              // Options given in a file before its first [run] group
+	std::vector<OptionValues> m_groups;   // Options of each [run] group
+	OptionValues m_overrides;             // Options given on the command line
+	std::vector<RunConfiguration> m_runs; // The expanded runs
+	std::string m_csvPath;                // Where the per-run summary is written
+	bool m_helpRequested;                 // Set by --help
+	std::string m_lastError;              // Description of the last error
+
+	/**
+ * @brief Records one option value, expanding lists and ranges.
+ *
+ * @param values The option set receiving the value.
+ * @param name The option name without dashes.
+ * @param value The option value as written.
+ * @return True if the option is known and the value is well formed.
+ */
+	bool addOption(OptionValues& values, const std::string& name, const std::string& value);
+	/**
+ * @brief Expands the parsed option groups into m_runs and validates every run.
+ *
+ * @return True if every run is valid.
+ */
+	bool expandRuns();
+	/**
+ * @brief Applies one option value to a run configuration.
+ *
+ * @param configuration The configuration to update.
+ * @param name The option name.
+ * @param value A single option value.
+ * @return True if the value is valid for the option.
+ */
+	bool applyOption(RunConfiguration& configuration, const std::string& name, const std::string& value);
+	/**
+ * @brief Checks the constraints between the parameters of a run.
+ *
+ * @param configuration The configuration to check.
+ * @return True if the configuration can be run.
+ */
+	bool validate(const RunConfiguration& configuration);
+};
@@ -0,0 +1,676 @@
+#include "RunModes.h"
+#include "AcquisitionPipeline.h"
+#include "Logger.h"
+#include "ReplaySource.h"
+#include "Sensor.h"
+#include "ThreadPool.h"
+#include "UserInputHandler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @brief Retrieves the physical value of one count of an integer sample type.
+ *
+ * The counts span the largest magnitude the sensor generates: the range for LINEAR and RANDOM data, 1 for SINE data.
+ *
+ * @param configuration The run configuration describing the sensor.
+ * @return The scale; 1.0 for floating point samples.
+ */
+template <typename T>
+static double getSampleScale(const RunConfiguration& configuration)
+{
+	if constexpr (std::is_floating_point_v<T>)
+		return 1.0;
+	double fullScale = configuration.dataType == SINE ? 1.0 : (double)std::max(std::abs(configuration.rangeMin), std::abs(configuration.rangeMax));
+	return fullScale / (double)std::numeric_limits<T>::max();
+}
+
+/**
+ * @brief Creates a sensor configured from the run configuration.
+ *
+ * @param configuration The run configuration describing the sensor.
+ * @param seed The seed of the sensor's random number generators.
+ * @return The sensor.
+ */
+template <typename T>
+static std::unique_ptr<BasicSensor<T>> createSensor(const RunConfiguration& configuration, std::uint64_t seed)
+{
+	std::unique_ptr<BasicSensor<T>> sensor(new BasicSensor<T>(configuration.numDataPoints,
+											  (DataGenerationTiming)configuration.dataTimingOption,
+											  configuration.dataTimingPeriod,
+											  (DataType)configuration.dataType,
+											  configuration.rangeMin,
+											  configuration.rangeMax,
+											  seed,
+											  getSampleScale<T>(configuration)));
+	sensor->setRandomEngine(createRandomEngine((RandomEngineType)configuration.randomEngine, seed));
+	sensor->setSamplePeriod(configuration.getSamplePeriodNs());
+	sensor->setSpinThreshold((std::uint64_t)configuration.spinThresholdUs * 1000); // Microseconds to nanoseconds
+	return sensor;
+}
+
+/**
+ * @brief Creates a data processor configured from the run configuration.
+ *
+ * @param configuration The run configuration describing the processing; its filter chain has been validated.
+ * @param workspace The workspace the processor's buffers are taken from, nullptr to allocate them directly.
+ * @param threadPool The pool processing large data in parallel chunks, nullptr to process on the calling thread.
+ * @return The data processor.
+ */
+template <typename T>
+static std::unique_ptr<BasicDataProcessor<T>> createProcessor(const RunConfiguration& configuration, std::shared_ptr<Workspace> workspace,
+	std::shared_ptr<ThreadPool> threadPool = nullptr)
+{
+	std::unique_ptr<BasicDataProcessor<T>> processor(new BasicDataProcessor<T>(configuration.movingAverageWindowSize, configuration.subsetSize,
+		getSampleScale<T>(configuration)));
+	processor->setWorkspace(std::move(workspace));
+	processor->setThreadPool(std::move(threadPool));
+	processor->setQuantileSketchesEnabled(configuration.percentiles != 0);
+	processor->setSummaryIndexEnabled(configuration.zoomBuckets > 0);
+	FilterChain chain;
+	chain.parse(configuration.filterChain);
+	processor->setFilterChain(std::move(chain));
+	if (configuration.spectrumSize > 0)
+		processor->setSpectrumAnalyzer(std::unique_ptr<SpectrumAnalyzer>(
+			new SpectrumAnalyzer((size_t)configuration.spectrumSize, (SpectralWindow)configuration.spectrumWindow)));
+	return processor;
+}
+
+template <typename T>
+ChannelStatistics runFleet(const RunConfiguration& configuration, std::shared_ptr<Workspace> workspace)
+{
+	BasicSensorFleet<T> fleet; // One worker per hardware thread
+
+	for (int i = 0; i < configuration.numChannels; i++)
+	{
+		// Every channel draws from its own generator and seed, so the channels neither share state nor repeat each other
+		std::unique_ptr<BasicSensor<T>> sensor = createSensor<T>(configuration, (std::uint64_t)configuration.seed + i);
+		sensor->setName("Channel " + std::to_string(i));
+		fleet.addChannel(std::move(sensor), createProcessor<T>(configuration, workspace));
+	}
+	fleet.run();
+	getLogger().flush(); // Let the progress messages out before the table
+
+	// Output per-channel statistics for both raw and processed data in a table format
+	std::cout << "\n------------------------------------------ Channel Statistics ------------------------------------------\n";
+	std::cout << std::setw(10) << std::left << "Channel"
+		<< std::setw(14) << std::left << "Points"
+		<< std::setw(14) << std::left << "Raw Min"
+		<< std::setw(14) << std::left << "Raw Max"
+		<< std::setw(14) << std::left << "Raw Avg"
+		<< std::setw(14) << std::left << "Proc Min"
+		<< std::setw(14) << std::left << "Proc Max"
+		<< std::setw(14) << std::left << "Proc Avg"
+		<< "\n";
+	std::cout << "--------------------------------------------------------------------------------------------------------\n";
+
+	for (size_t i = 0; i < fleet.getChannelCount(); i++)
+	{
+		const ChannelStatistics& statistics = fleet.getChannelStatistics(i);
+		std::cout << std::setw(10) << std::left << i
+			<< std::setw(14) << statistics.numDataPoints
+			<< std::setw(14) << statistics.rawMin
+			<< std::setw(14) << statistics.rawMax
+			<< std::setw(14) << statistics.rawAverage
+			<< std::setw(14) << statistics.processedMin
+			<< std::setw(14) << statistics.processedMax
+			<< std::setw(14) << statistics.processedAverage
+			<< "\n";
+	}
+
+	std::cout << "--------------------------------------------------------------------------------------------------------\n";
+	std::cout << fleet.getChannelCount() << " channels on " << fleet.getThreadCount() << " threads in "
+		<< fleet.getElapsedSeconds() << " s (" << fleet.getThroughput() << " data points/s)\n";
+
+	// Every channel has the same number of data points, so the overall averages are the means of the channel averages
+	ChannelStatistics summary = fleet.getChannelStatistics(0);
+	for (size_t i = 1; i < fleet.getChannelCount(); i++)
+	{
+		const ChannelStatistics& statistics = fleet.getChannelStatistics(i);
+		summary.numDataPoints += statistics.numDataPoints;
+		summary.rawMin = std::min(summary.rawMin, statistics.rawMin);
+		summary.rawMax = std::max(summary.rawMax, statistics.rawMax);
+		summary.rawAverage += statistics.rawAverage;
+		summary.processedMin = std::min(summary.processedMin, statistics.processedMin);
+		summary.processedMax = std::max(summary.processedMax, statistics.processedMax);
+		summary.processedAverage += statistics.processedAverage;
+		summary.jitterMeanNs += statistics.jitterMeanNs;
+		summary.jitterP99Ns = std::max(summary.jitterP99Ns, statistics.jitterP99Ns);
+		summary.jitterMaxNs = std::max(summary.jitterMaxNs, statistics.jitterMaxNs);
+	}
+	summary.jitterMeanNs /= (double)fleet.getChannelCount();
+	summary.rawAverage /= (double)fleet.getChannelCount();
+	summary.processedAverage /= (double)fleet.getChannelCount();
+
+	// Percentiles do not combine like averages, but the sketches of the channels merge into one of all data points
+	if (fleet.getProcessor(0).getRawQuantiles() != nullptr)
+	{
+		QuantileSketch raw(fleet.getProcessor(0).getRawQuantiles()->getK());
+		QuantileSketch processed(raw.getK());
+		for (size_t i = 0; i < fleet.getChannelCount(); i++)
+		{
+			raw.merge(*fleet.getProcessor(i).getRawQuantiles());
+			processed.merge(*fleet.getProcessor(i).getProcessedQuantiles());
+		}
+		setPercentiles(summary, &raw, &processed);
+		std::cout << "Percentiles of all channels: raw p50 " << summary.rawP50 << ", p95 " << summary.rawP95 << ", p99 " << summary.rawP99
+			<< "; processed p50 " << summary.processedP50 << ", p95 " << summary.processedP95 << ", p99 " << summary.processedP99 << "\n";
+	}
+	summary.elapsedSeconds = fleet.getElapsedSeconds();
+	return summary;
+}
+
+/**
+ * @brief Prints the statistics of the raw and processed data in a table format.
+ *
+ * @param processor The data processor holding the results of a capture.
+ */
+template <typename T>
+static void printStatistics(const BasicDataProcessor<T>& processor)
+{
+	// Output statistics for both raw and processed data in a table format
+	std::cout << "\n------------------------- Data Statistics -------------------------\n";
+	std::cout << std::setw(25) << std::left << "Statistic"
+		<< std::setw(15) << std::left << "Raw Data"
+		<< std::setw(15) << std::left << "Processed Data"
+		<< "\n";
+	std::cout << "---------------------------------------------------------------\n";
+
+	// Number of data points
+	std::cout << std::setw(25) << std::left << "Number of data points"
+		<< std::setw(15) << processor.getRawData().size()
+		<< std::setw(15) << processor.getProcessedData().size()
+		<< "\n";
+
+	// Minimum value
+	std::cout << std::setw(25) << std::left << "Minimum value"
+		<< std::setw(15) << processor.getRawDataMin()
+		<< std::setw(15) << processor.getProcessedDataMin()
+		<< "\n";
+
+	// Maximum value
+	std::cout << std::setw(25) << std::left << "Maximum value"
+		<< std::setw(15) << processor.getRawDataMax()
+		<< std::setw(15) << processor.getProcessedDataMax()
+		<< "\n";
+
+	// Average value
+	std::cout << std::setw(25) << std::left << "Average value"
+		<< std::setw(15) << processor.getRawAverage()
+		<< std::setw(15) << processor.getProcessedAverage()
+		<< "\n";
+
+	// Estimated percentiles, from bounded-memory sketches rather than a sort of the data
+	const QuantileSketch* raw = processor.getRawQuantiles();
+	const QuantileSketch* processed = processor.getProcessedQuantiles();
+	if (raw != nullptr && processed != nullptr)
+	{
+		const double kFractions[] = { 0.5, 0.95, 0.99 };
+		const char* const kLabels[] = { "50th percentile", "95th percentile", "99th percentile" };
+		for (int i = 0; i < 3; i++)
+		{
+			std::cout << std::setw(25) << std::left << kLabels[i]
+				<< std::setw(15) << raw->getQuantile(kFractions[i])
+				<< std::setw(15) << processed->getQuantile(kFractions[i])
+				<< "\n";
+		}
+	}
+
+	std::cout << "-----------------------------------------------------------------\n";
+}
+
+/**
+ * @brief Prints a zoomed-out overview of the raw and processed data.
+ *
+ * Each line summarizes one bucket of consecutive data points, read from the summary indexes in
+ * O(log N) per bucket rather than by scanning the data.
+ *
+ * @param processor The data processor holding the results of a capture.
+ * @param bucketCount The number of buckets, 0 to print nothing.
+ */
+template <typename T>
+static void printOverview(const BasicDataProcessor<T>& processor, int bucketCount)
+{
+	const SummaryPyramid* rawIndex = processor.getRawSummaryIndex();
+	const SummaryPyramid* processedIndex = processor.getProcessedSummaryIndex();
+	if (bucketCount <= 0 || rawIndex == nullptr || rawIndex->size() == 0)
+		return;
+
+	std::vector<DataStatistics> raw;
+	std::vector<DataStatistics> processed;
+	size_t size = rawIndex->size();
+	size_t buckets = std::min((size_t)bucketCount, size);
+	rawIndex->downsample(0, size, buckets, raw);
+	processedIndex->downsample(0, size, buckets, processed);
+
+	std::cout << "\n---------------------------- Overview ---------------------------\n";
+	std::cout << std::setw(25) << std::left << "Data points"
+		<< std::setw(12) << std::left << "Raw min"
+		<< std::setw(12) << std::left << "Raw avg"
+		<< std::setw(12) << std::left << "Raw max"
+		<< std::setw(12) << std::left << "Processed avg"
+		<< "\n";
+	for (size_t i = 0; i < buckets; i++)
+	{
+		std::ostringstream range;
+		range << i * size / buckets << "-" << (i + 1) * size / buckets - 1;
+		std::cout << std::setw(25) << std::left << range.str()
+			<< std::setw(12) << raw[i].min
+			<< std::setw(12) << raw[i].sum / (double)raw[i].count
+			<< std::setw(12) << raw[i].max;
+		if (processed[i].count > 0)
+			std::cout << processed[i].sum / (double)processed[i].count;
+		std::cout << "\n";
+	}
+	std::cout << "-----------------------------------------------------------------\n";
+}
+
+/**
+ * @brief Prints the dominant frequency and the band energies of the raw data.
+ *
+ * The spectrum is split into four bands of equal width between DC and half the sample rate.
+ *
+ * @param processor The data processor holding the results of a capture.
+ * @param sampleRate The number of data points per second, 0 if unknown; frequencies are then given in cycles per data point.
+ */
+template <typename T>
+static void printSpectrum(const BasicDataProcessor<T>& processor, double sampleRate)
+{
+	const SpectrumAnalyzer* analyzer = processor.getSpectrumAnalyzer();
+	if (analyzer == nullptr)
+		return;
+
+	std::cout << "\n--------------------------- Spectrum ----------------------------\n";
+	if (analyzer->getSegmentCount() == 0)
+	{
+		std::cout << "Fewer than " << analyzer->getSegmentSize() << " data points, no spectrum\n";
+		std::cout << "-----------------------------------------------------------------\n";
+		return;
+	}
+
+	double rate = sampleRate > 0.0 ? sampleRate : 1.0;
+	const char* unit = sampleRate > 0.0 ? " Hz" : " cycles/point";
+	std::cout << std::setw(25) << std::left << "Segments" << analyzer->getSegmentCount() << " x "
+		<< analyzer->getSegmentSize() << " points, " << getSpectralWindowName(analyzer->getWindow()) << " window\n";
+	std::cout << std::setw(25) << std::left << "Resolution" << analyzer->getBinFrequency(1, rate) << unit << "\n";
+	std::cout << std::setw(25) << std::left << "Dominant frequency" << analyzer->getDominantFrequency(rate) << unit << "\n";
+	std::cout << std::setw(25) << std::left << "Total power" << analyzer->getTotalEnergy() << "\n";
+
+	double nyquist = 0.5 * rate;
+	for (int band = 0; band < 4; band++)
+	{
+		double low = nyquist * band / 4.0;
+		double high = nyquist * (band + 1) / 4.0;
+		// Bin centers on a shared edge belong to the lower band only
+		double energy = analyzer->getBandEnergy(band == 0 ? low : std::nextafter(low, high), high, rate);
+		std::ostringstream label;
+		label << "Band " << low << "-" << high;
+		std::cout << std::setw(25) << std::left << label.str() << energy << "\n";
+	}
+	std::cout << "-----------------------------------------------------------------\n";
+}
+
+/**
+ * @brief Prints how closely a paced capture kept its schedule.
+ *
+ * @param jitter The lateness of every data point against its deadline.
+ * @param samples The processed data points with their timestamps and sequence numbers, may have no timing.
+ * @param periodNs The nominal sample period, 0 if the schedule is not periodic.
+ */
+template <typename T>
+static void printTiming(const JitterHistogram& jitter, const BasicSampleBuffer<T>& samples, std::uint64_t periodNs)
+{
+	std::cout << "\n---------------------------- Timing -----------------------------\n";
+	double rate = samples.getAverageRate();
+	if (periodNs > 0 && rate > 0.0)
+	{
+		// Deadlines are absolute, so the achieved period matches the nominal one however late single data points are
+		std::cout << std::setw(25) << std::left << "Nominal period" << (double)periodNs / 1000.0 << " us\n";
+		std::cout << std::setw(25) << std::left << "Achieved period" << 1e6 / rate << " us\n";
+	}
+	if (samples.hasTiming())
+		std::cout << std::setw(25) << std::left << "Missing data points" << samples.countSequenceGaps() << "\n";
+	std::cout << std::setw(25) << std::left << "Lateness mean" << jitter.getMean() / 1000.0 << " us (std dev "
+		<< jitter.getStandardDeviation() / 1000.0 << " us)\n";
+	std::cout << std::setw(25) << std::left << "Lateness min / max" << (double)jitter.getMin() / 1000.0 << " / "
+		<< (double)jitter.getMax() / 1000.0 << " us\n";
+	std::cout << std::setw(25) << std::left << "Lateness p50/p99/p99.9" << "<" << (double)jitter.getPercentile(0.5) / 1000.0
+		<< " / <" << (double)jitter.getPercentile(0.99) / 1000.0 << " / <" << (double)jitter.getPercentile(0.999) / 1000.0 << " us\n";
+
+	// One line per non-empty power-of-two bucket
+	std::cout << "\nLateness histogram:\n";
+	for (int bucket = 0; bucket < JitterHistogram::kBucketCount; bucket++)
+	{
+		long long count = jitter.getBucketCount(bucket);
+		if (count == 0)
+			continue;
+		std::string range = bucket == 0 ? std::string("0 ns") : bucket == JitterHistogram::kBucketCount - 1
+			? ">= " + std::to_string(JitterHistogram::getBucketUpperBound(bucket - 1)) + " ns"
+			: "< " + std::to_string(JitterHistogram::getBucketUpperBound(bucket)) + " ns";
+		int width = (int)(50.0 * (double)count / (double)jitter.getCount() + 0.5);
+		std::cout << "  " << std::setw(16) << std::left << range << std::setw(12) << std::right << count
+			<< "  " << std::string(width, '#') << std::left << "\n";
+	}
+	std::cout << "-----------------------------------------------------------------\n";
+}
+
+/**
+ * @brief Prints how many data points a dropping overflow policy discarded.
+ *
+ * @param droppedCount The number of data points the acquisition buffer discarded.
+ * @param configuration The run configuration; nothing is printed for eBlock, which never drops.
+ */
+static void printDropped(size_t droppedCount, const RunConfiguration& configuration)
+{
+	if (configuration.overflowPolicy == eBlock)
+		return;
+	std::cout << std::setw(25) << std::left << "Dropped data points" << droppedCount << "\n";
+}
+
+/**
+ * @brief Adds the lateness of a paced capture to its summary.
+ *
+ * @param summary The summary to complete.
+ * @param jitter The lateness of every data point against its deadline.
+ */
+static void addTiming(ChannelStatistics& summary, const JitterHistogram& jitter)
+{
+	summary.jitterMeanNs = jitter.getMean();
+	summary.jitterP99Ns = (double)jitter.getPercentile(0.99);
+	summary.jitterMaxNs = (double)jitter.getMax();
+}
+
+/**
+ * @brief Summarizes the results held by a data processor.
+ *
+ * @param processor The data processor holding the results of a capture.
+ * @param elapsedSeconds The wall-clock time the capture took.
+ * @return The statistics of the capture.
+ */
+template <typename T>
+static ChannelStatistics summarize(const BasicDataProcessor<T>& processor, double elapsedSeconds)
+{
+	ChannelStatistics summary = ChannelStatistics();
+	summary.numDataPoints = processor.getRawData().size();
+	summary.rawMin = processor.getRawDataMin();
+	summary.rawMax = processor.getRawDataMax();
+	summary.rawAverage = processor.getRawAverage();
+	summary.processedMin = processor.getProcessedDataMin();
+	summary.processedMax = processor.getProcessedDataMax();
+	summary.processedAverage = processor.getProcessedAverage();
+	setPercentiles(summary, processor.getRawQuantiles(), processor.getProcessedQuantiles());
+	summary.elapsedSeconds = elapsedSeconds;
+	return summary;
+}
+
+template <typename T>
+ChannelStatistics runSensor(const RunConfiguration& configuration, BasicDataProcessor<T>& processor)
+{
+	// Create an instance of the Sensor class with parameters passed from the run configuration
+	std::unique_ptr<BasicSensor<T>> sensor = createSensor<T>(configuration, (std::uint64_t)configuration.seed);
+
+	auto start = std::chrono::steady_clock::now();
+	size_t droppedCount = 0; // Only the streamed capture hands the data points over through a buffer
+	if (configuration.dataTimingOption == eImmediate && configuration.threads != 1)
+	{
+		// Nothing paces an immediate capture, so with more than one thread it is generated first and processed as
+		// one batch, whose moving average and statistics are split over the data processor's thread pool
+		sensor->collectAndStoreDataPoints();
+		processor.setRawData(sensor->releaseSamples());
+		processor.movingAverageFilter();
+		processor.calculateStatistics();
+		processor.calculateSpectrum();
+	}
+	else
+	{
+		// Acquire on a producer thread and process on a consumer thread: each data point is handed over through a
+		// ring buffer and the moving average filter, the averages and the subset averages (for both raw and
+		// processed data) are updated as soon as it arrives
+		BasicAcquisitionPipeline<T> pipeline(*sensor, processor, 4096, (OverflowPolicy)configuration.overflowPolicy);
+		pipeline.run();
+		droppedCount = pipeline.getDroppedCount();
+	}
+	double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	getLogger().flush(); // Let the progress messages out before the statistics
+
+	printStatistics(processor);
+	printDropped(droppedCount, configuration);
+	printSpectrum(processor, configuration.dataTimingOption == ePeriodic ? 1e9 / (double)configuration.getSamplePeriodNs() : 0.0);
+	printOverview(processor, configuration.zoomBuckets);
+	ChannelStatistics summary = summarize(processor, elapsedSeconds);
+	if (configuration.dataTimingOption != eImmediate)
+	{
+		std::uint64_t periodNs = configuration.dataTimingOption == ePeriodic ? configuration.getSamplePeriodNs() : 0;
+		printTiming(sensor->getJitterHistogram(), processor.getRawSamples(), periodNs);
+		addTiming(summary, sensor->getJitterHistogram());
+	}
+	return summary;
+}
+
+template <typename T>
+bool runReplay(const RunConfiguration& configuration, BasicDataProcessor<T>& processor, ChannelStatistics& summary)
+{
+	BasicReplaySource<T> source((ReplayPacing)configuration.replayPacing, (double)configuration.replaySpeedFactor);
+	if (!source.load(configuration.replayPath))
+	{
+		std::cout << "Failed to load the capture: " << source.getLastError() << "\n";
+		return false;
+	}
+	processor.setScale(source.getScale()); // Counts recorded by another run keep the scale they were recorded with
+	if (source.getSamplePeriod() == 0)
+		source.setSamplePeriod((std::uint64_t)configuration.replayPeriod * 1000000); // Milliseconds to nanoseconds
+
+	double elapsedSeconds;
+	size_t droppedCount = 0; // Only a paced replay hands the data points over through a buffer
+	if (configuration.replayPacing == eAsFastAsPossible)
+	{
+		auto start = std::chrono::steady_clock::now();
+		processor.setRawData(source.getSamples(), source.getTimestamps(), source.getSequences());
+		processor.movingAverageFilter();
+		processor.calculateStatistics();
+		processor.calculateSpectrum();
+		elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+	else
+	{
+		BasicAcquisitionPipeline<T> pipeline(source, processor, 4096, (OverflowPolicy)configuration.overflowPolicy);
+		pipeline.run();
+		elapsedSeconds = source.getElapsedSeconds();
+		getLogger().flush(); // Let the progress messages out before the statistics
+		droppedCount = pipeline.getDroppedCount();
+	}
+
+	printStatistics(processor);
+	printDropped(droppedCount, configuration);
+	printSpectrum(processor, source.getSamplePeriod() > 0 ? 1e9 / (double)source.getSamplePeriod() : 0.0);
+	printOverview(processor, configuration.zoomBuckets);
+	size_t numDataPoints = source.getSamples().size();
+	std::cout << "Replayed " << numDataPoints << " data points in " << elapsedSeconds << " s ("
+		<< (elapsedSeconds > 0.0 ? (double)numDataPoints / elapsedSeconds : 0.0) << " data points/s)\n";
+	summary = summarize(processor, elapsedSeconds);
+	if (source.getJitterHistogram().getCount() > 0)
+	{
+		printTiming(source.getJitterHistogram(), processor.getRawSamples(), 0);
+		addTiming(summary, source.getJitterHistogram());
+	}
+	return true;
+}
+
+/**
+ * @brief Builds the output path of one run of a batch.
+ *
+ * @param configuration The run configuration.
+ * @param runIndex The zero-based index of the run.
+ * @return The configured path (or output.txt/output.cap), with _<run> inserted before the extension after the first run.
+ */
+static std::string getOutputPath(const RunConfiguration& configuration, size_t runIndex)
+{
+	std::string path = configuration.outputPath;
+	if (path.empty())
+		path = configuration.outputFormat == eTextOutput ? "output.txt" : "output.cap";
+	if (runIndex == 0)
+		return path;
+
+	size_t dot = path.find_last_of('.');
+	size_t slash = path.find_last_of("/\\");
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+		dot = path.size();
+	return path.substr(0, dot) + "_" + std::to_string(runIndex + 1) + path.substr(dot);
+}
+
+/**
+ * @brief Executes one run of a batch in a sample type, prints its statistics and saves its data.
+ *
+ * @param configuration The run configuration.
+ * @param runIndex The zero-based index of the run.
+ * @param workspace The workspace the processors' buffers are taken from.
+ * @param threadPool The pool processing large data in parallel chunks, nullptr to process on the calling thread.
+ * @param summary Receives the statistics of the run.
+ * @param exitCode Set to 1 if the run or saving its data fails.
+ * @return False if the run could not be carried out and has no statistics.
+ */
+template <typename T>
+static bool executeRun(const RunConfiguration& configuration, size_t runIndex, std::shared_ptr<Workspace> workspace,
+	std::shared_ptr<ThreadPool> threadPool, ChannelStatistics& summary, int& exitCode)
+{
+	// A fresh processor per run, released as soon as the run has been summarized
+	std::unique_ptr<BasicDataProcessor<T>> processor = createProcessor<T>(configuration, workspace, threadPool);
+	if (configuration.dataSource == 1)
+	{
+		if (!runReplay(configuration, *processor, summary))
+		{
+			exitCode = 1;
+			return false;
+		}
+	}
+	else if (configuration.numChannels > 1)
+	{
+		summary = runFleet<T>(configuration, workspace);
+	}
+	else
+	{
+		summary = runSensor(configuration, *processor);
+	}
+	if constexpr (!std::is_same_v<T, double>)
+	{
+		std::cout << SampleTraits<T>::kName << " samples, " << sizeof(T) << " bytes per data point";
+		if (!std::is_floating_point_v<T>)
+			std::cout << ", " << processor->getScale() << " per count";
+		std::cout << "\n";
+	}
+
+	// Fleet runs keep their data inside the fleet, so only single-channel runs are saved
+	if (configuration.outputFormat != eNoOutput && configuration.numChannels == 1)
+	{
+		std::string path = getOutputPath(configuration, runIndex);
+		double scale = processor->getScale();
+		double ratio = 0.0;
+		bool saved = configuration.outputFormat == eCompressedOutput
+			? UserInputHandler::writeCompressedFile(path, processor->getRawSamples(), processor->getProcessedData(), configuration, &ratio, scale)
+			: configuration.outputFormat == eBinaryOutput
+			? UserInputHandler::writeBinaryFile(path, processor->getRawSamples(), processor->getProcessedData(), configuration, scale)
+			: UserInputHandler::writeTextFile(path, processor->getRawSamples(), processor->getProcessedData(), scale);
+		if (saved && ratio > 0.0)
+			std::cout << "Data has been saved to '" << path << "', compressed " << ratio << " times.\n";
+		else if (saved)
+			std::cout << "Data has been saved to '" << path << "'.\n";
+		else
+		{
+			std::cout << "Failed to save the data to '" << path << "'.\n";
+			exitCode = 1;
+		}
+	}
+	return true;
+}
+
+int runBatch(const RunConfigurationParser& parser)
+{
+	const std::vector<RunConfiguration>& runs = parser.getRuns();
+
+	std::ofstream csvFile;
+	if (!parser.getCsvPath().empty())
+	{
+		csvFile.open(parser.getCsvPath());
+		if (!csvFile.is_open())
+		{
+			std::cout << "Failed to open " << parser.getCsvPath() << " for writing.\n";
+			return 1;
+		}
+		csvFile << "run,source,points,channels,timing,period,period_us,spin_us,type,min,max,seed,rng,window,subset,pacing,speed,"
+			<< "total_points,elapsed_s,points_per_s,raw_min,raw_max,raw_avg,processed_min,processed_max,processed_avg,"
+			<< "jitter_mean_ns,jitter_p99_ns,jitter_max_ns,raw_p50,raw_p95,raw_p99,processed_p50,processed_p95,processed_p99,sample_type\n";
+		csvFile << std::setprecision(17);
+	}
+
+	// Shared by every run, so a sweep allocates the data buffers of its largest run once
+	std::shared_ptr<Workspace> workspace(new Workspace());
+	std::shared_ptr<ThreadPool> threadPool; // Kept while consecutive runs ask for the same number of threads
+	size_t poolThreads = 1;
+
+	int exitCode = 0;
+	for (size_t i = 0; i < runs.size(); i++)
+	{
+		const RunConfiguration& configuration = runs[i];
+		std::cout << "\n=== Run " << (i + 1) << "/" << runs.size() << ": " << configuration.describe() << " ===\n";
+		getLogger().setLevel((LogLevel)configuration.logLevel);
+
+		// The calling thread processes a chunk too, so the pool holds one thread less than requested.
+		// Fleet runs already spread their channels over the hardware threads and stay single-threaded per channel.
+		size_t threads = configuration.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : (size_t)configuration.threads;
+		if (configuration.numChannels > 1 && configuration.dataSource == 0)
+			threads = 1;
+		if (threads != poolThreads)
+		{
+			threadPool = threads > 1 ? std::shared_ptr<ThreadPool>(new ThreadPool(threads - 1)) : nullptr;
+			poolThreads = threads;
+		}
+
+		ChannelStatistics summary = ChannelStatistics();
+		bool ran = configuration.sampleType == eFloatSamples ? executeRun<float>(configuration, i, workspace, threadPool, summary, exitCode)
+			: configuration.sampleType == eInt16Samples ? executeRun<std::int16_t>(configuration, i, workspace, threadPool, summary, exitCode)
+			: configuration.sampleType == eInt32Samples ? executeRun<std::int32_t>(configuration, i, workspace, threadPool, summary, exitCode)
+			: executeRun<double>(configuration, i, workspace, threadPool, summary, exitCode);
+		if (!ran)
+			continue;
+
+		if (csvFile.is_open())
+		{
+			double rate = summary.elapsedSeconds > 0.0 ? (double)summary.numDataPoints / summary.elapsedSeconds : 0.0;
+			csvFile << (i + 1) << "," << (configuration.dataSource == 1 ? "replay" : "sensor") << ","
+				<< configuration.numDataPoints << "," << configuration.numChannels << ","
+				<< configuration.dataTimingOption << "," << configuration.dataTimingPeriod << ","
+				<< configuration.dataTimingPeriodUs << "," << configuration.spinThresholdUs << ","
+				<< configuration.dataType << "," << configuration.rangeMin << "," << configuration.rangeMax << ","
+				<< configuration.seed << "," << configuration.randomEngine << ","
+				<< configuration.movingAverageWindowSize << "," << configuration.subsetSize << ","
+				<< configuration.replayPacing << "," << configuration.replaySpeedFactor << ","
+				<< summary.numDataPoints << "," << summary.elapsedSeconds << "," << rate << ","
+				<< summary.rawMin << "," << summary.rawMax << "," << summary.rawAverage << ","
+				<< summary.processedMin << "," << summary.processedMax << "," << summary.processedAverage << ","
+				<< summary.jitterMeanNs << "," << summary.jitterP99Ns << "," << summary.jitterMaxNs << ","
+				<< summary.rawP50 << "," << summary.rawP95 << "," << summary.rawP99 << ","
+				<< summary.processedP50 << "," << summary.processedP95 << "," << summary.processedP99 << ","
+				<< configuration.sampleType << "\n";
+		}
+	}
+
+	std::ostringstream message;
+	message << "Workspace: " << workspace->getAllocationCount() << " buffer allocations, " << workspace->getReuseCount()
+		<< " reuses, " << (double)workspace->getPooledBytes() / 1048576.0 << " MB pooled";
+	getLogger().log(eLogInfo, message.str());
+	getLogger().flush();
+	return exitCode;
+}
+
+// The run modes that Sirius-Case-Study.cpp calls directly; runBatch uses every sample type
+template ChannelStatistics runFleet<double>(const RunConfiguration&, std::shared_ptr<Workspace>);
+template ChannelStatistics runSensor(const RunConfiguration&, BasicDataProcessor<double>&);
+template bool runReplay(const RunConfiguration&, BasicDataProcessor<double>&, ChannelStatistics&);
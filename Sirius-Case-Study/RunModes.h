@@ -0,0 +1,57 @@
+#pragma once
+#include <memory>
+#include "DataProcessor.h"
+#include "RunConfiguration.h"
+#include "SensorFleet.h"
+#include "Workspace.h"
+
+/**
+ * @brief Runs one capture per sensor channel on a thread pool and prints the per-channel statistics.
+ *
+ * Every channel gets its own sensor and data processor configured from the run configuration.
+ *
+ * @tparam T The sample type the channels store and process their data points in.
+ * @param configuration The run configuration describing the channels.
+ * @param workspace The workspace the processors' buffers are taken from, nullptr to allocate them directly.
+ * @return The statistics of all channels combined and the wall-clock time of the run.
+ */
+template <typename T = double>
+ChannelStatistics runFleet(const RunConfiguration& configuration, std::shared_ptr<Workspace> workspace);
+
+/**
+ * @brief Runs a single sensor channel through the acquisition pipeline and prints the statistics.
+ *
+ * The sensor generates its data points in the processor's sample type, quantized with the processor's scale.
+ *
+ * @param configuration The run configuration describing the sensor and the processing.
+ * @param processor The data processor to feed.
+ * @return The statistics of the capture.
+ */
+template <typename T>
+ChannelStatistics runSensor(const RunConfiguration& configuration, BasicDataProcessor<T>& processor);
+
+/**
+ * @brief Replays a saved capture through a data processor and prints the statistics.
+ *
+ * As-fast-as-possible replays copy the whole capture into the processor once, with its recorded
+ * timing, and process it in one batch; paced replays stream it through the same acquisition
+ * pipeline as a live sensor.
+ *
+ * The data points are converted to the processor's sample type unless the capture already stores them
+ * in it, and the processor takes over the scale of the replayed counts.
+ *
+ * @param configuration The run configuration describing the replay.
+ * @param processor The data processor to feed.
+ * @param summary Receives the statistics of the replay.
+ * @return True if the capture could be loaded.
+ */
+template <typename T>
+bool runReplay(const RunConfiguration& configuration, BasicDataProcessor<T>& processor, ChannelStatistics& summary);
+
+/**
+ * @brief Executes every run described on the command line without asking anything.
+ *
+ * @param parser The parsed command line.
+ * @return The process exit code: 0 if every run succeeded.
+ */
+int runBatch(const RunConfigurationParser& parser);
@@ -0,0 +1,136 @@
+#include "RunningMedian.h"
+#include <algorithm>
+#include <functional>
+
+RunningMedian::RunningMedian(int windowSize)
+	: m_windowSize(std::max(windowSize, 1)), // Data points per window
+	  m_position(0),                         // No data point seen yet
+	  m_lowerCount(0),
+	  m_upperCount(0),
+	  m_inLower((size_t)std::max(windowSize, 1), 0)
+{
+	m_lower.reserve((size_t)m_windowSize * 2 + 1);
+	m_upper.reserve((size_t)m_windowSize * 2 + 1);
+}
+
+RunningMedian::~RunningMedian()
+{
+	// Destructor body
+}
+
+void RunningMedian::process(std::span<double> block)
+{
+	for (double& value : block)
+		value = push(value);
+}
+
+void RunningMedian::reset()
+{
+	m_position = 0;
+	m_lower.clear();
+	m_upper.clear();
+	m_lowerCount = 0;
+	m_upperCount = 0;
+}
+
+std::string RunningMedian::describe() const
+{
+	return "median:" + std::to_string(m_windowSize);
+}
+
+double RunningMedian::push(double value)
+{
+	std::uint64_t position = m_position++;
+	size_t windowSize = (size_t)m_windowSize;
+
+	// The data point leaving the window is only counted out; its entry is dropped when it surfaces
+	if (position >= windowSize)
+	{
+		if (m_inLower[(position - windowSize) % windowSize])
+			m_lowerCount--;
+		else
+			m_upperCount--;
+	}
+
+	pruneTops();
+	size_t slot = (size_t)(position % windowSize);
+	if (m_lower.empty() || value <= m_lower.front().first)
+	{
+		m_lower.push_back(Entry(value, position));
+		std::push_heap(m_lower.begin(), m_lower.end());
+		m_inLower[slot] = 1;
+		m_lowerCount++;
+	}
+	else
+	{
+		m_upper.push_back(Entry(value, position));
+		std::push_heap(m_upper.begin(), m_upper.end(), std::greater<Entry>());
+		m_inLower[slot] = 0;
+		m_upperCount++;
+	}
+
+	rebalance();
+
+	// Bound the memory held by expired entries that have not surfaced yet
+	if (m_lower.size() > 2 * windowSize)
+		compact(m_lower, true);
+	if (m_upper.size() > 2 * windowSize)
+		compact(m_upper, false);
+
+	if (m_lowerCount > m_upperCount)
+		return m_lower.front().first;
+	return 0.5 * (m_lower.front().first + m_upper.front().first);
+}
+
+void RunningMedian::pruneTops()
+{
+	while (!m_lower.empty() && isExpired(m_lower.front()))
+	{
+		std::pop_heap(m_lower.begin(), m_lower.end());
+		m_lower.pop_back();
+	}
+	while (!m_upper.empty() && isExpired(m_upper.front()))
+	{
+		std::pop_heap(m_upper.begin(), m_upper.end(), std::greater<Entry>());
+		m_upper.pop_back();
+	}
+}
+
+void RunningMedian::rebalance()
+{
+	size_t windowSize = (size_t)m_windowSize;
+	while (m_lowerCount > m_upperCount + 1)
+	{
+		pruneTops();
+		std::pop_heap(m_lower.begin(), m_lower.end());
+		Entry entry = m_lower.back();
+		m_lower.pop_back();
+		m_upper.push_back(entry);
+		std::push_heap(m_upper.begin(), m_upper.end(), std::greater<Entry>());
+		m_inLower[(size_t)(entry.second % windowSize)] = 0;
+		m_lowerCount--;
+		m_upperCount++;
+	}
+	while (m_lowerCount < m_upperCount)
+	{
+		pruneTops();
+		std::pop_heap(m_upper.begin(), m_upper.end(), std::greater<Entry>());
+		Entry entry = m_upper.back();
+		m_upper.pop_back();
+		m_lower.push_back(entry);
+		std::push_heap(m_lower.begin(), m_lower.end());
+		m_inLower[(size_t)(entry.second % windowSize)] = 1;
+		m_upperCount--;
+		m_lowerCount++;
+	}
+	pruneTops(); // The tops are the median candidates
+}
+
+void RunningMedian::compact(std::vector<Entry>& heap, bool lower)
+{
+	heap.erase(std::remove_if(heap.begin(), heap.end(), [this](const Entry& entry) { return isExpired(entry); }), heap.end());
+	if (lower)
+		std::make_heap(heap.begin(), heap.end());
+	else
+		std::make_heap(heap.begin(), heap.end(), std::greater<Entry>());
+}
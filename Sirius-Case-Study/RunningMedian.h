@@ -0,0 +1,73 @@
+#pragma once
+#include "FilterStage.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Running median over the last `windowSize` data points.
+ *
+ * The window is split into two heaps: a max-heap holding the lower half and a min-heap holding
+ * the upper half, so the median is at their tops. A data point leaving the window is not searched
+ * for; it is only counted out of its heap and discarded once it reaches a top (lazy deletion).
+ * Each data point therefore costs O(log windowSize), and the heaps are compacted when stale
+ * entries make up half of them. Until the window has filled, the median of the data points seen
+ * so far is returned. Unlike averaging filters, the median removes isolated spikes completely.
+ */
+class RunningMedian final : public FilterStage
+{
+public:
+	/**
+ * @brief Constructs a RunningMedian object.
+ *
+ * @param windowSize The number of data points the median is taken over, at least 1.
+ */
+	RunningMedian(int windowSize);
+	~RunningMedian();
+
+	void process(std::span<double> block) override;
+	void reset() override;
+	std::string describe() const override;
+
+private:
+
+	typedef std::pair<double, std::uint64_t> Entry; // A value and the position of its data point
+
+	int m_windowSize;                  // The number of data points in a full window
+	std::uint64_t m_position;          // The position of the next data point
+	std::vector<Entry> m_lower;        // Max-heap of the lower half, may contain expired entries
+	std::vector<Entry> m_upper;        // Min-heap of the upper half, may contain expired entries
+	int m_lowerCount;                  // The number of live entries in m_lower
+	int m_upperCount;                  // The number of live entries in m_upper
+	std::vector<unsigned char> m_inLower; // Per window slot: whether the live entry is in m_lower
+
+	/**
+ * @brief Adds a data point, expires the oldest one and returns the median of the window.
+ *
+ * @param value The new data point.
+ * @return The median of the window.
+ */
+	double push(double value);
+	/**
+ * @brief Pops expired entries off the tops of both heaps.
+ */
+	void pruneTops();
+	/**
+ * @brief Moves entries between the heaps until the lower half holds as many or one more live entries.
+ */
+	void rebalance();
+	/**
+ * @brief Removes every expired entry from a heap and restores the heap order.
+ *
+ * @param heap The heap to compact.
+ * @param lower True for the max-heap of the lower half.
+ */
+	void compact(std::vector<Entry>& heap, bool lower);
+	/**
+ * @brief Checks whether an entry has left the window.
+ *
+ * @param entry The heap entry.
+ * @return True if it is older than the last `m_windowSize` data points.
+ */
+	bool isExpired(const Entry& entry) const { return entry.second + (std::uint64_t)m_windowSize < m_position; }
+};
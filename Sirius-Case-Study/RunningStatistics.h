@@ -0,0 +1,84 @@
+#pragma once
+#include "CompensatedSum.h"
+#include <limits>
+
+/**
+ * @brief Incrementally tracks the count, sum, minimum and maximum of a sequence of samples.
+ *
+ * Every update costs O(1), so the statistics of a capture are available at any point while
+ * it is still being acquired. The sum is Neumaier-compensated to keep long runs accurate.
+ */
+class RunningStatistics
+{
+public:
+	RunningStatistics()
+		: m_count(0),
+		  m_min(std::numeric_limits<double>::infinity()),
+		  m_max(-std::numeric_limits<double>::infinity())
+	{
+	}
+
+	/**
+ * @brief Adds a sample to the statistics.
+ *
+ * @param value The sample to add.
+ */
+	void add(double value)
+	{
+		m_count++;
+		m_sum.add(value);
+		if (value < m_min)
+			m_min = value;
+		if (value > m_max)
+			m_max = value;
+	}
+
+	/**
+ * @brief Retrieves the number of samples added so far.
+ *
+ * @return The sample count.
+ */
+	long long getCount() const { return m_count; }
+	/**
+ * @brief Retrieves the compensated sum of the samples added so far.
+ *
+ * @return The sum of the samples.
+ */
+	double getSum() const { return m_sum.getValue(); }
+	/**
+ * @brief Retrieves the mean of the samples added so far.
+ *
+ * @return The mean, or 0.0 if no samples have been added.
+ */
+	double getMean() const { return m_count > 0 ? m_sum.getValue() / (double)m_count : 0.0; }
+	/**
+ * @brief Retrieves the smallest sample added so far.
+ *
+ * @return The minimum, or +infinity if no samples have been added.
+ */
+	double getMin() const { return m_min; }
+	/**
+ * @brief Retrieves the largest sample added so far.
+ *
+ * @return The maximum, or -infinity if no samples have been added.
+ */
+	double getMax() const { return m_max; }
+
+	/**
+ * @brief Clears all statistics.
+ */
+	void reset()
+	{
+		m_count = 0;
+		m_sum.reset();
+		m_min = std::numeric_limits<double>::infinity();
+		m_max = -std::numeric_limits<double>::infinity();
+	}
+
+private:
+
+	long long m_count;    // The number of samples added
+	CompensatedSum m_sum; // The compensated sum of the samples
+	double m_min;         // The smallest sample added
+	double m_max;         // The largest sample added
+};
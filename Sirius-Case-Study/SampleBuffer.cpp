@@ -0,0 +1,117 @@
+#include "SampleBuffer.h"
+#include <algorithm>
+
+template <typename T>
+BasicSampleBuffer<T>::BasicSampleBuffer()
+{
+	// Constructor body
+}
+
+template <typename T>
+BasicSampleBuffer<T>::~BasicSampleBuffer()
+{
+	// Destructor body
+}
+
+template <typename T>
+void BasicSampleBuffer<T>::reserve(size_t capacity)
+{
+	m_values.reserve(capacity);
+	m_timestamps.reserve(capacity);
+	m_sequences.reserve(capacity);
+}
+
+template <typename T>
+void BasicSampleBuffer<T>::clear()
+{
+	m_values.clear();
+	m_timestamps.clear();
+	m_sequences.clear();
+}
+
+template <typename T>
+size_t BasicSampleBuffer<T>::capacity() const
+{
+	return std::min(m_values.capacity(), std::min(m_timestamps.capacity(), m_sequences.capacity()));
+}
+
+template <typename T>
+bool BasicSampleBuffer<T>::hasTiming() const
+{
+	return !m_values.empty() && m_timestamps.size() == m_values.size();
+}
+
+template <typename T>
+BasicSample<T> BasicSampleBuffer<T>::operator[](size_t index) const
+{
+	if (!hasTiming())
+		return BasicSample<T>{ 0, m_values[index], 0 };
+	return BasicSample<T>{ m_timestamps[index], m_values[index], m_sequences[index] };
+}
+
+template <typename T>
+void BasicSampleBuffer<T>::assignValues(std::span<const T> values)
+{
+	m_values.assign(values.begin(), values.end());
+	m_timestamps.clear();
+	m_sequences.clear();
+}
+
+template <typename T>
+void BasicSampleBuffer<T>::adoptValues(std::vector<T>&& values)
+{
+	// Take over the provided buffer instead of copying it
+	m_values = std::move(values);
+	values.clear();
+	m_timestamps.clear();
+	m_sequences.clear();
+}
+
+template <typename T>
+void BasicSampleBuffer<T>::append(std::span<const T> values, std::span<const std::uint64_t> timestamps, std::span<const std::uint32_t> sequences)
+{
+	m_values.insert(m_values.end(), values.begin(), values.end());
+	m_timestamps.insert(m_timestamps.end(), timestamps.begin(), timestamps.end());
+	m_sequences.insert(m_sequences.end(), sequences.begin(), sequences.end());
+}
+
+template <typename T>
+std::vector<T> BasicSampleBuffer<T>::releaseValues()
+{
+	std::vector<T> values = std::move(m_values);
+	clear();
+	return values;
+}
+
+template <typename T>
+std::uint64_t BasicSampleBuffer<T>::countSequenceGaps() const
+{
+	if (!hasTiming())
+		return 0;
+
+	// Unsigned differences keep working across a wrap-around of the 32-bit sequence
+	std::uint64_t missing = 0;
+	for (size_t i = 1; i < m_sequences.size(); i++)
+	{
+		std::uint32_t step = m_sequences[i] - m_sequences[i - 1];
+		if (step > 1 && step < 0x80000000u)
+			missing += step - 1;
+	}
+	return missing;
+}
+
+template <typename T>
+double BasicSampleBuffer<T>::getAverageRate() const
+{
+	if (!hasTiming() || m_timestamps.size() < 2 || m_timestamps.back() <= m_timestamps.front())
+		return 0.0;
+
+	double spanNs = (double)(m_timestamps.back() - m_timestamps.front());
+	return (double)(m_timestamps.size() - 1) * 1e9 / spanNs;
+}
+
+// The sample types the kernels support
+template class BasicSampleBuffer<double>;
+template class BasicSampleBuffer<float>;
+template class BasicSampleBuffer<std::int16_t>;
+template class BasicSampleBuffer<std::int32_t>;
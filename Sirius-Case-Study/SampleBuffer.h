@@ -0,0 +1,174 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief A single timestamped data point.
+ *
+ * This is the record handed from a data source to its consumers (24 bytes for double samples, so it
+ * fits the SpscRingBuffer in three words; 16 bytes for 16-bit counts). Stored data points are kept
+ * column by column in a BasicSampleBuffer.
+ *
+ * @tparam T The sample type: double, float, std::int16_t or std::int32_t (see SampleTraits).
+ */
+template <typename T>
+struct BasicSample
+{
+	std::uint64_t timestampNs; ///< Monotonic (steady clock) time the data point was taken, in nanoseconds.
+	T value;                   ///< The measured value, in counts for integer samples.
+	std::uint32_t sequence;    ///< Position of the data point in its source's sequence; a jump marks lost data points.
+};
+
+using Sample = BasicSample<double>;
+
+/**
+ * @brief Stores timestamped data points as a structure of arrays.
+ *
+ * The values, timestamps and sequence numbers are kept in three separate contiguous arrays, so the
+ * numeric kernels walk a dense array of samples and never load timing data they do not use. The
+ * values are stored in their native width: 16-bit counts take a quarter of the memory of doubles.
+ * The timing columns are either as long as the values or empty: data that was set from plain
+ * values (e.g. a text capture) has no timing.
+ *
+ * @tparam T The sample type: double, float, std::int16_t or std::int32_t (see SampleTraits).
+ */
+template <typename T>
+class BasicSampleBuffer
+{
+public:
+	BasicSampleBuffer();
+	~BasicSampleBuffer();
+
+	BasicSampleBuffer(const BasicSampleBuffer&) = default;
+	BasicSampleBuffer& operator=(const BasicSampleBuffer&) = default;
+	BasicSampleBuffer(BasicSampleBuffer&&) = default;            // Declared explicitly: the destructor would otherwise turn moves into copies
+	BasicSampleBuffer& operator=(BasicSampleBuffer&&) = default;
+
+	/**
+ * @brief Appends a data point with its timing.
+ *
+ * Appending to a buffer that holds values without timing is not allowed.
+ *
+ * @param sample The data point.
+ */
+	void push(const BasicSample<T>& sample)
+	{
+		m_values.push_back(sample.value);
+		m_timestamps.push_back(sample.timestampNs);
+		m_sequences.push_back(sample.sequence);
+	}
+	/**
+ * @brief Reserves storage in every column.
+ *
+ * @param capacity The number of data points to make room for.
+ */
+	void reserve(size_t capacity);
+	/**
+ * @brief Removes all data points, keeping the storage.
+ */
+	void clear();
+	/**
+ * @brief Retrieves the number of data points the buffer holds without reallocating.
+ *
+ * @return The smallest capacity of the three columns.
+ */
+	size_t capacity() const;
+	/**
+ * @brief Retrieves the number of data points.
+ *
+ * @return The number of stored values.
+ */
+	size_t size() const { return m_values.size(); }
+	/**
+ * @brief Checks whether the buffer holds no data points.
+ *
+ * @return True if there are no values.
+ */
+	bool empty() const { return m_values.empty(); }
+	/**
+ * @brief Checks whether the data points carry timestamps and sequence numbers.
+ *
+ * @return True if the buffer is non-empty and its timing columns are filled.
+ */
+	bool hasTiming() const;
+	/**
+ * @brief Reassembles a data point from the columns.
+ *
+ * @param index The index of the data point.
+ * @return The data point; timestamp and sequence are 0 without timing.
+ */
+	BasicSample<T> operator[](size_t index) const;
+
+	/**
+ * @brief Retrieves the values column.
+ *
+ * @return A view of the values, contiguous for the numeric kernels.
+ */
+	std::span<const T> getValues() const { return m_values; }
+	/**
+ * @brief Retrieves the timestamps column.
+ *
+ * @return A view of the timestamps in nanoseconds, empty without timing.
+ */
+	std::span<const std::uint64_t> getTimestamps() const { return m_timestamps; }
+	/**
+ * @brief Retrieves the sequence numbers column.
+ *
+ * @return A view of the sequence numbers, empty without timing.
+ */
+	std::span<const std::uint32_t> getSequences() const { return m_sequences; }
+
+	/**
+ * @brief Replaces the contents with a copy of plain values that have no timing.
+ *
+ * @param values The new values.
+ */
+	void assignValues(std::span<const T> values);
+	/**
+ * @brief Replaces the contents with plain values that have no timing, without copying them.
+ *
+ * @param values The new values, left empty on return.
+ */
+	void adoptValues(std::vector<T>&& values);
+	/**
+ * @brief Appends a block of data points, e.g. one decoded from a CompressedSampleStore.
+ *
+ * The timing spans are either as long as the values or empty; values without timing may only be
+ * appended to a buffer without timing.
+ *
+ * @param values The values.
+ * @param timestamps The timestamps in nanoseconds, or empty.
+ * @param sequences The sequence numbers, or empty.
+ */
+	void append(std::span<const T> values, std::span<const std::uint64_t> timestamps, std::span<const std::uint32_t> sequences);
+	/**
+ * @brief Moves the values column out of the buffer and clears the timing columns.
+ *
+ * @return The values.
+ */
+	std::vector<T> releaseValues();
+
+	/**
+ * @brief Counts the data points missing from the sequence.
+ *
+ * @return The sum of all forward jumps of the sequence numbers beyond 1, 0 without timing.
+ */
+	std::uint64_t countSequenceGaps() const;
+	/**
+ * @brief Computes the rate at which the data points were taken.
+ *
+ * @return The number of data points per second between the first and last timestamp,
+ *         0 without timing or with fewer than two data points.
+ */
+	double getAverageRate() const;
+
+private:
+
+	std::vector<T> m_values;                 // The values of the data points, read by the numeric kernels
+	std::vector<std::uint64_t> m_timestamps; // The monotonic time of every data point in nanoseconds
+	std::vector<std::uint32_t> m_sequences;  // The sequence number of every data point
+};
+
+using SampleBuffer = BasicSampleBuffer<double>;
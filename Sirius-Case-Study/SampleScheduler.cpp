@@ -0,0 +1,69 @@
+#include "SampleScheduler.h"
+#include <thread>
+
+SampleScheduler::SampleScheduler(std::uint64_t spinThresholdNs)
+	: m_origin(std::chrono::steady_clock::now()), // Restarted by start
+	  m_spinThresholdNs(spinThresholdNs)          // Busy-wait tail before each deadline
+{
+	// Constructor body
+}
+
+SampleScheduler::~SampleScheduler()
+{
+	// Destructor body
+}
+
+void SampleScheduler::start()
+{
+	m_jitter.reset();
+	m_origin = std::chrono::steady_clock::now();
+}
+
+std::uint64_t SampleScheduler::waitUntil(std::uint64_t deadlineNs)
+{
+	auto deadline = m_origin + std::chrono::nanoseconds(deadlineNs);
+	auto now = std::chrono::steady_clock::now();
+	if (now < deadline)
+	{
+		// Sleep through most of the wait, then spin so that the wake-up latency of the sleep does not add up
+		auto spin = std::chrono::nanoseconds(m_spinThresholdNs);
+		if (deadline - now > spin)
+			std::this_thread::sleep_until(deadline - spin);
+		now = std::chrono::steady_clock::now();
+		while (now < deadline)
+			now = std::chrono::steady_clock::now();
+	}
+
+	m_jitter.add(std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline).count());
+	return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_origin).count();
+}
+
+std::uint64_t SampleScheduler::getElapsed() const
+{
+	return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_origin).count();
+}
+
+std::uint64_t SampleScheduler::getOriginTimestamp() const
+{
+	return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(m_origin.time_since_epoch()).count();
+}
+
+std::uint64_t SampleScheduler::getTimestamp()
+{
+	return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SampleScheduler::setSpinThreshold(std::uint64_t spinThresholdNs)
+{
+	m_spinThresholdNs = spinThresholdNs;
+}
+
+std::uint64_t SampleScheduler::getSpinThreshold() const
+{
+	return m_spinThresholdNs;
+}
+
+const JitterHistogram& SampleScheduler::getJitterHistogram() const
+{
+	return m_jitter;
+}
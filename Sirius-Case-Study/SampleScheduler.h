@@ -0,0 +1,88 @@
+#pragma once
+#include "JitterHistogram.h"
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Waits for absolute deadlines on the steady clock, so that periodic sampling does not drift.
+ *
+ * Deadlines are offsets from the moment `start` was called. Because every deadline is absolute, the
+ * time spent generating, handing over and logging a data point does not delay the following ones;
+ * a late data point only shortens the next wait. `waitUntil` sleeps until shortly before the
+ * deadline and busy-waits the remaining spin threshold, which trades some CPU time for
+ * microsecond accuracy (the operating system's sleep typically overshoots by 50 us or more).
+ * The lateness of every deadline goes into a JitterHistogram.
+ */
+class SampleScheduler
+{
+public:
+	static const std::uint64_t kDefaultSpinThresholdNs = 100000; ///< The default busy-wait tail (100 us).
+
+	/**
+ * @brief Constructs a SampleScheduler object.
+ *
+ * @param spinThresholdNs How long before each deadline to stop sleeping and start busy-waiting,
+ *        in nanoseconds; 0 only sleeps (default: kDefaultSpinThresholdNs).
+ */
+	SampleScheduler(std::uint64_t spinThresholdNs = kDefaultSpinThresholdNs);
+	~SampleScheduler();
+
+	/**
+ * @brief Sets the time origin of the deadlines to now and clears the jitter histogram.
+ */
+	void start();
+	/**
+ * @brief Waits until a deadline and records how late it returned.
+ *
+ * Returns at once if the deadline has already passed.
+ *
+ * @param deadlineNs The deadline in nanoseconds after `start`.
+ * @return The time `waitUntil` returned, in nanoseconds after `start`.
+ */
+	std::uint64_t waitUntil(std::uint64_t deadlineNs);
+	/**
+ * @brief Retrieves the time since `start`.
+ *
+ * @return The elapsed time in nanoseconds.
+ */
+	std::uint64_t getElapsed() const;
+	/**
+ * @brief Retrieves the time `start` was called on the steady clock.
+ *
+ * Adding the result of `waitUntil` gives a timestamp comparable with `getTimestamp`.
+ *
+ * @return The time origin of the deadlines in nanoseconds since the steady clock's epoch.
+ */
+	std::uint64_t getOriginTimestamp() const;
+	/**
+ * @brief Reads the steady clock.
+ *
+ * @return The current monotonic time in nanoseconds since the steady clock's epoch.
+ */
+	static std::uint64_t getTimestamp();
+
+	/**
+ * @brief Sets the busy-wait tail.
+ *
+ * @param spinThresholdNs The spin threshold in nanoseconds, 0 to only sleep.
+ */
+	void setSpinThreshold(std::uint64_t spinThresholdNs);
+	/**
+ * @brief Retrieves the busy-wait tail.
+ *
+ * @return The spin threshold in nanoseconds.
+ */
+	std::uint64_t getSpinThreshold() const;
+	/**
+ * @brief Retrieves the lateness of every deadline since `start`.
+ *
+ * @return The jitter histogram.
+ */
+	const JitterHistogram& getJitterHistogram() const;
+
+private:
+
+	std::chrono::steady_clock::time_point m_origin; // The time `start` was called
+	std::uint64_t m_spinThresholdNs;                // The busy-wait tail before each deadline
+	JitterHistogram m_jitter;                       // The lateness of the deadlines
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include "CompensatedSum.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Describes how a sample type is stored, accumulated and converted to physical units.
+ *
+ * Floating point samples hold physical values directly. Integer samples hold ADC counts, and a
+ * count times the scale of the channel (e.g. volts per count) is the physical value. Every
+ * specialization provides:
+ * - `Accumulator`: the type sums of samples are kept in. Integer sums are exact in 64 bits. Float
+ *   sums are kept in double, so long captures do not lose the low-order bits.
+ * - `Sum`: the running sum of the kernels, over `Accumulator`. Double samples use a CompensatedSum,
+ *   as the double kernels always have; the sums of the other types are exact or far wider than the
+ *   samples and use a plain RunningSum.
+ * - `ChunkAccumulator` and `kChunkSize`: a narrower type that holds the exact sum of up to
+ *   `kChunkSize` samples. It lets the compiler pack more samples into each vector register: 16-bit
+ *   counts are summed in 32-bit lanes, twice as many per instruction as 64-bit lanes.
+ * - `kName`: the name used on the command line.
+ * - `quantize`: converts a physical value to a sample, rounding to the nearest count and saturating
+ *   at the limits of integer types.
+ * - `toValue`: converts a sample or an accumulated sum back to physical units.
+ * - `fromAverage`: converts an average of samples, in counts, back to a sample. Integer averages are
+ *   rounded to the nearest count; moving averages of odd windows have no ties.
+ */
+template <typename T>
+struct SampleTraits;
+
+template <>
+struct SampleTraits<double>
+{
+	using Accumulator = double;
+	using Sum = CompensatedSum;
+	using ChunkAccumulator = double;
+	static constexpr size_t kChunkSize = std::numeric_limits<size_t>::max();
+	static constexpr const char* kName = "double";
+
+	static double quantize(double value, double) { return value; }
+	static double toValue(double sample, double) { return sample; }
+	static double fromAverage(double average) { return average; }
+};
+
+template <>
+struct SampleTraits<float>
+{
+	using Accumulator = double;
+	using Sum = RunningSum<double>;
+	using ChunkAccumulator = double;
+	static constexpr size_t kChunkSize = std::numeric_limits<size_t>::max();
+	static constexpr const char* kName = "float";
+
+	static float quantize(double value, double) { return (float)value; }
+	static double toValue(double sample, double) { return sample; }
+	static float fromAverage(double average) { return (float)average; }
+};
+
+template <>
+struct SampleTraits<std::int16_t>
+{
+	using Accumulator = std::int64_t;
+	using Sum = RunningSum<std::int64_t>;
+	using ChunkAccumulator = std::int32_t;
+	static constexpr size_t kChunkSize = 65535; ///< 65535 * 32768 still fits in 31 bits.
+	static constexpr const char* kName = "int16";
+
+	static std::int16_t quantize(double value, double scale)
+	{
+		double counts = std::nearbyint(value / scale);
+		if (!(counts > -32768.0))
+			return -32768; // Also NaN
+		if (counts > 32767.0)
+			return 32767;
+		return (std::int16_t)counts;
+	}
+	static double toValue(double counts, double scale) { return counts * scale; }
+	static std::int16_t fromAverage(double average) { return (std::int16_t)(long long)(average + std::copysign(0.5, average)); }
+};
+
+template <>
+struct SampleTraits<std::int32_t>
+{
+	using Accumulator = std::int64_t;
+	using Sum = RunningSum<std::int64_t>;
+	using ChunkAccumulator = std::int64_t;
+	static constexpr size_t kChunkSize = (size_t)1 << 31; ///< 2^31 samples of up to 2^31 still fit in 63 bits.
+	static constexpr const char* kName = "int32";
+
+	static std::int32_t quantize(double value, double scale)
+	{
+		double counts = std::nearbyint(value / scale);
+		if (!(counts > -2147483648.0))
+			return std::numeric_limits<std::int32_t>::min(); // Also NaN
+		if (counts > 2147483647.0)
+			return std::numeric_limits<std::int32_t>::max();
+		return (std::int32_t)counts;
+	}
+	static double toValue(double counts, double scale) { return counts * scale; }
+	static std::int32_t fromAverage(double average) { return (std::int32_t)(long long)(average + std::copysign(0.5, average)); }
+};
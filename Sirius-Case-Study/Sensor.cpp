@@ -1,98 +1,386 @@
 #include "Sensor.h"
-#include <thread>
-#include <iostream>
+#include "ProgressReporter.h"
+#include "SampleTraits.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
 
-Sensor::Sensor(int numDataPoints, DataGenerationTiming generationTiming, int periodIfNecessary, DataType dataType, double rangeMin, double rangeMax)
+namespace
+{
+	const double kSineFrequency = 0.1;  // Phase advance per SINE data point in radians
+	const int kCollectBlockSize = 256;  // Data points generated at once by collectDataPoints in immediate mode
+
+	// Rotation of one SINE lane per row: the phase advances by kSineLanes data points
+	const double kRowSine = std::sin(Sensor::kSineLanes * kSineFrequency);
+	const double kRowCosine = std::cos(Sensor::kSineLanes * kSineFrequency);
+
+	const std::uint64_t kDelaySeedMask = 0x5deece66dULL; // Separates the delay sequence from the data sequence of the same seed
+
+	static_assert(Sensor::kSineSegment % Sensor::kSineLanes == 0, "SINE segments must hold whole rows");
+}
+
+template <typename T>
+BasicSensor<T>::BasicSensor(int numDataPoints, DataGenerationTiming generationTiming, int periodIfNecessary, DataType dataType, double rangeMin, double rangeMax, std::uint64_t seed, double scale)
 	:	m_numOfDataPoints(numDataPoints),         // Total number of data points to generate
 		m_generationTiming(generationTiming),     // Timing mode for data generation
-		m_periodForGeneration(periodIfNecessary), // Delay period for periodic generation
+		m_samplePeriodNs((std::uint64_t)periodIfNecessary * 1000000), // Period for periodic generation
 		m_dataType(dataType),                     // Type of data to generate
 		m_rangeMin(rangeMin),                     // Minimum range for generated data
 		m_rangeMax(rangeMax),                     // Maximum range for generated data
-		m_currentStep(0)                          // Initialize current step to 0
+		m_currentStep(0),                         // Initialize current step to 0
+		m_linearStep((rangeMax - rangeMin) / (numDataPoints - 1)), // Step size for linear data generation
+		m_nextSequence(0),                        // The first data point is number 0
+		m_randomEngine(createRandomEngine(eXoshiro256PlusPlus, seed)), // Generator of the RANDOM data
+		m_delayEngine(createRandomEngine(eXoshiro256PlusPlus, seed ^ kDelaySeedMask)), // Generator of the asynchronous delays
+		m_name("Sensor"),                         // Label of the log messages
+		m_compressedStorage(false),               // Store the data points as they are
+		m_scale(std::is_floating_point_v<T> ? 1.0 : scale) // Floating point samples are physical values already
 {
-	// Constructor body
+	seedSineLanes();
 }
-Sensor::~Sensor()
+
+template <typename T>
+BasicSensor<T>::~BasicSensor()
 {
-	// Destructor body
+	// Hand the storage back for the next sensor
+	if (m_workspace != nullptr)
+		m_workspace->release(std::move(m_physicalData));
 }
 
-void Sensor::collectAndStoreDataPoints()
+template <typename T>
+void BasicSensor<T>::collectAndStoreDataPoints(const std::function<void(const BasicSample<T>&)>& onDataPoint)
 {
-
-	if (m_generationTiming == eImmediate)
+	if (m_compressedStorage)
 	{
-		// Generate all data points immediately without delay
-		for (int i = 0; i < m_numOfDataPoints; i++)
+		// The data points are encoded a block at a time as they arrive, in physical units
+		collectDataPoints([this, &onDataPoint](const BasicSample<T>& sample)
 		{
-			m_physicalData.push_back(generateDataPoint()); // Store the generated data point
-			std::cout << "Data Generated\n"; // Log the generation event
-		}
+			m_compressedData.push(Sample{ sample.timestampNs, SampleTraits<T>::toValue((double)sample.value, m_scale), sample.sequence });
+			if (onDataPoint)
+				onDataPoint(sample);
+		});
+		return;
 	}
-	else if (m_generationTiming == ePeriodic)
+
+	size_t capacity = m_physicalData.size() + (size_t)m_numOfDataPoints;
+	if (m_workspace != nullptr && m_physicalData.empty() && m_physicalData.capacity() < capacity)
 	{
-		// Generate data points periodically with a fixed delay
-		for (int i = 0; i < m_numOfDataPoints; i++)
+		// Swap the storage for a large enough buffer of the workspace
+		m_workspace->release(std::move(m_physicalData));
+		m_physicalData = m_workspace->acquireSamples<T>(capacity);
+	}
+	m_physicalData.reserve(capacity); // Allocate the storage once
+
+	collectDataPoints([this, &onDataPoint](const BasicSample<T>& sample)
+	{
+		m_physicalData.push(sample); // Store the generated data point with its timing
+		if (onDataPoint)
+			onDataPoint(sample); // Hand the data point over for processing
+	});
+}
+
+template <typename T>
+void BasicSensor<T>::collectDataPoints(const std::function<void(const BasicSample<T>&)>& onDataPoint)
+{
+	// The console is never written from here: progress goes through the logger at a limited rate,
+	// and the per-data-point messages are only formatted when the debug level is enabled
+	Logger& logger = getLogger();
+	ProgressReporter progress(logger, m_name, (std::uint64_t)m_numOfDataPoints);
+
+	if (m_generationTiming == eImmediate)
+	{
+		// Generate all data points immediately without delay, a block at a time; the whole block shares one clock reading
+		double block[kCollectBlockSize];
+		for (int i = 0; i < m_numOfDataPoints; i += kCollectBlockSize)
 		{
-			m_physicalData.push_back(generateDataPoint()); // Store the generated data point
-			std::this_thread::sleep_for(std::chrono::milliseconds(m_periodForGeneration)); // Wait for the specified period before generating the next point
-			std::cout << "Data Generated\n"; // Log the generation event
+			int count = std::min(kCollectBlockSize, m_numOfDataPoints - i);
+			generateBlock(std::span<double>(block, count));
+			std::uint64_t timestamp = SampleScheduler::getTimestamp();
+			bool detailed = logger.isEnabled(eLogDebug);
+			for (int j = 0; j < count; j++)
+			{
+				if (detailed)
+					logGeneratedDataPoint(m_nextSequence, block[j]); // Log the generation event
+				onDataPoint(BasicSample<T>{ timestamp, SampleTraits<T>::quantize(block[j], m_scale), m_nextSequence++ }); // Hand the generated data point over
+			}
+			progress.advance((std::uint64_t)count);
 		}
 	}
 	else
 	{
-		// Generate data points asynchronously with a random delay
+		// Generate data points on absolute deadlines: periodic ones every sample period, asynchronous ones after a random delay
+		m_scheduler.start();
+		std::uint64_t origin = m_scheduler.getOriginTimestamp();
+		std::uint64_t deadline = 0;
 		for (int i = 0; i < m_numOfDataPoints; i++)
 		{
-			m_physicalData.push_back(generateDataPoint()); // Store the generated data point
-			std::this_thread::sleep_for(std::chrono::milliseconds(rand() % 200 + 100)); // Wait for a random delay between 100 and 300 milliseconds
-			std::cout << "Data Generated\n"; // Log the generation event
+			std::uint64_t timestamp = origin + m_scheduler.waitUntil(deadline); // Wait for the data point's slot on the schedule
+			double value = generateDataPoint();
+			if (logger.isEnabled(eLogDebug))
+				logGeneratedDataPoint(m_nextSequence, value); // Log the generation event
+			onDataPoint(BasicSample<T>{ timestamp, SampleTraits<T>::quantize(value, m_scale), m_nextSequence++ }); // Hand the generated data point over
+			progress.advance();
+
+			if (m_generationTiming == ePeriodic)
+				deadline += m_samplePeriodNs;
+			else
+				deadline += (100 + m_delayEngine->nextBelow(200)) * 1000000; // A random delay between 100 and 300 milliseconds
 		}
 	}
+	progress.finish();
+}
+
+template <typename T>
+void BasicSensor<T>::setName(const std::string& name)
+{
+	m_name = name;
+}
+
+template <typename T>
+const std::string& BasicSensor<T>::getName() const
+{
+	return m_name;
+}
+
+template <typename T>
+void BasicSensor<T>::setSeed(std::uint64_t seed)
+{
+	m_randomEngine->seed(seed);
+	m_delayEngine->seed(seed ^ kDelaySeedMask);
+}
+
+template <typename T>
+void BasicSensor<T>::setRandomEngine(std::unique_ptr<RandomEngine> engine)
+{
+	m_randomEngine = std::move(engine);
+}
+
+template <typename T>
+const RandomEngine& BasicSensor<T>::getRandomEngine() const
+{
+	return *m_randomEngine;
+}
+
+template <typename T>
+void BasicSensor<T>::setSamplePeriod(std::uint64_t samplePeriodNs)
+{
+	m_samplePeriodNs = samplePeriodNs;
+}
+
+template <typename T>
+std::uint64_t BasicSensor<T>::getSamplePeriod() const
+{
+	return m_samplePeriodNs;
+}
+
+template <typename T>
+void BasicSensor<T>::setSpinThreshold(std::uint64_t spinThresholdNs)
+{
+	m_scheduler.setSpinThreshold(spinThresholdNs);
+}
+
+template <typename T>
+const JitterHistogram& BasicSensor<T>::getJitterHistogram() const
+{
+	return m_scheduler.getJitterHistogram();
+}
+
+template <typename T>
+int BasicSensor<T>::getNumOfDataPoints() const
+{
+	return m_numOfDataPoints;
 }
 
-const std::vector<double>& Sensor::getData() const
+template <typename T>
+void BasicSensor<T>::setWorkspace(std::shared_ptr<Workspace> workspace)
+{
+	m_workspace = std::move(workspace);
+}
+
+template <typename T>
+void BasicSensor<T>::setCompressedStorage(bool compressed)
+{
+	m_compressedStorage = compressed;
+}
+
+template <typename T>
+std::span<const T> BasicSensor<T>::getData() const
+{
+	// Return a view of the values of the collected data points
+	return m_physicalData.getValues();
+}
+
+template <typename T>
+std::vector<T> BasicSensor<T>::releaseData()
+{
+	// Hand the values of the collected data points over without copying them; their timing is discarded
+	return m_physicalData.releaseValues();
+}
+
+template <typename T>
+const BasicSampleBuffer<T>& BasicSensor<T>::getSamples() const
 {
-	// Return a constant reference to the collected data points
 	return m_physicalData;
 }
 
-double Sensor::generateDataPoint()
+template <typename T>
+BasicSampleBuffer<T> BasicSensor<T>::releaseSamples()
 {
+	// Hand the collected data points over without copying them
+	BasicSampleBuffer<T> samples = std::move(m_physicalData);
+	m_physicalData.clear();
+	return samples;
+}
+
+template <typename T>
+const CompressedSampleStore& BasicSensor<T>::getCompressedSamples() const
+{
+	return m_compressedData;
+}
+
+template <typename T>
+void BasicSensor<T>::logGeneratedDataPoint(std::uint32_t sequence, double value) const
+{
+	getLogger().log(eLogDebug, m_name + ": data point " + std::to_string(sequence) + " generated: " + std::to_string(value));
+}
+
+template <typename T>
+double BasicSensor<T>::generateDataPoint()
+{
+	double value;
+	generateBlock(std::span<double>(&value, 1));
+	return value;
+}
+
+template <typename T>
+void BasicSensor<T>::generateBlock(std::span<double> block)
+{
+	// Dispatch once per block instead of once per data point
 	if (m_dataType == LINEAR)
+		generateLinearBlock(block);
+	else if (m_dataType == SINE)
+		generateSineBlock(block);
+	else
+		generateRandomBlock(block);
+}
+
+template <typename T>
+void BasicSensor<T>::generateSamples(std::span<T> block)
+{
+	// Generate in double through a small buffer that stays in cache, then quantize
+	double values[kCollectBlockSize];
+	for (size_t i = 0; i < block.size(); i += kCollectBlockSize)
 	{
-		// Calculate the step size for linear data generation
-		double step = (m_rangeMax - m_rangeMin) / (m_numOfDataPoints - 1);
+		size_t count = std::min((size_t)kCollectBlockSize, block.size() - i);
+		generateBlock(std::span<double>(values, count));
+		for (size_t j = 0; j < count; j++)
+			block[i + j] = SampleTraits<T>::quantize(values[j], m_scale);
+	}
+}
 
-		// Compute the current value based on the current step
-		double value = m_rangeMin + m_currentStep * step;
+template <typename T>
+double BasicSensor<T>::getScale() const
+{
+	return m_scale;
+}
 
-		// Increment the step counter, wrapping around to 0 when the maximum is reached
-		m_currentStep = (m_currentStep + 1) % m_numOfDataPoints;
+template <typename T>
+void BasicSensor<T>::generateLinearBlock(std::span<double> block)
+{
+	int period = std::max(m_numOfDataPoints, 1); // The step counter wraps around after the last data point
+	size_t i = 0;
+	while (i < block.size())
+	{
+		// Fill the run up to the next wrap-around; the index is an exact integer, so the values match the per-point formula
+		size_t run = std::min(block.size() - i, (size_t)(period - m_currentStep));
+		double first = m_currentStep;
+		double* output = block.data() + i;
+		for (size_t j = 0; j < run; j++)
+			output[j] = m_rangeMin + (first + (double)j) * m_linearStep;
 
-		return value;
+		i += run;
+		m_currentStep = (int)((m_currentStep + run) % period);
 	}
-	else if(m_dataType == SINE)
+}
+
+template <typename T>
+void BasicSensor<T>::generateSineBlock(std::span<double> block)
+{
+	size_t i = 0;
+	while (i < block.size())
 	{
-		// Define the frequency for the sine wave
-		double frequency = 0.1;
+		int position = m_currentStep % kSineSegment;
+		if (position == 0)
+			seedSineLanes(); // Start every segment from exact values so that the rotation error cannot grow
 
-		// Calculate the sine value based on the current step
-		double value = sin(m_currentStep * frequency);
+		int lane = position % kSineLanes;
+		if (lane == 0 && block.size() - i >= (size_t)kSineLanes)
+		{
+			// Whole rows: store the lanes and rotate them, the lanes are independent and vectorize
+			size_t rows = std::min(block.size() - i, (size_t)(kSineSegment - position)) / kSineLanes;
+			double sine[kSineLanes], cosine[kSineLanes];
+			std::copy(m_sineLanes, m_sineLanes + kSineLanes, sine);
+			std::copy(m_cosineLanes, m_cosineLanes + kSineLanes, cosine);
 
-		// Increment the step counter
-		m_currentStep++;
+			double* output = block.data() + i;
+			for (size_t row = 0; row < rows; row++)
+			{
+				for (int j = 0; j < kSineLanes; j++)
+				{
+					output[row * kSineLanes + j] = sine[j];
+					double nextSine = sine[j] * kRowCosine + cosine[j] * kRowSine;
+					cosine[j] = cosine[j] * kRowCosine - sine[j] * kRowSine;
+					sine[j] = nextSine;
+				}
+			}
 
-		return value;
+			std::copy(sine, sine + kSineLanes, m_sineLanes);
+			std::copy(cosine, cosine + kSineLanes, m_cosineLanes);
+			i += rows * kSineLanes;
+			m_currentStep += (int)(rows * kSineLanes);
+		}
+		else
+		{
+			// A partial row at either end of the block
+			block[i++] = m_sineLanes[lane];
+			m_currentStep++;
+			if (lane == kSineLanes - 1)
+				rotateSineLanes();
+		}
 	}
-	else
+}
+
+template <typename T>
+void BasicSensor<T>::generateRandomBlock(std::span<double> block)
+{
+	// Uniform values in the specified range, generated in one call so that the engine state stays in registers
+	m_randomEngine->fillUniform(block, m_rangeMin, m_rangeMax);
+}
+
+template <typename T>
+void BasicSensor<T>::seedSineLanes()
+{
+	for (int j = 0; j < kSineLanes; j++)
 	{
-		// Generate a random double value between 0 and 1
-		double f = (double)rand() / RAND_MAX;
+		double phase = (m_currentStep + j) * kSineFrequency;
+		m_sineLanes[j] = std::sin(phase);
+		m_cosineLanes[j] = std::cos(phase);
+	}
+}
 
-		// Scale and shift the random value to fit within the specified range
-		return m_rangeMin + f * (m_rangeMax - m_rangeMin);
+template <typename T>
+void BasicSensor<T>::rotateSineLanes()
+{
+	for (int j = 0; j < kSineLanes; j++)
+	{
+		double nextSine = m_sineLanes[j] * kRowCosine + m_cosineLanes[j] * kRowSine;
+		m_cosineLanes[j] = m_cosineLanes[j] * kRowCosine - m_sineLanes[j] * kRowSine;
+		m_sineLanes[j] = nextSine;
 	}
+}
 
-}
\ No newline at end of file
+// The sample types of SampleTraits; other types do not link
+template class BasicSensor<double>;
+template class BasicSensor<float>;
+template class BasicSensor<std::int16_t>;
+template class BasicSensor<std::int32_t>;
@@ -1,12 +1,27 @@
+#pragma once
+#include "CompressedSampleStore.h"
+#include "RandomEngine.h"
+#include "SampleBuffer.h"
+#include "SampleScheduler.h"
+#include "SampleTraits.h"
+#include "Workspace.h"
+#include <cstdint>
 #include <vector>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
 
 /**
  * @brief Represents the timing mode for generating sensor data.
  *
  * Defines the timing behavior for data generation:
  * - **eImmediate**: Data points are generated immediately without delay.
- * - **ePeriodic**: Data points are generated with a fixed delay between each point.
+ * - **ePeriodic**: Data points are generated with a fixed period between each point.
  * - **eAsynchronous**: Data points are generated with a random delay between 100-300 milliseconds.
+ *
+ * Periodic and asynchronous data points are scheduled on absolute deadlines by a SampleScheduler,
+ * so the time spent on each data point does not accumulate into drift.
  */
 enum DataGenerationTiming
 {
@@ -30,7 +45,18 @@ enum DataType
 	RANDOM       ///< Randomly generated data points within a specified range.
 };
 
-class Sensor
+/**
+ * @brief Generates simulated sensor data and stores it in a sample type.
+ *
+ * The values are generated in double and stored with `SampleTraits<T>::quantize`, so integer sensors hold the
+ * nearest ADC count of every value and take a fraction of the memory of double data points. `Sensor` is the
+ * double instantiation. The class is instantiated for double, float, std::int16_t and std::int32_t only,
+ * in Sensor.cpp.
+ *
+ * @tparam T The sample type.
+ */
+template <typename T>
+class BasicSensor
 {
 public:
 	/**
@@ -53,10 +79,13 @@ public:
  *        - RANDOM: Random data within the range.
  * @param rangeMin The minimum value of the data range (default: -100.0).
  * @param rangeMax The maximum value of the data range (default: 100.0).
+ * @param seed The seed of the sensor's random number generators (default: 1). Sensors with equal
+ *        seeds produce equal RANDOM data and asynchronous delays; give parallel sensors different seeds.
+ * @param scale The physical value of one count of integer samples; ignored for floating point samples (default: 1.0).
  */
-	Sensor(int numDataPoints = 10, DataGenerationTiming generationTiming = eImmediate, int periodIfNecessary = 100,
-		DataType dataType = LINEAR, double rangeMin = -100.0, double rangeMax = 100.0);
-	~Sensor();
+	BasicSensor(int numDataPoints = 10, DataGenerationTiming generationTiming = eImmediate, int periodIfNecessary = 100,
+		DataType dataType = LINEAR, double rangeMin = -100.0, double rangeMax = 100.0, std::uint64_t seed = 1, double scale = 1.0);
+	~BasicSensor();
 
 	/**
  * @brief Collects and stores multiple data points based on the selected generation timing.
@@ -64,30 +93,207 @@ public:
  * This method generates and stores `m_numOfDataPoints` data points into `m_physicalData`
  * using the timing specified by `m_generationTiming`:
  * - **eImmediate**: Generates all data points as quickly as possible without delay.
- * - **ePeriodic**: Generates data points with a fixed delay (`m_periodForGeneration`) between each point.
+ * - **ePeriodic**: Generates data point i at i times the sample period after the first one.
  * - **eAsync**: Generates data points with a random delay between 100 and 300 milliseconds.
  *
- * Additionally, a message "Data Generated" is printed to the console for each point.
+ * The progress is reported through `getLogger()` about once per second, and a message per data point
+ * is logged at eLogDebug; the collection never writes to the console itself. Every data point
+ * is stored with its steady clock timestamp and sequence number, see `getSamples`; in the paced modes
+ * its lateness against the schedule is recorded too, see `getJitterHistogram`.
+ *
+ * @param onDataPoint Optional callback invoked with each data point right after it is stored,
+ *        so that it can be processed while the remaining points are still being generated.
+ */
+	void collectAndStoreDataPoints(const std::function<void(const BasicSample<T>&)>& onDataPoint = nullptr);
+	/**
+ * @brief Collects data points with the selected generation timing without storing them.
+ *
+ * Behaves like `collectAndStoreDataPoints`, but each data point is only handed to `onDataPoint`,
+ * so a consumer that keeps its own copy (e.g. a streaming DataProcessor) does not duplicate the capture.
+ *
+ * The paced modes timestamp each data point with the time its deadline was met. eImmediate reads the
+ * clock once per block of generated data points, so consecutive data points may share a timestamp.
+ * Sequence numbers continue across collections, so data points from one sensor never share one.
+ *
+ * @param onDataPoint Callback invoked with each data point as soon as it is generated.
+ */
+	void collectDataPoints(const std::function<void(const BasicSample<T>&)>& onDataPoint);
+	/**
+ * @brief Generates the next data points in bulk, without delay and without console output.
+ *
+ * Fills the whole block with the same sequence that `collectDataPoints` would produce next and
+ * advances the sensor by `block.size()` data points, so that blocks of any size can be chained.
+ * The data type is dispatched once per block to a generator written for it:
+ * - **LINEAR**: The step size is computed once; the values are bit-identical to the per-point formula.
+ * - **SINE**: An incremental phase rotation in `kSineLanes` independent lanes replaces `sin`. The
+ *   lanes are re-seeded with `sin`/`cos` every `kSineSegment` data points, which keeps the values
+ *   within one ulp of the phase `step * 0.1` of `sin(step * 0.1)`, the rounding of the phase itself.
+ *   The sequence does not depend on how it is split into blocks.
+ * - **RANDOM**: One `RandomEngine::fillUniform` call per block, values in [rangeMin, rangeMax).
+ *
+ * @param block The buffer to fill.
+ */
+	void generateBlock(std::span<double> block);
+	/**
+ * @brief Generates the next data points in bulk as samples of the sensor's type.
+ *
+ * Generates the same values as `generateBlock` a block of doubles at a time and converts them with
+ * `SampleTraits<T>::quantize`, so integer samples hold the nearest ADC count of each value.
+ *
+ * @param block The buffer to fill.
+ */
+	void generateSamples(std::span<T> block);
+	/**
+ * @brief Retrieves the physical value of one count.
+ *
+ * @return The scale of integer samples, 1.0 for floating point samples.
  */
-	void collectAndStoreDataPoints();
+	double getScale() const;
 
 	/**
- * @brief Retrieves the collected sensor data.
+ * @brief Restarts the random number generators of the sensor from a seed.
+ *
+ * @param seed The new seed.
+ */
+	void setSeed(std::uint64_t seed);
+	/**
+ * @brief Replaces the generator of the RANDOM data, e.g. with a different algorithm.
+ *
+ * The asynchronous delays keep their own generator, so the data does not depend on the timing mode.
+ *
+ * @param engine The seeded engine to use from now on.
+ */
+	void setRandomEngine(std::unique_ptr<RandomEngine> engine);
+	/**
+ * @brief Retrieves the generator of the RANDOM data.
  *
- * @return A constant reference to the vector containing the collected data points.
+ * @return The engine.
  */
-	const std::vector<double>& getData() const;
+	const RandomEngine& getRandomEngine() const;
+
+	/**
+ * @brief Sets the period of ePeriodic timing with nanosecond resolution, overriding the constructor's milliseconds.
+ *
+ * @param samplePeriodNs The sample period in nanoseconds.
+ */
+	void setSamplePeriod(std::uint64_t samplePeriodNs);
+	/**
+ * @brief Retrieves the period of ePeriodic timing.
+ *
+ * @return The sample period in nanoseconds.
+ */
+	std::uint64_t getSamplePeriod() const;
+	/**
+ * @brief Sets how long before each deadline the sensor stops sleeping and busy-waits.
+ *
+ * @param spinThresholdNs The busy-wait tail in nanoseconds, 0 to only sleep (default: 100 us).
+ */
+	void setSpinThreshold(std::uint64_t spinThresholdNs);
+	/**
+ * @brief Sets the name identifying the sensor in log messages.
+ *
+ * @param name The name (default: "Sensor").
+ */
+	void setName(const std::string& name);
+	/**
+ * @brief Retrieves the name identifying the sensor in log messages.
+ *
+ * @return The name.
+ */
+	const std::string& getName() const;
+	/**
+ * @brief Retrieves how late each data point of the last paced collection was generated.
+ *
+ * @return The lateness against the schedule.
+ */
+	const JitterHistogram& getJitterHistogram() const;
+	/**
+ * @brief Retrieves the number of data points generated per collection.
+ *
+ * @return The number of data points given to the constructor.
+ */
+	int getNumOfDataPoints() const;
+	/**
+ * @brief Sets the workspace the storage of `collectAndStoreDataPoints` is taken from.
+ *
+ * The storage is returned to the workspace when the sensor is destroyed, so sensors created run after run
+ * reuse the same buffers. Released data points (`releaseSamples`) take their storage with them.
+ *
+ * @param workspace The shared workspace, nullptr to allocate the storage directly.
+ */
+	void setWorkspace(std::shared_ptr<Workspace> workspace);
+	/**
+ * @brief Selects whether `collectAndStoreDataPoints` keeps the data points compressed.
+ *
+ * Compressed data points take a fraction of the memory (see CompressedSampleStore) and are read with
+ * `getCompressedSamples`; `getData` and `getSamples` then stay empty.
+ *
+ * @param compressed True to store the data points compressed.
+ */
+	void setCompressedStorage(bool compressed);
+
+	/**
+ * @brief Retrieves the values of the collected sensor data.
+ *
+ * @return A view of the contiguous values of the collected data points.
+ */
+	std::span<const T> getData() const;
+	/**
+ * @brief Releases the values of the collected sensor data.
+ *
+ * Moves the values out of the sensor without copying them and discards their timing.
+ * The sensor holds no data afterwards.
+ *
+ * @return The vector of collected values.
+ */
+	std::vector<T> releaseData();
+	/**
+ * @brief Retrieves the collected data points with their timestamps and sequence numbers.
+ *
+ * @return A constant reference to the stored data points.
+ */
+	const BasicSampleBuffer<T>& getSamples() const;
+	/**
+ * @brief Releases the collected data points with their timing.
+ *
+ * Moves the collected data points out of the sensor without copying them, e.g. into
+ * `DataProcessor::setRawData`. The sensor holds no data afterwards.
+ *
+ * @return The collected data points.
+ */
+	BasicSampleBuffer<T> releaseSamples();
+	/**
+ * @brief Retrieves the data points collected with compressed storage.
+ *
+ * @return A constant reference to the compressed data points in physical units, e.g. for `DataProcessor::setRawData`.
+ */
+	const CompressedSampleStore& getCompressedSamples() const;
+
+	static const int kSineLanes = 8;      ///< Independent phase rotations in the SINE generator.
+	static const int kSineSegment = 1024; ///< Data points between two exact re-seeds of the SINE generator.
 
 private:
 
-	std::vector<double> m_physicalData;		 // A container to store the generated data points
+	BasicSampleBuffer<T> m_physicalData;	 // A container to store the generated data points with their timing
 	DataGenerationTiming m_generationTiming; // Specifies the timing mode for data generation
-	int m_periodForGeneration;				 // The delay period (in milliseconds) used for periodic data generation
+	std::uint64_t m_samplePeriodNs;			 // The period (in nanoseconds) used for periodic data generation
 	int m_numOfDataPoints;					 // The total number of data points to generate
 	int m_dataType;							 // The type of data to generate
 	double m_rangeMin;						 // The minimum value in the range of generated data
 	double m_rangeMax;						 // The maximum value in the range of generated data
 	int m_currentStep;						 // Tracks the current step for deterministic data generation
+	double m_linearStep;					 // The distance between two LINEAR data points
+	std::uint32_t m_nextSequence;			 // The sequence number of the next generated data point
+	double m_sineLanes[kSineLanes];			 // sin of the current SINE row, one data point per lane
+	double m_cosineLanes[kSineLanes];		 // cos of the current SINE row, one data point per lane
+	std::unique_ptr<RandomEngine> m_randomEngine; // Generates the RANDOM data
+	std::unique_ptr<RandomEngine> m_delayEngine;  // Generates the asynchronous delays
+	SampleScheduler m_scheduler;			 // Waits for the deadlines of the paced modes
+	std::string m_name;						 // Identifies the sensor in log messages
+	std::shared_ptr<Workspace> m_workspace;	 // Supplies the storage of the collected data points, may be nullptr
+	CompressedSampleStore m_compressedData;	 // The collected data points when compressed storage is selected
+	bool m_compressedStorage;				 // Set to store the collected data points compressed
+	double m_scale;							 // The physical value of one count, 1.0 for floating point samples
 
 	/**
  * Generates a single data point based on the current data type.
@@ -97,8 +303,44 @@ private:
  * - **SINE**: Produces sinusoidal values based on a fixed frequency.
  * - **RANDOM**: Produces random values uniformly distributed within the specified range.
  *
+ * It is a block of one for `generateBlock`, so both produce the same sequence.
+ *
  * @return A double representing the generated data point.
  */
 	double generateDataPoint();
+	/**
+ * @brief Logs the generation of one data point at eLogDebug.
+ *
+ * @param sequence The sequence number of the data point.
+ * @param value The generated value.
+ */
+	void logGeneratedDataPoint(std::uint32_t sequence, double value) const;
+	/**
+ * @brief Fills a block with LINEAR data points.
+ *
+ * @param block The buffer to fill.
+ */
+	void generateLinearBlock(std::span<double> block);
+	/**
+ * @brief Fills a block with SINE data points using the phase rotation recurrence.
+ *
+ * @param block The buffer to fill.
+ */
+	void generateSineBlock(std::span<double> block);
+	/**
+ * @brief Fills a block with RANDOM data points.
+ *
+ * @param block The buffer to fill.
+ */
+	void generateRandomBlock(std::span<double> block);
+	/**
+ * @brief Sets the SINE lanes to the exact values of the row starting at `m_currentStep`.
+ */
+	void seedSineLanes();
+	/**
+ * @brief Advances the SINE lanes by one row of `kSineLanes` data points.
+ */
+	void rotateSineLanes();
 };
 
+using Sensor = BasicSensor<double>;
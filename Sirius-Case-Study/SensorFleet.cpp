@@ -0,0 +1,137 @@
+#include "SensorFleet.h"
+#include <chrono>
+
+void setPercentiles(ChannelStatistics& statistics, const QuantileSketch* raw, const QuantileSketch* processed)
+{
+	const double kFractions[] = { 0.5, 0.95, 0.99 };
+	double percentiles[3];
+	if (raw != nullptr)
+	{
+		raw->getQuantiles(kFractions, percentiles);
+		statistics.rawP50 = percentiles[0];
+		statistics.rawP95 = percentiles[1];
+		statistics.rawP99 = percentiles[2];
+	}
+	if (processed != nullptr)
+	{
+		processed->getQuantiles(kFractions, percentiles);
+		statistics.processedP50 = percentiles[0];
+		statistics.processedP95 = percentiles[1];
+		statistics.processedP99 = percentiles[2];
+	}
+}
+
+template <typename T>
+BasicSensorFleet<T>::BasicSensorFleet(size_t threadCount)
+	:m_pool(threadCount),  // Start the fixed set of workers
+	 m_elapsedSeconds(0.0)
+{
+	// Constructor body
+}
+
+template <typename T>
+BasicSensorFleet<T>::~BasicSensorFleet()
+{
+	// Destructor body
+}
+
+template <typename T>
+size_t BasicSensorFleet<T>::addChannel(std::unique_ptr<BasicSensor<T>> sensor, std::unique_ptr<BasicDataProcessor<T>> processor)
+{
+	std::unique_ptr<Channel> channel(new Channel());
+	channel->sensor = std::move(sensor);
+	channel->processor = std::move(processor);
+	channel->statistics = ChannelStatistics();
+	m_channels.push_back(std::move(channel));
+	return m_channels.size() - 1;
+}
+
+template <typename T>
+void BasicSensorFleet<T>::run()
+{
+	auto start = std::chrono::steady_clock::now();
+
+	// Schedule one task per channel, the pool balances them across its workers
+	for (auto& channel : m_channels)
+	{
+		Channel* c = channel.get();
+		m_pool.submit([c] { runChannel(*c); });
+	}
+	m_pool.wait();
+
+	m_elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename T>
+size_t BasicSensorFleet<T>::getChannelCount() const
+{
+	return m_channels.size();
+}
+
+template <typename T>
+size_t BasicSensorFleet<T>::getThreadCount() const
+{
+	return m_pool.getThreadCount();
+}
+
+template <typename T>
+const ChannelStatistics& BasicSensorFleet<T>::getChannelStatistics(size_t channel) const
+{
+	return m_channels[channel]->statistics;
+}
+
+template <typename T>
+const BasicDataProcessor<T>& BasicSensorFleet<T>::getProcessor(size_t channel) const
+{
+	return *m_channels[channel]->processor;
+}
+
+template <typename T>
+double BasicSensorFleet<T>::getElapsedSeconds() const
+{
+	return m_elapsedSeconds;
+}
+
+template <typename T>
+double BasicSensorFleet<T>::getThroughput() const
+{
+	size_t total = 0;
+	for (const auto& channel : m_channels)
+	{
+		total += channel->statistics.numDataPoints;
+	}
+	return m_elapsedSeconds > 0.0 ? (double)total / m_elapsedSeconds : 0.0;
+}
+
+template <typename T>
+void BasicSensorFleet<T>::runChannel(Channel& channel)
+{
+	auto start = std::chrono::steady_clock::now();
+	BasicDataProcessor<T>& processor = *channel.processor;
+
+	// Stream the sensor's data points straight into the channel's data processor
+	processor.beginStream((size_t)channel.sensor->getNumOfDataPoints());
+	channel.sensor->collectDataPoints([&processor](const BasicSample<T>& sample) { processor.onSample(sample); });
+	processor.endStream();
+
+	ChannelStatistics& statistics = channel.statistics;
+	statistics.numDataPoints = (size_t)processor.getRawStatistics().getCount();
+	statistics.rawMin = processor.getRawStatistics().getMin();
+	statistics.rawMax = processor.getRawStatistics().getMax();
+	statistics.rawAverage = processor.getRawAverage();
+	statistics.processedMin = processor.getProcessedStatistics().getMin();
+	statistics.processedMax = processor.getProcessedStatistics().getMax();
+	statistics.processedAverage = processor.getProcessedAverage();
+	setPercentiles(statistics, processor.getRawQuantiles(), processor.getProcessedQuantiles());
+	statistics.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	const JitterHistogram& jitter = channel.sensor->getJitterHistogram();
+	statistics.jitterMeanNs = jitter.getMean();
+	statistics.jitterP99Ns = (double)jitter.getPercentile(0.99);
+	statistics.jitterMaxNs = (double)jitter.getMax();
+}
+
+// The sample types of SampleTraits; other types do not link
+template class BasicSensorFleet<double>;
+template class BasicSensorFleet<float>;
+template class BasicSensorFleet<std::int16_t>;
+template class BasicSensorFleet<std::int32_t>;
@@ -0,0 +1,140 @@
+#pragma once
+#include "Sensor.h"
+#include "DataProcessor.h"
+#include "ThreadPool.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Summary of one channel of a SensorFleet after a run.
+ */
+struct ChannelStatistics
+{
+	size_t numDataPoints;     ///< The number of data points captured by the channel.
+	double rawMin;            ///< The minimum value of the raw data.
+	double rawMax;            ///< The maximum value of the raw data.
+	double rawAverage;        ///< The average value of the raw data.
+	double processedMin;      ///< The minimum value of the processed data.
+	double processedMax;      ///< The maximum value of the processed data.
+	double processedAverage;  ///< The average value of the processed data.
+	double rawP50;            ///< The estimated median of the raw data, 0.0 without quantile sketches.
+	double rawP95;            ///< The estimated 95th percentile of the raw data.
+	double rawP99;            ///< The estimated 99th percentile of the raw data.
+	double processedP50;      ///< The estimated median of the processed data.
+	double processedP95;      ///< The estimated 95th percentile of the processed data.
+	double processedP99;      ///< The estimated 99th percentile of the processed data.
+	double elapsedSeconds;    ///< The wall-clock time the channel's capture took.
+	double jitterMeanNs;      ///< The mean lateness of the data points against their schedule (paced timing only).
+	double jitterP99Ns;       ///< The 99th percentile of the lateness, resolved to a power of two.
+	double jitterMaxNs;       ///< The largest lateness.
+};
+
+/**
+ * @brief Fills the percentiles of a channel summary from the quantile sketches of its data.
+ *
+ * @param statistics The summary to fill.
+ * @param raw The sketch of the raw data, or nullptr to leave the raw percentiles unchanged.
+ * @param processed The sketch of the processed data, or nullptr to leave the processed percentiles unchanged.
+ */
+void setPercentiles(ChannelStatistics& statistics, const QuantileSketch* raw, const QuantileSketch* processed);
+
+/**
+ * @brief Runs many sensor to data processor channels of a sample type on a shared thread pool.
+ *
+ * `SensorFleet` is the double instantiation. The class is instantiated for double, float, std::int16_t
+ * and std::int32_t only, in SensorFleet.cpp.
+ *
+ * @tparam T The sample type.
+ */
+template <typename T>
+class BasicSensorFleet
+{
+public:
+	/**
+ * @brief Constructs a BasicSensorFleet object that runs its channels on a fixed-size thread pool.
+ *
+ * @param threadCount The number of worker threads (default: 0, one per hardware thread).
+ */
+	BasicSensorFleet(size_t threadCount = 0);
+	~BasicSensorFleet();
+
+	/**
+ * @brief Adds a sensor to data processor pipeline to the fleet.
+ *
+ * @param sensor The sensor producing the channel's data points.
+ * @param processor The data processor consuming the channel's data points.
+ * @return The index of the new channel.
+ */
+	size_t addChannel(std::unique_ptr<BasicSensor<T>> sensor, std::unique_ptr<BasicDataProcessor<T>> processor);
+	/**
+ * @brief Runs a capture on every channel and waits for all of them to finish.
+ *
+ * Each channel is scheduled as one task on the work-stealing thread pool, so the number of
+ * OS threads stays fixed however many channels there are. A channel task streams its sensor's
+ * data points straight into its data processor and then records the channel statistics.
+ */
+	void run();
+
+	/**
+ * @brief Retrieves the number of channels.
+ *
+ * @return The number of sensor to data processor pipelines.
+ */
+	size_t getChannelCount() const;
+	/**
+ * @brief Retrieves the number of worker threads running the channels.
+ *
+ * @return The size of the thread pool.
+ */
+	size_t getThreadCount() const;
+	/**
+ * @brief Retrieves the statistics of a channel after `run`.
+ *
+ * @param channel The index of the channel.
+ * @return A constant reference to the channel statistics.
+ */
+	const ChannelStatistics& getChannelStatistics(size_t channel) const;
+	/**
+ * @brief Retrieves the data processor of a channel.
+ *
+ * @param channel The index of the channel.
+ * @return A constant reference to the channel's data processor.
+ */
+	const BasicDataProcessor<T>& getProcessor(size_t channel) const;
+	/**
+ * @brief Retrieves the wall-clock time of the last run.
+ *
+ * @return The time from scheduling the first channel until the last channel finished, in seconds.
+ */
+	double getElapsedSeconds() const;
+	/**
+ * @brief Retrieves the aggregate throughput of the last run.
+ *
+ * Comparing this value across thread counts shows how the fleet scales with cores.
+ *
+ * @return The total number of data points processed by all channels per second.
+ */
+	double getThroughput() const;
+
+private:
+
+	struct Channel
+	{
+		std::unique_ptr<BasicSensor<T>> sensor;           // The channel's data source
+		std::unique_ptr<BasicDataProcessor<T>> processor; // The channel's data sink
+		ChannelStatistics statistics;             // The channel's results of the last run
+	};
+
+	ThreadPool m_pool;                              // The workers running the channel tasks
+	std::vector<std::unique_ptr<Channel>> m_channels; // The sensor to data processor pipelines
+	double m_elapsedSeconds;                        // The wall-clock time of the last run
+
+	/**
+ * @brief Runs the capture of a single channel and records its statistics.
+ *
+ * @param channel The channel to run.
+ */
+	static void runChannel(Channel& channel);
+};
+
+using SensorFleet = BasicSensorFleet<double>;
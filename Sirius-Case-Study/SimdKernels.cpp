@@ -0,0 +1,350 @@
+#include "SimdKernels.h"
+#include "SampleTraits.h"
+#include "SlidingWindowSum.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	const int kUnset = -1;
+	std::atomic<int> g_simdLevel(kUnset); // The active SimdLevel, detected on first use
+
+	SimdLevel queryCpu()
+	{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return eScalar;
+
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx)
+			return eScalar;
+
+		unsigned long long xcr0 = _xgetbv(0);
+		bool ymmEnabled = (xcr0 & 0x6) == 0x6;      // The OS saves XMM and YMM state
+		bool zmmEnabled = (xcr0 & 0xe6) == 0xe6;    // ... and the AVX-512 opmask and ZMM state
+
+		__cpuidex(info, 7, 0);
+		bool avx2 = (info[1] & (1 << 5)) != 0;
+		bool avx512f = (info[1] & (1 << 16)) != 0;
+
+		if (avx512f && zmmEnabled)
+			return eAvx512;
+		if (avx2 && ymmEnabled)
+			return eAvx2;
+		return eScalar;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f"))
+			return eAvx512;
+		if (__builtin_cpu_supports("avx2"))
+			return eAvx2;
+		return eScalar;
+#else
+		return eScalar;
+#endif
+	}
+
+	// Position of output k's window element j in the padded data, clamped to the raw data
+	template <typename T>
+	inline T paddedValue(const T* data, long long size, long long index)
+	{
+		if (index < 0)
+			return data[0];
+		if (index >= size)
+			return data[size - 1];
+		return data[index];
+	}
+}
+
+SimdLevel detectSimdLevel()
+{
+	static const SimdLevel detected = queryCpu();
+	return detected;
+}
+
+SimdLevel getSimdLevel()
+{
+	int level = g_simdLevel.load(std::memory_order_relaxed);
+	if (level == kUnset)
+	{
+		level = detectSimdLevel();
+		g_simdLevel.store(level, std::memory_order_relaxed);
+	}
+	return (SimdLevel)level;
+}
+
+void setSimdLevel(SimdLevel level)
+{
+	SimdLevel detected = detectSimdLevel();
+	g_simdLevel.store(level > detected ? detected : level, std::memory_order_relaxed);
+}
+
+const char* getSimdLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case eAvx512:
+		return "avx512";
+	case eAvx2:
+		return "avx2";
+	default:
+		return "scalar";
+	}
+}
+
+double SimdKernels::sum(const double* data, size_t size)
+{
+	switch (getSimdLevel())
+	{
+	case eAvx512:
+		return Avx512::sum(data, size);
+	case eAvx2:
+		return Avx2::sum(data, size);
+	default:
+		return Scalar::sum(data, size);
+	}
+}
+
+template <typename T>
+DataStatistics SimdKernels::statistics(const T* data, size_t size, size_t subsetSize, double* subsetAverages, double scale)
+{
+	// Only double has vector kernels, and its samples are physical values already
+	if constexpr (std::is_same_v<T, double>)
+	{
+		switch (getSimdLevel())
+		{
+		case eAvx512:
+			return Avx512::statistics(data, size, subsetSize, subsetAverages);
+		case eAvx2:
+			return Avx2::statistics(data, size, subsetSize, subsetAverages);
+		default:
+			break;
+		}
+	}
+	return Scalar::statistics(data, size, subsetSize, subsetAverages, scale);
+}
+
+template <typename T>
+void SimdKernels::movingAverage(const T* data, size_t size, int windowSize, T* output)
+{
+	if constexpr (std::is_same_v<T, double>)
+	{
+		switch (getSimdLevel())
+		{
+		case eAvx512:
+			Avx512::movingAverage(data, size, windowSize, output);
+			return;
+		case eAvx2:
+			Avx2::movingAverage(data, size, windowSize, output);
+			return;
+		default:
+			break;
+		}
+	}
+	Scalar::movingAverage(data, size, windowSize, output);
+}
+
+template <typename T>
+void SimdKernels::movingAverageRange(const T* data, size_t size, int windowSize, size_t begin, size_t end, T* output)
+{
+	if constexpr (std::is_same_v<T, double>)
+	{
+		switch (getSimdLevel())
+		{
+		case eAvx512:
+			Avx512::movingAverageRange(data, size, windowSize, begin, end, output);
+			return;
+		case eAvx2:
+			Avx2::movingAverageRange(data, size, windowSize, begin, end, output);
+			return;
+		default:
+			break;
+		}
+	}
+	Scalar::movingAverageRange(data, size, windowSize, begin, end, output);
+}
+
+double SimdKernels::Scalar::sum(const double* data, size_t size)
+{
+	double sum = 0.0;
+	// Loop through the buffer to sum all values
+	for (size_t i = 0; i < size; i++)
+	{
+		sum += data[i];
+	}
+	return sum;
+}
+
+template <typename T>
+DataStatistics SimdKernels::Scalar::statistics(const T* data, size_t size, size_t subsetSize, double* subsetAverages, double scale)
+{
+	using Traits = SampleTraits<T>;
+	using Accumulator = typename Traits::Accumulator;
+	using ChunkAccumulator = typename Traits::ChunkAccumulator;
+	const size_t kLanes = 4; // Independent partial sums of integer subsets
+
+	DataStatistics statistics = { size, 0.0, 0.0, 0.0 };
+	double dScale = Traits::toValue(1.0, scale) / (double)subsetSize; // Turns a subset sum into an average in physical units
+
+	if (size == 0)
+		return statistics;
+
+	T minValue = data[0];
+	T maxValue = data[0];
+	typename Traits::Sum total;
+
+	// Walk the buffer one subset at a time, updating every statistic from the same load
+	for (size_t begin = 0; begin < size; begin += subsetSize)
+	{
+		size_t end = begin + subsetSize < size ? begin + subsetSize : size;
+		Accumulator subsetSum = 0;
+
+		if constexpr (!std::is_same_v<T, double>)
+		{
+			// Integer sums are exact in any order, and float values are summed in double, so chunks short enough for the
+			// narrow accumulator are summed in independent lanes, and neither the sums nor the extremes wait for the
+			// previous sample
+			for (size_t chunk = begin; chunk < end;)
+			{
+				size_t chunkEnd = end - chunk > Traits::kChunkSize ? chunk + Traits::kChunkSize : end;
+				ChunkAccumulator partial[kLanes] = {};
+				T low[kLanes], high[kLanes];
+				std::fill(low, low + kLanes, minValue);
+				std::fill(high, high + kLanes, maxValue);
+				size_t i = chunk;
+				for (; i + kLanes <= chunkEnd; i += kLanes)
+				{
+					for (size_t lane = 0; lane < kLanes; lane++)
+					{
+						T value = data[i + lane];
+						partial[lane] += (ChunkAccumulator)value;
+						low[lane] = std::min(low[lane], value);
+						high[lane] = std::max(high[lane], value);
+					}
+				}
+				for (; i < chunkEnd; i++)
+				{
+					T value = data[i];
+					partial[0] += (ChunkAccumulator)value;
+					low[0] = std::min(low[0], value);
+					high[0] = std::max(high[0], value);
+				}
+				for (size_t lane = 0; lane < kLanes; lane++)
+				{
+					subsetSum += (Accumulator)partial[lane];
+					minValue = std::min(minValue, low[lane]);
+					maxValue = std::max(maxValue, high[lane]);
+				}
+				chunk = chunkEnd;
+			}
+		}
+		else
+		{
+			// The scalar double kernel is the reference of the vector kernels and adds the values in turn
+			for (size_t i = begin; i < end; i++)
+			{
+				T value = data[i];
+				subsetSum += (Accumulator)value;
+				if (value < minValue)
+					minValue = value;
+				if (value > maxValue)
+					maxValue = value;
+			}
+		}
+
+		total.add(subsetSum);
+		if (subsetAverages)
+			*subsetAverages++ = (double)subsetSum * dScale; // A short last subset is implicitly zero padded
+	}
+
+	statistics.sum = Traits::toValue((double)total.getValue(), scale);
+	statistics.min = Traits::toValue((double)minValue, scale);
+	statistics.max = Traits::toValue((double)maxValue, scale);
+	return statistics;
+}
+
+template <typename T>
+void SimdKernels::Scalar::movingAverage(const T* data, size_t size, int windowSize, T* output)
+{
+	movingAverageRange(data, size, windowSize, 0, size, output);
+}
+
+template <typename T>
+void SimdKernels::Scalar::movingAverageRange(const T* data, size_t size, int windowSize, size_t begin, size_t end, T* output)
+{
+	using Traits = SampleTraits<T>;
+	using Accumulator = typename Traits::Accumulator;
+	const long long n = (long long)size;
+	const long long offset = (windowSize - 1) / 2; // Half the window size, rounded down
+	const double dScaler = 1.0 / (double)windowSize; // Scaling factor to normalize the sum to get the average
+	const long long rangeEnd = (long long)end;
+	typename Traits::Sum sum;
+	auto toSample = [dScaler](const typename Traits::Sum& windowSum)
+	{
+		return Traits::fromAverage((double)windowSum.getValue() * dScaler);
+	};
+
+	for (long long blockStart = (long long)begin; blockStart < rangeEnd; blockStart += SlidingWindowSum::kResyncInterval)
+	{
+		long long blockEnd = std::min(blockStart + (long long)SlidingWindowSum::kResyncInterval, rangeEnd);
+
+		// Re-seed: sum the whole window, oldest sample first
+		sum.reset();
+		for (long long j = blockStart - offset; j < blockStart - offset + windowSize; j++)
+		{
+			sum.add((Accumulator)paddedValue(data, n, j));
+		}
+		output[blockStart] = toSample(sum);
+
+		// Only the first and last `offset` outputs read past the ends; the loop between them needs no clamping
+		long long interiorBegin = std::clamp(offset + 1, blockStart + 1, blockEnd);
+		long long interiorEnd = std::clamp(n - offset, interiorBegin, blockEnd);
+		long long k = blockStart + 1;
+		for (; k < interiorBegin; k++)
+		{
+			sum.add((Accumulator)paddedValue(data, n, k + windowSize - 1 - offset)); // Sample entering the window
+			sum.add(-(Accumulator)paddedValue(data, n, k - 1 - offset));             // Sample leaving the window
+			output[k] = toSample(sum);
+		}
+		for (; k < interiorEnd; k++)
+		{
+			sum.add((Accumulator)data[k + windowSize - 1 - offset]);
+			sum.add(-(Accumulator)data[k - 1 - offset]);
+			output[k] = toSample(sum);
+		}
+		for (; k < blockEnd; k++)
+		{
+			sum.add((Accumulator)paddedValue(data, n, k + windowSize - 1 - offset));
+			sum.add(-(Accumulator)paddedValue(data, n, k - 1 - offset));
+			output[k] = toSample(sum);
+		}
+	}
+}
+
+// The sample types the kernels support; other types do not link
+template DataStatistics SimdKernels::statistics<double>(const double*, size_t, size_t, double*, double);
+template DataStatistics SimdKernels::statistics<float>(const float*, size_t, size_t, double*, double);
+template DataStatistics SimdKernels::statistics<std::int16_t>(const std::int16_t*, size_t, size_t, double*, double);
+template DataStatistics SimdKernels::statistics<std::int32_t>(const std::int32_t*, size_t, size_t, double*, double);
+template void SimdKernels::movingAverage<double>(const double*, size_t, int, double*);
+template void SimdKernels::movingAverage<float>(const float*, size_t, int, float*);
+template void SimdKernels::movingAverage<std::int16_t>(const std::int16_t*, size_t, int, std::int16_t*);
+template void SimdKernels::movingAverage<std::int32_t>(const std::int32_t*, size_t, int, std::int32_t*);
+template void SimdKernels::movingAverageRange<double>(const double*, size_t, int, size_t, size_t, double*);
+template void SimdKernels::movingAverageRange<float>(const float*, size_t, int, size_t, size_t, float*);
+template void SimdKernels::movingAverageRange<std::int16_t>(const std::int16_t*, size_t, int, size_t, size_t, std::int16_t*);
+template void SimdKernels::movingAverageRange<std::int32_t>(const std::int32_t*, size_t, int, size_t, size_t, std::int32_t*);
+template DataStatistics SimdKernels::Scalar::statistics<double>(const double*, size_t, size_t, double*, double);
+template void SimdKernels::Scalar::movingAverage<double>(const double*, size_t, int, double*);
+template void SimdKernels::Scalar::movingAverageRange<double>(const double*, size_t, int, size_t, size_t, double*);
@@ -0,0 +1,146 @@
+#pragma once
+#include "StatisticsKernel.h"
+#include <cstddef>
+
+/**
+ * @brief Represents the instruction set used by the numeric kernels.
+ *
+ * - **eScalar**: Portable scalar code, the reference implementation.
+ * - **eAvx2**: 256-bit AVX2 kernels (4 doubles per instruction).
+ * - **eAvx512**: 512-bit AVX-512F kernels (8 doubles per instruction).
+ */
+enum SimdLevel
+{
+	eScalar = 0, ///< Scalar reference kernels.
+	eAvx2,       ///< AVX2 kernels.
+	eAvx512      ///< AVX-512F kernels.
+};
+
+/**
+ * @brief Detects the widest instruction set supported by the CPU and the operating system (via CPUID).
+ *
+ * @return The best SimdLevel available on this machine.
+ */
+SimdLevel detectSimdLevel();
+/**
+ * @brief Retrieves the instruction set the dispatching kernels currently use.
+ *
+ * @return The active SimdLevel (the detected level unless overridden with `setSimdLevel`).
+ */
+SimdLevel getSimdLevel();
+/**
+ * @brief Selects the instruction set used by the dispatching kernels.
+ *
+ * Requests above the detected level are clamped to it, so forcing eScalar is always possible
+ * while forcing eAvx512 on a machine without it selects the best supported level instead.
+ *
+ * @param level The requested SimdLevel.
+ */
+void setSimdLevel(SimdLevel level);
+/**
+ * @brief Retrieves a printable name for an instruction set.
+ *
+ * @param level The SimdLevel to name.
+ * @return "scalar", "avx2" or "avx512".
+ */
+const char* getSimdLevelName(SimdLevel level);
+
+/**
+ * @brief Numeric kernels of the DataProcessor with one implementation per SimdLevel.
+ *
+ * The functions directly in this namespace dispatch to the implementation selected by `getSimdLevel`.
+ * - `movingAverage` is bit-identical across all levels: the vector kernels run the same compensated
+ *   sliding-window recurrence as the scalar kernel, one `SlidingWindowSum::kResyncInterval` block per lane.
+ *   The AVX-512 level reuses the AVX2 filter, whose 4-lane gathers measured faster.
+ * - `sum` and the total of `statistics` reassociate the additions and agree with the scalar kernels to
+ *   within size * DBL_EPSILON * sum|x|. Minimum and maximum are exact. Subset averages are bit-identical
+ *   for subsets shorter than 16 values and reassociated like `sum` otherwise.
+ *
+ * `statistics`, `movingAverage` and `movingAverageRange` are templates on the sample type and use the
+ * accumulators of SampleTraits<T>; they are instantiated for double, float, std::int16_t and std::int32_t
+ * in SimdKernels.cpp. Only double has vector kernels. The other types run the scalar template: integer
+ * moving averages are summed exactly and rounded to the nearest count, and the statistics of float and
+ * integer samples are summed in independent lanes the compiler can vectorize.
+ */
+namespace SimdKernels
+{
+	/**
+ * @brief Sums a buffer.
+ *
+ * @param data Pointer to the first value.
+ * @param size The number of values.
+ * @return The sum of the values (0.0 for an empty buffer).
+ */
+	double sum(const double* data, size_t size);
+	/**
+ * @brief Computes the minimum, maximum, sum and subset averages of a buffer in a single pass.
+ *
+ * @param data Pointer to the first value.
+ * @param size The number of values.
+ * @param subsetSize The number of values per subset (at least 1).
+ * @param subsetAverages If not null, receives ceil(size / subsetSize) subset averages; a short last subset is zero padded.
+ * @param scale The physical value of one count of an integer sample type; floating point samples ignore it (default: 1.0).
+ * @return The minimum, maximum, sum and count of the buffer; the values in physical units.
+ */
+	template <typename T>
+	DataStatistics statistics(const T* data, size_t size, size_t subsetSize, double* subsetAverages, double scale = 1.0);
+	/**
+ * @brief Applies the edge-padded centered moving average filter of `DataProcessor::movingAverageFilter`.
+ *
+ * Integer samples are rounded to the nearest count; the window is odd, so there are no ties.
+ *
+ * @param data Pointer to the first raw value.
+ * @param size The number of raw values (at least 1).
+ * @param windowSize The odd window size.
+ * @param output Receives `size` filtered values.
+ */
+	template <typename T>
+	void movingAverage(const T* data, size_t size, int windowSize, T* output);
+	/**
+ * @brief Computes the outputs [begin, end) of `movingAverage`, bit-identical to the whole-buffer call.
+ *
+ * Windows near the range edges read their neighbors from `data` like the whole-buffer call does, so
+ * ranges can be filtered independently, e.g. on different threads.
+ *
+ * @param data Pointer to the first raw value of the whole buffer.
+ * @param size The number of raw values in the whole buffer (at least 1).
+ * @param windowSize The odd window size.
+ * @param begin The first output to compute, a multiple of `SlidingWindowSum::kResyncInterval`.
+ * @param end One past the last output to compute, at most `size`.
+ * @param output Receives the outputs at their positions in the whole buffer.
+ */
+	template <typename T>
+	void movingAverageRange(const T* data, size_t size, int windowSize, size_t begin, size_t end, T* output);
+
+	namespace Scalar
+	{
+		double sum(const double* data, size_t size);
+		template <typename T>
+		DataStatistics statistics(const T* data, size_t size, size_t subsetSize, double* subsetAverages, double scale = 1.0);
+		template <typename T>
+		void movingAverage(const T* data, size_t size, int windowSize, T* output);
+		/**
+ * @brief Filters the outputs [begin, end) of the moving average, re-seeding the sum at every block start.
+ *
+ * Shared by the vector kernels for the blocks they cannot run in lanes (edges and leftovers).
+ */
+		template <typename T>
+		void movingAverageRange(const T* data, size_t size, int windowSize, size_t begin, size_t end, T* output);
+	}
+
+	namespace Avx2
+	{
+		double sum(const double* data, size_t size);
+		DataStatistics statistics(const double* data, size_t size, size_t subsetSize, double* subsetAverages);
+		void movingAverage(const double* data, size_t size, int windowSize, double* output);
+		void movingAverageRange(const double* data, size_t size, int windowSize, size_t begin, size_t end, double* output);
+	}
+
+	namespace Avx512
+	{
+		double sum(const double* data, size_t size);
+		DataStatistics statistics(const double* data, size_t size, size_t subsetSize, double* subsetAverages);
+		void movingAverage(const double* data, size_t size, int windowSize, double* output);
+		void movingAverageRange(const double* data, size_t size, int windowSize, size_t begin, size_t end, double* output);
+	}
+}
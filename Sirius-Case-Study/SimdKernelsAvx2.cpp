@@ -0,0 +1,265 @@
+#include "SimdKernels.h"
+#include "SlidingWindowSum.h"
+#include <immintrin.h>
+
+// Compile these functions for AVX2 regardless of the global architecture flags, they only run after CPUID confirmed support
+#if defined(__GNUC__) || defined(__clang__)
+#define SIRIUS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIRIUS_TARGET_AVX2
+#endif
+
+namespace
+{
+	const size_t kLanes = 4;                  // Doubles per vector
+	const size_t kGroupBlocks = 2 * kLanes;   // Filter blocks processed together (two vectors for instruction-level parallelism)
+	const size_t kChunkSize = 256;            // Values per min/max chunk when subsets are short
+	const size_t kShortSubset = 16;           // Subsets shorter than this are summed with scalar code
+
+	// Neumaier-compensated addition of v to (s, c) in every lane, the same operations as CompensatedSum::add
+	SIRIUS_TARGET_AVX2 inline void compensatedAdd(__m256d& s, __m256d& c, __m256d v, __m256d absMask)
+	{
+		__m256d t = _mm256_add_pd(s, v);
+		__m256d sumIsLarger = _mm256_cmp_pd(_mm256_and_pd(s, absMask), _mm256_and_pd(v, absMask), _CMP_GE_OQ);
+		__m256d lostFromValue = _mm256_add_pd(_mm256_sub_pd(s, t), v);
+		__m256d lostFromSum = _mm256_add_pd(_mm256_sub_pd(v, t), s);
+		c = _mm256_add_pd(c, _mm256_blendv_pd(lostFromSum, lostFromValue, sumIsLarger));
+		s = t;
+	}
+
+	SIRIUS_TARGET_AVX2 inline double horizontalSum(__m256d v)
+	{
+		alignas(32) double lanes[kLanes];
+		_mm256_store_pd(lanes, v);
+		return ((lanes[0] + lanes[1]) + lanes[2]) + lanes[3];
+	}
+
+	SIRIUS_TARGET_AVX2 inline void mergeMinMax(__m256d vmin, __m256d vmax, double& minValue, double& maxValue)
+	{
+		alignas(32) double lanes[kLanes];
+		_mm256_store_pd(lanes, vmin);
+		for (size_t i = 0; i < kLanes; i++)
+		{
+			if (lanes[i] < minValue)
+				minValue = lanes[i];
+		}
+		_mm256_store_pd(lanes, vmax);
+		for (size_t i = 0; i < kLanes; i++)
+		{
+			if (lanes[i] > maxValue)
+				maxValue = lanes[i];
+		}
+	}
+
+	// Filters kGroupBlocks consecutive interior blocks starting at output `first`, one block per lane
+	SIRIUS_TARGET_AVX2 void movingAverageGroup(const double* data, int windowSize, size_t first, double* output)
+	{
+		const size_t interval = SlidingWindowSum::kResyncInterval;
+		const long long offset = (windowSize - 1) / 2;
+		const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+		const __m256d signMask = _mm256_castsi256_pd(_mm256_set1_epi64x((long long)0x8000000000000000ULL));
+		const __m256d scale = _mm256_set1_pd(1.0 / (double)windowSize);
+		const __m256i laneStride = _mm256_set_epi64x(3 * (long long)interval, 2 * (long long)interval, (long long)interval, 0);
+		const double* lanes0 = data + first;                  // Lane g of the first vector starts at block first + g * interval
+		const double* lanes1 = data + first + kLanes * interval; // ... and of the second vector at first + (g + 4) * interval
+		alignas(32) double result[kGroupBlocks];
+
+		// Re-seed every lane: sum its first window from scratch, oldest sample first
+		__m256d s0 = _mm256_setzero_pd(), c0 = _mm256_setzero_pd();
+		__m256d s1 = _mm256_setzero_pd(), c1 = _mm256_setzero_pd();
+		for (long long j = -offset; j < windowSize - offset; j++)
+		{
+			compensatedAdd(s0, c0, _mm256_i64gather_pd(lanes0 + j, laneStride, 8), absMask);
+			compensatedAdd(s1, c1, _mm256_i64gather_pd(lanes1 + j, laneStride, 8), absMask);
+		}
+
+		for (size_t t = 0; t < interval; t++)
+		{
+			if (t > 0)
+			{
+				// Slide every lane by one sample: add the entering sample, subtract the leaving one
+				long long in = (long long)t + windowSize - 1 - offset;
+				long long out = (long long)t - 1 - offset;
+				compensatedAdd(s0, c0, _mm256_i64gather_pd(lanes0 + in, laneStride, 8), absMask);
+				compensatedAdd(s1, c1, _mm256_i64gather_pd(lanes1 + in, laneStride, 8), absMask);
+				compensatedAdd(s0, c0, _mm256_xor_pd(_mm256_i64gather_pd(lanes0 + out, laneStride, 8), signMask), absMask);
+				compensatedAdd(s1, c1, _mm256_xor_pd(_mm256_i64gather_pd(lanes1 + out, laneStride, 8), signMask), absMask);
+			}
+
+			_mm256_store_pd(result, _mm256_mul_pd(_mm256_add_pd(s0, c0), scale));
+			_mm256_store_pd(result + kLanes, _mm256_mul_pd(_mm256_add_pd(s1, c1), scale));
+			for (size_t g = 0; g < kGroupBlocks; g++)
+			{
+				output[first + g * interval + t] = result[g];
+			}
+		}
+	}
+}
+
+SIRIUS_TARGET_AVX2 double SimdKernels::Avx2::sum(const double* data, size_t size)
+{
+	__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+	__m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+	size_t i = 0;
+
+	// Four independent accumulators hide the latency of the vector additions
+	for (; i + 4 * kLanes <= size; i += 4 * kLanes)
+	{
+		acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(data + i));
+		acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(data + i + kLanes));
+		acc2 = _mm256_add_pd(acc2, _mm256_loadu_pd(data + i + 2 * kLanes));
+		acc3 = _mm256_add_pd(acc3, _mm256_loadu_pd(data + i + 3 * kLanes));
+	}
+	for (; i + kLanes <= size; i += kLanes)
+	{
+		acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(data + i));
+	}
+
+	double sum = horizontalSum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+	for (; i < size; i++)
+	{
+		sum += data[i];
+	}
+	return sum;
+}
+
+SIRIUS_TARGET_AVX2 DataStatistics SimdKernels::Avx2::statistics(const double* data, size_t size, size_t subsetSize, double* subsetAverages)
+{
+	DataStatistics statistics = { size, 0.0, 0.0, 0.0 };
+	double dScale = 1.0 / (double)subsetSize;
+
+	if (size == 0)
+		return statistics;
+
+	double minValue = data[0];
+	double maxValue = data[0];
+	__m256d vmin = _mm256_set1_pd(data[0]);
+	__m256d vmax = vmin;
+	CompensatedSum total;
+
+	if (subsetSize >= kShortSubset)
+	{
+		// Long subsets: vector sums per subset, min/max in the same loads
+		for (size_t begin = 0; begin < size; begin += subsetSize)
+		{
+			size_t end = begin + subsetSize < size ? begin + subsetSize : size;
+			__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+			size_t i = begin;
+
+			for (; i + 2 * kLanes <= end; i += 2 * kLanes)
+			{
+				__m256d v0 = _mm256_loadu_pd(data + i);
+				__m256d v1 = _mm256_loadu_pd(data + i + kLanes);
+				acc0 = _mm256_add_pd(acc0, v0);
+				acc1 = _mm256_add_pd(acc1, v1);
+				vmin = _mm256_min_pd(v0, _mm256_min_pd(v1, vmin)); // The accumulator is the second operand so NaN samples are skipped like in the scalar kernel
+				vmax = _mm256_max_pd(v0, _mm256_max_pd(v1, vmax));
+			}
+			for (; i + kLanes <= end; i += kLanes)
+			{
+				__m256d v0 = _mm256_loadu_pd(data + i);
+				acc0 = _mm256_add_pd(acc0, v0);
+				vmin = _mm256_min_pd(v0, vmin);
+				vmax = _mm256_max_pd(v0, vmax);
+			}
+
+			double subsetSum = horizontalSum(_mm256_add_pd(acc0, acc1));
+			for (; i < end; i++)
+			{
+				double value = data[i];
+				subsetSum += value;
+				if (value < minValue)
+					minValue = value;
+				if (value > maxValue)
+					maxValue = value;
+			}
+
+			total.add(subsetSum);
+			if (subsetAverages)
+				*subsetAverages++ = subsetSum * dScale;
+		}
+	}
+	else
+	{
+		// Short subsets: vector min/max over a cache-resident chunk, then scalar subset sums over the same chunk
+		double subsetSum = 0.0;
+		size_t subsetFill = 0;
+
+		for (size_t begin = 0; begin < size; begin += kChunkSize)
+		{
+			size_t end = begin + kChunkSize < size ? begin + kChunkSize : size;
+			size_t i = begin;
+
+			for (; i + kLanes <= end; i += kLanes)
+			{
+				__m256d v0 = _mm256_loadu_pd(data + i);
+				vmin = _mm256_min_pd(v0, vmin);
+				vmax = _mm256_max_pd(v0, vmax);
+			}
+			for (; i < end; i++)
+			{
+				if (data[i] < minValue)
+					minValue = data[i];
+				if (data[i] > maxValue)
+					maxValue = data[i];
+			}
+
+			for (i = begin; i < end; i++)
+			{
+				subsetSum += data[i];
+				if (++subsetFill == subsetSize)
+				{
+					total.add(subsetSum);
+					if (subsetAverages)
+						*subsetAverages++ = subsetSum * dScale;
+					subsetSum = 0.0;
+					subsetFill = 0;
+				}
+			}
+		}
+
+		if (subsetFill > 0)
+		{
+			total.add(subsetSum);
+			if (subsetAverages)
+				*subsetAverages++ = subsetSum * dScale; // The short last subset is implicitly zero padded
+		}
+	}
+
+	mergeMinMax(vmin, vmax, minValue, maxValue);
+	statistics.sum = total.getValue();
+	statistics.min = minValue;
+	statistics.max = maxValue;
+	return statistics;
+}
+
+SIRIUS_TARGET_AVX2 void SimdKernels::Avx2::movingAverage(const double* data, size_t size, int windowSize, double* output)
+{
+	movingAverageRange(data, size, windowSize, 0, size, output);
+}
+
+SIRIUS_TARGET_AVX2 void SimdKernels::Avx2::movingAverageRange(const double* data, size_t size, int windowSize, size_t begin, size_t end, double* output)
+{
+	const size_t interval = SlidingWindowSum::kResyncInterval;
+	const size_t offset = (size_t)(windowSize - 1) / 2;
+	const size_t blocks = (end + interval - 1) / interval;
+	size_t block = begin / interval;
+
+	while (block < blocks)
+	{
+		size_t first = block * interval;
+		size_t last = (block + kGroupBlocks) * interval; // One past the last output of the group
+
+		// A group runs in lanes only if it lies inside the range and every window it touches lies inside the raw data (no edge padding)
+		if (block + kGroupBlocks <= blocks && last <= end && first >= offset && last + windowSize - 1 - offset <= size)
+		{
+			movingAverageGroup(data, windowSize, first, output);
+			block += kGroupBlocks;
+		}
+		else
+		{
+			Scalar::movingAverageRange(data, size, windowSize, first, first + interval < end ? first + interval : end, output);
+			block++;
+		}
+	}
+}
@@ -0,0 +1,98 @@
+#include "SlidingWindowSum.h"
+
+template <typename T>
+BasicSlidingWindowSum<T>::BasicSlidingWindowSum(int windowSize)
+	:m_window(windowSize > 0 ? windowSize : 1),        // Allocate the ring buffer once
+	 m_scale(1.0 / (double)(windowSize > 0 ? windowSize : 1)), // Scaling factor to normalize the sum to get the average
+	 m_windowSize(windowSize > 0 ? windowSize : 1),    // Set the window size
+	 m_head(0),                                        // The window starts empty
+	 m_count(0),
+	 m_outputCount(0)
+{
+	// Constructor body
+}
+
+template <typename T>
+BasicSlidingWindowSum<T>::~BasicSlidingWindowSum()
+{
+	// Destructor body
+}
+
+template <typename T>
+void BasicSlidingWindowSum<T>::push(T value)
+{
+	if (m_count < m_windowSize)
+	{
+		// Window is still filling up, place the sample after the newest one
+		int tail = m_head + m_count;
+		if (tail >= m_windowSize)
+			tail -= m_windowSize;
+		m_window[tail] = value;
+		m_count++;
+		m_sum.add((Accumulator)value);
+	}
+	else
+	{
+		// Window is full, overwrite the oldest sample and advance the head
+		T oldest = m_window[m_head];
+		m_window[m_head] = value;
+		if (++m_head == m_windowSize)
+			m_head = 0;
+		m_sum.add((Accumulator)value);    // Add the incoming sample
+		m_sum.add(-(Accumulator)oldest); // Remove the evicted sample
+	}
+
+	if (m_count == m_windowSize)
+	{
+		// Re-seed the running sum at fixed output positions to bound drift
+		if (m_outputCount % kResyncInterval == 0)
+			resync();
+		m_outputCount++;
+	}
+}
+
+template <typename T>
+bool BasicSlidingWindowSum<T>::isFull() const
+{
+	return m_count == m_windowSize;
+}
+
+template <typename T>
+T BasicSlidingWindowSum<T>::getAverage() const
+{
+	return Traits::fromAverage((double)m_sum.getValue() * m_scale);
+}
+
+template <typename T>
+int BasicSlidingWindowSum<T>::getWindowSize() const
+{
+	return m_windowSize;
+}
+
+template <typename T>
+void BasicSlidingWindowSum<T>::reset()
+{
+	m_sum.reset();
+	m_head = 0;
+	m_count = 0;
+	m_outputCount = 0;
+}
+
+template <typename T>
+void BasicSlidingWindowSum<T>::resync()
+{
+	m_sum.reset();
+	// Sum the window contents from the oldest to the newest sample
+	for (int i = 0, k = m_head; i < m_count; i++)
+	{
+		m_sum.add((Accumulator)m_window[k]);
+		if (++k == m_windowSize)
+			k = 0;
+	}
+}
+
+// The sample types the kernels support
+template class BasicSlidingWindowSum<double>;
+template class BasicSlidingWindowSum<float>;
+template class BasicSlidingWindowSum<std::int16_t>;
+template class BasicSlidingWindowSum<std::int32_t>;
@@ -0,0 +1,89 @@
+#pragma once
+#include "SampleTraits.h"
+#include <vector>
+
+/**
+ * @brief Keeps the running sum of the most recent samples, the streaming form of the moving average kernels.
+ *
+ * The sum is kept in `SampleTraits<T>::Sum`, as the kernels keep theirs, so the averages of a stream are
+ * the values the batch kernels compute: compensated for double samples and exact for integer counts.
+ *
+ * @tparam T The sample type: double, float, std::int16_t or std::int32_t.
+ */
+template <typename T>
+class BasicSlidingWindowSum
+{
+public:
+	/**
+ * @brief Number of full windows after which the running sum is recomputed from the window contents.
+ *
+ * Re-seeding the sum at fixed output positions keeps long runs from drifting and makes
+ * every output depend only on the samples since the last re-seed point.
+ */
+	static const int kResyncInterval = 4096;
+
+	/**
+ * @brief Constructs a BasicSlidingWindowSum object for a fixed window size.
+ *
+ * @param windowSize The number of samples in the window (default: 3).
+ */
+	BasicSlidingWindowSum(int windowSize = 3);
+	~BasicSlidingWindowSum();
+
+	/**
+ * @brief Pushes a sample into the window, evicting the oldest sample once the window is full.
+ *
+ * The update costs O(1): the new sample is added to the running sum and the evicted sample
+ * is subtracted from it. Every `kResyncInterval` full windows the sum is recomputed directly
+ * from the window contents (oldest to newest).
+ *
+ * @param value The sample to push.
+ */
+	void push(T value);
+	/**
+ * @brief Checks whether the window holds `m_windowSize` samples.
+ *
+ * @return True if the window is full and `getAverage` is meaningful.
+ */
+	bool isFull() const;
+	/**
+ * @brief Retrieves the average of the samples currently in the window.
+ *
+ * For double samples the result agrees with a direct left-to-right summation of the window to
+ * within (windowSize + 2) * DBL_EPSILON * max|x| over the window. Integer averages are rounded
+ * to the nearest count, as `SampleTraits<T>::fromAverage` rounds them.
+ *
+ * @return The window sum scaled by 1 / windowSize, as a sample.
+ */
+	T getAverage() const;
+	/**
+ * @brief Retrieves the window size.
+ *
+ * @return The number of samples in a full window.
+ */
+	int getWindowSize() const;
+	/**
+ * @brief Empties the window and clears the running sum.
+ */
+	void reset();
+
+private:
+
+	using Traits = SampleTraits<T>;
+	using Accumulator = typename Traits::Accumulator;
+
+	std::vector<T> m_window;   // Ring buffer holding the samples currently in the window
+	typename Traits::Sum m_sum; // Running sum of the samples in m_window
+	double m_scale;            // Scaling factor (1 / m_windowSize) to turn the sum into an average
+	int m_windowSize;          // The number of samples in a full window
+	int m_head;                // Index of the oldest sample in m_window
+	int m_count;               // The number of samples currently in the window
+	long long m_outputCount;   // The number of full windows produced since the last reset
+
+	/**
+ * @brief Recomputes the running sum from the window contents, oldest sample first.
+ */
+	void resync();
+};
+
+using SlidingWindowSum = BasicSlidingWindowSum<double>;
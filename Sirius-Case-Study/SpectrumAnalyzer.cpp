@@ -0,0 +1,170 @@
+#include "SpectrumAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+const char* getSpectralWindowName(SpectralWindow window)
+{
+	static const char* const kNames[] = { "rectangular", "hann", "hamming", "blackman" };
+	return window >= eRectangularWindow && window <= eBlackmanWindow ? kNames[window] : "unknown";
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer(size_t segmentSize, SpectralWindow window, size_t hopSize)
+	: m_fft(segmentSize),   // Rounds the segment size up to a power of two
+	  m_window(window),     // Applied to every segment
+	  m_hopSize(0),         // Set below once the segment size is known
+	  m_filled(0),          // No data point buffered yet
+	  m_segmentCount(0)     // No segment analyzed yet
+{
+	size_t size = m_fft.getSize();
+	m_hopSize = hopSize == 0 ? size / 2 : std::min(hopSize, size);
+
+	// Periodic windows (the period is the segment size), as usual for spectral analysis
+	m_coefficients.resize(size);
+	double sumOfSquares = 0.0;
+	for (size_t n = 0; n < size; n++)
+	{
+		double phase = 2.0 * std::numbers::pi * (double)n / (double)size;
+		double coefficient = 1.0;
+		if (window == eHannWindow)
+			coefficient = 0.5 - 0.5 * std::cos(phase);
+		else if (window == eHammingWindow)
+			coefficient = 0.54 - 0.46 * std::cos(phase);
+		else if (window == eBlackmanWindow)
+			coefficient = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+		m_coefficients[n] = coefficient;
+		sumOfSquares += coefficient * coefficient;
+	}
+
+	// Parseval: the bins of a full spectrum add up to size * sum of (w[n] * x[n])^2. Every bin except DC and
+	// Nyquist also stands for its mirror image above size / 2, so it counts twice in the one-sided spectrum.
+	size_t binCount = m_fft.getBinCount();
+	m_binScale.assign(binCount, 2.0 / ((double)size * sumOfSquares));
+	m_binScale.front() *= 0.5;
+	m_binScale.back() *= 0.5;
+
+	m_segment.resize(size);
+	m_windowed.resize(size);
+	m_spectrum.resize(binCount);
+	m_power.assign(binCount, 0.0);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+	// Destructor body
+}
+
+void SpectrumAnalyzer::process(std::span<const double> block)
+{
+	size_t size = m_segment.size();
+	while (!block.empty())
+	{
+		size_t count = std::min(size - m_filled, block.size());
+		std::copy(block.begin(), block.begin() + count, m_segment.begin() + m_filled);
+		m_filled += count;
+		block = block.subspan(count);
+
+		if (m_filled == size)
+		{
+			analyzeSegment();
+
+			// The next segment starts one hop later and shares the rest of this one
+			std::copy(m_segment.begin() + m_hopSize, m_segment.end(), m_segment.begin());
+			m_filled = size - m_hopSize;
+		}
+	}
+}
+
+void SpectrumAnalyzer::reset()
+{
+	m_filled = 0;
+	m_segmentCount = 0;
+	std::fill(m_power.begin(), m_power.end(), 0.0);
+}
+
+std::span<const double> SpectrumAnalyzer::getPowerSpectrum() const
+{
+	return m_power;
+}
+
+size_t SpectrumAnalyzer::getSegmentCount() const
+{
+	return m_segmentCount;
+}
+
+size_t SpectrumAnalyzer::getSegmentSize() const
+{
+	return m_segment.size();
+}
+
+SpectralWindow SpectrumAnalyzer::getWindow() const
+{
+	return m_window;
+}
+
+double SpectrumAnalyzer::getBinFrequency(size_t bin, double sampleRate) const
+{
+	return (double)bin * sampleRate / (double)m_segment.size();
+}
+
+double SpectrumAnalyzer::getDominantFrequency(double sampleRate) const
+{
+	if (m_segmentCount == 0)
+		return 0.0;
+
+	size_t peak = 1;
+	for (size_t k = 2; k < m_power.size(); k++)
+	{
+		if (m_power[k] > m_power[peak])
+			peak = k;
+	}
+
+	// Refine between bins with a parabola through the logarithms of the peak and its neighbors
+	double offset = 0.0;
+	if (peak + 1 < m_power.size() && m_power[peak - 1] > 0.0 && m_power[peak + 1] > 0.0)
+	{
+		double left = std::log(m_power[peak - 1]);
+		double center = std::log(m_power[peak]);
+		double right = std::log(m_power[peak + 1]);
+		double curvature = left - 2.0 * center + right;
+		if (curvature < 0.0)
+			offset = 0.5 * (left - right) / curvature;
+	}
+	return ((double)peak + offset) * sampleRate / (double)m_segment.size();
+}
+
+double SpectrumAnalyzer::getBandEnergy(double lowFrequency, double highFrequency, double sampleRate) const
+{
+	double energy = 0.0;
+	for (size_t k = 0; k < m_power.size(); k++)
+	{
+		double frequency = getBinFrequency(k, sampleRate);
+		if (frequency >= lowFrequency && frequency <= highFrequency)
+			energy += m_power[k];
+	}
+	return energy;
+}
+
+double SpectrumAnalyzer::getTotalEnergy() const
+{
+	double energy = 0.0;
+	for (double power : m_power)
+		energy += power;
+	return energy;
+}
+
+void SpectrumAnalyzer::analyzeSegment()
+{
+	for (size_t n = 0; n < m_segment.size(); n++)
+		m_windowed[n] = m_segment[n] * m_coefficients[n];
+	m_fft.forward(m_windowed, m_spectrum);
+
+	// Running mean over the segments, so the spectrum is valid after every segment
+	m_segmentCount++;
+	double weight = 1.0 / (double)m_segmentCount;
+	for (size_t k = 0; k < m_power.size(); k++)
+	{
+		double power = std::norm(m_spectrum[k]) * m_binScale[k];
+		m_power[k] += (power - m_power[k]) * weight;
+	}
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include "RealFft.h"
+#include <complex>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Represents the window applied to every segment before its transform.
+ */
+enum SpectralWindow
+{
+	eRectangularWindow = 0, ///< No tapering; the narrowest peaks but the most leakage.
+	eHannWindow,            ///< Raised cosine, a good default for periodic signals.
+	eHammingWindow,         ///< Raised cosine on a pedestal, a lower first side lobe than Hann.
+	eBlackmanWindow         ///< Three cosine terms, the lowest leakage but the widest peaks.
+};
+
+/**
+ * @brief Retrieves the lower-case name of a spectral window.
+ *
+ * @param window The window.
+ * @return The name, e.g. "hann".
+ */
+const char* getSpectralWindowName(SpectralWindow window);
+
+/**
+ * @brief Estimates the power spectrum of a signal by Welch's method.
+ *
+ * The signal is cut into overlapping segments of `segmentSize` data points, every segment is
+ * multiplied by the window and transformed by a RealFft, and the power of each bin is averaged over
+ * the segments. Averaging lowers the variance of the estimate, the overlap (half a segment by
+ * default) recovers most of the data the window attenuates at the segment edges.
+ *
+ * The analyzer is fed like a filter stage: `process` accepts blocks of any size, down to single data
+ * points, and transforms a segment as soon as it is complete, so the spectrum is kept up to date
+ * while a capture is streamed. The window, the transform tables and every buffer are set up by the
+ * constructor; feeding data allocates nothing.
+ *
+ * The spectrum is one-sided and scaled so that the sum of all bins equals the mean square of the
+ * signal, so `getBandEnergy` returns the power of the signal within a band.
+ */
+class SpectrumAnalyzer
+{
+public:
+	/**
+ * @brief Constructs a SpectrumAnalyzer object.
+ *
+ * @param segmentSize The number of data points per segment; rounded up to a power of two, at least 2.
+ * @param window The window applied to every segment (default: eHannWindow).
+ * @param hopSize The number of data points between the starts of two segments, 1 to segmentSize (default: 0, half a segment).
+ */
+	SpectrumAnalyzer(size_t segmentSize, SpectralWindow window = eHannWindow, size_t hopSize = 0);
+	~SpectrumAnalyzer();
+
+	/**
+ * @brief Feeds the next data points of the signal.
+ *
+ * @param block The data points, in order; any number.
+ */
+	void process(std::span<const double> block);
+	/**
+ * @brief Discards the averaged spectrum and the buffered data points.
+ */
+	void reset();
+
+	/**
+ * @brief Retrieves the averaged power spectrum.
+ *
+ * Bin k is centered on k / segmentSize cycles per data point, i.e. k * sampleRate / segmentSize.
+ *
+ * @return The power of bins 0 to segmentSize / 2, all 0.0 until the first segment is complete.
+ */
+	std::span<const double> getPowerSpectrum() const;
+	/**
+ * @brief Retrieves the number of segments averaged so far.
+ *
+ * @return The number of complete segments.
+ */
+	size_t getSegmentCount() const;
+	/**
+ * @brief Retrieves the number of data points per segment.
+ *
+ * @return The segment size, a power of two.
+ */
+	size_t getSegmentSize() const;
+	/**
+ * @brief Retrieves the window applied to every segment.
+ *
+ * @return The window.
+ */
+	SpectralWindow getWindow() const;
+	/**
+ * @brief Retrieves the center frequency of a bin.
+ *
+ * @param bin The bin index.
+ * @param sampleRate The number of data points per second (default: 1.0, frequencies in cycles per data point).
+ * @return The frequency.
+ */
+	double getBinFrequency(size_t bin, double sampleRate = 1.0) const;
+	/**
+ * @brief Retrieves the frequency of the strongest spectral peak, ignoring the DC bin.
+ *
+ * The peak is located between bins by fitting a parabola through the logarithms of the three
+ * largest values around it, which is exact for a Gaussian-shaped peak and within a few hundredths
+ * of a bin for the windows above.
+ *
+ * @param sampleRate The number of data points per second (default: 1.0, frequencies in cycles per data point).
+ * @return The frequency, or 0.0 if no segment has been analyzed.
+ */
+	double getDominantFrequency(double sampleRate = 1.0) const;
+	/**
+ * @brief Retrieves the power of the signal within a frequency band.
+ *
+ * @param lowFrequency The lower edge of the band.
+ * @param highFrequency The upper edge of the band.
+ * @param sampleRate The number of data points per second the edges refer to (default: 1.0, cycles per data point).
+ * @return The sum of the bins whose center lies within [lowFrequency, highFrequency].
+ */
+	double getBandEnergy(double lowFrequency, double highFrequency, double sampleRate = 1.0) const;
+	/**
+ * @brief Retrieves the total power of the signal.
+ *
+ * @return The sum of all bins, the mean square of the analyzed segments.
+ */
+	double getTotalEnergy() const;
+
+private:
+
+	RealFft m_fft;                                // The transform of one segment
+	SpectralWindow m_window;                      // The window type
+	size_t m_hopSize;                             // Data points between the starts of two segments
+	std::vector<double> m_coefficients;           // The window coefficients
+	std::vector<double> m_binScale;               // Converts |X[k]|^2 into one-sided power per bin
+	std::vector<double> m_segment;                // The data points of the segment being filled
+	size_t m_filled;                              // The number of data points in m_segment
+	std::vector<double> m_windowed;               // The windowed segment handed to the transform
+	std::vector<std::complex<double>> m_spectrum; // The transform of the last segment
+	std::vector<double> m_power;                  // The power spectrum averaged over every segment
+	size_t m_segmentCount;                        // The number of segments in m_power
+
+	/**
+ * @brief Windows and transforms the complete segment and adds its power to the average.
+ */
+	void analyzeSegment();
+};
@@ -0,0 +1,246 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @brief Represents what a bounded buffer does when a value is pushed while it is full.
+ *
+ * - **eBlock**: The producer waits until the consumer frees a slot. No value is lost.
+ * - **eDropOldest**: The oldest buffered value is discarded to make room for the new one.
+ * - **eDropNewest**: The new value is discarded and the buffered values are kept.
+ */
+enum OverflowPolicy
+{
+	eBlock = 0,  ///< Wait for free space.
+	eDropOldest, ///< Discard the oldest buffered value.
+	eDropNewest  ///< Discard the value being pushed.
+};
+
+/**
+ * @brief A bounded single-producer/single-consumer ring buffer.
+ *
+ * Exactly one thread may call `push`/`close` and exactly one other thread may call `tryPop`.
+ * The read and write indices live on separate cache lines, and each side keeps a cached copy
+ * of the other side's index so that it only touches the shared cache line when the buffer
+ * looks full (producer) or empty (consumer).
+ *
+ * `push` is wait-free for eDropOldest and eDropNewest, and `tryPop` is wait-free for eBlock and
+ * eDropNewest. With eDropOldest the producer may advance the read index itself, so `tryPop`
+ * becomes lock-free: it retries only when the value it was reading got dropped.
+ *
+ * Slots are stored as arrays of atomic 64-bit words, so a value that is overwritten by
+ * eDropOldest while the consumer is reading it is a benign, detected race rather than
+ * undefined behavior. `T` must therefore be trivially copyable.
+ */
+template <typename T>
+class SpscRingBuffer
+{
+	static_assert(std::is_trivially_copyable<T>::value, "SpscRingBuffer requires a trivially copyable type");
+
+public:
+	/**
+ * @brief Constructs a SpscRingBuffer object.
+ *
+ * @param capacity The number of values the buffer can hold, rounded up to a power of two (default: 4096).
+ * @param policy The behavior of `push` when the buffer is full (default: eBlock).
+ */
+	SpscRingBuffer(size_t capacity = 4096, OverflowPolicy policy = eBlock)
+		: m_capacity(roundUpToPowerOfTwo(capacity)),
+		  m_mask(m_capacity - 1),
+		  m_policy(policy),
+		  m_slots(new Slot[m_capacity]),
+		  m_head(0),
+		  m_cachedTail(0),
+		  m_tail(0),
+		  m_cachedHead(0),
+		  m_droppedCount(0),
+		  m_closed(false)
+	{
+	}
+
+	~SpscRingBuffer()
+	{
+		// Destructor body
+	}
+
+	SpscRingBuffer(const SpscRingBuffer&) = delete;
+	SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+	/**
+ * @brief Pushes a value into the buffer (producer side).
+ *
+ * If the buffer is full, the configured `OverflowPolicy` decides whether the producer waits,
+ * the oldest value is discarded or the new value is discarded. Discarded values are counted.
+ *
+ * @param value The value to push.
+ * @return True if the value was stored, false if it was discarded (eDropNewest only).
+ */
+	bool push(const T& value)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+
+		while (tail - m_cachedHead >= m_capacity)
+		{
+			// The buffer looks full, refresh the consumer's position before deciding
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			if (tail - m_cachedHead < m_capacity)
+				break;
+
+			if (m_policy == eDropNewest)
+			{
+				m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else if (m_policy == eDropOldest)
+			{
+				// Claim the oldest value; if the consumer took it first, there is room now anyway
+				size_t head = m_cachedHead;
+				if (m_head.compare_exchange_strong(head, head + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+				{
+					m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+					m_cachedHead = head + 1;
+				}
+				else
+				{
+					m_cachedHead = head;
+				}
+			}
+			else
+			{
+				std::this_thread::yield(); // Wait for the consumer to free a slot
+			}
+		}
+
+		writeSlot(m_slots[tail & m_mask], value);
+		m_tail.store(tail + 1, std::memory_order_release); // Publish the value to the consumer
+		return true;
+	}
+
+	/**
+ * @brief Pops the oldest value from the buffer (consumer side).
+ *
+ * @param value Receives the popped value.
+ * @return True if a value was popped, false if the buffer was empty.
+ */
+	bool tryPop(T& value)
+	{
+		while (true)
+		{
+			size_t head = m_head.load(std::memory_order_relaxed);
+			// With eDropOldest the producer can move the read index past the cached write index
+			if (head >= m_cachedTail)
+			{
+				// The buffer looks empty, refresh the producer's position
+				m_cachedTail = m_tail.load(std::memory_order_acquire);
+				if (head >= m_cachedTail)
+					return false;
+			}
+
+			readSlot(m_slots[head & m_mask], value);
+
+			if (m_policy != eDropOldest)
+			{
+				// Only the consumer moves the read index, a plain store releases the slot
+				m_head.store(head + 1, std::memory_order_release);
+				return true;
+			}
+
+			// The producer may have dropped this value while it was being read; if so, read again
+			if (m_head.compare_exchange_strong(head, head + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+				return true;
+		}
+	}
+
+	/**
+ * @brief Marks the end of the stream (producer side). Values already pushed can still be popped.
+ */
+	void close()
+	{
+		m_closed.store(true, std::memory_order_release);
+	}
+
+	/**
+ * @brief Checks whether the producer has closed the buffer and every value has been popped.
+ *
+ * @return True if no more values will ever be available.
+ */
+	bool isDrained() const
+	{
+		// Read the closed flag first so that a value pushed right before close() is never missed
+		bool closed = m_closed.load(std::memory_order_acquire);
+		return closed && m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+	}
+
+	/**
+ * @brief Retrieves the number of values discarded because the buffer was full.
+ *
+ * @return The number of dropped values.
+ */
+	size_t getDroppedCount() const
+	{
+		return m_droppedCount.load(std::memory_order_relaxed);
+	}
+
+	/**
+ * @brief Retrieves the capacity of the buffer.
+ *
+ * @return The number of values the buffer can hold.
+ */
+	size_t getCapacity() const
+	{
+		return m_capacity;
+	}
+
+private:
+
+	static const size_t kCacheLineSize = 64;
+	static const size_t kWordsPerSlot = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+	struct Slot
+	{
+		std::atomic<std::uint64_t> words[kWordsPerSlot];
+	};
+
+	const size_t m_capacity;                // The number of slots (a power of two)
+	const size_t m_mask;                    // Mask to turn an index into a slot position
+	const OverflowPolicy m_policy;          // What push does when the buffer is full
+	std::unique_ptr<Slot[]> m_slots;        // The slot storage
+
+	alignas(kCacheLineSize) std::atomic<size_t> m_head; // Index of the next value to pop, written by the consumer (and by the producer for eDropOldest)
+	size_t m_cachedTail;                                // The consumer's last observed value of m_tail
+
+	alignas(kCacheLineSize) std::atomic<size_t> m_tail; // Index of the next slot to write, written by the producer
+	size_t m_cachedHead;                                // The producer's last observed value of m_head
+
+	alignas(kCacheLineSize) std::atomic<size_t> m_droppedCount; // The number of values discarded on overflow
+	std::atomic<bool> m_closed;                                 // Set by the producer once it will push no more values
+
+	static size_t roundUpToPowerOfTwo(size_t value)
+	{
+		size_t result = 1;
+		while (result < value)
+			result <<= 1;
+		return result;
+	}
+
+	static void writeSlot(Slot& slot, const T& value)
+	{
+		std::uint64_t words[kWordsPerSlot] = {};
+		std::memcpy(words, &value, sizeof(T));
+		for (size_t i = 0; i < kWordsPerSlot; i++)
+			slot.words[i].store(words[i], std::memory_order_relaxed);
+	}
+
+	static void readSlot(const Slot& slot, T& value)
+	{
+		std::uint64_t words[kWordsPerSlot];
+		for (size_t i = 0; i < kWordsPerSlot; i++)
+			words[i] = slot.words[i].load(std::memory_order_relaxed);
+		std::memcpy(&value, words, sizeof(T));
+	}
+};
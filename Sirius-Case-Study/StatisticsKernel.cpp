@@ -0,0 +1,64 @@
+#include "StatisticsKernel.h"
+#include "SimdKernels.h"
+#include "CompensatedSum.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdint>
+
+template <typename T>
+DataStatistics computeDataStatistics(const T* data, size_t size, int subsetSize, std::vector<double>* subsetAverages, double scale)
+{
+	size_t step = subsetSize > 0 ? (size_t)subsetSize : 1;
+
+	if (subsetAverages)
+		subsetAverages->resize((size + step - 1) / step); // One average per subset, the last one possibly zero padded
+
+	// Dispatch to the widest kernel the CPU supports
+	return SimdKernels::statistics(data, size, step, subsetAverages ? subsetAverages->data() : nullptr, scale);
+}
+
+// The sample types of SampleTraits; other types do not link
+template DataStatistics computeDataStatistics<double>(const double*, size_t, int, std::vector<double>*, double);
+template DataStatistics computeDataStatistics<float>(const float*, size_t, int, std::vector<double>*, double);
+template DataStatistics computeDataStatistics<std::int16_t>(const std::int16_t*, size_t, int, std::vector<double>*, double);
+template DataStatistics computeDataStatistics<std::int32_t>(const std::int32_t*, size_t, int, std::vector<double>*, double);
+
+template <typename T>
+DataStatistics computeDataStatisticsParallel(const T* data, size_t size, int subsetSize, std::vector<double>* subsetAverages,
+											 ThreadPool& pool, size_t chunkSize, double scale)
+{
+	size_t step = subsetSize > 0 ? (size_t)subsetSize : 1;
+	size_t chunk = (std::max(chunkSize, (size_t)1) + step - 1) / step * step; // Whole subsets only
+	size_t chunkCount = (size + chunk - 1) / chunk;
+	if (chunkCount <= 1)
+		return computeDataStatistics(data, size, subsetSize, subsetAverages, scale);
+
+	if (subsetAverages)
+		subsetAverages->resize((size + step - 1) / step);
+	double* averages = subsetAverages ? subsetAverages->data() : nullptr;
+
+	// Every chunk writes its own subset averages and its own partial statistics
+	std::vector<DataStatistics> partials(chunkCount);
+	pool.parallelFor(chunkCount, [data, size, step, chunk, averages, scale, &partials](size_t index)
+	{
+		size_t begin = index * chunk;
+		size_t end = std::min(begin + chunk, size);
+		partials[index] = SimdKernels::statistics(data + begin, end - begin, step, averages ? averages + begin / step : nullptr, scale);
+	});
+
+	// Reduce in chunk order, independent of which thread finished first
+	DataStatistics statistics = { size, 0.0, partials[0].min, partials[0].max };
+	CompensatedSum total;
+	for (const DataStatistics& partial : partials)
+	{
+		total.add(partial.sum);
+		statistics.min = std::min(statistics.min, partial.min);
+		statistics.max = std::max(statistics.max, partial.max);
+	}
+	statistics.sum = total.getValue();
+	return statistics;
+}
+template DataStatistics computeDataStatisticsParallel<double>(const double*, size_t, int, std::vector<double>*, ThreadPool&, size_t, double);
+template DataStatistics computeDataStatisticsParallel<float>(const float*, size_t, int, std::vector<double>*, ThreadPool&, size_t, double);
+template DataStatistics computeDataStatisticsParallel<std::int16_t>(const std::int16_t*, size_t, int, std::vector<double>*, ThreadPool&, size_t, double);
+template DataStatistics computeDataStatisticsParallel<std::int32_t>(const std::int32_t*, size_t, int, std::vector<double>*, ThreadPool&, size_t, double);
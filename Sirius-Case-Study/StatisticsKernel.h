@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @brief Summary statistics of a data buffer.
+ */
+struct DataStatistics
+{
+	size_t count; ///< The number of values in the buffer.
+	double sum;   ///< The sum of the values.
+	double min;   ///< The smallest value, or 0.0 if the buffer is empty.
+	double max;   ///< The largest value, or 0.0 if the buffer is empty.
+};
+
+/**
+ * @brief Computes the minimum, maximum, sum and subset averages of a buffer in a single pass.
+ *
+ * The buffer is walked once, one subset of `subsetSize` values at a time: each value updates the
+ * running minimum and maximum and the current subset sum, and each completed subset sum is added
+ * to the (Neumaier-compensated) total. If the size is not a multiple of `subsetSize`, the last
+ * subset is averaged as if it were padded with zeros, like `DataProcessor::calculateSubsetAverage`.
+ * No temporary copy of the buffer is made. The work is done by `SimdKernels::statistics`, which
+ * picks the scalar, AVX2 or AVX-512 implementation at runtime. The sample type is double, float,
+ * std::int16_t or std::int32_t (see SampleTraits); the results are in physical units.
+ *
+ * @param data Pointer to the first value of the buffer.
+ * @param size The number of values in the buffer.
+ * @param subsetSize The number of values in each subset (values below 1 are treated as 1).
+ * @param subsetAverages If not null, receives the average of each subset (previous contents are replaced).
+ * @param scale The physical value of one count of integer samples; ignored for floating point samples.
+ * @return The minimum, maximum, sum and count of the buffer.
+ */
+template <typename T>
+DataStatistics computeDataStatistics(const T* data, size_t size, int subsetSize, std::vector<double>* subsetAverages, double scale = 1.0);
+
+/**
+ * @brief Computes the same statistics as `computeDataStatistics` with the buffer split into chunks on a thread pool.
+ *
+ * The chunks are whole numbers of subsets, so every subset lies in one chunk and the subset averages,
+ * the minimum and the maximum are exactly those of `computeDataStatistics`. The chunk sums are added in
+ * chunk order with Neumaier compensation. The chunks depend only on the size, `subsetSize` and `chunkSize`,
+ * never on the number of threads, so the sum is reproducible on any machine; it agrees with the
+ * single-threaded sum to within size * DBL_EPSILON * sum|x|.
+ *
+ * @param data Pointer to the first value of the buffer.
+ * @param size The number of values in the buffer.
+ * @param subsetSize The number of values in each subset (values below 1 are treated as 1).
+ * @param subsetAverages If not null, receives the average of each subset (previous contents are replaced).
+ * @param pool The thread pool running the chunks; the calling thread takes part.
+ * @param chunkSize The number of values per chunk, rounded up to a whole number of subsets.
+ * @param scale The physical value of one count of integer samples; ignored for floating point samples.
+ * @return The minimum, maximum, sum and count of the buffer.
+ */
+template <typename T>
+DataStatistics computeDataStatisticsParallel(const T* data, size_t size, int subsetSize, std::vector<double>* subsetAverages,
+											 ThreadPool& pool, size_t chunkSize, double scale = 1.0);
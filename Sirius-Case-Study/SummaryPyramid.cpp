@@ -0,0 +1,159 @@
+#include "SummaryPyramid.h"
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+SummaryPyramid::SummaryPyramid()
+{
+	// Constructor body
+}
+
+SummaryPyramid::~SummaryPyramid()
+{
+	// Destructor body
+}
+
+void SummaryPyramid::append(double value)
+{
+	m_values.push_back(value);
+
+	// Only every second value completes a block
+	if ((m_values.size() & 1) == 0)
+		propagate();
+}
+
+void SummaryPyramid::append(std::span<const double> values)
+{
+	m_values.insert(m_values.end(), values.begin(), values.end());
+	propagate();
+}
+
+void SummaryPyramid::assign(std::span<const double> values)
+{
+	clear();
+	append(values);
+}
+
+void SummaryPyramid::clear()
+{
+	m_values.clear();
+	for (std::vector<Block>& level : m_levels)
+		level.clear();
+}
+
+void SummaryPyramid::reserve(size_t capacity)
+{
+	m_values.reserve(capacity);
+	size_t levelCount = capacity > 1 ? (size_t)std::bit_width(capacity) - 1 : 0;
+	if (m_levels.size() < levelCount)
+		m_levels.resize(levelCount);
+	for (size_t k = 1; k <= levelCount; k++)
+		m_levels[k - 1].reserve(capacity >> k);
+}
+
+size_t SummaryPyramid::size() const
+{
+	return m_values.size();
+}
+
+size_t SummaryPyramid::getLevelCount() const
+{
+	return (size_t)std::bit_width(m_values.size());
+}
+
+size_t SummaryPyramid::getBlockCount(size_t level) const
+{
+	return level < getLevelCount() ? m_values.size() >> level : 0;
+}
+
+DataStatistics SummaryPyramid::getBlock(size_t level, size_t index) const
+{
+	if (level == 0)
+		return DataStatistics{ 1, m_values[index], m_values[index], m_values[index] };
+	const Block& block = m_levels[level - 1][index];
+	return DataStatistics{ (size_t)1 << level, block.sum, block.min, block.max };
+}
+
+DataStatistics SummaryPyramid::query(size_t begin, size_t end) const
+{
+	end = std::min(end, m_values.size());
+	if (begin >= end)
+		return DataStatistics();
+
+	// Bottom-up segment tree walk: an odd left edge or an odd right edge is a block of its own at this
+	// level, everything between them is covered by the blocks of the next level. Every block read is
+	// complete, because the right edge never passes size >> level.
+	DataStatistics result = { end - begin, 0.0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+	size_t left = begin;
+	size_t right = end;
+	for (size_t level = 0; left < right; level++)
+	{
+		if (left & 1)
+		{
+			DataStatistics block = getBlock(level, left++);
+			result.sum += block.sum;
+			result.min = std::min(result.min, block.min);
+			result.max = std::max(result.max, block.max);
+		}
+		if (right & 1)
+		{
+			DataStatistics block = getBlock(level, --right);
+			result.sum += block.sum;
+			result.min = std::min(result.min, block.min);
+			result.max = std::max(result.max, block.max);
+		}
+		left >>= 1;
+		right >>= 1;
+	}
+	return result;
+}
+
+void SummaryPyramid::downsample(size_t begin, size_t end, size_t bucketCount, std::vector<DataStatistics>& buckets) const
+{
+	end = std::min(end, m_values.size());
+	size_t length = end > begin ? end - begin : 0;
+	buckets.resize(bucketCount);
+	for (size_t i = 0; i < bucketCount; i++)
+		buckets[i] = query(begin + i * length / bucketCount, begin + (i + 1) * length / bucketCount);
+}
+
+void SummaryPyramid::propagate()
+{
+	size_t size = m_values.size();
+	for (size_t k = 1; (size >> k) > 0; k++)
+	{
+		if (m_levels.size() < k)
+			m_levels.emplace_back();
+		std::vector<Block>& level = m_levels[k - 1];
+		size_t first = level.size();
+		size_t complete = size >> k;
+
+		// A level without a new block cannot complete one on the levels above
+		if (first == complete)
+			break;
+
+		// Sized once and filled through pointers, so the loops carry no capacity checks
+		level.resize(complete);
+		Block* blocks = level.data();
+		if (k == 1)
+		{
+			const double* values = m_values.data();
+			for (size_t i = first; i < complete; i++)
+			{
+				double a = values[2 * i];
+				double b = values[2 * i + 1];
+				blocks[i] = Block{ std::min(a, b), std::max(a, b), a + b };
+			}
+		}
+		else
+		{
+			const Block* children = m_levels[k - 2].data();
+			for (size_t i = first; i < complete; i++)
+			{
+				const Block& a = children[2 * i];
+				const Block& b = children[2 * i + 1];
+				blocks[i] = Block{ std::min(a.min, b.min), std::max(a.max, b.max), a.sum + b.sum };
+			}
+		}
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include "StatisticsKernel.h"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ * @brief A hierarchical summary of a growing data series that answers range statistics in O(log N).
+ *
+ * Level 0 holds the values themselves. Level k (k >= 1) holds the minimum, maximum and sum of every
+ * complete, aligned block of 2^k values, computed from two blocks of level k - 1. Blocks are added
+ * as soon as they are complete, so appending a value costs amortized O(1) and the pyramid is always
+ * up to date while a capture is streamed. An incomplete block at the end of a level is not stored;
+ * its values are still reachable through the lower levels.
+ *
+ * `query` splits any range [begin, end) into at most two blocks per level, like a segment tree, so it
+ * reads O(log N) entries whatever the length of the range. `downsample` answers one query per bucket
+ * and therefore builds a zoomed-out view of any part of the series in O(buckets * log N).
+ *
+ * The levels above 0 take 24 bytes per value in total, so the pyramid needs four times the memory
+ * of the data it summarizes. Sums are formed pairwise, so they are at least as accurate as a
+ * running sum, but they are not bit-identical to `computeDataStatistics`.
+ */
+class SummaryPyramid
+{
+public:
+	SummaryPyramid();
+	~SummaryPyramid();
+
+	/**
+ * @brief Appends a value to the series.
+ *
+ * @param value The value.
+ */
+	void append(double value);
+	/**
+ * @brief Appends values to the series.
+ *
+ * @param values The values, in order.
+ */
+	void append(std::span<const double> values);
+	/**
+ * @brief Replaces the series.
+ *
+ * @param values The new values, in order.
+ */
+	void assign(std::span<const double> values);
+	/**
+ * @brief Removes every value; the storage is kept.
+ */
+	void clear();
+	/**
+ * @brief Makes room for a number of values, so appending up to that many does not allocate.
+ *
+ * @param capacity The number of values.
+ */
+	void reserve(size_t capacity);
+
+	/**
+ * @brief Retrieves the number of values in the series.
+ *
+ * @return The number of values.
+ */
+	size_t size() const;
+	/**
+ * @brief Retrieves the number of levels, including level 0.
+ *
+ * @return 1 + floor(log2(size)), or 0 if the series is empty.
+ */
+	size_t getLevelCount() const;
+	/**
+ * @brief Retrieves the number of complete blocks of a level.
+ *
+ * @param level The level; its blocks hold 2^level values.
+ * @return size >> level.
+ */
+	size_t getBlockCount(size_t level) const;
+	/**
+ * @brief Retrieves the summary of one block.
+ *
+ * @param level The level; its blocks hold 2^level values.
+ * @param index The block index, below `getBlockCount(level)`; the block starts at value index << level.
+ * @return The count, sum, minimum and maximum of the block.
+ */
+	DataStatistics getBlock(size_t level, size_t index) const;
+	/**
+ * @brief Computes the statistics of a range of the series.
+ *
+ * @param begin The index of the first value.
+ * @param end One past the index of the last value; clamped to the size.
+ * @return The count, sum, minimum and maximum of the range; all zero if it is empty.
+ */
+	DataStatistics query(size_t begin, size_t end) const;
+	/**
+ * @brief Summarizes a range of the series in buckets of (almost) equal length.
+ *
+ * Bucket i covers [begin + i * length / bucketCount, begin + (i + 1) * length / bucketCount), so the
+ * buckets differ in length by at most one value. A range shorter than `bucketCount` gives buckets of
+ * a single value and some empty ones.
+ *
+ * @param begin The index of the first value.
+ * @param end One past the index of the last value; clamped to the size.
+ * @param bucketCount The number of buckets.
+ * @param buckets Receives the statistics of every bucket (previous contents are replaced).
+ */
+	void downsample(size_t begin, size_t end, size_t bucketCount, std::vector<DataStatistics>& buckets) const;
+
+private:
+
+	// Summary of a complete block; the count follows from the level
+	struct Block
+	{
+		double min; // The smallest value of the block
+		double max; // The largest value of the block
+		double sum; // The sum of the values of the block
+	};
+
+	std::vector<double> m_values;             // Level 0, the values themselves
+	std::vector<std::vector<Block>> m_levels; // m_levels[k - 1] holds the blocks of 2^k values
+
+	/**
+ * @brief Adds the blocks completed by the latest values to every level above 0.
+ */
+	void propagate();
+};
@@ -0,0 +1,1969 @@
+#include "TestSuite.h"
+#include "../CaptureFile.h"
+#include "../CompressedSampleStore.h"
+#include "../DataProcessor.h"
+#include "../FilterChain.h"
+#include "../JitterHistogram.h"
+#include "../Logger.h"
+#include "../QuantileSketch.h"
+#include "../RandomEngine.h"
+#include "../RealFft.h"
+#include "../ReplaySource.h"
+#include "../SampleScheduler.h"
+#include "../SampleTraits.h"
+#include "../Sensor.h"
+#include "../SimdKernels.h"
+#include "../SpectrumAnalyzer.h"
+#include "../SpscRingBuffer.h"
+#include "../SummaryPyramid.h"
+#include "../ThreadPool.h"
+#include "../Workspace.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numbers>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	std::vector<double> makeRandomData(size_t size, unsigned seed, double magnitude = 100.0)
+	{
+		std::mt19937_64 generator(seed);
+		std::uniform_real_distribution<double> distribution(-magnitude, magnitude);
+		std::vector<double> data(size);
+		for (double& value : data)
+			value = distribution(generator);
+		return data;
+	}
+
+	// The edge-padded centered moving average, one window sum per output
+	std::vector<double> naiveMovingAverage(const std::vector<double>& data, int windowSize)
+	{
+		long long n = (long long)data.size();
+		long long offset = (windowSize - 1) / 2;
+		std::vector<double> output(data.size());
+		for (long long k = 0; k < n; k++)
+		{
+			double sum = 0.0;
+			for (long long j = k - offset; j <= k + offset; j++)
+				sum += data[(size_t)std::clamp(j, 0ll, n - 1)];
+			output[(size_t)k] = sum / (double)windowSize;
+		}
+		return output;
+	}
+
+	void registerDataProcessorTests(TestSuite& suite)
+	{
+		suite.add("DataProcessor/movingAverageFilter", [](TestSuite& test)
+		{
+			const int windows[] = { 1, 3, 11, 101 };
+			const size_t sizes[] = { 1, 2, 50, 4097, 20000 };
+			for (size_t size : sizes)
+			{
+				std::vector<double> data = makeRandomData(size, (unsigned)size);
+				for (int window : windows)
+				{
+					DataProcessor processor(window, 3);
+					processor.setRawData(data);
+					processor.movingAverageFilter();
+					std::vector<double> expected = naiveMovingAverage(data, window);
+					std::span<const double> actual = processor.getProcessedData();
+					test.check(actual.size() == size, "processed size " + std::to_string(actual.size()));
+					for (size_t i = 0; i < std::min(size, actual.size()); i++)
+						test.checkNear(actual[i], expected[i], 1e-12, "size " + std::to_string(size) + " window " + std::to_string(window) + " output " + std::to_string(i));
+				}
+			}
+		});
+
+		suite.add("DataProcessor/calculateStatistics", [](TestSuite& test)
+		{
+			std::vector<double> data = makeRandomData(10007, 7);
+			DataProcessor processor(5, 100);
+			processor.setRawData(data);
+			processor.movingAverageFilter();
+			processor.calculateStatistics();
+
+			double sum = 0.0;
+			for (double value : data)
+				sum += value;
+			test.check(processor.getRawDataMin() == *std::min_element(data.begin(), data.end()), "raw minimum");
+			test.check(processor.getRawDataMax() == *std::max_element(data.begin(), data.end()), "raw maximum");
+			test.checkNear(processor.getRawAverage(), sum / (double)data.size(), 1e-12, "raw average");
+
+			// Subset averages divide by the subset size, zero padding the short last subset
+			std::span<const double> averages = processor.getRawSubsetAverageData();
+			test.check(averages.size() == (data.size() + 99) / 100, "subset count " + std::to_string(averages.size()));
+			for (size_t subset = 0; subset < averages.size(); subset++)
+			{
+				double subsetSum = 0.0;
+				for (size_t i = subset * 100; i < std::min(data.size(), subset * 100 + 100); i++)
+					subsetSum += data[i];
+				test.checkNear(averages[subset], subsetSum / 100.0, 1e-12, "subset " + std::to_string(subset));
+			}
+		});
+
+		suite.add("DataProcessor/setRawData", [](TestSuite& test)
+		{
+			// Columns as a replayed capture holds them, copied with and without their timing
+			std::vector<double> values = makeRandomData(5000, 11);
+			std::vector<std::uint64_t> timestamps(values.size());
+			std::vector<std::uint32_t> sequences(values.size());
+			for (size_t i = 0; i < values.size(); i++)
+			{
+				timestamps[i] = 1000000 + i * 250;
+				sequences[i] = (std::uint32_t)(i + i / 1000); // A gap every 1000 data points
+			}
+
+			DataProcessor processor(3, 100);
+			processor.setRawData(values, timestamps, sequences);
+			const SampleBuffer& samples = processor.getRawSamples();
+			test.check(samples.hasTiming(), "timed copy has timing");
+			test.check(samples.size() == values.size()
+				&& std::equal(values.begin(), values.end(), samples.getValues().begin())
+				&& std::equal(timestamps.begin(), timestamps.end(), samples.getTimestamps().begin())
+				&& std::equal(sequences.begin(), sequences.end(), samples.getSequences().begin()), "timed copy columns");
+			test.check(samples.countSequenceGaps() == 4, "sequence gaps " + std::to_string(samples.countSequenceGaps()));
+
+			processor.setRawData(values, {}, {});
+			test.check(!processor.getRawSamples().hasTiming(), "untimed copy has no timing");
+			test.check(processor.getRawSamples().size() == values.size()
+				&& std::equal(values.begin(), values.end(), processor.getRawSamples().getValues().begin()), "untimed copy values");
+		});
+
+		suite.add("DataProcessor/timingRoundTrip", [](TestSuite& test)
+		{
+			// Irregular timestamps and lost sequence numbers, across several compressed blocks
+			std::vector<double> values = makeRandomData(3 * CompressedSampleStore::kBlockSize + 123, 29);
+			std::vector<std::uint64_t> timestamps(values.size());
+			std::vector<std::uint32_t> sequences(values.size());
+			for (size_t i = 0; i < values.size(); i++)
+			{
+				timestamps[i] = 7000000000ull + i * 1000000 + (i * 7919) % 4000;
+				sequences[i] = (std::uint32_t)(i + i / 777);
+			}
+			auto sameColumns = [&values, &timestamps, &sequences](const SampleBuffer& samples)
+			{
+				return samples.hasTiming() && samples.size() == values.size()
+					&& std::memcmp(samples.getValues().data(), values.data(), values.size() * sizeof(double)) == 0
+					&& std::equal(timestamps.begin(), timestamps.end(), samples.getTimestamps().begin(), samples.getTimestamps().end())
+					&& std::equal(sequences.begin(), sequences.end(), samples.getSequences().begin(), samples.getSequences().end());
+			};
+
+			// Copied in with the timed overload, compressed, and decoded into a second processor
+			DataProcessor processor(3, 100);
+			processor.setRawData(values, timestamps, sequences);
+			test.check(sameColumns(processor.getRawSamples()), "timed setRawData");
+			CompressedSampleStore store;
+			store.assign(processor.getRawSamples());
+			test.check(store.hasTiming() && store.size() == values.size(), "the store keeps the timing");
+			DataProcessor restored(3, 100);
+			restored.setRawData(store);
+			test.check(sameColumns(restored.getRawSamples()), "setRawData from the compressed store");
+
+			// Through serialization, and moved into a processor
+			std::vector<unsigned char> bytes;
+			store.serialize(bytes);
+			CompressedSampleStore deserialized;
+			deserialized.deserialize(bytes);
+			SampleBuffer decoded;
+			deserialized.decode(decoded);
+			restored.setRawData(std::move(decoded));
+			test.check(sameColumns(restored.getRawSamples()), "serialized store moved into the processor");
+			test.check(restored.getRawSamples().countSequenceGaps() == processor.getRawSamples().countSequenceGaps(), "sequence gaps");
+
+			// Streamed data points keep their timing too
+			DataProcessor streamed(3, 100);
+			streamed.beginStream(values.size());
+			for (size_t i = 0; i < values.size(); i++)
+				streamed.onSample(Sample{ timestamps[i], values[i], sequences[i] });
+			streamed.endStream();
+			test.check(sameColumns(streamed.getRawSamples()), "streamed data points");
+		});
+	}
+
+	// Sums the magnitudes of a range, the scale of the rounding errors of summing it in any order
+	double absoluteSum(const double* data, size_t size)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i < size; i++)
+			sum += std::fabs(data[i]);
+		return sum;
+	}
+
+	// Streams data through onSample and checks the results against the batch functions
+	void checkStreamAgainstBatch(TestSuite& test, const std::vector<double>& data, int window, int subset, const std::string& name)
+	{
+		DataProcessor streamed(window, subset);
+		streamed.beginStream(data.size());
+		for (size_t i = 0; i < data.size(); i++)
+			streamed.onSample(Sample{ (std::uint64_t)i, data[i], (std::uint32_t)i });
+		streamed.endStream();
+
+		DataProcessor batch(window, subset);
+		batch.setRawData(data);
+		batch.movingAverageFilter();
+		batch.calculateStatistics();
+
+		std::span<const double> streamedOutput = streamed.getProcessedData();
+		std::span<const double> batchOutput = batch.getProcessedData();
+		test.check(streamedOutput.size() == batchOutput.size()
+			&& std::memcmp(streamedOutput.data(), batchOutput.data(), batchOutput.size() * sizeof(double)) == 0, name + " filter output");
+		test.check(streamed.getRawDataMin() == batch.getRawDataMin() && streamed.getRawDataMax() == batch.getRawDataMax(), name + " raw minimum and maximum");
+
+		// Subsets of 16 or more values are summed in a different order by the vector kernels
+		std::span<const double> streamedAverages = streamed.getRawSubsetAverageData();
+		std::span<const double> batchAverages = batch.getRawSubsetAverageData();
+		test.check(streamedAverages.size() == batchAverages.size(), name + " subset count");
+		for (size_t i = 0; i < std::min(streamedAverages.size(), batchAverages.size()); i++)
+		{
+			size_t begin = i * (size_t)subset;
+			double tolerance = DBL_EPSILON * absoluteSum(data.data() + begin, std::min((size_t)subset, data.size() - begin));
+			test.checkNear(streamedAverages[i], batchAverages[i], tolerance, name + " subset " + std::to_string(i));
+		}
+	}
+
+	void registerStreamingTests(TestSuite& suite)
+	{
+		suite.add("Streaming/onSample", [](TestSuite& test)
+		{
+			const int windows[] = { 1, 3, 11, 101 };
+			const int subsets[] = { 1, 3, 16, 17, 100 };
+			std::vector<double> data = makeRandomData(20011, 5);
+			SimdLevel selected = getSimdLevel();
+			for (int level = eScalar; level <= detectSimdLevel(); level++)
+			{
+				setSimdLevel((SimdLevel)level);
+				for (int window : windows)
+					for (int subset : subsets)
+						checkStreamAgainstBatch(test, data, window, subset, std::string(getSimdLevelName((SimdLevel)level))
+							+ " window " + std::to_string(window) + " subset " + std::to_string(subset));
+			}
+			setSimdLevel(selected);
+		});
+
+		suite.add("Streaming/integerSamples", [](TestSuite& test)
+		{
+			// Streamed counts must give the batch results: the integer moving average is exact in either order
+			const double scale = 100.0 / 32767.0;
+			std::vector<double> data = makeRandomData(20011, 23);
+			std::vector<std::int16_t> counts(data.size());
+			for (size_t i = 0; i < data.size(); i++)
+				counts[i] = SampleTraits<std::int16_t>::quantize(data[i], scale);
+			for (int window : { 3, 11, 101 })
+			{
+				BasicDataProcessor<std::int16_t> batch(window, 17, scale);
+				batch.setRawData(std::span<const std::int16_t>(counts));
+				batch.movingAverageFilter();
+				batch.calculateStatistics();
+				BasicDataProcessor<std::int16_t> streamed(window, 17, scale);
+				streamed.beginStream(counts.size());
+				for (size_t i = 0; i < counts.size(); i++)
+					streamed.onSample(BasicSample<std::int16_t>{ (std::uint64_t)i * 1000, counts[i], (std::uint32_t)i });
+				streamed.endStream();
+
+				std::string name = "window " + std::to_string(window);
+				std::span<const std::int16_t> streamedOutput = streamed.getProcessedData();
+				std::span<const std::int16_t> batchOutput = batch.getProcessedData();
+				test.check(std::equal(streamedOutput.begin(), streamedOutput.end(), batchOutput.begin(), batchOutput.end()), name + " filter output");
+				test.check(streamed.getRawDataMin() == batch.getRawDataMin() && streamed.getRawDataMax() == batch.getRawDataMax()
+					&& streamed.getProcessedDataMin() == batch.getProcessedDataMin() && streamed.getProcessedDataMax() == batch.getProcessedDataMax(),
+					name + " minimum and maximum");
+				test.checkNear(streamed.getRawAverage(), batch.getRawAverage(), 1e-9, name + " raw average");
+				test.checkNear(streamed.getProcessedAverage(), batch.getProcessedAverage(), 1e-9, name + " processed average");
+				std::span<const double> streamedAverages = streamed.getRawSubsetAverageData();
+				std::span<const double> batchAverages = batch.getRawSubsetAverageData();
+				test.check(std::equal(streamedAverages.begin(), streamedAverages.end(), batchAverages.begin(), batchAverages.end()),
+					name + " subset averages, exact sums of counts");
+			}
+		});
+	}
+
+	// Checks every vector kernel the CPU supports against the scalar kernels with the accuracy contract of SimdKernels.h
+	void registerSimdKernelTests(TestSuite& suite)
+	{
+		const size_t sizes[] = { 1, 2, 7, 100, 4095, 4096, 4097, 10007, 100003 };
+		const double magnitudes[] = { 1e-3, 100.0, 1e9 };
+
+		suite.add("SimdKernels/movingAverage", [sizes](TestSuite& test)
+		{
+			const int windows[] = { 1, 3, 5, 11, 51, 101 };
+			SimdLevel selected = getSimdLevel();
+			for (int level = eAvx2; level <= detectSimdLevel(); level++)
+			{
+				setSimdLevel((SimdLevel)level);
+				for (size_t size : sizes)
+				{
+					std::vector<double> data = makeRandomData(size, (unsigned)(size * 31 + level));
+					std::vector<double> expected(size), actual(size);
+					for (int window : windows)
+					{
+						// The filter runs the same recurrence in every lane, so it must be bit-identical
+						SimdKernels::Scalar::movingAverage(data.data(), size, window, expected.data());
+						SimdKernels::movingAverage(data.data(), size, window, actual.data());
+						test.check(std::memcmp(expected.data(), actual.data(), size * sizeof(double)) == 0,
+							std::string(getSimdLevelName((SimdLevel)level)) + " size " + std::to_string(size) + " window " + std::to_string(window));
+					}
+				}
+			}
+			setSimdLevel(selected);
+		});
+
+		suite.add("SimdKernels/sum", [sizes, magnitudes](TestSuite& test)
+		{
+			SimdLevel selected = getSimdLevel();
+			for (int level = eAvx2; level <= detectSimdLevel(); level++)
+			{
+				setSimdLevel((SimdLevel)level);
+				for (size_t size : sizes)
+				{
+					for (double magnitude : magnitudes)
+					{
+						std::vector<double> data = makeRandomData(size, (unsigned)(size + level), magnitude);
+						double tolerance = (double)size * DBL_EPSILON * absoluteSum(data.data(), size);
+						test.checkNear(SimdKernels::sum(data.data(), size), SimdKernels::Scalar::sum(data.data(), size), tolerance,
+							std::string(getSimdLevelName((SimdLevel)level)) + " size " + std::to_string(size));
+					}
+				}
+			}
+			setSimdLevel(selected);
+		});
+
+		suite.add("SimdKernels/statistics", [sizes, magnitudes](TestSuite& test)
+		{
+			const size_t subsets[] = { 1, 3, 15, 16, 17, 100, 1000 };
+			SimdLevel selected = getSimdLevel();
+			for (int level = eAvx2; level <= detectSimdLevel(); level++)
+			{
+				setSimdLevel((SimdLevel)level);
+				std::string levelName = getSimdLevelName((SimdLevel)level);
+				for (size_t size : sizes)
+				{
+					for (double magnitude : magnitudes)
+					{
+						std::vector<double> data = makeRandomData(size, (unsigned)(size * 7 + level), magnitude);
+						double tolerance = (double)size * DBL_EPSILON * absoluteSum(data.data(), size);
+						for (size_t subset : subsets)
+						{
+							std::string name = levelName + " size " + std::to_string(size) + " subset " + std::to_string(subset);
+							size_t count = (size + subset - 1) / subset;
+							std::vector<double> expectedAverages(count), actualAverages(count);
+							DataStatistics expected = SimdKernels::Scalar::statistics(data.data(), size, subset, expectedAverages.data());
+							DataStatistics actual = SimdKernels::statistics(data.data(), size, subset, actualAverages.data());
+							test.check(actual.min == expected.min && actual.max == expected.max && actual.count == expected.count, name + " minimum, maximum and count");
+							test.checkNear(actual.sum, expected.sum, tolerance, name + " sum");
+
+							// Short subsets are summed in order; longer ones are reassociated like `sum`, scaled down by the subset size
+							for (size_t i = 0; i < count; i++)
+							{
+								size_t begin = i * subset;
+								double subsetTolerance = subset < 16 ? 0.0
+									: DBL_EPSILON * absoluteSum(data.data() + begin, std::min(subset, size - begin));
+								test.checkNear(actualAverages[i], expectedAverages[i], subsetTolerance, name + " average " + std::to_string(i));
+							}
+						}
+					}
+				}
+			}
+			setSimdLevel(selected);
+		});
+
+		// ADC counts run the scalar template with the exact integer accumulators of SampleTraits
+		suite.add("SimdKernels/integerSamples", [sizes](TestSuite& test)
+		{
+			const int windows[] = { 1, 5, 101 };
+			const size_t subsets[] = { 1, 16, 1000 };
+			const double scale = 0.01;
+			for (size_t size : sizes)
+			{
+				std::mt19937 generator((unsigned)size);
+				std::uniform_int_distribution<int> distribution(-32768, 32767);
+				std::vector<std::int16_t> data(size);
+				std::vector<double> values(size);
+				for (size_t i = 0; i < size; i++)
+				{
+					data[i] = (std::int16_t)distribution(generator);
+					values[i] = data[i];
+				}
+				std::string name = "size " + std::to_string(size);
+
+				// Window sums of counts are exact in double, so the naive average rounds to the same count
+				for (int window : windows)
+				{
+					std::vector<double> expected = naiveMovingAverage(values, window);
+					std::vector<std::int16_t> actual(size);
+					SimdKernels::movingAverage(data.data(), size, window, actual.data());
+					bool equal = true;
+					for (size_t i = 0; i < size; i++)
+						equal = equal && actual[i] == (std::int16_t)std::lround(expected[i]);
+					test.check(equal, name + " window " + std::to_string(window));
+				}
+
+				for (size_t subset : subsets)
+				{
+					size_t count = (size + subset - 1) / subset;
+					std::vector<double> averages(count);
+					DataStatistics statistics = SimdKernels::statistics(data.data(), size, subset, averages.data(), scale);
+					std::int64_t total = 0;
+					bool averagesEqual = true;
+					for (size_t i = 0; i < count; i++)
+					{
+						std::int64_t subsetSum = 0;
+						for (size_t j = i * subset; j < std::min((i + 1) * subset, size); j++)
+							subsetSum += data[j];
+						total += subsetSum;
+						averagesEqual = averagesEqual && averages[i] == (double)subsetSum * (scale / (double)subset);
+					}
+					std::string subsetName = name + " subset " + std::to_string(subset);
+					test.check(statistics.sum == (double)total * scale, subsetName + " sum");
+					test.check(statistics.min == *std::min_element(data.begin(), data.end()) * scale
+						&& statistics.max == *std::max_element(data.begin(), data.end()) * scale, subsetName + " minimum and maximum");
+					test.check(averagesEqual, subsetName + " averages");
+				}
+			}
+		});
+	}
+
+	void registerThreadPoolTests(TestSuite& suite)
+	{
+		suite.add("ThreadPool/submit", [](TestSuite& test)
+		{
+			const size_t threadCounts[] = { 1, 2, 4 };
+			for (size_t threads : threadCounts)
+			{
+				ThreadPool pool(threads);
+				std::atomic<size_t> finished(0);
+				for (int round = 0; round < 20; round++)
+				{
+					// Tasks from outside the pool and tasks that spawn more tasks on their own worker
+					const size_t numTasks = 1000;
+					finished = 0;
+					for (size_t i = 0; i < numTasks; i++)
+					{
+						pool.submit([&pool, &finished]
+						{
+							pool.submit([&finished] { finished++; });
+							finished++;
+						});
+					}
+					pool.wait();
+					test.check(finished.load() == 2 * numTasks, std::to_string(threads) + " threads, round " + std::to_string(round)
+						+ ": " + std::to_string(finished.load()) + " tasks finished");
+				}
+			}
+		});
+
+		suite.add("ThreadPool/parallelFor", [](TestSuite& test)
+		{
+			const size_t counts[] = { 0, 1, 2, 3, 100, 10007 };
+			ThreadPool pool(3);
+			for (size_t count : counts)
+			{
+				// Every index exactly once
+				std::vector<std::atomic<int>> calls(count);
+				pool.parallelFor(count, [&calls](size_t i) { calls[i]++; });
+				size_t wrong = 0;
+				for (const std::atomic<int>& call : calls)
+					wrong += call.load() != 1;
+				test.check(wrong == 0, "count " + std::to_string(count) + ": " + std::to_string(wrong) + " indices not called once");
+			}
+		});
+	}
+
+	void registerFilterTests(TestSuite& suite)
+	{
+		suite.add("Filters/runningMedian", [](TestSuite& test)
+		{
+			// Continuous values and integers with many ties, against sorting the window at every data point
+			const int windows[] = { 1, 2, 3, 4, 5, 8, 101 };
+			std::vector<double> continuous = makeRandomData(3000, 5);
+			std::vector<double> ties(continuous.size());
+			for (size_t i = 0; i < ties.size(); i++)
+				ties[i] = std::floor(continuous[i] / 20.0);
+			for (const std::vector<double>* data : { &continuous, &ties })
+			{
+				for (int window : windows)
+				{
+					FilterChain chain;
+					chain.parse("median:" + std::to_string(window));
+					std::vector<double> output = *data;
+					chain.process(output);
+
+					size_t wrong = 0;
+					std::vector<double> sorted;
+					for (size_t i = 0; i < data->size(); i++)
+					{
+						size_t begin = i + 1 >= (size_t)window ? i + 1 - (size_t)window : 0;
+						sorted.assign(data->begin() + (std::ptrdiff_t)begin, data->begin() + (std::ptrdiff_t)i + 1);
+						std::sort(sorted.begin(), sorted.end());
+						size_t middle = sorted.size() / 2;
+						double expected = sorted.size() % 2 == 1 ? sorted[middle] : 0.5 * (sorted[middle - 1] + sorted[middle]);
+						wrong += output[i] != expected;
+					}
+					test.check(wrong == 0, std::string(data == &ties ? "ties" : "continuous") + " window " + std::to_string(window)
+						+ ": " + std::to_string(wrong) + " medians differ from the sorted window");
+				}
+			}
+		});
+
+		suite.add("Filters/reference", [](TestSuite& test)
+		{
+			std::vector<double> data = makeRandomData(2000, 6);
+
+			// The signal is taken as constant at its first value before it starts
+			std::vector<double> output = data;
+			FilterChain chain;
+			chain.parse("ema:0.2");
+			chain.process(output);
+			double average = data[0];
+			for (size_t i = 0; i < data.size(); i++)
+			{
+				average += 0.2 * (data[i] - average);
+				test.checkNear(output[i], average, 1e-12, "ema " + std::to_string(i));
+			}
+
+			const double taps[] = { 0.1, 0.2, 0.4, 0.3 };
+			output = data;
+			chain.parse("fir:0.1:0.2:0.4:0.3");
+			chain.process(output);
+			for (size_t i = 0; i < data.size(); i++)
+			{
+				double expected = 0.0;
+				for (size_t k = 0; k < 4; k++)
+					expected += taps[k] * data[i >= k ? i - k : 0];
+				test.checkNear(output[i], expected, 1e-12, "fir " + std::to_string(i));
+			}
+
+			// Designed sections pass a constant at their DC gain from the first data point on
+			std::vector<double> constant(500, 42.0);
+			chain.parse("lowpass:0.05");
+			chain.process(constant);
+			test.check(std::all_of(constant.begin(), constant.end(), [](double value) { return std::fabs(value - 42.0) <= 1e-9; }), "lowpass passes a constant");
+			constant.assign(500, 42.0);
+			chain.parse("highpass:0.05");
+			chain.process(constant);
+			test.check(std::all_of(constant.begin(), constant.end(), [](double value) { return std::fabs(value) <= 1e-9; }), "highpass blocks a constant");
+		});
+
+		suite.add("Filters/blocks", [](TestSuite& test)
+		{
+			// The output must not depend on how the signal is split, down to single data points
+			const char* descriptions[] = { "ema:0.2", "median:5", "median:64", "fir:0.25:0.5:0.25", "lowpass:0.05:2",
+				"biquad:0.2:0.3:0.2:-0.5:0.2", "median:5,ema:0.2,fir:0.25:0.5:0.25,lowpass:0.05" };
+			std::vector<double> data = makeRandomData(5000, 8);
+			std::mt19937_64 generator(9);
+			for (const char* description : descriptions)
+			{
+				FilterChain whole;
+				test.check(whole.parse(description), std::string("parse ") + description);
+				std::vector<double> expected = data;
+				whole.process(expected);
+
+				FilterChain split;
+				split.parse(description);
+				std::vector<double> actual = data;
+				for (size_t begin = 0; begin < actual.size();)
+				{
+					size_t size = std::min(actual.size() - begin, (size_t)(generator() % 300));
+					split.process(std::span<double>(actual.data() + begin, size));
+					begin += size;
+				}
+				test.check(std::memcmp(expected.data(), actual.data(), data.size() * sizeof(double)) == 0, std::string("blocks ") + description);
+
+				// A reset starts a new signal, as a fresh chain does
+				split.reset();
+				actual = data;
+				split.process(actual);
+				test.check(std::memcmp(expected.data(), actual.data(), data.size() * sizeof(double)) == 0, std::string("reset ") + description);
+			}
+		});
+
+		suite.add("Filters/parse", [](TestSuite& test)
+		{
+			FilterChain chain;
+			test.check(chain.parse("median:5,ema:0.2,lowpass:0.05") && chain.getStageCount() == 3, "three stages");
+			FilterChain again;
+			test.check(again.parse(chain.describe()) && again.describe() == chain.describe(), "describe round trip: " + chain.describe());
+			test.check(chain.parse("") && chain.empty(), "empty text gives an empty chain");
+
+			const char* invalid[] = { "ema:0", "ema:1.5", "median:0", "median:100001", "lowpass:0.5", "fir", "biquad:1:2", "notch:0.1", "ema:0.2," };
+			for (const char* description : invalid)
+			{
+				test.check(!chain.parse(description) && chain.empty() && !chain.getLastError().empty(), std::string("rejects ") + description);
+			}
+		});
+	}
+
+	void registerSpectrumTests(TestSuite& suite)
+	{
+		suite.add("Spectrum/realFft", [](TestSuite& test)
+		{
+			for (size_t size = 2; size <= 4096; size *= 2)
+			{
+				std::vector<double> data = makeRandomData(size, (unsigned)size);
+				RealFft fft(size);
+				std::vector<std::complex<double>> bins(fft.getBinCount());
+				fft.forward(data, bins);
+
+				// Naive DFT with exactly reduced angles; both are accurate to a few ulps of the sum of magnitudes
+				double tolerance = 1e-13 * absoluteSum(data.data(), size);
+				for (size_t k = 0; k < bins.size(); k++)
+				{
+					std::complex<double> expected = 0.0;
+					for (size_t n = 0; n < size; n++)
+					{
+						double angle = -2.0 * std::numbers::pi * (double)((k * n) % size) / (double)size;
+						expected += data[n] * std::complex<double>(std::cos(angle), std::sin(angle));
+					}
+					test.check(std::abs(bins[k] - expected) <= tolerance, "size " + std::to_string(size) + " bin " + std::to_string(k)
+						+ ": error " + std::to_string(std::abs(bins[k] - expected)));
+				}
+			}
+		});
+
+		suite.add("Spectrum/welch", [](TestSuite& test)
+		{
+			// Without a window or overlap, the bins of each segment add up to its mean square
+			std::vector<double> data = makeRandomData(8192, 12);
+			SpectrumAnalyzer rectangular(256, eRectangularWindow, 256);
+			rectangular.process(data);
+			double meanSquare = 0.0;
+			for (double value : data)
+				meanSquare += value * value;
+			meanSquare /= (double)data.size();
+			test.check(rectangular.getSegmentCount() == 32, "segment count " + std::to_string(rectangular.getSegmentCount()));
+			test.checkNear(rectangular.getTotalEnergy(), meanSquare, 1e-12 * meanSquare, "rectangular total energy");
+
+			// A sine of amplitude 3 centered on bin 40 holds power 4.5 around 40/1024 cycles per data point
+			const SpectralWindow windows[] = { eHannWindow, eHammingWindow, eBlackmanWindow };
+			std::vector<double> sine(16384);
+			for (size_t n = 0; n < sine.size(); n++)
+				sine[n] = 3.0 * std::sin(2.0 * std::numbers::pi * 40.0 * (double)n / 1024.0);
+			for (SpectralWindow window : windows)
+			{
+				SpectrumAnalyzer analyzer(1024, window);
+				analyzer.process(sine);
+				std::string name = getSpectralWindowName(window);
+				test.check(analyzer.getSegmentCount() == 31, name + " segment count " + std::to_string(analyzer.getSegmentCount()));
+				test.checkNear(analyzer.getDominantFrequency(), 40.0 / 1024.0, 1e-15, name + " dominant frequency");
+				test.checkNear(analyzer.getBandEnergy(36.0 / 1024.0, 44.0 / 1024.0), 4.5, 0.01 * 4.5, name + " band energy");
+				test.checkNear(analyzer.getTotalEnergy(), 4.5, 0.01 * 4.5, name + " total energy");
+			}
+		});
+
+		suite.add("Spectrum/blocks", [](TestSuite& test)
+		{
+			// Streaming data points in blocks of any size transforms the same segments
+			std::vector<double> data = makeRandomData(10000, 13);
+			SpectrumAnalyzer whole(512);
+			whole.process(data);
+			SpectrumAnalyzer split(512);
+			std::mt19937_64 generator(14);
+			for (size_t begin = 0; begin < data.size();)
+			{
+				size_t size = std::min(data.size() - begin, (size_t)(generator() % 700));
+				split.process(std::span<const double>(data.data() + begin, size));
+				begin += size;
+			}
+			test.check(whole.getSegmentCount() == (10000 - 512) / 256 + 1 && split.getSegmentCount() == whole.getSegmentCount(), "segment count");
+			test.check(std::equal(whole.getPowerSpectrum().begin(), whole.getPowerSpectrum().end(), split.getPowerSpectrum().begin()), "power spectrum");
+		});
+	}
+
+	void registerParallelTests(TestSuite& suite)
+	{
+		suite.add("Parallel/DataProcessor", [](TestSuite& test)
+		{
+			// Just below the parallel threshold, at it, and chunks with a short last one
+			const size_t sizes[] = { DataProcessor::kMinParallelSize - 1, DataProcessor::kMinParallelSize, 3 * DataProcessor::kParallelChunkSize + 12345 };
+			const int windows[] = { 1, 3, 101 };
+			const int subsets[] = { 1, 100, 4103 };
+			std::shared_ptr<ThreadPool> pools[] = { std::shared_ptr<ThreadPool>(new ThreadPool(1)), std::shared_ptr<ThreadPool>(new ThreadPool(3)) };
+			for (size_t size : sizes)
+			{
+				std::vector<double> data = makeRandomData(size, (unsigned)size);
+				double tolerance = DBL_EPSILON * absoluteSum(data.data(), size); // size * DBL_EPSILON * sum|x| on the sum, divided by size
+				for (int window : windows)
+				{
+					for (int subset : subsets)
+					{
+						DataProcessor serial(window, subset);
+						serial.setRawData(data);
+						serial.movingAverageFilter();
+						serial.calculateStatistics();
+
+						double firstAverage = 0.0;
+						for (size_t p = 0; p < 2; p++)
+						{
+							DataProcessor parallel(window, subset);
+							parallel.setThreadPool(pools[p]);
+							parallel.setRawData(data);
+							parallel.movingAverageFilter();
+							parallel.calculateStatistics();
+
+							std::string name = "size " + std::to_string(size) + " window " + std::to_string(window) + " subset " + std::to_string(subset)
+								+ " threads " + std::to_string(pools[p]->getThreadCount() + 1);
+							test.check(std::memcmp(serial.getProcessedData().data(), parallel.getProcessedData().data(), size * sizeof(double)) == 0, name + " filter output");
+							test.check(std::equal(serial.getRawSubsetAverageData().begin(), serial.getRawSubsetAverageData().end(), parallel.getRawSubsetAverageData().begin(), parallel.getRawSubsetAverageData().end())
+								&& std::equal(serial.getProcessedSubsetAverageData().begin(), serial.getProcessedSubsetAverageData().end(), parallel.getProcessedSubsetAverageData().begin(), parallel.getProcessedSubsetAverageData().end()),
+								name + " subset averages");
+							test.check(serial.getRawDataMin() == parallel.getRawDataMin() && serial.getRawDataMax() == parallel.getRawDataMax()
+								&& serial.getProcessedDataMin() == parallel.getProcessedDataMin() && serial.getProcessedDataMax() == parallel.getProcessedDataMax(), name + " minimum and maximum");
+							test.checkNear(parallel.getRawAverage(), serial.getRawAverage(), tolerance, name + " raw average");
+
+							// The chunks do not depend on the number of threads, so neither does the sum
+							if (p == 0)
+								firstAverage = parallel.getRawAverage();
+							else
+								test.check(parallel.getRawAverage() == firstAverage, name + " raw average independent of the thread count");
+						}
+					}
+				}
+			}
+		});
+	}
+
+	// Scans a range value by value, the reference for the summary pyramid
+	DataStatistics scanRange(const std::vector<double>& data, size_t begin, size_t end)
+	{
+		end = std::min(end, data.size());
+		DataStatistics statistics = { 0, 0.0, 0.0, 0.0 };
+		for (size_t i = begin; i < end; i++)
+		{
+			statistics.min = statistics.count == 0 ? data[i] : std::min(statistics.min, data[i]);
+			statistics.max = statistics.count == 0 ? data[i] : std::max(statistics.max, data[i]);
+			statistics.sum += data[i];
+			statistics.count++;
+		}
+		return statistics;
+	}
+
+	// Compares pyramid statistics with a scan; the sums are added in a different order
+	void checkRange(TestSuite& test, const DataStatistics& actual, const std::vector<double>& data, size_t begin, size_t end, const std::string& name)
+	{
+		DataStatistics expected = scanRange(data, begin, end);
+		test.check(actual.count == expected.count && actual.min == expected.min && actual.max == expected.max,
+			name + ": count, minimum or maximum differ");
+		double tolerance = expected.count == 0 ? 0.0 : (double)expected.count * DBL_EPSILON * absoluteSum(data.data() + begin, expected.count);
+		test.checkNear(actual.sum, expected.sum, tolerance, name + " sum");
+	}
+
+	void registerSummaryPyramidTests(TestSuite& suite)
+	{
+		suite.add("SummaryPyramid/query", [](TestSuite& test)
+		{
+			std::vector<double> data = makeRandomData(10007, 21);
+			SummaryPyramid pyramid;
+			pyramid.assign(data);
+			test.check(pyramid.size() == data.size(), "size");
+
+			// Edges of the blocks, empty and single-value ranges and ranges clamped at the end
+			const size_t edges[][2] = { { 0, 0 }, { 0, 1 }, { 5, 6 }, { 0, 10007 }, { 0, 8192 }, { 4096, 8192 }, { 4095, 8193 },
+				{ 1, 10006 }, { 10006, 10007 }, { 9000, 20000 }, { 10007, 10007 }, { 300, 300 } };
+			for (const auto& edge : edges)
+				checkRange(test, pyramid.query(edge[0], edge[1]), data, edge[0], edge[1], "range " + std::to_string(edge[0]) + "-" + std::to_string(edge[1]));
+
+			std::mt19937_64 generator(22);
+			for (int i = 0; i < 2000; i++)
+			{
+				size_t begin = (size_t)(generator() % data.size());
+				size_t end = begin + (size_t)(generator() % (data.size() - begin + 1));
+				checkRange(test, pyramid.query(begin, end), data, begin, end, "range " + std::to_string(begin) + "-" + std::to_string(end));
+			}
+		});
+
+		suite.add("SummaryPyramid/append", [](TestSuite& test)
+		{
+			// Queries while the series grows, as while a capture is streamed
+			std::vector<double> data = makeRandomData(5000, 23);
+			std::vector<double> appended;
+			SummaryPyramid pyramid;
+			std::mt19937_64 generator(24);
+			for (size_t i = 0; i < data.size(); i++)
+			{
+				pyramid.append(data[i]);
+				appended.push_back(data[i]);
+				if (i % 37 == 0)
+				{
+					size_t begin = (size_t)(generator() % appended.size());
+					checkRange(test, pyramid.query(begin, appended.size()), appended, begin, appended.size(), "size " + std::to_string(appended.size()) + " from " + std::to_string(begin));
+					checkRange(test, pyramid.query(0, appended.size()), appended, 0, appended.size(), "size " + std::to_string(appended.size()) + " whole");
+				}
+			}
+
+			// Appending in blocks builds the same levels as appending single values
+			SummaryPyramid blocks;
+			blocks.append(std::span<const double>(data.data(), 1234));
+			blocks.append(std::span<const double>(data.data() + 1234, data.size() - 1234));
+			test.check(blocks.getLevelCount() == pyramid.getLevelCount(), "level count");
+			for (size_t level = 1; level < pyramid.getLevelCount(); level++)
+			{
+				for (size_t b = 0; b < pyramid.getBlockCount(level); b++)
+				{
+					DataStatistics expected = pyramid.getBlock(level, b);
+					DataStatistics actual = blocks.getBlock(level, b);
+					test.check(actual.sum == expected.sum && actual.min == expected.min && actual.max == expected.max,
+						"level " + std::to_string(level) + " block " + std::to_string(b));
+				}
+			}
+		});
+
+		suite.add("SummaryPyramid/downsample", [](TestSuite& test)
+		{
+			std::vector<double> data = makeRandomData(10007, 25);
+			SummaryPyramid pyramid;
+			pyramid.assign(data);
+			const size_t ranges[][3] = { { 0, 10007, 100 }, { 123, 9876, 7 }, { 0, 10007, 10007 }, { 500, 510, 30 }, { 0, 1, 1 } };
+			std::vector<DataStatistics> buckets;
+			for (const auto& range : ranges)
+			{
+				size_t begin = range[0], end = range[1], bucketCount = range[2];
+				pyramid.downsample(begin, end, bucketCount, buckets);
+				test.check(buckets.size() == bucketCount, "bucket count");
+				size_t length = end - begin;
+				for (size_t i = 0; i < std::min(buckets.size(), bucketCount); i++)
+				{
+					size_t bucketBegin = begin + i * length / bucketCount;
+					size_t bucketEnd = begin + (i + 1) * length / bucketCount;
+					checkRange(test, buckets[i], data, bucketBegin, bucketEnd, "range " + std::to_string(begin) + "-" + std::to_string(end)
+						+ " bucket " + std::to_string(i) + " of " + std::to_string(bucketCount));
+				}
+			}
+		});
+	}
+
+	// The distance of a value's rank from the requested one, as a fraction of the count; ties count as any rank they span
+	double rankError(const std::vector<double>& sorted, double value, double fraction)
+	{
+		double lower = (double)(std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin());
+		double upper = (double)(std::upper_bound(sorted.begin(), sorted.end(), value) - sorted.begin());
+		double target = fraction * (double)sorted.size();
+		double distance = target < lower ? lower - target : target > upper ? target - upper : 0.0;
+		return distance / (double)sorted.size();
+	}
+
+	// Checks the quantiles of a sketch against the sorted stream, scaling the bound documented for k = 200 by 200 / k
+	void checkQuantiles(TestSuite& test, const QuantileSketch& sketch, std::vector<double> stream, const std::string& name)
+	{
+		const double fractions[] = { 0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99 };
+		double bound = 0.013 * 200.0 / (double)sketch.getK();
+		std::sort(stream.begin(), stream.end());
+		test.check(sketch.getCount() == stream.size(), name + " count");
+		test.check(sketch.getMin() == stream.front() && sketch.getMax() == stream.back(), name + " minimum and maximum");
+		test.check(sketch.getQuantile(0.0) == stream.front() && sketch.getQuantile(1.0) == stream.back(), name + " quantiles 0 and 1");
+		// About 3k values, plus the levels held at the smallest capacity when k is small
+		double capacity = 3.0 * sketch.getK() + QuantileSketch::kMinK * std::log2((double)stream.size());
+		test.check((double)sketch.getRetainedCount() <= capacity, name + " retained " + std::to_string(sketch.getRetainedCount()));
+
+		double worst = 0.0;
+		for (double fraction : fractions)
+			worst = std::max(worst, rankError(stream, sketch.getQuantile(fraction), fraction));
+		test.check(worst <= bound, name + ": rank error " + std::to_string(worst) + " above " + std::to_string(bound));
+	}
+
+	void registerQuantileSketchTests(TestSuite& suite)
+	{
+		suite.add("QuantileSketch/rankError", [](TestSuite& test)
+		{
+			// Random, sorted, reversed and heavily tied streams; sorted input is the hardest case for the compactions
+			const size_t sizes[] = { 1000, 100000, 1000000 };
+			const int ks[] = { 50, QuantileSketch::kDefaultK };
+			for (size_t size : sizes)
+			{
+				std::vector<double> random = makeRandomData(size, (unsigned)size);
+				std::vector<double> ascending = random;
+				std::sort(ascending.begin(), ascending.end());
+				std::vector<double> descending(ascending.rbegin(), ascending.rend());
+				std::vector<double> ties(size);
+				for (size_t i = 0; i < size; i++)
+					ties[i] = std::floor(random[i] / 25.0);
+
+				const std::vector<double>* streams[] = { &random, &ascending, &descending, &ties };
+				const char* names[] = { "random", "ascending", "descending", "ties" };
+				for (int k : ks)
+				{
+					for (int s = 0; s < 4; s++)
+					{
+						QuantileSketch sketch(k);
+						sketch.add(*streams[s]);
+						checkQuantiles(test, sketch, *streams[s], std::string(names[s]) + " size " + std::to_string(size) + " k " + std::to_string(k));
+					}
+				}
+			}
+		});
+
+		suite.add("QuantileSketch/merge", [](TestSuite& test)
+		{
+			// 16 chunk sketches merged into one, as the parallel statistics and the fleet summary do
+			std::vector<double> data = makeRandomData(1000000, 31);
+			for (size_t i = 500000; i < data.size(); i++)
+				data[i] += 1000.0; // A second mode, so the chunks differ
+			QuantileSketch merged;
+			size_t chunk = data.size() / 16;
+			for (size_t c = 0; c < 16; c++)
+			{
+				QuantileSketch part;
+				part.add(std::span<const double>(data.data() + c * chunk, chunk));
+				test.check(merged.merge(part), "merge chunk " + std::to_string(c));
+			}
+			checkQuantiles(test, merged, data, "16 merged chunks");
+
+			QuantileSketch other(50);
+			test.check(!merged.merge(other) && merged.getCount() == data.size(), "sketches of different k are not merged");
+
+			// The same values in the same order give the same quantiles
+			QuantileSketch first, second;
+			first.add(data);
+			second.add(data);
+			test.check(first.getQuantile(0.5) == second.getQuantile(0.5) && first.getQuantile(0.99) == second.getQuantile(0.99), "deterministic");
+		});
+	}
+
+	// A store of `size` data points: a noisy sine with a few special values, with jittered timing if asked for
+	void fillStore(CompressedSampleStore& store, size_t size, bool timing)
+	{
+		std::vector<double> noise = makeRandomData(size, (unsigned)size, 1e-3);
+		for (size_t i = 0; i < size; i++)
+		{
+			double value = std::sin((double)i * 0.01) + noise[i];
+			if (i % 1000 == 7)
+				value = i % 3000 == 7 ? std::nan("") : i % 3000 == 1007 ? -0.0 : HUGE_VAL;
+			if (timing)
+				store.push({ 1000000ull * i + (i % 17) * 3, value, (std::uint32_t)(i + i / 2500) }); // Jitter and lost data points
+			else
+				store.append(std::span<const double>(&value, 1));
+		}
+	}
+
+	// Checks two buffers for the same data points, bit for bit
+	bool sameSamples(const SampleBuffer& first, const SampleBuffer& second)
+	{
+		return first.size() == second.size() && first.hasTiming() == second.hasTiming()
+			&& (first.empty() || std::memcmp(first.getValues().data(), second.getValues().data(), first.size() * sizeof(double)) == 0)
+			&& std::equal(first.getTimestamps().begin(), first.getTimestamps().end(), second.getTimestamps().begin(), second.getTimestamps().end())
+			&& std::equal(first.getSequences().begin(), first.getSequences().end(), second.getSequences().begin(), second.getSequences().end());
+	}
+
+	void registerCompressedSampleStoreTests(TestSuite& suite)
+	{
+		const size_t sizes[] = { 0, 1, 4095, 4096, 4097, 3 * CompressedSampleStore::kBlockSize + 17 };
+
+		suite.add("CompressedSampleStore/roundTrip", [sizes](TestSuite& test)
+		{
+			for (size_t size : sizes)
+			{
+				for (bool timing : { false, true })
+				{
+					std::string name = "size " + std::to_string(size) + (timing ? " with timing" : " without timing");
+					CompressedSampleStore store;
+					fillStore(store, size, timing);
+					SampleBuffer original;
+					store.decode(original);
+
+					std::vector<unsigned char> bytes;
+					store.serialize(bytes);
+					CompressedSampleStore restored;
+					test.check(restored.deserialize(bytes), name + " deserializes");
+					SampleBuffer decoded;
+					restored.decode(decoded);
+					test.check(original.size() == size && sameSamples(original, decoded), name + " decodes bit-exactly");
+					test.check(restored.hasTiming() == (timing && size > 0) && restored.getBlockCount() == store.getBlockCount(), name + " blocks and timing");
+
+					DataStatistics expected = store.getStatistics();
+					DataStatistics actual = restored.getStatistics();
+					test.check(actual.count == expected.count && std::memcmp(&actual.sum, &expected.sum, sizeof(double)) == 0
+						&& std::memcmp(&actual.min, &expected.min, sizeof(double)) == 0 && std::memcmp(&actual.max, &expected.max, sizeof(double)) == 0,
+						name + " statistics");
+
+					// A restored partial block keeps filling like the original one
+					std::vector<unsigned char> again;
+					restored.serialize(again);
+					test.check(again == bytes, name + " serializes to the same bytes");
+					if (!timing)
+					{
+						const double more[] = { 1.0, 2.0, 3.0 };
+						store.append(more);
+						restored.append(more);
+						store.decode(original);
+						restored.decode(decoded);
+						test.check(sameSamples(original, decoded), name + " appends after deserializing");
+					}
+				}
+			}
+		});
+
+		suite.add("CompressedSampleStore/malformed", [sizes](TestSuite& test)
+		{
+			for (size_t size : sizes)
+			{
+				CompressedSampleStore store;
+				fillStore(store, size, true);
+				std::vector<unsigned char> bytes;
+				store.serialize(bytes);
+				std::string name = "size " + std::to_string(size);
+
+				// Every truncation is rejected and leaves the store empty
+				CompressedSampleStore restored;
+				bool truncatedRejected = true;
+				for (size_t length = 0; length < bytes.size(); length += length < 256 ? 1 : 61)
+				{
+					fillStore(restored, 3, true);
+					truncatedRejected = truncatedRejected && !restored.deserialize(std::span<const unsigned char>(bytes.data(), length)) && restored.empty();
+				}
+				test.check(truncatedRejected, name + " truncated");
+
+				std::vector<unsigned char> extended = bytes;
+				extended.push_back(0);
+				test.check(!restored.deserialize(extended) && restored.empty(), name + " trailing byte");
+
+				// Corrupt header words and block summaries are rejected
+				const size_t headerWords[] = { 0, 1, 3, 4, 5, 6 };
+				for (size_t word : headerWords)
+				{
+					std::vector<unsigned char> corrupt = bytes;
+					corrupt[word * sizeof(std::uint64_t)] ^= 0x5a;
+					test.check(!restored.deserialize(corrupt) && restored.empty(), name + " corrupt header word " + std::to_string(word));
+				}
+
+				// A corrupt bit stream decodes to garbage of the right length, without reading outside the store
+				std::mt19937 generator((unsigned)size);
+				bool decodedAll = true;
+				for (int round = 0; round < 50; round++)
+				{
+					std::vector<unsigned char> corrupt = bytes;
+					size_t streamBegin = 8 * sizeof(std::uint64_t) + store.getBlockCount() * 8 * sizeof(std::uint64_t);
+					if (streamBegin >= corrupt.size())
+						break;
+					corrupt[streamBegin + generator() % (corrupt.size() - streamBegin)] ^= (unsigned char)(1 + generator() % 255);
+					if (restored.deserialize(corrupt))
+					{
+						SampleBuffer decoded;
+						restored.decode(decoded);
+						decodedAll = decodedAll && decoded.size() == size;
+					}
+				}
+				test.check(decodedAll, name + " corrupt bit streams");
+			}
+		});
+	}
+
+	// Fletcher-64 as written in its definition: one modulo per 32-bit word
+	std::uint64_t naiveFletcher64(const std::vector<unsigned char>& bytes)
+	{
+		std::uint64_t sum1 = 0;
+		std::uint64_t sum2 = 0;
+		for (size_t i = 0; i < bytes.size(); i += 4)
+		{
+			std::uint64_t word = 0;
+			for (size_t b = 0; b < 4 && i + b < bytes.size(); b++)
+				word |= (std::uint64_t)bytes[i + b] << (8 * b);
+			sum1 = (sum1 + word) % 0xFFFFFFFFull;
+			sum2 = (sum2 + sum1) % 0xFFFFFFFFull;
+		}
+		return (sum2 << 32) | sum1;
+	}
+
+	std::vector<unsigned char> readFileBytes(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void writeFileBytes(const std::string& path, const std::vector<unsigned char>& bytes)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+	}
+
+	std::string getTestFilePath(const std::string& name)
+	{
+		return (std::filesystem::temp_directory_path() / ("sirius_tests_" + name)).string();
+	}
+
+	void registerCaptureFileTests(TestSuite& suite)
+	{
+		suite.add("CaptureFile/checksum", [](TestSuite& test)
+		{
+			// Every tail length, and a size past the point where the sums are first reduced
+			std::mt19937 generator(17);
+			const size_t sizes[] = { 0, 1, 2, 3, 4, 5, 7, 8, 1001, 4 * 92680 + 6, 4 * 200000 + 3 };
+			for (size_t size : sizes)
+			{
+				std::vector<unsigned char> bytes(size);
+				for (unsigned char& byte : bytes)
+					byte = (unsigned char)(generator() | 0xf0); // Large words make the sums wrap
+				test.check(computeCaptureChecksum(bytes.data(), bytes.size()) == naiveFletcher64(bytes), "size " + std::to_string(size));
+			}
+		});
+
+		suite.add("CaptureFile/roundTrip", [](TestSuite& test)
+		{
+			std::vector<double> raw = makeRandomData(100003, 19);
+			std::vector<double> processed = naiveMovingAverage(raw, 3);
+			std::vector<std::uint64_t> timestamps(raw.size());
+			std::vector<std::uint32_t> sequences(raw.size());
+			for (size_t i = 0; i < raw.size(); i++)
+			{
+				timestamps[i] = 5000000000ull + i * 1000 + i % 7;
+				sequences[i] = (std::uint32_t)(i + i / 10000);
+			}
+			CompressedSampleStore store;
+			fillStore(store, 10000, true);
+
+			std::string path = getTestFilePath("roundTrip.cap");
+			CaptureWriter writer(4096);
+			writer.setSamplePeriod(1000);
+			writer.addColumn("raw", std::span<const double>(raw));
+			writer.addColumn("timestamp", std::span<const std::uint64_t>(timestamps));
+			writer.addColumn("sequence", std::span<const std::uint32_t>(sequences));
+			writer.addColumn("processed", std::span<const double>(processed), 1);
+			writer.addColumn("compressed", store);
+			test.check(writer.write(path), "written");
+
+			CaptureReader reader;
+			test.check(reader.open(path), "opened: " + reader.getLastError());
+			test.check(reader.getSamplePeriod() == 1000 && reader.getColumnCount() == 5 && reader.getChunkSize() == 4096, "header");
+			test.check(reader.findColumn("raw") == 0 && reader.findColumn("processed", 1) == 3 && reader.findColumn("processed") == -1
+				&& reader.findColumn("missing") == -1, "columns found by name and channel");
+
+			// The views into the mapping hold the written bytes
+			std::span<const double> rawColumn = reader.getColumn(0);
+			std::span<const double> processedColumn = reader.getColumn(3);
+			std::span<const std::uint64_t> timestampColumn = reader.getUInt64Column(1);
+			std::span<const std::uint32_t> sequenceColumn = reader.getUInt32Column(2);
+			test.check(rawColumn.size() == raw.size() && std::memcmp(rawColumn.data(), raw.data(), raw.size() * sizeof(double)) == 0, "raw column");
+			test.check(processedColumn.size() == processed.size()
+				&& std::memcmp(processedColumn.data(), processed.data(), processed.size() * sizeof(double)) == 0, "processed column");
+			test.check(std::equal(timestamps.begin(), timestamps.end(), timestampColumn.begin(), timestampColumn.end()), "timestamp column");
+			test.check(std::equal(sequences.begin(), sequences.end(), sequenceColumn.begin(), sequenceColumn.end()), "sequence column");
+			test.check(reader.getUInt64Column(0).empty() && reader.getColumn(1).empty(), "typed views of other column types are empty");
+
+			CompressedSampleStore restored;
+			SampleBuffer expected;
+			SampleBuffer decoded;
+			store.decode(expected);
+			test.check(reader.getCompressedColumn(4, restored), "compressed column");
+			restored.decode(decoded);
+			test.check(sameSamples(expected, decoded), "compressed column decodes to the stored data points");
+
+			// One summary per chunk of the double columns only
+			std::span<const CaptureChunkIndexEntry> chunks = reader.getChunkIndex(0);
+			test.check(chunks.size() == (raw.size() + 4095) / 4096 && reader.getChunkIndex(1).empty(), "chunk count");
+			bool chunksMatch = true;
+			for (size_t chunk = 0; chunk < chunks.size(); chunk++)
+			{
+				size_t begin = chunk * 4096;
+				size_t end = std::min(raw.size(), begin + 4096);
+				chunksMatch = chunksMatch && chunks[chunk].min == *std::min_element(raw.begin() + begin, raw.begin() + end)
+					&& chunks[chunk].max == *std::max_element(raw.begin() + begin, raw.begin() + end)
+					&& chunks[chunk].checksum == computeCaptureChecksum(raw.data() + begin, (end - begin) * sizeof(double));
+			}
+			test.check(chunksMatch, "chunk summaries");
+			reader.close();
+			test.check(!reader.isOpen(), "closed");
+			std::filesystem::remove(path);
+		});
+
+		suite.add("CaptureFile/integerReplay", [](TestSuite& test)
+		{
+			// 16-bit counts are stored in their own width and replayed without a copy, or converted through physical units
+			const double scale = 100.0 / 32767.0;
+			std::vector<double> data = makeRandomData(10007, 29);
+			std::vector<std::int16_t> counts(data.size());
+			for (size_t i = 0; i < data.size(); i++)
+				counts[i] = SampleTraits<std::int16_t>::quantize(data[i], scale);
+
+			std::string path = getTestFilePath("integerReplay.cap");
+			CaptureWriter writer(1024);
+			writer.setValueScale(scale);
+			writer.addColumn("raw", std::span<const std::int16_t>(counts));
+			test.check(writer.write(path), "written");
+
+			CaptureReader reader;
+			test.check(reader.open(path), "opened: " + reader.getLastError());
+			std::span<const std::int16_t> column = reader.getSampleColumn<std::int16_t>(0);
+			test.check(reader.getValueScale() == scale && reader.getColumnDescriptor(0).type == eColumnInt16, "scale and column type");
+			test.check(std::equal(counts.begin(), counts.end(), column.begin(), column.end()) && reader.getColumn(0).empty(), "counts column");
+			std::span<const CaptureChunkIndexEntry> chunks = reader.getChunkIndex(0);
+			test.check(chunks.size() == (counts.size() + 1023) / 1024
+				&& chunks[0].max == *std::max_element(counts.begin(), counts.begin() + 1024) * scale, "chunk summaries in physical units");
+			reader.close();
+
+			{
+				// Scoped, so neither source keeps the file mapped when it is removed
+				BasicReplaySource<std::int16_t> native;
+				test.check(native.load(path), "native replay loaded: " + native.getLastError());
+				std::span<const std::int16_t> replayed = native.getSamples();
+				test.check(native.getScale() == scale && std::equal(counts.begin(), counts.end(), replayed.begin(), replayed.end()), "native replay");
+
+				ReplaySource converted;
+				test.check(converted.load(path), "converted replay loaded: " + converted.getLastError());
+				std::span<const double> values = converted.getSamples();
+				size_t wrong = 0;
+				for (size_t i = 0; i < std::min(values.size(), counts.size()); i++)
+					wrong += values[i] != counts[i] * scale;
+				test.check(values.size() == counts.size() && wrong == 0 && converted.getScale() == 1.0, std::to_string(wrong) + " converted values differ");
+			}
+			std::filesystem::remove(path);
+		});
+
+		suite.add("CaptureFile/corruption", [](TestSuite& test)
+		{
+			std::vector<double> raw = makeRandomData(20000, 23);
+			std::vector<std::uint32_t> sequences(raw.size());
+			for (size_t i = 0; i < sequences.size(); i++)
+				sequences[i] = (std::uint32_t)i;
+			std::string path = getTestFilePath("corruption.cap");
+			CaptureWriter writer;
+			writer.addColumn("raw", std::span<const double>(raw));
+			writer.addColumn("sequence", std::span<const std::uint32_t>(sequences));
+			writer.write(path);
+			std::vector<unsigned char> bytes = readFileBytes(path);
+			CaptureReader reader;
+			test.check(reader.open(path), "intact file opens");
+			reader.close();
+
+			// A flipped bit anywhere in either column fails its checksum, unless checksums are skipped
+			const CaptureColumnDescriptor* descriptors = reinterpret_cast<const CaptureColumnDescriptor*>(bytes.data() + sizeof(CaptureFileHeader));
+			for (int column = 0; column < 2; column++)
+			{
+				size_t begin = (size_t)descriptors[column].dataOffset;
+				size_t length = (size_t)descriptors[column].valueCount * getCaptureValueSize(descriptors[column].type);
+				const size_t positions[] = { begin, begin + length / 2, begin + length - 1 };
+				for (size_t position : positions)
+				{
+					std::vector<unsigned char> corrupt = bytes;
+					corrupt[position] ^= 0x10;
+					writeFileBytes(path, corrupt);
+					std::string name = "column " + std::to_string(column) + " byte " + std::to_string(position);
+					test.check(!reader.open(path) && reader.getLastError().find("checksum") != std::string::npos && !reader.isOpen(), name + " rejected");
+					test.check(reader.open(path, false), name + " opens without verification");
+					reader.close();
+				}
+			}
+
+			// Cut anywhere in the header, the column table or the data
+			bool truncatedRejected = true;
+			const size_t lengths[] = { 0, 1, sizeof(CaptureFileHeader) - 1, sizeof(CaptureFileHeader), sizeof(CaptureFileHeader) + 71,
+				(size_t)descriptors[0].dataOffset + 8, bytes.size() / 2, bytes.size() - 1 };
+			for (size_t length : lengths)
+			{
+				writeFileBytes(path, std::vector<unsigned char>(bytes.begin(), bytes.begin() + length));
+				truncatedRejected = truncatedRejected && !reader.open(path, false) && !reader.isOpen();
+			}
+			test.check(truncatedRejected, "truncated files rejected");
+
+			std::vector<unsigned char> wrongMagic = bytes;
+			wrongMagic[0] = 'X';
+			writeFileBytes(path, wrongMagic);
+			test.check(!reader.open(path) && reader.getLastError() == "not a capture file", "wrong magic rejected");
+
+			std::vector<unsigned char> wrongVersion = bytes;
+			wrongVersion[offsetof(CaptureFileHeader, version)] = 2;
+			writeFileBytes(path, wrongVersion);
+			test.check(!reader.open(path) && reader.getLastError().find("version 2") != std::string::npos, "wrong version rejected");
+
+			std::vector<unsigned char> wrongType = bytes;
+			wrongType[sizeof(CaptureFileHeader) + offsetof(CaptureColumnDescriptor, type)] = 0x7f;
+			writeFileBytes(path, wrongType);
+			test.check(!reader.open(path) && reader.getLastError().find("unknown type") != std::string::npos, "unknown column type rejected");
+			std::filesystem::remove(path);
+		});
+	}
+
+	// xoshiro256++ as published by Blackman and Vigna, on an explicit state
+	std::uint64_t referenceXoshiro(std::uint64_t state[4])
+	{
+		auto rotl = [](std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); };
+		std::uint64_t result = rotl(state[0] + state[3], 23) + state[0];
+		std::uint64_t t = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = rotl(state[3], 45);
+		return result;
+	}
+
+	// pcg32_random_r as published by O'Neill, on an explicit state and increment
+	std::uint32_t referencePcg32(std::uint64_t& state, std::uint64_t increment)
+	{
+		std::uint64_t old = state;
+		state = old * 6364136223846793005ULL + increment;
+		std::uint32_t shifted = (std::uint32_t)(((old >> 18) ^ old) >> 27);
+		std::uint32_t rotation = (std::uint32_t)(old >> 59);
+		return (shifted >> rotation) | (shifted << ((0u - rotation) & 31));
+	}
+
+	// pcg32_srandom_r: seeds the state and selects the stream
+	void referencePcg32Seed(std::uint64_t& state, std::uint64_t& increment, std::uint64_t initialState, std::uint64_t stream)
+	{
+		state = 0;
+		increment = (stream << 1) | 1;
+		referencePcg32(state, increment);
+		state += initialState;
+		referencePcg32(state, increment);
+	}
+
+	void registerRandomEngineTests(TestSuite& suite)
+	{
+		suite.add("RandomEngine/splitMix64", [](TestSuite& test)
+		{
+			// The first outputs of SplitMix64 from state 0
+			std::uint64_t state = 0;
+			test.check(RandomEngine::splitMix64(state) == 0xe220a8397b1dcdafULL, "first output");
+			test.check(RandomEngine::splitMix64(state) == 0x6e789e6aa1b965f4ULL, "second output");
+			test.check(RandomEngine::splitMix64(state) == 0x06c45d188009454fULL, "third output");
+			test.check(state == 3 * 0x9e3779b97f4a7c15ULL, "the state advances by the golden gamma");
+		});
+
+		suite.add("RandomEngine/xoshiro256PlusPlus", [](TestSuite& test)
+		{
+			// The reference implementation reproduces the published outputs of the state {1, 2, 3, 4}
+			const std::uint64_t published[] = { 41943041ULL, 58720359ULL, 3588806011781223ULL, 3591011842654386ULL,
+				9228616714210784205ULL, 9973669472204895162ULL };
+			std::uint64_t state[4] = { 1, 2, 3, 4 };
+			bool referenceMatches = true;
+			for (std::uint64_t expected : published)
+				referenceMatches = referenceMatches && referenceXoshiro(state) == expected;
+			test.check(referenceMatches, "reference implementation");
+
+			// The engine expands its seed into four SplitMix64 outputs and then follows the reference
+			const std::uint64_t seeds[] = { 0, 1, 42, 0xffffffffffffffffULL };
+			for (std::uint64_t seed : seeds)
+			{
+				std::uint64_t seedState = seed;
+				for (std::uint64_t& word : state)
+					word = RandomEngine::splitMix64(seedState);
+				std::unique_ptr<RandomEngine> engine = createRandomEngine(eXoshiro256PlusPlus, seed);
+				size_t wrong = 0;
+				for (int i = 0; i < 1000; i++)
+					wrong += engine->next() != referenceXoshiro(state);
+				test.check(wrong == 0, "seed " + std::to_string(seed) + ": " + std::to_string(wrong) + " of 1000 outputs differ");
+			}
+
+			// Fixed outputs of seed 1, so a change of the seeding shows up too
+			std::unique_ptr<RandomEngine> engine = createRandomEngine(eXoshiro256PlusPlus, 1);
+			test.check(engine->next() == 0xcfc5d07f6f03c29bULL && engine->next() == 0xbf424132963fe08dULL
+				&& engine->next() == 0x19a37d5757aaf520ULL && engine->next() == 0xbf08119f05cd56d6ULL, "seed 1 outputs");
+		});
+
+		suite.add("RandomEngine/pcg32", [](TestSuite& test)
+		{
+			// The reference implementation reproduces the output of the pcg32 demo program (seed 42, stream 54)
+			const std::uint32_t published[] = { 0xa15c02b7u, 0x7b47f409u, 0xba1d3330u, 0x83d2f293u, 0xbfa4784bu, 0xcbed606eu };
+			std::uint64_t state;
+			std::uint64_t increment;
+			referencePcg32Seed(state, increment, 42, 54);
+			bool referenceMatches = true;
+			for (std::uint32_t expected : published)
+				referenceMatches = referenceMatches && referencePcg32(state, increment) == expected;
+			test.check(referenceMatches, "reference implementation");
+
+			// The engine derives the initial state and the stream from two SplitMix64 outputs, and joins two outputs per value
+			const std::uint64_t seeds[] = { 0, 1, 42, 0xffffffffffffffffULL };
+			for (std::uint64_t seed : seeds)
+			{
+				std::uint64_t seedState = seed;
+				std::uint64_t initialState = RandomEngine::splitMix64(seedState);
+				referencePcg32Seed(state, increment, initialState, RandomEngine::splitMix64(seedState));
+				std::unique_ptr<RandomEngine> engine = createRandomEngine(ePcg32, seed);
+				size_t wrong = 0;
+				for (int i = 0; i < 1000; i++)
+				{
+					std::uint64_t high = referencePcg32(state, increment);
+					wrong += engine->next() != ((high << 32) | referencePcg32(state, increment));
+				}
+				test.check(wrong == 0, "seed " + std::to_string(seed) + ": " + std::to_string(wrong) + " of 1000 outputs differ");
+			}
+
+			std::unique_ptr<RandomEngine> engine = createRandomEngine(ePcg32, 1);
+			test.check(engine->next() == 0x5249c5dc01959430ULL && engine->next() == 0xe797676957d21847ULL
+				&& engine->next() == 0xec0994207efb0d93ULL && engine->next() == 0xe1ee15d6bae53d6bULL, "seed 1 outputs");
+		});
+
+		suite.add("RandomEngine/fillUniform", [](TestSuite& test)
+		{
+			// A filled block holds exactly the values of single draws, and leaves the engine where they would
+			for (RandomEngineType type : { eXoshiro256PlusPlus, ePcg32 })
+			{
+				std::string name = type == ePcg32 ? "pcg32" : "xoshiro256++";
+				std::unique_ptr<RandomEngine> blocks = createRandomEngine(type, 7);
+				std::unique_ptr<RandomEngine> single = createRandomEngine(type, 7);
+				const size_t sizes[] = { 0, 1, 3, 1000, 4097 };
+				size_t wrong = 0;
+				size_t outside = 0;
+				for (size_t size : sizes)
+				{
+					std::vector<double> block(size);
+					blocks->fillUniform(std::span<double>(block), -3.0, 5.0);
+					for (double value : block)
+					{
+						wrong += value != -3.0 + RandomEngine::toUnitInterval(single->next()) * 8.0;
+						outside += value < -3.0 || value >= 5.0;
+					}
+				}
+				test.check(wrong == 0, name + ": " + std::to_string(wrong) + " values differ from single draws");
+				test.check(outside == 0, name + ": " + std::to_string(outside) + " values outside [min, max)");
+				test.check(blocks->next() == single->next(), name + ": the engines continue in step");
+			}
+		});
+	}
+
+	void registerSensorTests(TestSuite& suite)
+	{
+		suite.add("Sensor/blockSplits", [](TestSuite& test)
+		{
+			// Chained blocks of any size continue the sequence of one large block, bit for bit
+			const size_t count = 10000;
+			const DataType types[] = { LINEAR, SINE, RANDOM };
+			const char* const names[] = { "linear", "sine", "random" };
+			for (int t = 0; t < 3; t++)
+			{
+				for (RandomEngineType engine : { eXoshiro256PlusPlus, ePcg32 })
+				{
+					std::string name = std::string(names[t]) + (engine == ePcg32 ? " pcg" : " xoshiro");
+					Sensor whole((int)count, eImmediate, 100, types[t], -50.0, 75.0, 3);
+					whole.setRandomEngine(createRandomEngine(engine, 3));
+					std::vector<double> expected(count);
+					whole.generateBlock(std::span<double>(expected));
+
+					// Split sizes around the lane width and the re-seed segment, then random ones
+					std::mt19937 generator(t);
+					const size_t fixedSplits[] = { 1, 7, 8, 9, 1023, 1024, 1025 };
+					for (int round = 0; round < 10; round++)
+					{
+						Sensor split((int)count, eImmediate, 100, types[t], -50.0, 75.0, 3);
+						split.setRandomEngine(createRandomEngine(engine, 3));
+						std::vector<double> actual(count);
+						for (size_t begin = 0, piece = 0; begin < count; piece++)
+						{
+							size_t size = round < 7 ? fixedSplits[round] : 1 + generator() % (round == 7 ? 16 : 3000);
+							size = std::min(size, count - begin);
+							split.generateBlock(std::span<double>(actual.data() + begin, size));
+							begin += size;
+						}
+						test.check(std::memcmp(actual.data(), expected.data(), count * sizeof(double)) == 0, name + ", split round " + std::to_string(round));
+					}
+
+					// The per-point collection produces the same sequence
+					Sensor collected((int)count, eImmediate, 100, types[t], -50.0, 75.0, 3);
+					collected.setRandomEngine(createRandomEngine(engine, 3));
+					std::vector<double> points;
+					collected.collectDataPoints([&points](const Sample& sample) { points.push_back(sample.value); });
+					test.check(points.size() == count && std::memcmp(points.data(), expected.data(), count * sizeof(double)) == 0, name + ", collectDataPoints");
+				}
+			}
+		});
+
+		suite.add("Sensor/sineAccuracy", [](TestSuite& test)
+		{
+			// The phase rotation stays within one ulp of the phase of sin(step * 0.1), across many re-seed segments
+			Sensor sensor(10, eImmediate, 100, SINE);
+			std::vector<double> block(300000);
+			sensor.generateBlock(std::span<double>(block));
+			size_t outside = 0;
+			double worst = 0.0;
+			for (size_t i = 0; i < block.size(); i++)
+			{
+				double phase = (double)i * 0.1;
+				double error = std::fabs(block[i] - std::sin(phase));
+				double bound = std::nextafter(phase, HUGE_VAL) - phase;
+				outside += error > bound;
+				worst = std::max(worst, error);
+			}
+			test.check(outside == 0, std::to_string(outside) + " values outside one ulp of the phase, worst error " + std::to_string(worst));
+		});
+
+		suite.add("Sensor/typedBlocks", [](TestSuite& test)
+		{
+			// Typed blocks hold the quantized values of the double sequence
+			const size_t count = 5000;
+			const double scale = 100.0 / 32767.0;
+			Sensor reference((int)count, eImmediate, 100, RANDOM, -100.0, 100.0, 5);
+			BasicSensor<std::int16_t> typed((int)count, eImmediate, 100, RANDOM, -100.0, 100.0, 5, scale);
+			std::vector<double> values(count);
+			std::vector<std::int16_t> counts(count);
+			reference.generateBlock(std::span<double>(values));
+			typed.generateSamples(std::span<std::int16_t>(counts.data(), 1234));
+			typed.generateSamples(std::span<std::int16_t>(counts.data() + 1234, count - 1234));
+			size_t wrong = 0;
+			for (size_t i = 0; i < count; i++)
+				wrong += counts[i] != SampleTraits<std::int16_t>::quantize(values[i], scale);
+			test.check(wrong == 0, std::to_string(wrong) + " counts differ from the quantized values");
+		});
+	}
+
+	// A value spanning two slot words, so a slot read while it is being overwritten shows up as a mismatch
+	struct Token
+	{
+		std::uint64_t sequence; // Position in the pushed stream
+		std::uint64_t check;    // Derived from sequence
+	};
+
+	Token makeToken(std::uint64_t sequence)
+	{
+		return { sequence, ~sequence * 0x9e3779b97f4a7c15ull };
+	}
+
+	bool isIntact(const Token& token)
+	{
+		return token.check == ~token.sequence * 0x9e3779b97f4a7c15ull;
+	}
+
+	// Pushes `count` tokens on one thread and pops them on another, which pauses every `pauseEvery` pops
+	// so that the buffer overflows; returns the sequences received in order
+	std::vector<std::uint64_t> streamTokens(SpscRingBuffer<Token>& buffer, std::uint64_t count, int pauseEvery, bool& intact)
+	{
+		std::vector<std::uint64_t> received;
+		bool allIntact = true;
+		std::thread consumer([&buffer, &received, &allIntact, pauseEvery]
+		{
+			Token token;
+			while (true)
+			{
+				if (buffer.tryPop(token))
+				{
+					allIntact = allIntact && isIntact(token);
+					received.push_back(token.sequence);
+					if (pauseEvery > 0 && received.size() % pauseEvery == 0)
+						std::this_thread::yield();
+				}
+				else if (buffer.isDrained())
+				{
+					break;
+				}
+			}
+		});
+		for (std::uint64_t i = 0; i < count; i++)
+			buffer.push(makeToken(i));
+		buffer.close();
+		consumer.join();
+		intact = allIntact;
+		return received;
+	}
+
+	void registerSpscRingBufferTests(TestSuite& suite)
+	{
+		suite.add("SpscRingBuffer/wraparound", [](TestSuite& test)
+		{
+			// The indices run far past the capacity, the slots are reused in order
+			SpscRingBuffer<Token> buffer(5);
+			test.check(buffer.getCapacity() == 8, "capacity rounded up to a power of two");
+			std::uint64_t pushed = 0;
+			std::uint64_t popped = 0;
+			bool inOrder = true;
+			for (int round = 0; round < 1000; round++)
+			{
+				// Varying fill levels, up to a full buffer
+				int fill = 1 + round % 8;
+				for (int i = 0; i < fill; i++)
+					buffer.push(makeToken(pushed++));
+				Token token;
+				for (int i = 0; i < fill; i++)
+					inOrder = inOrder && buffer.tryPop(token) && token.sequence == popped++ && isIntact(token);
+				inOrder = inOrder && !buffer.tryPop(token);
+			}
+			test.check(inOrder, "every value popped once, in order");
+			test.check(buffer.getDroppedCount() == 0, "nothing dropped");
+			buffer.close();
+			test.check(buffer.isDrained(), "drained after close");
+		});
+
+		suite.add("SpscRingBuffer/overflowPolicies", [](TestSuite& test)
+		{
+			// Ten values into four slots on one thread, then the survivors are popped
+			const OverflowPolicy policies[] = { eDropOldest, eDropNewest };
+			for (OverflowPolicy policy : policies)
+			{
+				std::string name = policy == eDropOldest ? "drop-oldest" : "drop-newest";
+				SpscRingBuffer<Token> buffer(4, policy);
+				int stored = 0;
+				for (std::uint64_t i = 0; i < 10; i++)
+					stored += buffer.push(makeToken(i));
+				test.check(buffer.getDroppedCount() == 6, name + ": " + std::to_string(buffer.getDroppedCount()) + " dropped");
+				test.check(stored == (policy == eDropOldest ? 10 : 4), name + ": push reports whether the value was stored");
+
+				// The survivors are a contiguous run: the newest four or the oldest four
+				std::uint64_t expected = policy == eDropOldest ? 6 : 0;
+				Token token;
+				bool continuous = true;
+				for (int i = 0; i < 4; i++)
+					continuous = continuous && buffer.tryPop(token) && token.sequence == expected++;
+				test.check(continuous && !buffer.tryPop(token), name + ": the kept values are consecutive");
+
+				// Room again after popping, nothing more is dropped
+				buffer.push(makeToken(10));
+				test.check(buffer.tryPop(token) && token.sequence == 10 && buffer.getDroppedCount() == 6, name + ": keeps going after the overflow");
+			}
+		});
+
+		suite.add("SpscRingBuffer/producerConsumer", [](TestSuite& test)
+		{
+			// A slow consumer against a producer that never waits; each policy accounts for every value
+			const std::uint64_t count = 200000;
+			const OverflowPolicy policies[] = { eBlock, eDropOldest, eDropNewest };
+			const char* const names[] = { "block", "drop-oldest", "drop-newest" };
+			for (int p = 0; p < 3; p++)
+			{
+				SpscRingBuffer<Token> buffer(64, policies[p]);
+				bool intact = false;
+				std::vector<std::uint64_t> received = streamTokens(buffer, count, 16, intact);
+				bool increasing = std::adjacent_find(received.begin(), received.end(),
+					[](std::uint64_t a, std::uint64_t b) { return b <= a; }) == received.end();
+				std::string name = names[p];
+				test.check(intact && increasing, name + ": intact values in increasing order");
+				test.check(received.size() + buffer.getDroppedCount() == count, name + ": " + std::to_string(received.size()) + " received + "
+					+ std::to_string(buffer.getDroppedCount()) + " dropped");
+				if (policies[p] == eBlock)
+					test.check(buffer.getDroppedCount() == 0, name + ": nothing dropped");
+				else if (policies[p] == eDropOldest)
+					test.check(!received.empty() && received.back() == count - 1, name + ": the newest value is delivered");
+				else
+					test.check(!received.empty() && received.front() == 0, name + ": the first value is delivered");
+			}
+		});
+
+		suite.add("SpscRingBuffer/closeWithValuesInFlight", [](TestSuite& test)
+		{
+			// The producer fills the buffer and closes it before the consumer starts; the consumer must not
+			// treat the closed buffer as drained while values are left
+			const OverflowPolicy policies[] = { eBlock, eDropOldest, eDropNewest };
+			for (OverflowPolicy policy : policies)
+			{
+				SpscRingBuffer<Token> buffer(16, policy);
+				std::atomic<bool> closed(false);
+				std::thread producer([&buffer, &closed]
+				{
+					for (std::uint64_t i = 0; i < 16; i++)
+						buffer.push(makeToken(i));
+					buffer.close();
+					closed.store(true, std::memory_order_release);
+				});
+				while (!closed.load(std::memory_order_acquire))
+					std::this_thread::yield();
+
+				std::uint64_t expected = 0;
+				Token token;
+				bool complete = true;
+				while (!buffer.isDrained())
+				{
+					if (buffer.tryPop(token))
+						complete = complete && token.sequence == expected++;
+				}
+				producer.join();
+				test.check(complete && expected == 16, "policy " + std::to_string((int)policy) + ": "
+					+ std::to_string(expected) + " of 16 values popped after close");
+			}
+		});
+
+		suite.add("SpscRingBuffer/dropOldestRace", [](TestSuite& test)
+		{
+			// Two slots and a producer that overruns the consumer all the time: the producer keeps claiming the
+			// value the consumer is reading, whose compare-and-swap then fails and reads the next one instead.
+			// A torn or repeated value would mean a dropped value was returned.
+			const std::uint64_t count = 1000000;
+			SpscRingBuffer<Token> buffer(2, eDropOldest);
+			bool intact = false;
+			std::vector<std::uint64_t> received = streamTokens(buffer, count, 0, intact);
+			bool increasing = std::adjacent_find(received.begin(), received.end(),
+				[](std::uint64_t a, std::uint64_t b) { return b <= a; }) == received.end();
+			test.check(intact, "no torn values");
+			test.check(increasing, "no value returned twice or out of order");
+			test.check(received.size() + buffer.getDroppedCount() == count, std::to_string(received.size()) + " received + "
+				+ std::to_string(buffer.getDroppedCount()) + " dropped");
+			test.check(!received.empty() && received.back() == count - 1, "the newest value is delivered");
+		});
+	}
+
+	void registerTimingTests(TestSuite& suite)
+	{
+		suite.add("Timing/jitterBuckets", [](TestSuite& test)
+		{
+			// Bucket 0 holds exact hits, bucket b holds [2^(b-1), 2^b), the last bucket everything above
+			const std::int64_t latenesses[] = { -5, 0, 1, 2, 3, 4, 1023, 1024, 1025, (std::int64_t)1 << 38, (std::int64_t)1 << 62 };
+			const int buckets[] = { 0, 0, 1, 2, 2, 3, 10, 11, 11, 39, 39 };
+			JitterHistogram histogram;
+			for (std::int64_t lateness : latenesses)
+				histogram.add(lateness);
+			int expectedCounts[JitterHistogram::kBucketCount] = {};
+			for (int bucket : buckets)
+				expectedCounts[bucket]++;
+			bool countsMatch = true;
+			for (int bucket = 0; bucket < JitterHistogram::kBucketCount; bucket++)
+				countsMatch = countsMatch && histogram.getBucketCount(bucket) == expectedCounts[bucket];
+			test.check(countsMatch, "bucket counts");
+			test.check(JitterHistogram::getBucketUpperBound(0) == 1 && JitterHistogram::getBucketUpperBound(11) == 2048
+				&& JitterHistogram::getBucketUpperBound(JitterHistogram::kBucketCount - 1) == INT64_MAX, "bucket bounds");
+
+			// Early events count as on time, the moments are exact
+			double sum = 0.0;
+			for (std::int64_t lateness : latenesses)
+				sum += (double)std::max<std::int64_t>(lateness, 0);
+			double mean = sum / 11.0;
+			double squares = 0.0;
+			for (std::int64_t lateness : latenesses)
+				squares += ((double)std::max<std::int64_t>(lateness, 0) - mean) * ((double)std::max<std::int64_t>(lateness, 0) - mean);
+			test.check(histogram.getCount() == 11 && histogram.getMin() == 0 && histogram.getMax() == (std::int64_t)1 << 62, "count, minimum and maximum");
+			test.checkNear(histogram.getMean(), mean, 1e-12 * mean, "mean");
+			test.checkNear(histogram.getStandardDeviation(), std::sqrt(squares / 11.0), 1e-9 * std::sqrt(squares / 11.0), "standard deviation");
+
+			histogram.reset();
+			test.check(histogram.getCount() == 0 && histogram.getBucketCount(0) == 0 && histogram.getPercentile(0.5) == 0, "reset");
+		});
+
+		suite.add("Timing/jitterPercentiles", [](TestSuite& test)
+		{
+			// 900 latenesses of 500 ns, 90 of 5 us and 10 of 100 us
+			JitterHistogram histogram;
+			for (int i = 0; i < 1000; i++)
+				histogram.add(i < 900 ? 500 : i < 990 ? 5000 : 100000);
+			test.check(histogram.getPercentile(0.0) == 512 && histogram.getPercentile(0.5) == 512 && histogram.getPercentile(0.9) == 512,
+				"up to p90 in [256, 512)");
+			test.check(histogram.getPercentile(0.901) == 8192 && histogram.getPercentile(0.99) == 8192, "p90.1 to p99 in [4096, 8192)");
+			test.check(histogram.getPercentile(0.991) == 100000 && histogram.getPercentile(1.0) == 100000, "the top bucket is capped at the maximum");
+		});
+
+		suite.add("Timing/absoluteDeadlines", [](TestSuite& test)
+		{
+			// Each tick does half a period of work and tick 5 stalls for three periods. Deadlines are absolute, so the
+			// work does not add up and the ticks after the stall catch up instead of being shifted.
+			const std::uint64_t period = 4000000; // 4 ms
+			const int ticks = 25;
+			SampleScheduler scheduler;
+			scheduler.start();
+			bool neverEarly = true;
+			std::uint64_t returned = 0;
+			std::uint64_t lateAfterStall = 0;
+			for (int i = 0; i <= ticks; i++)
+			{
+				std::uint64_t deadline = (std::uint64_t)i * period;
+				returned = scheduler.waitUntil(deadline);
+				neverEarly = neverEarly && returned >= deadline;
+				if (i == 6)
+					lateAfterStall = returned - deadline;
+				std::this_thread::sleep_for(std::chrono::nanoseconds(i == 5 ? 3 * period : period / 2));
+			}
+			test.check(neverEarly, "no tick returns before its deadline");
+			test.check(lateAfterStall >= 2 * period, "the tick after the stall is late by " + std::to_string(lateAfterStall) + " ns");
+
+			// A scheduler sleeping one period after each tick would end 12.5 periods and the stall later
+			std::uint64_t lateness = returned - (std::uint64_t)ticks * period;
+			test.check(lateness < 2 * period, "the last tick is " + std::to_string(lateness) + " ns late");
+			const JitterHistogram& jitter = scheduler.getJitterHistogram();
+			test.check(jitter.getCount() == ticks + 1 && jitter.getMax() >= (std::int64_t)(2 * period), "every tick recorded, the stall included");
+		});
+	}
+
+	// Records the messages written to a RecordingLogSink and, while closed, holds the writing thread
+	class LogRecorder
+	{
+	public:
+		void record(LogLevel level, const std::string& message)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_messages.push_back(std::string(getLogLevelName(level)) + " " + message);
+			m_entered = true;
+			m_changed.notify_all();
+			m_changed.wait(lock, [this] { return m_open; });
+		}
+
+		// Waits until the writing thread is held by `record`
+		void waitForWriter()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_changed.wait(lock, [this] { return m_entered; });
+		}
+
+		void open()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_open = true;
+			}
+			m_changed.notify_all();
+		}
+
+		std::vector<std::string> getMessages()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_messages;
+		}
+
+	private:
+		std::mutex m_mutex;                  // Protects the members below
+		std::condition_variable m_changed;   // Signals m_entered and m_open
+		std::vector<std::string> m_messages; // Every message recorded, as "level message"
+		bool m_entered = false;              // A message has been recorded
+		bool m_open = false;                 // `record` returns immediately
+	};
+
+	// Passes messages to a LogRecorder that outlives it
+	class RecordingLogSink : public LogSink
+	{
+	public:
+		RecordingLogSink(std::shared_ptr<LogRecorder> recorder) : m_recorder(std::move(recorder)) {}
+
+		void write(LogLevel level, const std::string& message) override { m_recorder->record(level, message); }
+
+	private:
+		std::shared_ptr<LogRecorder> m_recorder; // Receives the messages
+	};
+
+	void registerLoggerTests(TestSuite& suite)
+	{
+		suite.add("Logger/asyncDropsWhenFull", [](TestSuite& test)
+		{
+			// The background thread is held writing the first message, so the queue fills and further messages are dropped
+			const size_t capacity = 8;
+			const size_t extra = 5;
+			std::shared_ptr<LogRecorder> recorder = std::make_shared<LogRecorder>();
+			AsyncLogSink sink(std::unique_ptr<LogSink>(new RecordingLogSink(recorder)), capacity);
+			sink.write(eLogInfo, "held");
+			recorder->waitForWriter();
+			for (size_t i = 0; i < capacity + extra; i++)
+				sink.write(eLogInfo, std::to_string(i));
+			test.check(sink.getDroppedCount() == extra, "dropped " + std::to_string(sink.getDroppedCount()) + " of " + std::to_string(extra));
+
+			// The drops are reported once after the batch written while they happened, then the queued messages follow in order
+			recorder->open();
+			sink.flush();
+			std::vector<std::string> messages = recorder->getMessages();
+			bool complete = messages.size() == capacity + 2 && messages[0] == "info held";
+			test.check(complete && messages[1] == "warning " + std::to_string(extra) + " log messages dropped, the log sink could not keep up",
+				"the drops are reported");
+			for (size_t i = 0; complete && i < capacity; i++)
+				complete = messages[i + 2] == "info " + std::to_string(i);
+			test.check(complete, "the queued messages are written in order");
+		});
+
+		suite.add("Logger/destructionFlushes", [](TestSuite& test)
+		{
+			// Destroying the logger releases the last reference to its AsyncLogSink, which writes every queued line before it stops
+			const size_t lines = 100;
+			std::shared_ptr<LogRecorder> recorder = std::make_shared<LogRecorder>();
+			std::unique_ptr<Logger> logger(new Logger(eLogDebug,
+				std::make_shared<AsyncLogSink>(std::unique_ptr<LogSink>(new RecordingLogSink(recorder)), lines)));
+			logger->log(eLogInfo, "held");
+			recorder->waitForWriter();
+			for (size_t i = 0; i < lines; i++)
+				logger->log(eLogDebug, std::to_string(i));
+			recorder->open();
+			logger.reset();
+
+			std::vector<std::string> messages = recorder->getMessages();
+			bool complete = messages.size() == lines + 1;
+			for (size_t i = 0; complete && i < lines; i++)
+				complete = messages[i + 1] == "debug " + std::to_string(i);
+			test.check(complete, std::to_string(messages.size()) + " of " + std::to_string(lines + 1) + " lines written");
+		});
+	}
+
+	void registerWorkspaceTests(TestSuite& suite)
+	{
+		suite.add("Workspace/steadyState", [](TestSuite& test)
+		{
+			// After the first round every buffer comes back from the pool, whether the processor is kept or replaced
+			std::vector<double> data = makeRandomData(20000, 13);
+			for (bool keepProcessor : { true, false })
+			{
+				std::string name = keepProcessor ? "one processor" : "a processor per round";
+				std::shared_ptr<Workspace> workspace(new Workspace());
+				std::unique_ptr<DataProcessor> processor;
+				size_t warmAllocations = 0;
+				for (int round = 0; round < 5; round++)
+				{
+					if (!keepProcessor || processor == nullptr)
+					{
+						processor.reset(new DataProcessor(5, 100));
+						processor->setWorkspace(workspace);
+					}
+					processor->setRawData(data);
+					processor->calculateStatistics();
+					processor->movingAverageFilter();
+					processor->beginStream(data.size());
+					for (size_t i = 0; i < data.size(); i++)
+						processor->onSample(Sample{ (std::uint64_t)i, data[i], (std::uint32_t)i });
+					processor->endStream();
+					test.check(processor->getProcessedData().size() == data.size(), name + ", round " + std::to_string(round) + " output size");
+
+					if (round == 0)
+						warmAllocations = workspace->getAllocationCount();
+					else
+						test.check(workspace->getAllocationCount() == warmAllocations, name + ", round " + std::to_string(round) + ": "
+							+ std::to_string(workspace->getAllocationCount() - warmAllocations) + " allocations after warm-up");
+				}
+				test.check(warmAllocations > 0 && (keepProcessor || workspace->getReuseCount() > 0), name + ": the buffers come from the workspace");
+			}
+		});
+	}
+
+	void printUsage()
+	{
+		std::cout << "Usage: sirius_tests [options]\n\n"
+			<< "  --filter TEXT      Only run tests whose name contains TEXT\n"
+			<< "  --help             Show this text\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string filter;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--help")
+		{
+			printUsage();
+			return 0;
+		}
+		else if (argument == "--filter" && i + 1 < argc)
+			filter = argv[++i];
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	// Progress messages of the code under test would only clutter the results
+	getLogger().setLevel(eLogOff);
+
+	TestSuite suite;
+	registerCaptureFileTests(suite);
+	registerCompressedSampleStoreTests(suite);
+	registerDataProcessorTests(suite);
+	registerFilterTests(suite);
+	registerLoggerTests(suite);
+	registerParallelTests(suite);
+	registerQuantileSketchTests(suite);
+	registerRandomEngineTests(suite);
+	registerSensorTests(suite);
+	registerSimdKernelTests(suite);
+	registerSpectrumTests(suite);
+	registerSpscRingBufferTests(suite);
+	registerStreamingTests(suite);
+	registerSummaryPyramidTests(suite);
+	registerThreadPoolTests(suite);
+	registerTimingTests(suite);
+	registerWorkspaceTests(suite);
+	return suite.run(filter) == 0 ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#include "TestSuite.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+	const size_t kMaxPrintedFailures = 10; // Failure messages printed per test; a broken loop would flood the output
+}
+
+TestSuite::TestSuite()
+	: m_failedChecks(0),    // No test is running yet
+	  m_printedFailures(0)
+{
+	// Constructor body
+}
+
+TestSuite::~TestSuite()
+{
+	// Destructor body
+}
+
+void TestSuite::add(const std::string& name, const std::function<void(TestSuite&)>& body)
+{
+	m_tests.push_back(Test{ name, body });
+}
+
+int TestSuite::run(const std::string& filter)
+{
+	int failedTests = 0;
+	int ranTests = 0;
+	for (const Test& test : m_tests)
+	{
+		if (!filter.empty() && test.name.find(filter) == std::string::npos)
+			continue;
+
+		m_failedChecks = 0;
+		m_printedFailures = 0;
+		std::cout << "[ RUN  ] " << test.name << "\n";
+		auto start = std::chrono::steady_clock::now();
+		test.body(*this);
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		ranTests++;
+		if (m_failedChecks > 0)
+			failedTests++;
+		std::cout << (m_failedChecks == 0 ? "[  OK  ] " : "[ FAIL ] ") << test.name
+			<< " (" << std::fixed << std::setprecision(1) << milliseconds << " ms";
+		std::cout.unsetf(std::ios::floatfield);
+		if (m_failedChecks > 0)
+			std::cout << ", " << m_failedChecks << " failed checks";
+		std::cout << ")\n";
+	}
+
+	// A filter that matches nothing is a mistake, not a success
+	if (ranTests == 0)
+	{
+		std::cout << "No test matches '" << filter << "'.\n";
+		return 1;
+	}
+	std::cout << "\n" << (ranTests - failedTests) << " of " << ranTests << " tests passed.\n";
+	return failedTests;
+}
+
+void TestSuite::check(bool condition, const std::string& message)
+{
+	if (condition)
+		return;
+
+	m_failedChecks++;
+	if (m_printedFailures++ < kMaxPrintedFailures)
+		std::cout << "         " << message << "\n";
+}
+
+void TestSuite::checkNear(double actual, double expected, double tolerance, const std::string& message)
+{
+	// Written so that a NaN fails the comparison
+	if (std::abs(actual - expected) <= tolerance)
+		return;
+
+	std::ostringstream text;
+	text << std::setprecision(17) << message << ": " << actual << " differs from " << expected << " by more than " << tolerance;
+	check(false, text.str());
+}
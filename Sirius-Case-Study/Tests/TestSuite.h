@@ -0,0 +1,62 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A minimal unit test harness in the style of the benchmark suite.
+ *
+ * Each registered test is a function that reports its expectations through `check` and `checkNear`.
+ * A failed expectation does not stop the test, so one run lists every mismatch of a test. The
+ * harness prints the messages of the failed expectations of each test and its outcome.
+ */
+class TestSuite
+{
+public:
+	TestSuite();
+	~TestSuite();
+
+	/**
+ * @brief Registers a test.
+ *
+ * @param name The test name, e.g. "SimdKernels/statistics"; `run` filters on it.
+ * @param body The test code; it reports its expectations to the suite it is given.
+ */
+	void add(const std::string& name, const std::function<void(TestSuite&)>& body);
+	/**
+ * @brief Runs every registered test whose name contains the filter.
+ *
+ * @param filter A substring of the names to run, empty to run everything.
+ * @return The number of failed tests, 1 if no test matches the filter.
+ */
+	int run(const std::string& filter);
+
+	/**
+ * @brief Records an expectation of the running test.
+ *
+ * @param condition The expectation, false if it failed.
+ * @param message Describes the expectation, printed if it failed.
+ */
+	void check(bool condition, const std::string& message);
+	/**
+ * @brief Records that a value is within a tolerance of its expected value.
+ *
+ * @param actual The computed value.
+ * @param expected The expected value.
+ * @param tolerance The largest allowed absolute difference.
+ * @param message Describes the value, printed with both values if it failed.
+ */
+	void checkNear(double actual, double expected, double tolerance, const std::string& message);
+
+private:
+
+	struct Test
+	{
+		std::string name;                          // The test name
+		std::function<void(TestSuite&)> body;      // The test code
+	};
+
+	std::vector<Test> m_tests;    // The registered tests
+	size_t m_failedChecks;        // Failed expectations of the running test
+	size_t m_printedFailures;     // Failure messages printed for the running test
+};
@@ -0,0 +1,173 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace
+{
+	thread_local const ThreadPool* tls_currentPool = nullptr; // The pool owning the current worker thread, if any
+	thread_local size_t tls_workerIndex = 0;                 // The queue index of the current worker thread
+}
+
+ThreadPool::ThreadPool(size_t threadCount)
+	:m_nextQueue(0),
+	 m_queuedTasks(0),
+	 m_pendingTasks(0),
+	 m_sleepingWorkers(0),
+	 m_stopping(false)
+{
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		m_queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+	}
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		m_workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	wait();
+	{
+		std::lock_guard<std::mutex> lock(m_stateMutex);
+		m_stopping = true;
+	}
+	m_workAvailable.notify_all();
+
+	for (auto& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+	// Keep tasks spawned by a worker local to it, spread the others round-robin
+	size_t index = (tls_currentPool == this) ? tls_workerIndex : m_nextQueue.fetch_add(1) % m_queues.size();
+	m_pendingTasks.fetch_add(1); // Before the task can run and finish
+	{
+		// Counted under the queue's lock, so the take of this task cannot decrement before the increment
+		std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+		m_queues[index]->tasks.push_back(std::move(task));
+		m_queuedTasks.fetch_add(1);
+	}
+
+	// A worker going to sleep counts itself before it checks m_queuedTasks, so either it sees this task or it is seen
+	// here. Taking the lock makes sure a worker that has counted itself is waiting; it is released before notifying,
+	// so the woken worker does not block on it.
+	if (m_sleepingWorkers.load() > 0)
+	{
+		std::lock_guard<std::mutex> lock(m_stateMutex);
+		m_workAvailable.notify_one();
+	}
+}
+
+void ThreadPool::wait()
+{
+	std::unique_lock<std::mutex> lock(m_stateMutex);
+	m_allDone.wait(lock, [this] { return m_pendingTasks.load() == 0; });
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body)
+{
+	// State shared with the helper tasks, which may start only after the caller has done every index
+	struct Loop
+	{
+		std::atomic<size_t> next{ 0 }; // The next index to hand out
+		std::mutex mutex;              // Protects finished
+		std::condition_variable done;  // Signalled when the last index has finished
+		size_t finished = 0;           // The number of indices whose call has returned
+	};
+	std::shared_ptr<Loop> loop = std::make_shared<Loop>();
+	const std::function<void(size_t)>* work = &body;
+	auto run = [loop, work, count]()
+	{
+		// `body` is only touched while an index is left, i.e. before the caller can return
+		for (size_t i = loop->next.fetch_add(1); i < count; i = loop->next.fetch_add(1))
+		{
+			(*work)(i);
+			std::lock_guard<std::mutex> lock(loop->mutex);
+			if (++loop->finished == count)
+				loop->done.notify_all();
+		}
+	};
+
+	size_t helpers = count > 1 ? std::min(m_workers.size(), count - 1) : 0;
+	for (size_t i = 0; i < helpers; i++)
+	{
+		submit(run);
+	}
+	run();
+
+	// Helpers that have not started yet find nothing left to do, so this never waits for a queued task
+	std::unique_lock<std::mutex> lock(loop->mutex);
+	loop->done.wait(lock, [&loop, count] { return loop->finished == count; });
+}
+
+size_t ThreadPool::getThreadCount() const
+{
+	return m_workers.size();
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+	tls_currentPool = this;
+	tls_workerIndex = index;
+
+	std::function<void()> task;
+	while (true)
+	{
+		// Run tasks for as long as there are any, without touching the state mutex
+		if (tryTakeTask(index, task))
+		{
+			task();
+			task = nullptr; // Release captured state before reporting completion
+
+			if (m_pendingTasks.fetch_sub(1) == 1)
+			{
+				// The lock keeps the notification from falling between wait's check and its sleep
+				std::lock_guard<std::mutex> lock(m_stateMutex);
+				m_allDone.notify_all();
+			}
+			continue;
+		}
+
+		// Sleep until there is something to run or the pool stops
+		std::unique_lock<std::mutex> lock(m_stateMutex);
+		m_sleepingWorkers.fetch_add(1);
+		m_workAvailable.wait(lock, [this] { return m_queuedTasks.load() > 0 || m_stopping; });
+		m_sleepingWorkers.fetch_sub(1);
+		if (m_queuedTasks.load() == 0 && m_stopping)
+			return;
+	}
+}
+
+bool ThreadPool::tryTakeTask(size_t index, std::function<void()>& task)
+{
+	size_t count = m_queues.size();
+
+	// Take the newest task from the own queue, then steal the oldest task from the other queues
+	for (size_t i = 0; i < count; i++)
+	{
+		WorkerQueue& queue = *m_queues[(index + i) % count];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+			continue;
+
+		if (i == 0)
+		{
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+		}
+		else
+		{
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+		m_queuedTasks.fetch_sub(1);
+		return true;
+	}
+	return false;
+}
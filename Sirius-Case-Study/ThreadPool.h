@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A fixed-size work-stealing thread pool.
+ *
+ * Every worker owns a task queue. A worker takes tasks from the back of its own queue and,
+ * when that queue is empty, steals from the front of the other workers' queues, so long and
+ * short tasks balance across the workers without a single contended queue. Tasks submitted
+ * from outside the pool are distributed round-robin; tasks submitted from a worker go to that
+ * worker's own queue.
+ *
+ * The task counters are atomics, so submitting, taking and finishing a task only lock the queue
+ * involved. The state mutex is taken only by workers going to sleep and by the threads waking them.
+ */
+class ThreadPool
+{
+public:
+	/**
+ * @brief Constructs a ThreadPool object and starts its workers.
+ *
+ * @param threadCount The number of worker threads (default: 0, one per hardware thread).
+ */
+	ThreadPool(size_t threadCount = 0);
+	/**
+ * @brief Waits for all submitted tasks to finish and stops the workers.
+ */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+ * @brief Schedules a task for execution on one of the workers.
+ *
+ * @param task The task to run.
+ */
+	void submit(std::function<void()> task);
+	/**
+ * @brief Blocks until every task submitted so far has finished.
+ */
+	void wait();
+	/**
+ * @brief Runs `body(i)` for every i in [0, count) and returns when all calls have finished.
+ *
+ * The calling thread takes part in the work, and the indices are handed out dynamically, so chunks of
+ * uneven cost balance across the threads. Unlike `wait`, only the calls of this loop are waited for,
+ * so the pool can be busy with other tasks. Which thread runs which index is not deterministic.
+ *
+ * @param count The number of indices.
+ * @param body The work for one index; may run concurrently with itself for different indices.
+ */
+	void parallelFor(size_t count, const std::function<void(size_t)>& body);
+	/**
+ * @brief Retrieves the number of worker threads.
+ *
+ * @return The number of workers.
+ */
+	size_t getThreadCount() const;
+
+private:
+
+	struct WorkerQueue
+	{
+		std::mutex mutex;                        // Protects tasks
+		std::deque<std::function<void()>> tasks; // Tasks owned by the worker
+	};
+
+	std::vector<std::unique_ptr<WorkerQueue>> m_queues; // One task queue per worker
+	std::vector<std::thread> m_workers;                 // The worker threads
+	std::atomic<size_t> m_nextQueue;                    // Round-robin position for tasks submitted from outside the pool
+	std::mutex m_stateMutex;                            // Taken only to sleep on and signal the condition variables; protects m_stopping
+	std::condition_variable m_workAvailable;            // Signalled when a task is queued while a worker sleeps, or the pool stops
+	std::condition_variable m_allDone;                  // Signalled when the last pending task finishes
+	std::atomic<size_t> m_queuedTasks;                  // The number of tasks waiting in the queues
+	std::atomic<size_t> m_pendingTasks;                 // The number of tasks submitted but not yet finished
+	std::atomic<size_t> m_sleepingWorkers;              // The number of workers waiting on m_workAvailable
+	bool m_stopping;                                    // Set when the workers should exit
+
+	/**
+ * @brief Main loop of a worker: runs tasks from its own queue, steals when it runs dry and sleeps when there is no work.
+ *
+ * @param index The index of the worker's queue.
+ */
+	void workerLoop(size_t index);
+	/**
+ * @brief Takes a task from the worker's own queue or steals one from another worker.
+ *
+ * @param index The index of the worker's queue.
+ * @param task Receives the task.
+ * @return True if a task was found.
+ */
+	bool tryTakeTask(size_t index, std::function<void()>& task);
+};
@@ -1,7 +1,25 @@
 #include "UserInputHandler.h"
+#include "CaptureFile.h"
+#include "CompressedSampleStore.h"
+#include "SampleTraits.h"
+#include <filesystem>
 #include <fstream>
+#include <type_traits>
 
 UserInputHandler::UserInputHandler()
+    : m_numDataPoints(0),           // Every value is set by getInputs; these defaults match Sensor's
+      m_numChannels(1),             // A single channel unless the user asks for more
+      m_dataTimingPeriod(100),
+      m_movingAverageWindowSize(3),
+      m_subsetSize(1),
+      m_dataTimingOption(0),
+      m_dataType(0),
+      m_rangeMin(-100),
+      m_rangeMax(100),
+      m_dataSource(0),              // The simulated sensor unless the user asks for a replay
+      m_replayPacing(0),            // Replays run as fast as possible by default
+      m_replaySpeedFactor(1),       // Real time unless the user asks for a speed-up
+      m_replayPeriod(0)             // Use the sample period stored in the capture
 {
     // Constructor body
 }
@@ -16,6 +34,11 @@ int UserInputHandler::getNumDataPoints() const
     return m_numDataPoints; // Return the number of data points
 }
 
+int UserInputHandler::getNumChannels() const
+{
+    return m_numChannels; // Return the number of sensor channels
+}
+
 int UserInputHandler::getDataTimingPeriod() const
 {
     return m_dataTimingPeriod; // Return the data timing period in milliseconds
@@ -51,10 +74,69 @@ int UserInputHandler::getDataType() const
     return m_dataType; // Return the selected data type
 }
 
+int UserInputHandler::getDataSource() const
+{
+    return m_dataSource; // Return the selected data source
+}
+
+const std::string& UserInputHandler::getReplayPath() const
+{
+    return m_replayPath; // Return the path of the capture to replay
+}
+
+int UserInputHandler::getReplayPacing() const
+{
+    return m_replayPacing; // Return the selected replay pacing
+}
+
+int UserInputHandler::getReplaySpeedFactor() const
+{
+    return m_replaySpeedFactor; // Return the replay speed factor
+}
+
+int UserInputHandler::getReplayPeriod() const
+{
+    return m_replayPeriod; // Return the replay sample period in milliseconds
+}
+
 void UserInputHandler::getInputs()
 {
+    // Get data source
+    std::cout << "Select data source:\n";
+    std::cout << "0 - Sensor\n";
+    std::cout << "1 - Replay a saved capture (output.txt or output.cap)\n";
+    m_dataSource = getIntInput("Enter your choice (0 or 1): ", 0, 1);
+
+    // A replay only needs the capture, its pacing and the processing parameters
+    if (m_dataSource == 1)
+    {
+        m_replayPath = getLineInput("Enter the path of the capture file: ");
+
+        std::cout << "Select replay speed:\n";
+        std::cout << "0 - As fast as possible\n";
+        std::cout << "1 - Real time\n";
+        std::cout << "2 - N times real time\n";
+        m_replayPacing = getIntInput("Enter your choice (0, 1 or 2): ", 0, 2);
+
+        if (m_replayPacing == 2)
+            m_replaySpeedFactor = getIntInput("Enter the speed factor (1 to 1000): ", 1, 1000);
+        if (m_replayPacing != 0)
+            m_replayPeriod = getIntInput("Enter the sample period in milliseconds, used if the capture does not store one (1 to 1000): ", 1, 1000);
+
+        m_movingAverageWindowSize = getIntInput("Enter the moving average window size (3 to 101, odd numbers only): ", 3, 101);
+        if (m_movingAverageWindowSize % 2 == 0) {
+            std::cout << "Window size must be odd. Incrementing to the next odd number.\n";
+            m_movingAverageWindowSize++; // Ensure it's odd
+        }
+        m_subsetSize = getIntInput("Enter the subset size: ", 1, std::numeric_limits<int>::max());
+        return;
+    }
+
     // Get number of data points
-    m_numDataPoints = getIntInput("Enter the number of data points (1 to 10000): ", 1, 10000);
+    m_numDataPoints = getIntInput("Enter the number of data points (1 to 2147483647): ", 1, std::numeric_limits<int>::max());
+
+    // Get number of sensor channels
+    m_numChannels = getIntInput("Enter the number of sensor channels (1 to 1000): ", 1, 1000);
 
     // Get timing option
     std::cout << "Select timing option:\n";
@@ -114,46 +196,169 @@ void UserInputHandler::getInputs()
     m_subsetSize = getIntInput("Enter the subset size: ", 1, m_numDataPoints);
 }
 
-void UserInputHandler::saveDataToFile(const std::vector<double>& rawData, const std::vector<double>& processedData) {
+void UserInputHandler::saveDataToFile(const SampleBuffer& rawSamples, std::span<const double> processedData) {
     // Ask the user if they want to save the generated data
-    std::cout << "\nDo you want to save the generated data to a text file (output.txt)?\n";
-    std::cout << "0 - YES\n";
+    std::cout << "\nDo you want to save the generated data?\n";
+    std::cout << "0 - YES, as a text file (output.txt)\n";
     std::cout << "1 - NO\n";
-    int userResponse = getIntInput("Enter your choice (0 or 1): \n", 0, 1);
+    std::cout << "2 - YES, as a binary capture (output.cap)\n";
+    std::cout << "3 - YES, as a compressed binary capture (output.cap)\n";
+    int userResponse = getIntInput("Enter your choice (0, 1, 2 or 3): \n", 0, 3);
 
     // If the user responds with "yes", proceed to save the data
     if (userResponse == 0) {
-        // Open the file output.txt for writing
-        std::ofstream outFile("output.txt");
-
-        // Check if the file is open successfully
-        if (outFile.is_open()) {
-            // Save raw data to the file
-            outFile << "Raw Data:\n";
-            for (const auto& dataPoint : rawData) {
-                outFile << dataPoint << "\n";  // Write each data point on a new line
-            }
-
-            // Save processed data to the file
-            outFile << "\nProcessed Data:\n";
-            for (const auto& dataPoint : processedData) {
-                outFile << dataPoint << "\n";  // Write each processed data point on a new line
-            }
-
-            // Close the file after writing
-            outFile.close();
-
+        if (writeTextFile("output.txt", rawSamples, processedData)) {
             std::cout << "Data has been saved to 'output.txt'.\n";
         }
         else {
             std::cout << "Failed to open the file for writing.\n";
         }
     }
+    else if (userResponse == 2) {
+        if (writeBinaryFile("output.cap", rawSamples, processedData, getConfiguration())) {
+            std::cout << "Data has been saved to 'output.cap'.\n";
+        }
+        else {
+            std::cout << "Failed to write the binary capture.\n";
+        }
+    }
+    else if (userResponse == 3) {
+        double ratio = 0.0;
+        if (writeCompressedFile("output.cap", rawSamples, processedData, getConfiguration(), &ratio)) {
+            std::cout << "Data has been saved to 'output.cap', compressed " << ratio << " times.\n";
+        }
+        else {
+            std::cout << "Failed to write the binary capture.\n";
+        }
+    }
     else {
         std::cout << "Data was not saved.\n";
     }
 }
 
+template <typename T>
+bool UserInputHandler::writeTextFile(const std::string& path, const BasicSampleBuffer<T>& rawSamples, std::span<const T> processedData,
+                                     double scale)
+{
+    // Open the file for writing
+    std::ofstream outFile(path);
+
+    // Check if the file is open successfully
+    if (!outFile.is_open())
+        return false;
+
+    // Save raw data to the file
+    outFile << "Raw Data:\n";
+    for (const auto& dataPoint : rawSamples.getValues()) {
+        outFile << SampleTraits<T>::toValue(dataPoint, scale) << "\n";  // Write each data point on a new line
+    }
+
+    // Save processed data to the file
+    outFile << "\nProcessed Data:\n";
+    for (const auto& dataPoint : processedData) {
+        outFile << SampleTraits<T>::toValue(dataPoint, scale) << "\n";  // Write each processed data point on a new line
+    }
+
+    // Save the timing of the raw data last, so that readers of the values can stop at "Processed Data:"
+    if (rawSamples.hasTiming()) {
+        outFile << "\nRaw Timing (sequence, timestamp ns):\n";
+        std::span<const std::uint32_t> sequences = rawSamples.getSequences();
+        std::span<const std::uint64_t> timestamps = rawSamples.getTimestamps();
+        for (size_t i = 0; i < sequences.size(); i++) {
+            outFile << sequences[i] << ", " << timestamps[i] << "\n";
+        }
+    }
+
+    // Close the file after writing
+    outFile.close();
+    return !outFile.fail();
+}
+
+template <typename T>
+bool UserInputHandler::writeBinaryFile(const std::string& path, const BasicSampleBuffer<T>& rawSamples, std::span<const T> processedData,
+                                       const RunConfiguration& configuration, double scale)
+{
+    // Store both buffers as raw columns in their own width; no formatting is needed to write or to read them back
+    CaptureWriter writer;
+    writer.setSamplePeriod(getCaptureSamplePeriod(configuration));
+    if constexpr (!std::is_floating_point_v<T>)
+        writer.setValueScale(scale);
+    writer.addColumn("raw", rawSamples.getValues());
+    writer.addColumn("processed", processedData);
+    if (rawSamples.hasTiming()) {
+        writer.addColumn("timestamp", rawSamples.getTimestamps());
+        writer.addColumn("sequence", rawSamples.getSequences());
+    }
+    return writer.write(path);
+}
+
+template <typename T>
+bool UserInputHandler::writeCompressedFile(const std::string& path, const BasicSampleBuffer<T>& rawSamples, std::span<const T> processedData,
+                                           const RunConfiguration& configuration, double* compressionRatio, double scale)
+{
+    // The raw column keeps its timing inside the store; neither compressed column has a chunk index
+    CaptureWriter writer(0);
+    writer.setSamplePeriod(getCaptureSamplePeriod(configuration));
+    CompressedSampleStore samples;
+    if constexpr (std::is_same_v<T, double>) {
+        samples.assign(rawSamples);
+        writer.addColumn("raw", samples);
+        samples.clear();
+        samples.append(processedData);
+    }
+    else {
+        samples.assign(rawSamples, scale);
+        writer.addColumn("raw", samples);
+        samples.clear();
+        std::vector<double> values(processedData.size());
+        for (size_t i = 0; i < values.size(); i++)
+            values[i] = SampleTraits<T>::toValue(processedData[i], scale);
+        samples.append(values);
+    }
+    writer.addColumn("processed", samples);
+    if (!writer.write(path))
+        return false;
+
+    // Compare against the bytes the columns of writeBinaryFile take
+    if (compressionRatio != nullptr) {
+        size_t timingBytes = rawSamples.hasTiming() ? sizeof(std::uint64_t) + sizeof(std::uint32_t) : 0;
+        size_t columnBytes = rawSamples.size() * (sizeof(T) + timingBytes) + processedData.size() * sizeof(T);
+        std::error_code error;
+        std::uintmax_t fileBytes = std::filesystem::file_size(path, error);
+        *compressionRatio = !error && fileBytes > 0 ? (double)columnBytes / (double)fileBytes : 0.0;
+    }
+    return true;
+}
+
+std::uint64_t UserInputHandler::getCaptureSamplePeriod(const RunConfiguration& configuration)
+{
+    if (configuration.dataSource == 0 && configuration.dataTimingOption == 1)
+        return configuration.getSamplePeriodNs();
+    if (configuration.dataSource == 1)
+        return (std::uint64_t)configuration.replayPeriod * 1000000; // Milliseconds to nanoseconds
+    return 0;
+}
+
+RunConfiguration UserInputHandler::getConfiguration() const
+{
+    RunConfiguration configuration;
+    configuration.numDataPoints = m_numDataPoints;
+    configuration.numChannels = m_numChannels;
+    configuration.dataTimingOption = m_dataTimingOption;
+    configuration.dataTimingPeriod = m_dataTimingPeriod;
+    configuration.dataType = m_dataType;
+    configuration.rangeMin = m_rangeMin;
+    configuration.rangeMax = m_rangeMax;
+    configuration.movingAverageWindowSize = m_movingAverageWindowSize;
+    configuration.subsetSize = m_subsetSize;
+    configuration.dataSource = m_dataSource;
+    configuration.replayPath = m_replayPath;
+    configuration.replayPacing = m_replayPacing;
+    configuration.replaySpeedFactor = m_replaySpeedFactor;
+    configuration.replayPeriod = m_replayPeriod;
+    return configuration;
+}
+
 int UserInputHandler::getIntInput(const std::string& prompt, int minValue, int maxValue)
 {
     int value;
@@ -175,4 +380,31 @@ int UserInputHandler::getIntInput(const std::string& prompt, int minValue, int m
             return value;
         }
     }
-}
\ No newline at end of file
+}
+
+std::string UserInputHandler::getLineInput(const std::string& prompt)
+{
+    std::string line;
+
+    // Keep asking until a non-empty line is entered
+    while (line.empty()) {
+        std::cout << prompt;
+        if (!std::getline(std::cin, line))
+            std::cin.clear();
+    }
+    return line;
+}
+
+// The sample types of SampleTraits; other types do not link
+template bool UserInputHandler::writeTextFile(const std::string&, const BasicSampleBuffer<double>&, std::span<const double>, double);
+template bool UserInputHandler::writeTextFile(const std::string&, const BasicSampleBuffer<float>&, std::span<const float>, double);
+template bool UserInputHandler::writeTextFile(const std::string&, const BasicSampleBuffer<std::int16_t>&, std::span<const std::int16_t>, double);
+template bool UserInputHandler::writeTextFile(const std::string&, const BasicSampleBuffer<std::int32_t>&, std::span<const std::int32_t>, double);
+template bool UserInputHandler::writeBinaryFile(const std::string&, const BasicSampleBuffer<double>&, std::span<const double>, const RunConfiguration&, double);
+template bool UserInputHandler::writeBinaryFile(const std::string&, const BasicSampleBuffer<float>&, std::span<const float>, const RunConfiguration&, double);
+template bool UserInputHandler::writeBinaryFile(const std::string&, const BasicSampleBuffer<std::int16_t>&, std::span<const std::int16_t>, const RunConfiguration&, double);
+template bool UserInputHandler::writeBinaryFile(const std::string&, const BasicSampleBuffer<std::int32_t>&, std::span<const std::int32_t>, const RunConfiguration&, double);
+template bool UserInputHandler::writeCompressedFile(const std::string&, const BasicSampleBuffer<double>&, std::span<const double>, const RunConfiguration&, double*, double);
+template bool UserInputHandler::writeCompressedFile(const std::string&, const BasicSampleBuffer<float>&, std::span<const float>, const RunConfiguration&, double*, double);
+template bool UserInputHandler::writeCompressedFile(const std::string&, const BasicSampleBuffer<std::int16_t>&, std::span<const std::int16_t>, const RunConfiguration&, double*, double);
+template bool UserInputHandler::writeCompressedFile(const std::string&, const BasicSampleBuffer<std::int32_t>&, std::span<const std::int32_t>, const RunConfiguration&, double*, double);
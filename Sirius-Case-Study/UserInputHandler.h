@@ -2,6 +2,9 @@
 #include <string>
 #include <limits>
 #include <vector>
+#include <span>
+#include "RunConfiguration.h"
+#include "SampleBuffer.h"
 
 class UserInputHandler
 {
@@ -20,6 +23,15 @@ public:
  */
     int getNumDataPoints() const;
     /**
+ * @brief Retrieves the number of sensor channels.
+ *
+ * This function returns the value of `m_numChannels`, which represents the number of
+ * independent sensor to data processor pipelines the user has requested.
+ *
+ * @return The number of sensor channels.
+ */
+    int getNumChannels() const;
+    /**
  * @brief Retrieves the data timing period in milliseconds.
  *
  * This function returns the value of `m_dataTimingPeriod`, which represents the
@@ -82,6 +94,51 @@ public:
  * @return The data type.
  */
     int getDataType() const;
+    /**
+ * @brief Retrieves the selected data source.
+ *
+ * This function returns the value of `m_dataSource`: 0 for the simulated sensor or 1 for
+ * replaying a previously saved capture.
+ *
+ * @return The data source.
+ */
+    int getDataSource() const;
+    /**
+ * @brief Retrieves the path of the capture to replay.
+ *
+ * This function returns the value of `m_replayPath`, which is only set when the replay data
+ * source is selected.
+ *
+ * @return The path of the capture file.
+ */
+    const std::string& getReplayPath() const;
+    /**
+ * @brief Retrieves the selected replay pacing.
+ *
+ * This function returns the value of `m_replayPacing`, which represents how fast the capture
+ * is replayed (`eAsFastAsPossible`, `eRealTime` or `eScaledTime`).
+ *
+ * @return The replay pacing.
+ */
+    int getReplayPacing() const;
+    /**
+ * @brief Retrieves the replay speed factor.
+ *
+ * This function returns the value of `m_replaySpeedFactor`, the speed-up relative to real time
+ * used when the `eScaledTime` pacing is selected.
+ *
+ * @return The replay speed factor.
+ */
+    int getReplaySpeedFactor() const;
+    /**
+ * @brief Retrieves the sample period used to pace a replay in milliseconds.
+ *
+ * This function returns the value of `m_replayPeriod`, which is used when the capture does not
+ * store its own sample period (text captures).
+ *
+ * @return The replay sample period in milliseconds.
+ */
+    int getReplayPeriod() const;
     
     /**
  * @brief Prompts the user for an integer input within a specified range.
@@ -97,22 +154,93 @@ public:
  */
     void getInputs();
     /**
- * @brief Prompts the user to save the generated data to a text file.
+ * @brief Prompts the user to save the generated data to a text file or a binary capture.
  *
  * This function asks the user whether they want to save the generated raw and processed data
- * to a text file named `output.txt`. If the user confirms, the function writes the raw and
- * processed data to the file. If the file is successfully opened, the data is written with
- * "Raw Data" and "Processed Data" headings, each data point on a new line. If the user declines
- * or the file cannot be opened, appropriate messages are displayed.
+ * to a text file named `output.txt` or to a binary capture named `output.cap`, optionally compressed. The text file
+ * contains "Raw Data" and "Processed Data" headings, each data point on a new line. The binary
+ * capture stores the values bit-exactly as "raw" and "processed" columns that CaptureReader can
+ * map straight back into memory. If the user declines or the file cannot be written,
+ * appropriate messages are displayed.
  *
- * @param rawData A vector containing the raw data points.
- * @param processedData A vector containing the processed data points.
+ * @param rawSamples The raw data points with their timing.
+ * @param processedData A view of the processed data points.
  */
-    void saveDataToFile(const std::vector<double>& rawData, const std::vector<double>& processedData);
+    void saveDataToFile(const SampleBuffer& rawSamples, std::span<const double> processedData);
+    /**
+ * @brief Retrieves every collected parameter as a run configuration.
+ *
+ * This function copies the user inputs into a `RunConfiguration`, so interactive runs and runs
+ * described on the command line go through the same code.
+ *
+ * @return The configuration of the run the user described.
+ */
+    RunConfiguration getConfiguration() const;
+    /**
+ * @brief Writes raw and processed data to a text file.
+ *
+ * The file contains "Raw Data" and "Processed Data" headings, each data point on a new line.
+ * If the raw data has timing, a final "Raw Timing" section holds one "sequence, timestamp" line per raw data point.
+ *
+ * Data points of an integer sample type are written as the physical values they represent.
+ *
+ * @param path The path of the file to create or overwrite.
+ * @param rawSamples The raw data points with their timing.
+ * @param processedData A view of the processed data points.
+ * @param scale The physical value of one count of the data points, ignored for floating point samples (default: 1.0).
+ * @return True if the file was written successfully.
+ */
+    template <typename T>
+    static bool writeTextFile(const std::string& path, const BasicSampleBuffer<T>& rawSamples, std::span<const T> processedData,
+                              double scale = 1.0);
+    /**
+ * @brief Writes raw and processed data to a binary capture.
+ *
+ * The data is stored as "raw" and "processed" columns of the sample type together with the sample period of the run,
+ * if it has one, and the scale of integer samples. If the raw data has timing, it is stored in "timestamp"
+ * (nanoseconds) and "sequence" columns.
+ *
+ * @param path The path of the file to create or overwrite.
+ * @param rawSamples The raw data points with their timing.
+ * @param processedData A view of the processed data points.
+ * @param configuration The configuration of the run that produced the data.
+ * @param scale The physical value of one count of the data points, ignored for floating point samples (default: 1.0).
+ * @return True if the file was written successfully.
+ */
+    template <typename T>
+    static bool writeBinaryFile(const std::string& path, const BasicSampleBuffer<T>& rawSamples, std::span<const T> processedData,
+                                const RunConfiguration& configuration, double scale = 1.0);
+    /**
+ * @brief Writes raw and processed data to a binary capture with compressed columns.
+ *
+ * Like `writeBinaryFile`, but the "raw" column is a CompressedSampleStore that also holds the timing of
+ * the raw data, and the "processed" column is compressed too. CaptureReader and ReplaySource decode them.
+ * Both columns hold physical values, whatever the sample type.
+ *
+ * @param path The path of the file to create or overwrite.
+ * @param rawSamples The raw data points with their timing.
+ * @param processedData A view of the processed data points.
+ * @param configuration The configuration of the run that produced the data.
+ * @param compressionRatio Receives the size of the uncompressed columns divided by the file size, may be nullptr.
+ * @param scale The physical value of one count of the data points, ignored for floating point samples (default: 1.0).
+ * @return True if the file was written successfully.
+ */
+    template <typename T>
+    static bool writeCompressedFile(const std::string& path, const BasicSampleBuffer<T>& rawSamples, std::span<const T> processedData,
+                                    const RunConfiguration& configuration, double* compressionRatio = nullptr, double scale = 1.0);
 
 private:
 
+    /**
+ * @brief Retrieves the sample period stored in a binary capture of a run.
+ *
+ * @param configuration The configuration of the run that produced the data.
+ * @return The sample period in nanoseconds, 0 if the run has none.
+ */
+    static std::uint64_t getCaptureSamplePeriod(const RunConfiguration& configuration);
+
     int m_numDataPoints;           // The number of data points to be generated or processed
+    int m_numChannels;             // The number of sensor channels, each with its own sensor and data processor
     int m_dataTimingPeriod;        // The data timing period in milliseconds, relevant only when the data timing option is set to 'Periodic'
     int m_movingAverageWindowSize; // The size of the moving average window
     int m_subsetSize;              // The number of elements in each subset for subset averaging
@@ -120,6 +248,11 @@ private:
     int m_dataType;                // The type of data generation selected by the user
     int m_rangeMin;                // The minimum possible value for data points
     int m_rangeMax;                // The maximum possible value for data points
+    int m_dataSource;              // The data source selected by the user: 0 for the sensor, 1 for a replay
+    std::string m_replayPath;      // The path of the capture to replay
+    int m_replayPacing;            // How fast the capture is replayed
+    int m_replaySpeedFactor;       // The speed-up relative to real time for scaled pacing
+    int m_replayPeriod;            // The sample period in milliseconds for captures that do not store one
     
     /**
  * @brief Prompts the user for various input parameters.
@@ -137,5 +270,12 @@ private:
  * and the user is prompted again until valid values are provided.
  */
     int getIntInput(const std::string& prompt, int minValue, int maxValue);
+    /**
+ * @brief Prompts the user for a non-empty line of text.
+ *
+ * @param prompt The prompt message displayed to the user.
+ * @return The line entered by the user.
+ */
+    std::string getLineInput(const std::string& prompt);
 };
 
@@ -0,0 +1,183 @@
+#include "Workspace.h"
+#include <utility>
+
+Workspace::Workspace()
+	: m_allocationCount(0), // Nothing allocated yet
+	  m_reuseCount(0)       // Nothing reused yet
+{
+	// Reserve the pools themselves, so returning a buffer never allocates
+	std::apply([](auto&... pools)
+	{
+		((pools.values.reserve(kMaxPooledBuffers), pools.samples.reserve(kMaxPooledBuffers)), ...);
+	}, m_pools);
+}
+
+Workspace::~Workspace()
+{
+	// Destructor body
+}
+
+template <typename T>
+std::vector<T> Workspace::acquireValues(size_t capacity)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::vector<T> buffer = take(std::get<Pools<T>>(m_pools).values, capacity);
+	if (buffer.capacity() < capacity)
+	{
+		buffer.reserve(capacity);
+		m_allocationCount++;
+	}
+	else
+	{
+		m_reuseCount++;
+	}
+	return buffer;
+}
+
+template <typename T>
+BasicSampleBuffer<T> Workspace::acquireSamples(size_t capacity)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	BasicSampleBuffer<T> buffer = take(std::get<Pools<T>>(m_pools).samples, capacity);
+	if (buffer.capacity() < capacity)
+	{
+		buffer.reserve(capacity);
+		m_allocationCount++;
+	}
+	else
+	{
+		m_reuseCount++;
+	}
+	return buffer;
+}
+
+template <typename T>
+void Workspace::release(std::vector<T>&& buffer)
+{
+	std::vector<T> released = std::move(buffer);
+	buffer.clear();
+	released.clear();
+	if (released.capacity() == 0)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	put(std::get<Pools<T>>(m_pools).values, std::move(released));
+}
+
+template <typename T>
+void Workspace::release(BasicSampleBuffer<T>&& buffer)
+{
+	BasicSampleBuffer<T> released = std::move(buffer);
+	buffer.clear();
+	released.clear();
+	if (released.capacity() == 0)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	put(std::get<Pools<T>>(m_pools).samples, std::move(released));
+}
+
+void Workspace::trim()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::apply([](auto&... pools)
+	{
+		((pools.values.clear(), pools.samples.clear()), ...);
+	}, m_pools);
+}
+
+size_t Workspace::getAllocationCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_allocationCount;
+}
+
+size_t Workspace::getReuseCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_reuseCount;
+}
+
+size_t Workspace::getPooledBytes() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t bytes = 0;
+	std::apply([&bytes](const auto&... pools)
+	{
+		(addPooledBytes(pools, bytes), ...);
+	}, m_pools);
+	return bytes;
+}
+
+template <typename Buffer>
+Buffer Workspace::take(std::vector<Buffer>& pool, size_t capacity)
+{
+	if (pool.empty())
+		return Buffer();
+
+	// The smallest buffer that fits, so large buffers stay available for large requests
+	size_t best = pool.size();
+	size_t largest = 0;
+	for (size_t i = 0; i < pool.size(); i++)
+	{
+		size_t available = pool[i].capacity();
+		if (available >= capacity && (best == pool.size() || available < pool[best].capacity()))
+			best = i;
+		if (available > pool[largest].capacity())
+			largest = i;
+	}
+	size_t index = best < pool.size() ? best : largest; // Growing the largest buffer wastes the least
+
+	Buffer buffer = std::move(pool[index]);
+	if (index + 1 < pool.size())
+		pool[index] = std::move(pool.back());
+	pool.pop_back();
+	return buffer;
+}
+
+template <typename Buffer>
+void Workspace::put(std::vector<Buffer>& pool, Buffer&& buffer)
+{
+	if (pool.size() < kMaxPooledBuffers)
+	{
+		pool.push_back(std::move(buffer));
+		return;
+	}
+
+	// Keep the larger buffers: they can serve any request the smaller ones could
+	size_t smallest = 0;
+	for (size_t i = 1; i < pool.size(); i++)
+	{
+		if (pool[i].capacity() < pool[smallest].capacity())
+			smallest = i;
+	}
+	if (buffer.capacity() > pool[smallest].capacity())
+		pool[smallest] = std::move(buffer);
+}
+
+template <typename T>
+void Workspace::addPooledBytes(const Pools<T>& pools, size_t& bytes)
+{
+	for (const std::vector<T>& buffer : pools.values)
+		bytes += buffer.capacity() * sizeof(T);
+	for (const BasicSampleBuffer<T>& buffer : pools.samples)
+		bytes += buffer.capacity() * (sizeof(T) + sizeof(std::uint64_t) + sizeof(std::uint32_t));
+}
+
+// The sample types the kernels support
+template std::vector<double> Workspace::acquireValues<double>(size_t);
+template std::vector<float> Workspace::acquireValues<float>(size_t);
+template std::vector<std::int16_t> Workspace::acquireValues<std::int16_t>(size_t);
+template std::vector<std::int32_t> Workspace::acquireValues<std::int32_t>(size_t);
+template BasicSampleBuffer<double> Workspace::acquireSamples<double>(size_t);
+template BasicSampleBuffer<float> Workspace::acquireSamples<float>(size_t);
+template BasicSampleBuffer<std::int16_t> Workspace::acquireSamples<std::int16_t>(size_t);
+template BasicSampleBuffer<std::int32_t> Workspace::acquireSamples<std::int32_t>(size_t);
+template void Workspace::release<double>(std::vector<double>&&);
+template void Workspace::release<float>(std::vector<float>&&);
+template void Workspace::release<std::int16_t>(std::vector<std::int16_t>&&);
+template void Workspace::release<std::int32_t>(std::vector<std::int32_t>&&);
+template void Workspace::release<double>(BasicSampleBuffer<double>&&);
+template void Workspace::release<float>(BasicSampleBuffer<float>&&);
+template void Workspace::release<std::int16_t>(BasicSampleBuffer<std::int16_t>&&);
+template void Workspace::release<std::int32_t>(BasicSampleBuffer<std::int32_t>&&);
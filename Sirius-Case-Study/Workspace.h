@@ -0,0 +1,132 @@
+#pragma once
+#include "SampleBuffer.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+/**
+ * @brief A pool of reusable data buffers shared by the sensors and data processors of a program.
+ *
+ * Sensors and data processors that are given a workspace take their storage from it and hand it back
+ * when they are done with it (when their data is replaced or when they are destroyed), instead of
+ * allocating and freeing it every run. Once the buffers of the largest run have been allocated, the
+ * following runs of the same or a smaller size perform no heap allocation for their data at all.
+ *
+ * Buffers are matched by capacity: `acquire` returns the smallest pooled buffer that is large enough,
+ * or grows the largest one if none is. Every growth is counted, so `getAllocationCount` staying constant
+ * across runs verifies that the steady state does not allocate. A workspace may be shared by threads;
+ * buffers are exchanged under a lock, which is taken per buffer and never per data point. Every sample
+ * type (see SampleTraits) has pools of its own.
+ */
+class Workspace
+{
+public:
+	static const size_t kMaxPooledBuffers = 32; ///< Buffers kept per kind; the smallest is freed when more are released.
+
+	Workspace();
+	~Workspace();
+
+	Workspace(const Workspace&) = delete;
+	Workspace& operator=(const Workspace&) = delete;
+
+	/**
+ * @brief Takes an empty value buffer from the pool.
+ *
+ * @tparam T The sample type of the buffer.
+ * @param capacity The number of values the buffer must hold without reallocating.
+ * @return An empty buffer with at least that capacity.
+ */
+	template <typename T = double>
+	std::vector<T> acquireValues(size_t capacity);
+	/**
+ * @brief Takes an empty data point buffer from the pool.
+ *
+ * @tparam T The sample type of the buffer.
+ * @param capacity The number of data points every column must hold without reallocating.
+ * @return An empty buffer with at least that capacity.
+ */
+	template <typename T = double>
+	BasicSampleBuffer<T> acquireSamples(size_t capacity);
+	/**
+ * @brief Returns a value buffer to the pool. Its contents are discarded, its storage is kept.
+ *
+ * @param buffer The buffer, left empty on return.
+ */
+	template <typename T>
+	void release(std::vector<T>&& buffer);
+	/**
+ * @brief Returns a data point buffer to the pool. Its contents are discarded, its storage is kept.
+ *
+ * @param buffer The buffer, left empty on return.
+ */
+	template <typename T>
+	void release(BasicSampleBuffer<T>&& buffer);
+	/**
+ * @brief Frees every pooled buffer.
+ */
+	void trim();
+
+	/**
+ * @brief Retrieves the number of acquisitions that had to allocate storage.
+ *
+ * @return The number of buffers created or grown since construction.
+ */
+	size_t getAllocationCount() const;
+	/**
+ * @brief Retrieves the number of acquisitions served from the pool without allocating.
+ *
+ * @return The number of reused buffers since construction.
+ */
+	size_t getReuseCount() const;
+	/**
+ * @brief Retrieves the storage currently held by the pool.
+ *
+ * @return The capacity of the pooled buffers in bytes.
+ */
+	size_t getPooledBytes() const;
+
+private:
+
+	/**
+ * @brief The pooled buffers of one sample type.
+ */
+	template <typename T>
+	struct Pools
+	{
+		std::vector<std::vector<T>> values;          ///< Pooled value buffers.
+		std::vector<BasicSampleBuffer<T>> samples;   ///< Pooled data point buffers.
+	};
+
+	mutable std::mutex m_mutex; // Protects the pools and the counters
+	std::tuple<Pools<double>, Pools<float>, Pools<std::int16_t>, Pools<std::int32_t>> m_pools; // The pools of every sample type
+	size_t m_allocationCount;   // Acquisitions that created or grew a buffer
+	size_t m_reuseCount;        // Acquisitions served without allocating
+
+	/**
+ * @brief Takes the best matching buffer out of a pool.
+ *
+ * @param pool The pool to take from.
+ * @param capacity The capacity needed.
+ * @return The smallest buffer with at least that capacity, otherwise the largest one, or an empty buffer if the pool is empty.
+ */
+	template <typename Buffer>
+	Buffer take(std::vector<Buffer>& pool, size_t capacity);
+	/**
+ * @brief Puts a buffer into a pool, freeing the smallest buffer if the pool is full.
+ *
+ * @param pool The pool to put into.
+ * @param buffer The cleared buffer.
+ */
+	template <typename Buffer>
+	void put(std::vector<Buffer>& pool, Buffer&& buffer);
+	/**
+ * @brief Adds the storage held by the pools of one sample type.
+ *
+ * @param pools The pools.
+ * @param bytes The running total in bytes.
+ */
+	template <typename T>
+	static void addPooledBytes(const Pools<T>& pools, size_t& bytes);
+};
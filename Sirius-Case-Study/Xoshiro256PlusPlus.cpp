@@ -0,0 +1,64 @@
+#include "Xoshiro256PlusPlus.h"
+
+namespace
+{
+	inline std::uint64_t rotateLeft(std::uint64_t x, int k)
+	{
+		return (x << k) | (x >> (64 - k));
+	}
+
+	// One step of xoshiro256++ on a state held in local variables
+	inline std::uint64_t step(std::uint64_t& s0, std::uint64_t& s1, std::uint64_t& s2, std::uint64_t& s3)
+	{
+		std::uint64_t result = rotateLeft(s0 + s3, 23) + s0;
+		std::uint64_t t = s1 << 17;
+		s2 ^= s0;
+		s3 ^= s1;
+		s1 ^= s2;
+		s0 ^= s3;
+		s2 ^= t;
+		s3 = rotateLeft(s3, 45);
+		return result;
+	}
+}
+
+Xoshiro256PlusPlus::Xoshiro256PlusPlus(std::uint64_t seed)
+{
+	this->seed(seed);
+}
+
+Xoshiro256PlusPlus::~Xoshiro256PlusPlus()
+{
+	// Destructor body
+}
+
+void Xoshiro256PlusPlus::seed(std::uint64_t seed)
+{
+	// SplitMix64 never yields four zero words in a row, so the state is always valid
+	std::uint64_t state = seed;
+	for (std::uint64_t& word : m_state)
+		word = splitMix64(state);
+}
+
+std::uint64_t Xoshiro256PlusPlus::next()
+{
+	return step(m_state[0], m_state[1], m_state[2], m_state[3]);
+}
+
+void Xoshiro256PlusPlus::fillUniform(std::span<double> block, double min, double max)
+{
+	// Keep the state in registers for the whole block instead of reloading it through this
+	std::uint64_t s0 = m_state[0], s1 = m_state[1], s2 = m_state[2], s3 = m_state[3];
+	double range = max - min;
+	for (double& value : block)
+		value = min + toUnitInterval(step(s0, s1, s2, s3)) * range;
+	m_state[0] = s0;
+	m_state[1] = s1;
+	m_state[2] = s2;
+	m_state[3] = s3;
+}
+
+const char* Xoshiro256PlusPlus::getName() const
+{
+	return "xoshiro256++";
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "RandomEngine.h"
+
+/**
+ * @brief The xoshiro256++ generator (Blackman and Vigna, 2019).
+ *
+ * 256 bits of state, a period of 2^256 - 1 and a few shifts, rotations and additions per output,
+ * with no multiplication. It passes BigCrush and PractRand and is the default engine of Sensor.
+ */
+class Xoshiro256PlusPlus final : public RandomEngine
+{
+public:
+	/**
+ * @brief Constructs a seeded Xoshiro256PlusPlus object.
+ *
+ * @param seed The seed (default: 1).
+ */
+	Xoshiro256PlusPlus(std::uint64_t seed = 1);
+	~Xoshiro256PlusPlus();
+
+	void seed(std::uint64_t seed) override;
+	std::uint64_t next() override;
+	void fillUniform(std::span<double> block, double min, double max) override;
+	const char* getName() const override;
+
+private:
+
+	std::uint64_t m_state[4]; // The generator state, never all zero
+};